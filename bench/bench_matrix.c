@@ -0,0 +1,771 @@
+/**
+ * @file    bench_matrix.c
+ * @brief   Performance benchmark for the dense matrix kernels.
+ *
+ * Usage: bench_matrix [options]
+ *
+ *   --ops LIST       Comma separated subset of add, scale, transpose, gemv,
+ *                    gemm, lu and inverse (default: all).
+ *   --sizes LIST     Comma separated base sizes n (default: 64 to 1024).
+ *   --threads N      Threads used by parallel kernels (default: all CPUs).
+ *   --reps N         Timed samples per case (default: 10).
+ *   --warmup N       Samples run and discarded before timing (default: 2).
+ *   --no-pin         Do not pin threads to CPUs.
+ *   --format FMT     table, csv or json (default: table).
+ *   --output PATH    Write results to PATH instead of stdout.
+ *   --help           Print usage.
+ *
+ * Every base size n is run as three shapes: square n x n, tall 4n x n/4 and
+ * wide n/4 x 4n. LU and inverse need square input and only run the square
+ * shape. For an r x c shape GEMM multiplies r x c by c x c, and GEMV
+ * multiplies r x c by a vector of c elements.
+ *
+ * A sample repeats the operation enough times to last at least
+ * BENCH_MIN_SAMPLE_S, so short kernels are not lost in timer overhead, and
+ * reports the time per operation. GFLOPS counts the nominal floating-point
+ * operations of the textbook algorithm. GB/s counts the compulsory traffic,
+ * with each operand read and each result written once. Both use the median
+ * sample, which is less sensitive to scheduler noise than the mean.
+ *
+ * @author  heapbadger
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "matrix.h"
+#include "parallel.h"
+
+#define BENCH_DEFAULT_REPS   10U
+#define BENCH_DEFAULT_WARMUP 2U
+#define BENCH_MIN_SAMPLE_S   1e-3
+#define BENCH_MAX_SIZES      32U
+
+typedef enum
+{
+    BENCH_FORMAT_TABLE = 0,
+    BENCH_FORMAT_CSV   = 1,
+    BENCH_FORMAT_JSON  = 2,
+} bench_format_t;
+
+/**
+ * Operands for one shape, allocated once and shared by every operation.
+ */
+typedef struct
+{
+    size_t    rows;
+    size_t    cols;
+    matrix_t *p_a;      /**< rows x cols, diagonally dominant when square. */
+    matrix_t *p_b;      /**< rows x cols. */
+    matrix_t *p_c;      /**< rows x cols result. */
+    matrix_t *p_t;      /**< cols x rows result of the transpose. */
+    matrix_t *p_square; /**< cols x cols right operand of GEMM. */
+    double   *p_x;      /**< cols elements. */
+    double   *p_y;      /**< rows elements. */
+    size_t   *p_pivots; /**< rows pivots. */
+} bench_operands_t;
+
+typedef struct
+{
+    const char *p_name;
+    bool        b_square_only;
+
+    /**
+     * @brief Run the operation once.
+     */
+    matrix_error_code_t (*run)(bench_operands_t *p_ops);
+
+    /**
+     * @brief Nominal flops and compulsory bytes for an r x c shape.
+     */
+    void (*cost)(double rows, double cols, double *p_flops, double *p_bytes);
+} bench_op_t;
+
+typedef struct
+{
+    const char *p_op;
+    size_t      rows;
+    size_t      cols;
+    double      best_s;
+    double      median_s;
+    double      mean_s;
+    double      gflops;
+    double      gbps;
+} bench_result_t;
+
+/**
+ * @brief Operation runners and cost models.
+ */
+static matrix_error_code_t bench_run_add(bench_operands_t *p_ops);
+static matrix_error_code_t bench_run_scale(bench_operands_t *p_ops);
+static matrix_error_code_t bench_run_transpose(bench_operands_t *p_ops);
+static matrix_error_code_t bench_run_gemv(bench_operands_t *p_ops);
+static matrix_error_code_t bench_run_gemm(bench_operands_t *p_ops);
+static matrix_error_code_t bench_run_lu(bench_operands_t *p_ops);
+static matrix_error_code_t bench_run_inverse(bench_operands_t *p_ops);
+static void bench_cost_add(double r, double c, double *p_f, double *p_b);
+static void bench_cost_scale(double r, double c, double *p_f, double *p_b);
+static void bench_cost_transpose(double r, double c, double *p_f, double *p_b);
+static void bench_cost_gemv(double r, double c, double *p_f, double *p_b);
+static void bench_cost_gemm(double r, double c, double *p_f, double *p_b);
+static void bench_cost_lu(double r, double c, double *p_f, double *p_b);
+static void bench_cost_inverse(double r, double c, double *p_f, double *p_b);
+
+/**
+ * @brief Allocate and fill the operands for a rows x cols shape.
+ *
+ * @return True on success. On failure everything is released.
+ */
+static bool bench_operands_create(bench_operands_t *p_ops,
+                                  size_t            rows,
+                                  size_t            cols);
+
+/**
+ * @brief Release the operands of a shape (NULL members are skipped).
+ */
+static void bench_operands_destroy(bench_operands_t *p_ops);
+
+/**
+ * @brief Time one operation on one shape.
+ *
+ * @return True on success, false if the operation reported an error.
+ */
+static bool bench_measure(const bench_op_t *p_op,
+                          bench_operands_t *p_ops,
+                          size_t            reps,
+                          size_t            warmup,
+                          bench_result_t   *p_result);
+
+/**
+ * @brief Print one result, or the header when p_result is NULL.
+ */
+static void bench_print(FILE                 *p_out,
+                        bench_format_t        format,
+                        const bench_result_t *p_result,
+                        bool                  b_first);
+
+static double now_seconds(void);
+static int    compare_double(const void *p_lhs, const void *p_rhs);
+static bool   parse_list(const char *p_text, size_t *p_out, size_t *p_count);
+static void   print_usage(const char *p_prog);
+
+static const bench_op_t g_ops[] = {
+    { "add", false, bench_run_add, bench_cost_add },
+    { "scale", false, bench_run_scale, bench_cost_scale },
+    { "transpose", false, bench_run_transpose, bench_cost_transpose },
+    { "gemv", false, bench_run_gemv, bench_cost_gemv },
+    { "gemm", false, bench_run_gemm, bench_cost_gemm },
+    { "lu", true, bench_run_lu, bench_cost_lu },
+    { "inverse", true, bench_run_inverse, bench_cost_inverse },
+};
+
+#define BENCH_OP_COUNT (sizeof(g_ops) / sizeof(g_ops[0]))
+
+int
+main (int argc, char **argv)
+{
+    size_t         sizes[BENCH_MAX_SIZES] = { 64, 128, 256, 512, 1024 };
+    size_t         size_count             = 5U;
+    size_t         reps                   = BENCH_DEFAULT_REPS;
+    size_t         warmup                 = BENCH_DEFAULT_WARMUP;
+    size_t         threads                = 0U;
+    bool           b_pin                  = true;
+    bench_format_t format                 = BENCH_FORMAT_TABLE;
+    const char    *p_path                 = NULL;
+    bool           selected[BENCH_OP_COUNT];
+
+    for (size_t idx = 0U; idx < BENCH_OP_COUNT; ++idx)
+    {
+        selected[idx] = true;
+    }
+
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        const char *p_value = (arg + 1 < argc) ? argv[arg + 1] : NULL;
+
+        if (0 == strcmp(argv[arg], "--help"))
+        {
+            print_usage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+
+        if (0 == strcmp(argv[arg], "--no-pin"))
+        {
+            b_pin = false;
+            continue;
+        }
+
+        if (NULL == p_value)
+        {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        ++arg;
+
+        if (0 == strcmp(argv[arg - 1], "--sizes"))
+        {
+            if (!parse_list(p_value, sizes, &size_count))
+            {
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (0 == strcmp(argv[arg - 1], "--ops"))
+        {
+            for (size_t idx = 0U; idx < BENCH_OP_COUNT; ++idx)
+            {
+                const char *p_hit = strstr(p_value, g_ops[idx].p_name);
+                size_t      len   = strlen(g_ops[idx].p_name);
+                selected[idx]
+                    = (NULL != p_hit)
+                      && ((p_hit == p_value) || (',' == p_hit[-1]))
+                      && (('\0' == p_hit[len]) || (',' == p_hit[len]));
+            }
+        }
+        else if (0 == strcmp(argv[arg - 1], "--threads"))
+        {
+            threads = (size_t)strtoull(p_value, NULL, 10);
+        }
+        else if (0 == strcmp(argv[arg - 1], "--reps"))
+        {
+            reps = (size_t)strtoull(p_value, NULL, 10);
+        }
+        else if (0 == strcmp(argv[arg - 1], "--warmup"))
+        {
+            warmup = (size_t)strtoull(p_value, NULL, 10);
+        }
+        else if (0 == strcmp(argv[arg - 1], "--format"))
+        {
+            if (0 == strcmp(p_value, "csv"))
+            {
+                format = BENCH_FORMAT_CSV;
+            }
+            else if (0 == strcmp(p_value, "json"))
+            {
+                format = BENCH_FORMAT_JSON;
+            }
+            else if (0 == strcmp(p_value, "table"))
+            {
+                format = BENCH_FORMAT_TABLE;
+            }
+            else
+            {
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (0 == strcmp(argv[arg - 1], "--output"))
+        {
+            p_path = p_value;
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (0U == reps)
+    {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE *p_out = (NULL == p_path) ? stdout : fopen(p_path, "w");
+
+    if (NULL == p_out)
+    {
+        fprintf(stderr, "cannot open %s\n", p_path);
+        return EXIT_FAILURE;
+    }
+
+    parallel_set_threads(threads);
+
+    if (b_pin && (0 != parallel_set_affinity(true)))
+    {
+        fprintf(stderr, "warning: could not pin threads\n");
+        b_pin = false;
+    }
+
+    int  status  = EXIT_SUCCESS;
+    bool b_first = true;
+
+    if (BENCH_FORMAT_JSON == format)
+    {
+        fprintf(p_out,
+                "{\n  \"benchmark\": \"bench_matrix\",\n"
+                "  \"threads\": %zu,\n  \"pinned\": %s,\n"
+                "  \"reps\": %zu,\n  \"warmup\": %zu,\n  \"results\": [",
+                parallel_get_threads(),
+                b_pin ? "true" : "false",
+                reps,
+                warmup);
+    }
+    else
+    {
+        if (BENCH_FORMAT_TABLE == format)
+        {
+            fprintf(p_out,
+                    "# threads %zu, %s, %zu samples after %zu warmup\n",
+                    parallel_get_threads(),
+                    b_pin ? "pinned" : "unpinned",
+                    reps,
+                    warmup);
+        }
+
+        bench_print(p_out, format, NULL, true);
+    }
+
+    for (size_t size = 0U; size < size_count; ++size)
+    {
+        size_t n            = sizes[size];
+        size_t shapes[3][2] = {
+            { n, n },
+            { 4U * n, n / 4U },
+            { n / 4U, 4U * n },
+        };
+
+        for (size_t shape = 0U; shape < 3U; ++shape)
+        {
+            bench_operands_t ops = { 0 };
+
+            if ((0U == shapes[shape][0]) || (0U == shapes[shape][1]))
+            {
+                continue;
+            }
+
+            if (!bench_operands_create(
+                    &ops, shapes[shape][0], shapes[shape][1]))
+            {
+                fprintf(stderr,
+                        "allocation failed for %zu x %zu\n",
+                        shapes[shape][0],
+                        shapes[shape][1]);
+                status = EXIT_FAILURE;
+                continue;
+            }
+
+            for (size_t op = 0U; op < BENCH_OP_COUNT; ++op)
+            {
+                bench_result_t result = { 0 };
+
+                if ((!selected[op])
+                    || (g_ops[op].b_square_only && (ops.rows != ops.cols)))
+                {
+                    continue;
+                }
+
+                if (!bench_measure(&g_ops[op], &ops, reps, warmup, &result))
+                {
+                    fprintf(stderr,
+                            "%s failed for %zu x %zu\n",
+                            g_ops[op].p_name,
+                            ops.rows,
+                            ops.cols);
+                    status = EXIT_FAILURE;
+                    continue;
+                }
+
+                bench_print(p_out, format, &result, b_first);
+                b_first = false;
+                fflush(p_out);
+            }
+
+            bench_operands_destroy(&ops);
+        }
+    }
+
+    if (BENCH_FORMAT_JSON == format)
+    {
+        fprintf(p_out, "\n  ]\n}\n");
+    }
+
+    parallel_set_affinity(false);
+    parallel_set_threads(0U);
+
+    if ((stdout != p_out) && (0 != fclose(p_out)))
+    {
+        status = EXIT_FAILURE;
+    }
+
+    return status;
+}
+
+static matrix_error_code_t
+bench_run_add (bench_operands_t *p_ops)
+{
+    return matrix_add(p_ops->p_a, p_ops->p_b, p_ops->p_c);
+}
+
+static matrix_error_code_t
+bench_run_scale (bench_operands_t *p_ops)
+{
+    return matrix_scalar_multiply(p_ops->p_a, 1.000001, p_ops->p_c);
+}
+
+static matrix_error_code_t
+bench_run_transpose (bench_operands_t *p_ops)
+{
+    return matrix_transpose(p_ops->p_a, p_ops->p_t);
+}
+
+static matrix_error_code_t
+bench_run_gemv (bench_operands_t *p_ops)
+{
+    return matrix_gemv(p_ops->p_a, 1.0, p_ops->p_x, 0.0, p_ops->p_y);
+}
+
+static matrix_error_code_t
+bench_run_gemm (bench_operands_t *p_ops)
+{
+    return matrix_multiply(p_ops->p_a, p_ops->p_square, p_ops->p_c);
+}
+
+static matrix_error_code_t
+bench_run_lu (bench_operands_t *p_ops)
+{
+    return matrix_lu(p_ops->p_a, p_ops->p_c, p_ops->p_pivots, NULL);
+}
+
+static matrix_error_code_t
+bench_run_inverse (bench_operands_t *p_ops)
+{
+    return matrix_inverse(p_ops->p_a, p_ops->p_c);
+}
+
+static void
+bench_cost_add (double r, double c, double *p_f, double *p_b)
+{
+    *p_f = r * c;
+    *p_b = 3.0 * r * c * sizeof(double);
+}
+
+static void
+bench_cost_scale (double r, double c, double *p_f, double *p_b)
+{
+    *p_f = r * c;
+    *p_b = 2.0 * r * c * sizeof(double);
+}
+
+static void
+bench_cost_transpose (double r, double c, double *p_f, double *p_b)
+{
+    *p_f = 0.0;
+    *p_b = 2.0 * r * c * sizeof(double);
+}
+
+static void
+bench_cost_gemv (double r, double c, double *p_f, double *p_b)
+{
+    *p_f = 2.0 * r * c;
+    *p_b = ((r * c) + r + c) * sizeof(double);
+}
+
+static void
+bench_cost_gemm (double r, double c, double *p_f, double *p_b)
+{
+    *p_f = 2.0 * r * c * c;
+    *p_b = ((2.0 * r * c) + (c * c)) * sizeof(double);
+}
+
+static void
+bench_cost_lu (double r, double c, double *p_f, double *p_b)
+{
+    (void)c;
+    *p_f = (2.0 / 3.0) * r * r * r;
+    *p_b = 2.0 * r * r * sizeof(double);
+}
+
+static void
+bench_cost_inverse (double r, double c, double *p_f, double *p_b)
+{
+    (void)c;
+    *p_f = 2.0 * r * r * r;
+    *p_b = 2.0 * r * r * sizeof(double);
+}
+
+static bool
+bench_operands_create (bench_operands_t *p_ops, size_t rows, size_t cols)
+{
+    unsigned int state = 12345U;
+
+    p_ops->rows     = rows;
+    p_ops->cols     = cols;
+    p_ops->p_a      = matrix_create(rows, cols);
+    p_ops->p_b      = matrix_create(rows, cols);
+    p_ops->p_c      = matrix_create(rows, cols);
+    p_ops->p_t      = matrix_create(cols, rows);
+    p_ops->p_square = matrix_create(cols, cols);
+    p_ops->p_x      = (double *)malloc(cols * sizeof(double));
+    p_ops->p_y      = (double *)malloc(rows * sizeof(double));
+    p_ops->p_pivots = (size_t *)malloc(rows * sizeof(size_t));
+
+    if ((NULL == p_ops->p_a) || (NULL == p_ops->p_b) || (NULL == p_ops->p_c)
+        || (NULL == p_ops->p_t) || (NULL == p_ops->p_square)
+        || (NULL == p_ops->p_x) || (NULL == p_ops->p_y)
+        || (NULL == p_ops->p_pivots))
+    {
+        bench_operands_destroy(p_ops);
+        return false;
+    }
+
+    matrix_t *p_fill[] = { p_ops->p_a, p_ops->p_b, p_ops->p_square };
+
+    for (size_t idx = 0U; idx < 3U; ++idx)
+    {
+        for (size_t row = 0U; row < p_fill[idx]->rows; ++row)
+        {
+            for (size_t col = 0U; col < p_fill[idx]->cols; ++col)
+            {
+                state = (state * 1103515245U) + 12345U;
+                double value
+                    = ((double)((state >> 8) % 2000U) / 1000.0) - 1.0;
+
+                // A dominant diagonal keeps LU and inverse well defined
+                if (row == col)
+                {
+                    value += (double)p_fill[idx]->cols;
+                }
+
+                matrix_set(p_fill[idx], row, col, value);
+            }
+        }
+    }
+
+    for (size_t idx = 0U; idx < cols; ++idx)
+    {
+        p_ops->p_x[idx] = 1.0 / (double)(idx + 1U);
+    }
+
+    return true;
+}
+
+static void
+bench_operands_destroy (bench_operands_t *p_ops)
+{
+    matrix_destroy(p_ops->p_a);
+    matrix_destroy(p_ops->p_b);
+    matrix_destroy(p_ops->p_c);
+    matrix_destroy(p_ops->p_t);
+    matrix_destroy(p_ops->p_square);
+    free(p_ops->p_x);
+    free(p_ops->p_y);
+    free(p_ops->p_pivots);
+    memset(p_ops, 0, sizeof(*p_ops));
+}
+
+static bool
+bench_measure (const bench_op_t *p_op,
+               bench_operands_t *p_ops,
+               size_t            reps,
+               size_t            warmup,
+               bench_result_t   *p_result)
+{
+    double *p_samples = (double *)malloc(reps * sizeof(double));
+    size_t  inner     = 1U;
+
+    if (NULL == p_samples)
+    {
+        return false;
+    }
+
+    // Calibrate the repeat count so one sample lasts BENCH_MIN_SAMPLE_S; the
+    // calibration runs count as warmup and are never reported
+    for (;;)
+    {
+        double start = now_seconds();
+
+        for (size_t idx = 0U; idx < inner; ++idx)
+        {
+            matrix_error_code_t ret = p_op->run(p_ops);
+
+            if ((MATRIX_SUCCESS != ret) && (MATRIX_SINGULAR != ret))
+            {
+                free(p_samples);
+                return false;
+            }
+        }
+
+        if (((now_seconds() - start) >= BENCH_MIN_SAMPLE_S)
+            || (inner >= ((size_t)1U << 30)))
+        {
+            break;
+        }
+
+        inner *= 2U;
+    }
+
+    for (size_t sample = 0U; sample < warmup + reps; ++sample)
+    {
+        double start = now_seconds();
+
+        for (size_t idx = 0U; idx < inner; ++idx)
+        {
+            (void)p_op->run(p_ops);
+        }
+
+        double elapsed = (now_seconds() - start) / (double)inner;
+
+        if (sample >= warmup)
+        {
+            p_samples[sample - warmup] = elapsed;
+        }
+    }
+
+    qsort(p_samples, reps, sizeof(double), compare_double);
+    double sum = 0.0;
+
+    for (size_t idx = 0U; idx < reps; ++idx)
+    {
+        sum += p_samples[idx];
+    }
+
+    double flops = 0.0;
+    double bytes = 0.0;
+    p_op->cost((double)p_ops->rows, (double)p_ops->cols, &flops, &bytes);
+
+    p_result->p_op     = p_op->p_name;
+    p_result->rows     = p_ops->rows;
+    p_result->cols     = p_ops->cols;
+    p_result->best_s   = p_samples[0];
+    p_result->median_s = (0U == (reps % 2U))
+                             ? 0.5
+                                   * (p_samples[(reps / 2U) - 1U]
+                                      + p_samples[reps / 2U])
+                             : p_samples[reps / 2U];
+    p_result->mean_s   = sum / (double)reps;
+    p_result->gflops   = flops / p_result->median_s * 1e-9;
+    p_result->gbps     = bytes / p_result->median_s * 1e-9;
+    free(p_samples);
+    return true;
+}
+
+static void
+bench_print (FILE                 *p_out,
+             bench_format_t        format,
+             const bench_result_t *p_result,
+             bool                  b_first)
+{
+    switch (format)
+    {
+        case BENCH_FORMAT_CSV:
+            if (NULL == p_result)
+            {
+                fprintf(p_out,
+                        "op,rows,cols,threads,best_s,median_s,mean_s,"
+                        "gflops,gbps\n");
+                return;
+            }
+
+            fprintf(p_out,
+                    "%s,%zu,%zu,%zu,%.9e,%.9e,%.9e,%.4f,%.4f\n",
+                    p_result->p_op,
+                    p_result->rows,
+                    p_result->cols,
+                    parallel_get_threads(),
+                    p_result->best_s,
+                    p_result->median_s,
+                    p_result->mean_s,
+                    p_result->gflops,
+                    p_result->gbps);
+            break;
+
+        case BENCH_FORMAT_JSON:
+            fprintf(p_out,
+                    "%s\n    {\"op\": \"%s\", \"rows\": %zu, \"cols\": %zu, "
+                    "\"best_s\": %.9e, \"median_s\": %.9e, "
+                    "\"mean_s\": %.9e, \"gflops\": %.4f, \"gbps\": %.4f}",
+                    b_first ? "" : ",",
+                    p_result->p_op,
+                    p_result->rows,
+                    p_result->cols,
+                    p_result->best_s,
+                    p_result->median_s,
+                    p_result->mean_s,
+                    p_result->gflops,
+                    p_result->gbps);
+            break;
+
+        default:
+            if (NULL == p_result)
+            {
+                fprintf(p_out,
+                        "%-10s %7s %7s %12s %12s %10s %10s\n",
+                        "op",
+                        "rows",
+                        "cols",
+                        "best (us)",
+                        "median (us)",
+                        "GFLOPS",
+                        "GB/s");
+                return;
+            }
+
+            fprintf(p_out,
+                    "%-10s %7zu %7zu %12.2f %12.2f %10.2f %10.2f\n",
+                    p_result->p_op,
+                    p_result->rows,
+                    p_result->cols,
+                    p_result->best_s * 1e6,
+                    p_result->median_s * 1e6,
+                    p_result->gflops,
+                    p_result->gbps);
+            break;
+    }
+}
+
+static double
+now_seconds (void)
+{
+    struct timespec ts = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+static int
+compare_double (const void *p_lhs, const void *p_rhs)
+{
+    double lhs = *(const double *)p_lhs;
+    double rhs = *(const double *)p_rhs;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static bool
+parse_list (const char *p_text, size_t *p_out, size_t *p_count)
+{
+    size_t      count = 0U;
+    const char *p_pos = p_text;
+
+    while ('\0' != *p_pos)
+    {
+        char  *p_end = NULL;
+        size_t value = (size_t)strtoull(p_pos, &p_end, 10);
+
+        if ((p_end == p_pos) || (0U == value) || (count >= BENCH_MAX_SIZES)
+            || ((',' != *p_end) && ('\0' != *p_end)))
+        {
+            return false;
+        }
+
+        p_out[count++] = value;
+        p_pos          = (',' == *p_end) ? p_end + 1 : p_end;
+    }
+
+    *p_count = count;
+    return 0U < count;
+}
+
+static void
+print_usage (const char *p_prog)
+{
+    fprintf(stderr,
+            "usage: %s [--ops LIST] [--sizes LIST] [--threads N] "
+            "[--reps N]\n"
+            "          [--warmup N] [--no-pin] [--format table|csv|json] "
+            "[--output PATH] [--help]\n",
+            p_prog);
+}
+
+/*** end of file ***/
@@ -0,0 +1,180 @@
+/**
+ * @file    bench_matrix_conv.c
+ * @brief   Direct and im2col + GEMM paths of the 3x3 convolution.
+ *
+ * Usage: bench_matrix_conv [size] [threads]
+ *
+ * Convolves a size x size image (default 512) with 1 to 256 "same" padded
+ * 3x3 kernels, once with each algorithm, and prints the best of several
+ * runs in milliseconds and GFLOPS, counting 18 flops per output pixel and
+ * kernel. MATRIX_CONV_AUTO uses the direct path up to
+ * MATRIX_CONV_DIRECT_MAX_KERNELS kernels; set it to the last count where
+ * direct still wins on the target. threads defaults to all CPUs.
+ *
+ * @author  heapbadger
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "matrix_conv.h"
+#include "parallel.h"
+
+#define BENCH_DEFAULT_SIZE  512U
+#define BENCH_MAX_KERNELS   256U
+#define BENCH_REPEATS       10
+
+/**
+ * @brief Monotonic wall clock in seconds.
+ */
+static double
+now_seconds (void)
+{
+    struct timespec ts = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+/**
+ * @brief Fill a matrix with pseudo-random values in [-1, 1).
+ */
+static void
+fill_random (matrix_t *p_matrix)
+{
+    unsigned int state = 12345U;
+
+    for (size_t row = 0U; row < p_matrix->rows; ++row)
+    {
+        for (size_t col = 0U; col < p_matrix->cols; ++col)
+        {
+            state = (state * 1103515245U) + 12345U;
+            p_matrix->p_data[(row * p_matrix->ld) + col]
+                = ((double)((state >> 8) % 2000U) / 1000.0) - 1.0;
+        }
+    }
+}
+
+/**
+ * @brief Best time of BENCH_REPEATS convolutions, or a negative value if
+ *        the convolution failed.
+ */
+static double
+bench_conv (const matrix_t             *p_image,
+            const matrix_t             *p_kernels,
+            const matrix_conv_params_t *p_params,
+            matrix_t                   *p_output)
+{
+    double best = 1e30;
+
+    for (int run = 0; run < BENCH_REPEATS; ++run)
+    {
+        double start = now_seconds();
+
+        if (MATRIX_SUCCESS
+            != matrix_conv2d(p_image, p_kernels, p_params, p_output))
+        {
+            return -1.0;
+        }
+
+        double elapsed = now_seconds() - start;
+        best           = (elapsed < best) ? elapsed : best;
+    }
+
+    return best;
+}
+
+int
+main (int argc, char **argv)
+{
+    size_t               size   = BENCH_DEFAULT_SIZE;
+    int                  status = EXIT_SUCCESS;
+    matrix_conv_params_t params = { .kernel_rows = 3,
+                                    .kernel_cols = 3,
+                                    .stride_rows = 1,
+                                    .stride_cols = 1,
+                                    .pad_rows    = 1,
+                                    .pad_cols    = 1 };
+
+    if (1 < argc)
+    {
+        size = (size_t)strtoull(argv[1], NULL, 10);
+    }
+
+    if (2 < argc)
+    {
+        parallel_set_threads((size_t)strtoull(argv[2], NULL, 10));
+    }
+
+    if (0U == size)
+    {
+        fprintf(stderr, "usage: %s [size] [threads]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    matrix_t *p_image = matrix_create(size, size);
+
+    if (NULL == p_image)
+    {
+        fprintf(stderr, "allocation failed\n");
+        return EXIT_FAILURE;
+    }
+
+    fill_random(p_image);
+    printf("%zu x %zu image, 3x3 same, %zu threads, best of %d runs\n",
+           size,
+           size,
+           parallel_get_threads(),
+           BENCH_REPEATS);
+    printf("%8s %12s %10s %12s %10s\n",
+           "kernels",
+           "direct (ms)",
+           "GFLOPS",
+           "im2col (ms)",
+           "GFLOPS");
+
+    for (size_t kernels = 1U; kernels <= BENCH_MAX_KERNELS; kernels *= 2U)
+    {
+        matrix_t *p_kernels = matrix_create(kernels, 9U);
+        matrix_t *p_output  = matrix_create(kernels, size * size);
+
+        if ((NULL == p_kernels) || (NULL == p_output))
+        {
+            fprintf(stderr, "allocation failed for %zu kernels\n", kernels);
+            matrix_destroy(p_kernels);
+            matrix_destroy(p_output);
+            status = EXIT_FAILURE;
+            break;
+        }
+
+        fill_random(p_kernels);
+        params.algorithm = MATRIX_CONV_DIRECT;
+        double direct    = bench_conv(p_image, p_kernels, &params, p_output);
+        params.algorithm = MATRIX_CONV_IM2COL;
+        double im2col    = bench_conv(p_image, p_kernels, &params, p_output);
+        double flops     = 18.0 * (double)kernels * (double)size * (double)size;
+
+        if ((direct < 0.0) || (im2col < 0.0))
+        {
+            fprintf(stderr, "convolution failed for %zu kernels\n", kernels);
+            status = EXIT_FAILURE;
+        }
+        else
+        {
+            printf("%8zu %12.3f %10.2f %12.3f %10.2f\n",
+                   kernels,
+                   direct * 1e3,
+                   flops / direct * 1e-9,
+                   im2col * 1e3,
+                   flops / im2col * 1e-9);
+        }
+
+        matrix_destroy(p_kernels);
+        matrix_destroy(p_output);
+    }
+
+    matrix_destroy(p_image);
+    parallel_set_threads(0U);
+    return status;
+}
+
+/*** end of file ***/
@@ -0,0 +1,158 @@
+/**
+ * @file    bench_matrix_fixed.c
+ * @brief   Throughput of fixed-size matrix kernels, one at a time and
+ *          batched.
+ *
+ * Usage: bench_matrix_fixed [count]
+ *
+ * For each order, multiplies and inverts `count` matrices with the
+ * single-matrix functions and with the batched SoA functions, and prints the
+ * best of several runs in millions of matrices per second. The default count
+ * keeps the working set in L2, where the kernels are compute bound; pass a
+ * few million to see the memory-bound rate instead.
+ *
+ * @author  heapbadger
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "matrix_fixed.h"
+
+#define BENCH_DEFAULT_COUNT 16384U
+#define BENCH_REPEATS       20
+
+/**
+ * @brief Time the single-matrix and batched functions of one order.
+ */
+#define BENCH_FIXED_DEFINE(N)                                                \
+    static void bench_matrix##N(size_t count)                               \
+    {                                                                       \
+        size_t              packs = (count + MATRIX_FIXED_LANES - 1U)       \
+                                   / MATRIX_FIXED_LANES;                    \
+        matrix##N##_t      *p_a   = malloc(count * sizeof(*p_a));           \
+        matrix##N##_t      *p_c   = malloc(count * sizeof(*p_c));           \
+        matrix##N##_pack_t *p_pa  = malloc(packs * sizeof(*p_pa));          \
+        matrix##N##_pack_t *p_pc  = malloc(packs * sizeof(*p_pc));          \
+        double              best[4];                                        \
+                                                                            \
+        if ((NULL == p_a) || (NULL == p_c) || (NULL == p_pa)                \
+            || (NULL == p_pc))                                              \
+        {                                                                   \
+            fprintf(stderr, "allocation failed\n");                         \
+            goto CLEANUP;                                                   \
+        }                                                                   \
+                                                                            \
+        fill_diagonally_dominant(p_a->m, count, (N));                       \
+        matrix##N##_pack(p_a, count, p_pa);                                 \
+                                                                            \
+        for (int idx = 0; idx < 4; ++idx)                                   \
+        {                                                                   \
+            best[idx] = 1e30;                                               \
+        }                                                                   \
+                                                                            \
+        for (int run = 0; run < BENCH_REPEATS; ++run)                       \
+        {                                                                   \
+            double start = now_seconds();                                   \
+                                                                            \
+            for (size_t idx = 0U; idx < count; ++idx)                       \
+            {                                                               \
+                matrix##N##_multiply(&p_a[idx], &p_a[idx], &p_c[idx]);      \
+            }                                                               \
+                                                                            \
+            double mid = now_seconds();                                     \
+            matrix##N##_multiply_batch(p_pa, p_pa, p_pc, packs);            \
+            double mid2 = now_seconds();                                    \
+                                                                            \
+            for (size_t idx = 0U; idx < count; ++idx)                       \
+            {                                                               \
+                matrix##N##_inverse(&p_a[idx], &p_c[idx]);                  \
+            }                                                               \
+                                                                            \
+            double mid3 = now_seconds();                                    \
+            matrix##N##_inverse_batch(p_pa, p_pc, packs);                   \
+            double end = now_seconds();                                     \
+                                                                            \
+            best[0] = (mid - start) < best[0] ? (mid - start) : best[0];    \
+            best[1] = (mid2 - mid) < best[1] ? (mid2 - mid) : best[1];      \
+            best[2] = (mid3 - mid2) < best[2] ? (mid3 - mid2) : best[2];    \
+            best[3] = (end - mid3) < best[3] ? (end - mid3) : best[3];      \
+        }                                                                   \
+                                                                            \
+        printf("%dx%d  multiply  %10.1f %10.1f   inverse  %10.1f %10.1f\n", \
+               (N),                                                         \
+               (N),                                                         \
+               (double)count / best[0] * 1e-6,                              \
+               (double)count / best[1] * 1e-6,                              \
+               (double)count / best[2] * 1e-6,                              \
+               (double)count / best[3] * 1e-6);                             \
+                                                                            \
+    CLEANUP:                                                                \
+        free(p_a);                                                          \
+        free(p_c);                                                          \
+        free(p_pa);                                                         \
+        free(p_pc);                                                         \
+    }
+
+/**
+ * @brief Monotonic wall clock in seconds.
+ */
+static double
+now_seconds (void)
+{
+    struct timespec ts = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec * 1e-9);
+}
+
+/**
+ * @brief Fill count consecutive order x order matrices with random values
+ *        and a dominant diagonal, so every inverse is well conditioned.
+ */
+static void
+fill_diagonally_dominant (double *p_values, size_t count, size_t order)
+{
+    unsigned int state = 12345U;
+
+    for (size_t idx = 0U; idx < count * order * order; ++idx)
+    {
+        state         = (state * 1103515245U) + 12345U;
+        p_values[idx] = ((double)((state >> 8) % 2000U) / 1000.0) - 1.0;
+
+        if (0U == ((idx % (order * order)) % (order + 1U)))
+        {
+            p_values[idx] += (double)order;
+        }
+    }
+}
+
+BENCH_FIXED_DEFINE(2)
+BENCH_FIXED_DEFINE(3)
+BENCH_FIXED_DEFINE(4)
+
+int
+main (int argc, char **argv)
+{
+    size_t count = BENCH_DEFAULT_COUNT;
+
+    if (1 < argc)
+    {
+        count = (size_t)strtoull(argv[1], NULL, 10);
+    }
+
+    if (0U == count)
+    {
+        fprintf(stderr, "usage: %s [count]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%zu matrices, best of %d runs, Mmat/s (single, batched)\n",
+           count,
+           BENCH_REPEATS);
+    bench_matrix2(count);
+    bench_matrix3(count);
+    bench_matrix4(count);
+    return EXIT_SUCCESS;
+}
+
+/*** end of file ***/
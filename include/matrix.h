@@ -9,29 +9,105 @@
 #define MATRIX_H
 
 #include <stdbool.h>
-#include "array.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Alignment in bytes of every buffer allocated by matrix_create: one cache
+ * line, which is also the width of the widest SIMD register in use.
+ */
+#define MATRIX_ALIGNMENT 64
+
+/**
+ * Row strides that are a multiple of this many bytes map a whole column onto
+ * a few L1 sets, and rows 4 KiB apart falsely alias in the load/store
+ * queues. matrix_create pads such strides by one cache line.
+ */
+#define MATRIX_ALIAS_STRIDE 512
+
+/**
+ * Side length (in elements) of the leaf tiles used by the cache-oblivious
+ * transpose. Two tiles of this size should fit comfortably in L1.
+ */
+#define MATRIX_TRANSPOSE_TILE 32
+
+/**
+ * GEMM cache blocking parameters. A MATRIX_GEMM_MC x MATRIX_GEMM_KC panel of
+ * A is packed to stay in L2, and a MATRIX_GEMM_KC x MATRIX_GEMM_NC panel of B
+ * is packed to stay in L3.
+ */
+#define MATRIX_GEMM_MC 128
+#define MATRIX_GEMM_KC 256
+#define MATRIX_GEMM_NC 4096
+
+/**
+ * Panel width of the blocked LU factorization. Columns are factored in
+ * panels of this width and the trailing matrix is updated with one GEMM per
+ * panel.
+ */
+#define MATRIX_LU_BLOCK 64
+
+/**
+ * Minimum number of multiply-adds per thread before GEMV is split across
+ * threads. Matrix-vector products are memory bound, so smaller problems
+ * finish before extra threads would add any bandwidth.
+ */
+#define MATRIX_GEMV_PARALLEL_MIN 65536
+
+/**
+ * Minimum number of multiply-adds per thread before a batched GEMM is split
+ * across threads. Below this, starting a thread costs more than the
+ * products it would take over.
+ */
+#define MATRIX_GEMM_PARALLEL_MIN 262144
 
 typedef enum
 {
-    MATRIX_SUCCESS            = 0,  /**< Operation succeeded. */
-    MATRIX_NOT_FOUND          = -1, /**< Element not found. */
-    MATRIX_OUT_OF_BOUNDS      = -2, /**< Index out of range. */
-    MATRIX_INVALID_ARGUMENT   = -3, /**< Invalid argument provided. */
-    MATRIX_ALLOCATION_FAILURE = -4, /**< Memory allocation failed. */
-    MATRIX_FAILURE            = -5, /**< Generic failure. */
+    MATRIX_SUCCESS               = 0,  /**< Operation succeeded. */
+    MATRIX_NOT_FOUND             = -1, /**< Element not found. */
+    MATRIX_OUT_OF_BOUNDS         = -2, /**< Index out of range. */
+    MATRIX_INVALID_ARGUMENT      = -3, /**< Invalid argument provided. */
+    MATRIX_ALLOCATION_FAILURE    = -4, /**< Memory allocation failed. */
+    MATRIX_FAILURE               = -5, /**< Generic failure. */
+    MATRIX_SINGULAR              = -6, /**< Matrix is singular. */
+    MATRIX_NOT_POSITIVE_DEFINITE = -7, /**< Matrix is not SPD. */
 } matrix_error_code_t;
 
+typedef enum
+{
+    MATRIX_OP_NONE      = 0, /**< Use the operand as stored. */
+    MATRIX_OP_TRANSPOSE = 1, /**< Use the transpose of the operand. */
+} matrix_op_t;
+
+typedef enum
+{
+    MATRIX_LAYOUT_ROW_MAJOR = 0, /**< ld is the distance between rows. */
+    MATRIX_LAYOUT_COL_MAJOR = 1, /**< ld is the distance between columns. */
+} matrix_layout_t;
+
+/**
+ * Dense row-major matrix. Element (row, col) lives at p_data[row * ld + col].
+ * Matrices from matrix_create own a MATRIX_ALIGNMENT aligned buffer of
+ * capacity >= rows * ld elements with ld == matrix_padded_ld(cols); views
+ * describe a block of another matrix's buffer and own nothing. Padding
+ * elements past cols are never read as matrix elements.
+ */
 typedef struct
 {
-    size_t   rows;
-    size_t   cols;
-    array_t *p_flat;
+    size_t  rows;
+    size_t  cols;
+    size_t  ld;       /**< Row stride in elements, at least cols. */
+    size_t  capacity; /**< Elements owned at p_data; 0 for views. */
+    bool    b_view;   /**< Storage is borrowed from another matrix. */
+    double *p_data;   /**< Row-major element storage. */
 } matrix_t;
 
 /**
  * @brief Create a new matrix with given dimensions.
  *
- * Allocates memory for a rows x cols matrix initialized to 0.0.
+ * Allocates memory for a rows x cols matrix initialized to 0.0. The buffer
+ * is MATRIX_ALIGNMENT aligned and rows are matrix_padded_ld(cols) elements
+ * apart, so rows of at least one cache line each start on a cache line.
  *
  * @param rows Number of rows (> 0).
  * @param cols Number of columns (> 0).
@@ -39,20 +115,105 @@ typedef struct
  */
 matrix_t *matrix_create(size_t rows, size_t cols);
 
+/**
+ * @brief Leading dimension matrix_create uses for a given column count.
+ *
+ * Rows narrower than a cache line are packed, since padding them would
+ * multiply the footprint without aligning anything useful. Wider rows are
+ * rounded up to a whole number of cache lines, plus one more line when the
+ * stride would be a multiple of MATRIX_ALIAS_STRIDE bytes. The stride is
+ * then an odd number of cache lines, so walking down a column touches every
+ * L1 set instead of a handful.
+ *
+ * @param cols Number of columns.
+ * @return Row stride in elements, at least cols.
+ */
+size_t matrix_padded_ld(size_t cols);
+
 /**
  * @brief Destroy a matrix and free all associated memory.
  *
+ * Views do not own their storage, so destroying a view is a no-op.
+ *
  * @param p_matrix Pointer to matrix to destroy (NULL safe).
  */
 void matrix_destroy(matrix_t *p_matrix);
 
 /**
- * @brief Deletes a single element using the registered delete function.
+ * @brief Describe a rectangular block of a matrix without copying it.
+ *
+ * The view shares storage with p_matrix: writes through either are visible
+ * in both. It is filled into caller storage, stays valid only as long as
+ * the parent buffer, and can be passed to every matrix_* function that
+ * does not change dimensions. Views of views are allowed.
+ *
+ * @param p_matrix Pointer to the parent matrix (or view).
+ * @param row First row of the block.
+ * @param col First column of the block.
+ * @param rows Number of rows in the block (> 0).
+ * @param cols Number of columns in the block (> 0).
+ * @param p_view Output view.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_OUT_OF_BOUNDS if the block does
+ *         not fit in p_matrix, error code on failure.
+ */
+matrix_error_code_t matrix_view(const matrix_t *p_matrix,
+                                size_t          row,
+                                size_t          col,
+                                size_t          rows,
+                                size_t          cols,
+                                matrix_t       *p_view);
+
+/**
+ * @brief Describe every row_step-th row of a block without copying it.
  *
- * @param p_matrix Pointer to the matrix.
- * @param p_value Pointer to the element to delete.
+ * Row i of the view is row (row + i * row_step) of p_matrix. Columns stay
+ * contiguous so the view works with every kernel.
+ *
+ * @param p_matrix Pointer to the parent matrix (or view).
+ * @param row First row of the block.
+ * @param col First column of the block.
+ * @param rows Number of rows in the view (> 0).
+ * @param cols Number of columns in the view (> 0).
+ * @param row_step Distance between consecutive selected rows (> 0).
+ * @param p_view Output view.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_OUT_OF_BOUNDS if the block does
+ *         not fit in p_matrix, error code on failure.
+ */
+matrix_error_code_t matrix_view_strided(const matrix_t *p_matrix,
+                                        size_t          row,
+                                        size_t          col,
+                                        size_t          rows,
+                                        size_t          cols,
+                                        size_t          row_step,
+                                        matrix_t       *p_view);
+
+/**
+ * @brief Describe one row of a matrix as a 1 x cols view.
+ *
+ * @param p_matrix Pointer to the parent matrix (or view).
+ * @param row Row index (0-based).
+ * @param p_view Output view.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
  */
-void matrix_del_ele(matrix_t *p_matrix, void *p_data);
+matrix_error_code_t matrix_row_view(const matrix_t *p_matrix,
+                                    size_t          row,
+                                    matrix_t       *p_view);
+
+/**
+ * @brief Describe one column of a matrix as a rows x 1 view.
+ *
+ * @param p_matrix Pointer to the parent matrix (or view).
+ * @param col Column index (0-based).
+ * @param p_view Output view.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_column_view(const matrix_t *p_matrix,
+                                       size_t          col,
+                                       matrix_t       *p_view);
 
 /**
  * @brief Fill the entire matrix with a given value. Overwrites any
@@ -95,12 +256,54 @@ matrix_error_code_t matrix_set(matrix_t *p_matrix,
 /**
  * @brief Check if two matrices are equal in size and contents.
  *
+ * Equivalent to matrix_is_close with both tolerances 0.
+ *
  * @param p_matrix_a Pointer to first matrix.
  * @param p_matrix_b Pointer to second matrix.
  * @return true if equal, false otherwise.
  */
 bool matrix_is_equal(const matrix_t *p_matrix_a, const matrix_t *p_matrix_b);
 
+/**
+ * @brief Check if two matrices are equal in size and close in contents.
+ *
+ * Elements a and b are close when a == b or
+ * |a - b| <= atol + rtol * max(|a|, |b|). The test is symmetric in a and b,
+ * NaN is close to nothing, and an infinity is only close to itself. With
+ * AVX, four elements are compared per step and the scan stops at the first
+ * step that finds a difference.
+ *
+ * @param p_matrix_a Pointer to first matrix.
+ * @param p_matrix_b Pointer to second matrix.
+ * @param rtol Relative tolerance (>= 0).
+ * @param atol Absolute tolerance (>= 0).
+ * @return true if close, false otherwise or if a tolerance is negative or
+ *         NaN.
+ */
+bool matrix_is_close(const matrix_t *p_matrix_a,
+                     const matrix_t *p_matrix_b,
+                     double          rtol,
+                     double          atol);
+
+/**
+ * @brief Check if two matrices are equal in size and contents to within a
+ * number of units in the last place.
+ *
+ * The distance of two elements is the number of representable doubles
+ * between them, so +0.0 and -0.0 are 0 apart, the smallest subnormals of
+ * either sign are 2 apart, and the largest double is 1 away from infinity.
+ * NaN is close to nothing. With AVX2 the comparison runs on four elements
+ * per step and stops at the first step that finds a difference.
+ *
+ * @param p_matrix_a Pointer to first matrix.
+ * @param p_matrix_b Pointer to second matrix.
+ * @param max_ulps Largest allowed distance.
+ * @return true if every element pair is within max_ulps, false otherwise.
+ */
+bool matrix_is_close_ulps(const matrix_t *p_matrix_a,
+                          const matrix_t *p_matrix_b,
+                          uint64_t        max_ulps);
+
 /**
  * @brief Print the matrix to stdout in a readable format.
  *
@@ -130,6 +333,8 @@ matrix_error_code_t matrix_column_size(const matrix_t *p_matrix,
 /**
  * @brief Find the first occurrence of a value in the matrix.
  *
+ * Equivalent to matrix_find_close with both tolerances 0.
+ *
  * @param p_matrix Pointer to matrix.
  * @param key Value to find.
  * @param p_row Output parameter to hold the found row index.
@@ -142,18 +347,96 @@ matrix_error_code_t matrix_find(const matrix_t *p_matrix,
                                 size_t         *p_row,
                                 size_t         *p_col);
 
+/**
+ * @brief Find the first element close to a value, in row-major order.
+ *
+ * Closeness is defined as for matrix_is_close.
+ *
+ * @param p_matrix Pointer to matrix.
+ * @param key Value to find.
+ * @param rtol Relative tolerance (>= 0).
+ * @param atol Absolute tolerance (>= 0).
+ * @param p_row Output parameter to hold the found row index.
+ * @param p_col Output parameter to hold the found column index.
+ *
+ * @return MATRIX_SUCCESS if found, MATRIX_NOT_FOUND if no element is close,
+ *         MATRIX_INVALID_ARGUMENT if a tolerance is negative or NaN.
+ */
+matrix_error_code_t matrix_find_close(const matrix_t *p_matrix,
+                                      double          key,
+                                      double          rtol,
+                                      double          atol,
+                                      size_t         *p_row,
+                                      size_t         *p_col);
+
 /**
  * @brief Create a deep copy of a matrix.
  *
+ * Cloning a view yields an ordinary owning matrix with the view's contents.
+ *
  * @param p_ori Pointer to original matrix.
  * @return Pointer to cloned matrix, or NULL on failure.
  */
 matrix_t *matrix_clone(const matrix_t *p_ori);
 
+/**
+ * @brief Copy a matrix into an existing one, reshaping it if necessary.
+ *
+ * Unlike matrix_clone this allocates nothing when p_dst already has the
+ * dimensions of p_src, or when its buffer has the capacity for them, so a
+ * pooled scratch matrix can be reused across problems of varying size. An
+ * owned p_dst that is too small is reallocated. A view must already have
+ * the dimensions of p_src.
+ *
+ * @param p_dst Pointer to the destination matrix.
+ * @param p_src Pointer to the source matrix or view. Must not overlap p_dst
+ *              unless it is p_dst itself.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_copy_into(matrix_t *p_dst, const matrix_t *p_src);
+
+/**
+ * @brief Change the dimensions of a matrix, keeping the element count.
+ *
+ * Elements keep their row-major order. When the rows are contiguous
+ * (ld == cols, or a single row) only the dimensions change and no data is
+ * moved; this also works on such views. The rows of an owned padded matrix
+ * are moved in place to the stride of the new shape.
+ *
+ * @param p_matrix Pointer to the matrix.
+ * @param rows New number of rows (> 0).
+ * @param cols New number of columns (> 0), with rows * cols unchanged.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_INVALID_ARGUMENT if the element
+ *         count differs or a view is not contiguous.
+ */
+matrix_error_code_t matrix_reshape(matrix_t *p_matrix,
+                                   size_t    rows,
+                                   size_t    cols);
+
+/**
+ * @brief Change the dimensions of an owned matrix, keeping its contents.
+ *
+ * The top-left block common to both shapes is preserved and new elements
+ * are 0.0. The buffer is only reallocated when the new shape needs more
+ * than its capacity, and shrinking never releases memory, so a matrix
+ * resized up and down settles at its largest footprint.
+ *
+ * @param p_matrix Pointer to the owned matrix.
+ * @param rows New number of rows (> 0).
+ * @param cols New number of columns (> 0).
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_resize(matrix_t *p_matrix, size_t rows, size_t cols);
+
 /**
  * @brief Add two matrices element-wise.
  *
- * Both matrices must have the same dimensions.
+ * Both matrices must have the same dimensions. p_result may be either input
+ * (`A += B`), which runs in place. A view that only partially overlaps an
+ * input is computed through a temporary.
  *
  * @param p_matrix_a Pointer to first matrix.
  * @param p_matrix_b Pointer to second matrix.
@@ -169,7 +452,7 @@ matrix_error_code_t matrix_add(const matrix_t *p_matrix_a,
 /**
  * @brief Subtract one matrix from another element-wise.
  *
- * Both matrices must have the same dimensions.
+ * Both matrices must have the same dimensions. Aliasing follows matrix_add.
  *
  * @param p_matrix_a Pointer to first matrix.
  * @param p_matrix_b Pointer to second matrix.
@@ -186,7 +469,9 @@ matrix_error_code_t matrix_subtract(const matrix_t *p_matrix_a,
  * @brief Multiply two matrices (matrix multiplication).
  *
  * The number of columns of the first matrix must equal the number of rows
- * of the second matrix.
+ * of the second matrix. p_result may alias or overlap either input
+ * (`A = A * B`); the product is then formed in internal workspace and copied
+ * back, costing one extra result-sized buffer.
  *
  * @param p_matrix_a Pointer to first matrix.
  * @param p_matrix_b Pointer to second matrix.
@@ -199,11 +484,278 @@ matrix_error_code_t matrix_multiply(const matrix_t *p_matrix_a,
                                     const matrix_t *p_matrix_b,
                                     matrix_t       *p_result);
 
+/**
+ * @brief Multiply two matrices, either of which may be transposed.
+ *
+ * Computes op_a(A) * op_b(B), for example A^T * B or A * B^T, without
+ * forming the transposes: matrix_gemm_ex reads the operands transposed
+ * while packing them. Aliasing is handled as in matrix_multiply.
+ *
+ * @param p_matrix_a Pointer to A.
+ * @param op_a Operation applied to A.
+ * @param p_matrix_b Pointer to B.
+ * @param op_b Operation applied to B.
+ * @param p_result Pointer to the output, rows of op_a(A) by columns of
+ *                 op_b(B).
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_multiply_ex(const matrix_t *p_matrix_a,
+                                       matrix_op_t     op_a,
+                                       const matrix_t *p_matrix_b,
+                                       matrix_op_t     op_b,
+                                       matrix_t       *p_result);
+
+/**
+ * @brief Raise a square matrix to a non-negative integer power.
+ *
+ * Uses binary exponentiation, so A^k costs about log2(k) squarings plus one
+ * product per set bit of k, each a single GEMM. Intermediate powers
+ * alternate between p_result and one internal workspace matrix, which is
+ * allocated once per call; the order is chosen so the last product lands in
+ * p_result without a final copy. p_result may alias p_matrix, at the cost of
+ * a second workspace matrix holding A.
+ *
+ * @param p_matrix Pointer to the square matrix A.
+ * @param exponent Power k; A^0 is the identity.
+ * @param p_result Pointer to the output, same dimensions as A.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_pow(const matrix_t *p_matrix,
+                               size_t          exponent,
+                               matrix_t       *p_result);
+
+/**
+ * @brief Multiply a chain of matrices in the cheapest order.
+ *
+ * The cost of a chain product depends heavily on its parenthesization:
+ * (10x1000 * 1000x10) * 10x1000 takes 0.2 Mflop where
+ * 10x1000 * (1000x10 * 10x1000) takes 20 Mflop. The optimal order is found
+ * by the classic O(count^3) dynamic program over multiply-add counts and
+ * then executed with matrix_gemm. Intermediate products share one workspace,
+ * sized for the deepest point of the evaluation and allocated once.
+ *
+ * @param pp_matrices Array of count matrix pointers; the columns of each
+ *                    must equal the rows of the next.
+ * @param count Number of matrices (> 0).
+ * @param p_result Pointer to the output, rows of the first matrix by columns
+ *                 of the last. May overlap any input, at the cost of one
+ *                 result-sized buffer.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_chain_multiply(const matrix_t *const *pp_matrices,
+                                          size_t                 count,
+                                          matrix_t              *p_result);
+
+/**
+ * @brief General matrix multiply on raw row-major buffers.
+ *
+ * Computes C = alpha * A * B + beta * C where A is m x k, B is k x n and C is
+ * m x n. Operands are packed into cache-sized panels and multiplied with a
+ * register-blocked micro-kernel. When beta is 0.0, C is not read. Equivalent
+ * to matrix_gemm_ex with MATRIX_LAYOUT_ROW_MAJOR and no transposes.
+ *
+ * @param m Number of rows of A and C.
+ * @param n Number of columns of B and C.
+ * @param k Number of columns of A and rows of B.
+ * @param alpha Scale applied to A * B.
+ * @param p_a Pointer to the first element of A.
+ * @param lda Leading dimension (row stride) of A, at least k.
+ * @param p_b Pointer to the first element of B.
+ * @param ldb Leading dimension (row stride) of B, at least n.
+ * @param beta Scale applied to C before accumulation.
+ * @param p_c Pointer to the first element of C. Must not overlap A or B.
+ * @param ldc Leading dimension (row stride) of C, at least n.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_gemm(size_t        m,
+                                size_t        n,
+                                size_t        k,
+                                double        alpha,
+                                const double *p_a,
+                                size_t        lda,
+                                const double *p_b,
+                                size_t        ldb,
+                                double        beta,
+                                double       *p_c,
+                                size_t        ldc);
+
+/**
+ * @brief General matrix multiply with transposed operands and either
+ * storage order.
+ *
+ * Computes C = alpha * op_a(A) * op_b(B) + beta * C where op_a(A) is m x k,
+ * op_b(B) is k x n and C is m x n. Transposes cost nothing extra: the
+ * packing stage reads each operand with its row and column steps swapped,
+ * and the micro-kernel is the same as for matrix_gemm. A column-major
+ * product is computed as the row-major product C^T = op_b(B)^T * op_a(A)^T
+ * of the same buffers.
+ *
+ * @param layout Storage order of A, B and C.
+ * @param op_a Operation applied to A.
+ * @param op_b Operation applied to B.
+ * @param m Number of rows of op_a(A) and C.
+ * @param n Number of columns of op_b(B) and C.
+ * @param k Number of columns of op_a(A) and rows of op_b(B).
+ * @param alpha Scale applied to op_a(A) * op_b(B).
+ * @param p_a Pointer to the first element of A as stored.
+ * @param lda Leading dimension of A, at least its stored row length (or
+ *            column length for MATRIX_LAYOUT_COL_MAJOR).
+ * @param p_b Pointer to the first element of B as stored.
+ * @param ldb Leading dimension of B, likewise.
+ * @param beta Scale applied to C before accumulation.
+ * @param p_c Pointer to the first element of C. Must not overlap A or B.
+ * @param ldc Leading dimension of C, at least n (m if column-major).
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_gemm_ex(matrix_layout_t layout,
+                                   matrix_op_t     op_a,
+                                   matrix_op_t     op_b,
+                                   size_t          m,
+                                   size_t          n,
+                                   size_t          k,
+                                   double          alpha,
+                                   const double   *p_a,
+                                   size_t          lda,
+                                   const double   *p_b,
+                                   size_t          ldb,
+                                   double          beta,
+                                   double         *p_c,
+                                   size_t          ldc);
+
+/**
+ * @brief Strided batched GEMM over many products of the same shape.
+ *
+ * Computes C[i] = alpha * op_a(A[i]) * op_b(B[i]) + beta * C[i] for
+ * i < batch_count, where A[i] starts at p_a + i * stride_a and likewise for
+ * B and C. Arguments are validated once and pack buffers are allocated once
+ * per thread rather than once per product. When the batch has at least as
+ * many products as there are threads, whole products are spread across the
+ * threads; otherwise each product is also split into MATRIX_GEMM_MC row
+ * bands of C, so a few large products still use every thread. Batches with
+ * fewer than MATRIX_GEMM_PARALLEL_MIN multiply-adds per thread run on the
+ * calling thread. Results do not depend on the thread count.
+ *
+ * @param layout Storage order of every A, B and C.
+ * @param op_a Operation applied to each A.
+ * @param op_b Operation applied to each B.
+ * @param m Number of rows of op_a(A[i]) and C[i].
+ * @param n Number of columns of op_b(B[i]) and C[i].
+ * @param k Number of columns of op_a(A[i]) and rows of op_b(B[i]).
+ * @param alpha Scale applied to each product.
+ * @param p_a Pointer to the first element of A[0].
+ * @param lda Leading dimension of each A, as for matrix_gemm_ex.
+ * @param stride_a Distance in elements between A[i] and A[i + 1]. May be 0
+ *                 to use one A for the whole batch.
+ * @param p_b Pointer to the first element of B[0].
+ * @param ldb Leading dimension of each B, as for matrix_gemm_ex.
+ * @param stride_b Distance in elements between B[i] and B[i + 1]. May be 0.
+ * @param beta Scale applied to each C[i] before accumulation.
+ * @param p_c Pointer to the first element of C[0]. Must not overlap any A
+ *            or B.
+ * @param ldc Leading dimension of each C, at least n (m if column-major).
+ * @param stride_c Distance in elements between C[i] and C[i + 1]. Must be
+ *                 large enough that the C[i] do not overlap.
+ * @param batch_count Number of products.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_gemm_batched_strided(matrix_layout_t layout,
+                                                matrix_op_t     op_a,
+                                                matrix_op_t     op_b,
+                                                size_t          m,
+                                                size_t          n,
+                                                size_t          k,
+                                                double          alpha,
+                                                const double   *p_a,
+                                                size_t          lda,
+                                                size_t          stride_a,
+                                                const double   *p_b,
+                                                size_t          ldb,
+                                                size_t          stride_b,
+                                                double          beta,
+                                                double         *p_c,
+                                                size_t          ldc,
+                                                size_t          stride_c,
+                                                size_t          batch_count);
+
+/**
+ * @brief Matrix-vector multiply, y = alpha * A * x + beta * y.
+ *
+ * A is streamed exactly once. Four rows are reduced together against the
+ * same slice of x with independent SIMD accumulators, and tall matrices are
+ * split into row bands processed by parallel_for. When beta is 0.0, y is not
+ * read.
+ *
+ * @param p_matrix Pointer to A (m x n).
+ * @param alpha Scale applied to A * x.
+ * @param p_x Pointer to x, n contiguous elements.
+ * @param beta Scale applied to y before accumulation.
+ * @param p_y Pointer to y, m contiguous elements. Must not overlap A or x.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_gemv(const matrix_t *p_matrix,
+                                double          alpha,
+                                const double   *p_x,
+                                double          beta,
+                                double         *p_y);
+
+/**
+ * @brief Transposed matrix-vector multiply, y = alpha * A^T * x + beta * y.
+ *
+ * A is streamed once in row order, adding four scaled rows into y per pass,
+ * so no transpose is formed. Tall matrices are split into row bands whose
+ * partial sums are reduced into y at the end. When beta is 0.0, y is not
+ * read.
+ *
+ * @param p_matrix Pointer to A (m x n).
+ * @param alpha Scale applied to A^T * x.
+ * @param p_x Pointer to x, m contiguous elements.
+ * @param beta Scale applied to y before accumulation.
+ * @param p_y Pointer to y, n contiguous elements. Must not overlap A or x.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_gemv_transposed(const matrix_t *p_matrix,
+                                           double          alpha,
+                                           const double   *p_x,
+                                           double          beta,
+                                           double         *p_y);
+
+/**
+ * @brief Multiply one matrix against a batch of vectors,
+ * Y[v] = alpha * A * X[v] + beta * Y[v].
+ *
+ * Each row of A is loaded once and reduced against four vectors at a time,
+ * so the batch costs one pass over A instead of one per vector. This is
+ * Y = alpha * X * A^T + beta * Y without transposing A. When beta is 0.0,
+ * Y is not read.
+ *
+ * @param p_matrix Pointer to A (m x n).
+ * @param alpha Scale applied to the products.
+ * @param p_x Pointer to the input vectors, one per row (count x n).
+ * @param beta Scale applied to Y before accumulation.
+ * @param p_y Pointer to the output vectors, one per row (count x m). Must
+ *            not overlap A or X.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_gemv_batched(const matrix_t *p_matrix,
+                                        double          alpha,
+                                        const matrix_t *p_x,
+                                        double          beta,
+                                        matrix_t       *p_y);
+
 /**
  * @brief Multiply all elements of a matrix by a scalar value.
  *
- * The number of columns of the first matrix must equal the number of rows
- * of the second matrix.
+ * p_result may be the input (`A *= s`), which runs in place. Aliasing
+ * follows matrix_add.
  *
  * @param p_matrix Pointer to input matrix.
  * @param scalar Scalar value to multiply.
@@ -219,22 +771,95 @@ matrix_error_code_t matrix_scalar_multiply(const matrix_t *p_matrix,
 /**
  * @brief Compute the transpose of a matrix.
  *
- * The transpose swaps rows and columns of the input matrix.
+ * The transpose swaps rows and columns of the input matrix. The copy is done
+ * by recursively halving the larger dimension until both fit in a
+ * MATRIX_TRANSPOSE_TILE square, which keeps source and destination tiles
+ * cache resident regardless of the matrix size. Tiles are transposed in
+ * 4x4 register blocks when SIMD is available.
+ *
+ * Passing the same matrix twice (`A = A^T`) transposes it in place. Square
+ * matrices swap mirrored tiles without extra memory. Non-square matrices
+ * must own their buffer; they are transposed into internal workspace,
+ * copied back with the padded stride of the new shape when it fits in the
+ * buffer (packed otherwise), and their dimensions swapped. This is faster than
+ * matrix_transpose_inplace at the cost of one matrix-sized buffer. A result
+ * view that overlaps the input is also filled through workspace.
  *
  * @param p_matrix Pointer to input matrix.
  * @param p_result Pointer to matrix where transpose will be stored.
  *                 Must be pre-allocated with dimensions
- *                 p_matrix->cols x p_matrix->rows.
+ *                 p_matrix->cols x p_matrix->rows, or be p_matrix.
  *
  * @return MATRIX_SUCCESS if found, error code on failure.
  */
 matrix_error_code_t matrix_transpose(const matrix_t *p_matrix,
                                      matrix_t       *p_result);
 
+/**
+ * @brief Transpose a matrix in place, swapping its dimensions.
+ *
+ * Square matrices are transposed by swapping mirrored tiles. Non-square
+ * matrices are permuted by following the cycles of the transpose
+ * permutation, which needs only a one-bit-per-element visited map instead
+ * of a second copy of the matrix. Padded rows are compacted first and
+ * re-padded afterwards when the new shape fits in the buffer. Non-square
+ * views cannot change shape and are rejected.
+ *
+ * @param p_matrix Pointer to matrix to transpose.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_transpose_inplace(matrix_t *p_matrix);
+
+/**
+ * @brief Compute the LU factorization of a square matrix with partial
+ * pivoting, P * A = L * U.
+ *
+ * Uses a right-looking blocked algorithm: each MATRIX_LU_BLOCK wide panel is
+ * factored in place and the trailing submatrix is updated with matrix_gemm.
+ * L (unit diagonal, not stored) and U are packed into p_lu.
+ *
+ * @param p_matrix Pointer to input square matrix.
+ * @param p_lu Pointer to matrix receiving the packed factors. Must be
+ *             pre-allocated with the same dimensions as input. May be the
+ *             same matrix as p_matrix.
+ * @param p_pivots Output array of n pivot rows; row k was swapped with row
+ *                 p_pivots[k] at step k.
+ * @param p_sign Optional output for the permutation parity (+1 or -1).
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_SINGULAR if a zero pivot was met
+ *         (the factors are still complete), error code on failure.
+ */
+matrix_error_code_t matrix_lu(const matrix_t *p_matrix,
+                              matrix_t       *p_lu,
+                              size_t         *p_pivots,
+                              int            *p_sign);
+
+/**
+ * @brief Solve A * X = B using factors computed by matrix_lu.
+ *
+ * Forward and back substitution are blocked, with off-diagonal updates done
+ * by matrix_gemm, so a single factorization serves any number of right-hand
+ * sides efficiently.
+ *
+ * @param p_lu Pointer to the packed LU factors.
+ * @param p_pivots Pivot array produced by matrix_lu.
+ * @param p_b Pointer to the right-hand side matrix (n x nrhs).
+ * @param p_x Pointer to the solution matrix (n x nrhs). May be p_b.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_SINGULAR if U has a zero on the
+ *         diagonal, error code on failure.
+ */
+matrix_error_code_t matrix_lu_solve(const matrix_t *p_lu,
+                                    const size_t   *p_pivots,
+                                    const matrix_t *p_b,
+                                    matrix_t       *p_x);
+
 /**
  * @brief Calculate the determinant of a square matrix.
  *
- * Only defined for square matrices.
+ * Only defined for square matrices. Computed from the LU factorization, so a
+ * singular matrix yields 0.0.
  *
  * @param p_matrix Pointer to input square matrix.
  * @param p_result Pointer to double where determinant will be stored.
@@ -244,16 +869,34 @@ matrix_error_code_t matrix_transpose(const matrix_t *p_matrix,
 matrix_error_code_t matrix_determinant(const matrix_t *p_matrix,
                                        double         *p_result);
 
+/**
+ * @brief Calculate the logarithm of the absolute determinant and its sign.
+ *
+ * Sums log|u_ii| over the LU factors, which does not overflow or underflow
+ * for large matrices where the determinant itself would.
+ *
+ * @param p_matrix Pointer to input square matrix.
+ * @param p_log_abs Output for log|det(A)|, -INFINITY when singular.
+ * @param p_sign Output for the sign of det(A): +1, -1, or 0 when singular.
+ *
+ * @return MATRIX_SUCCESS if found, error code on failure.
+ */
+matrix_error_code_t matrix_log_determinant(const matrix_t *p_matrix,
+                                           double         *p_log_abs,
+                                           int            *p_sign);
+
 /**
  * @brief Compute the inverse of a square, invertible matrix.
  *
- * Only defined for square matrices with non-zero determinant.
+ * Only defined for square matrices with non-zero determinant. Computed by
+ * solving A * X = I with the LU factors.
  *
  * @param p_matrix Pointer to input square matrix.
  * @param p_result Pointer to matrix where inverse will be stored.
  *                 Must be pre-allocated and of same dimensions as input.
  *
- * @return MATRIX_SUCCESS if found, error code on failure.
+ * @return MATRIX_SUCCESS on success, MATRIX_SINGULAR if the matrix is not
+ *         invertible, error code on failure.
  */
 matrix_error_code_t matrix_inverse(const matrix_t *p_matrix,
                                    matrix_t       *p_result);
@@ -0,0 +1,120 @@
+/**
+ * @file    matrix_conv.h
+ * @brief   Header file for `matrix_conv.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef MATRIX_CONV_H
+#define MATRIX_CONV_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+/**
+ * Number of elements in one im2col panel. The panel holds one column of
+ * kernel_rows * kernel_cols input samples per output pixel, so its width
+ * shrinks as kernels grow and it stays L2 resident while matrix_gemm
+ * consumes it.
+ */
+#define MATRIX_CONV_PANEL 32768
+
+/**
+ * Largest number of 3x3 kernels for which MATRIX_CONV_AUTO uses the direct
+ * path. The direct path reads the input rows once per kernel, while im2col
+ * gathers them once for all kernels, but with a single input channel the
+ * GEMM's inner dimension is only the nine kernel taps and it runs far from
+ * peak. Direct measured faster at every count bench_matrix_conv covers, so
+ * this is the largest one; retune with bench_matrix_conv.
+ */
+#define MATRIX_CONV_DIRECT_MAX_KERNELS 256
+
+/**
+ * Minimum number of multiply-adds per thread before a convolution is split
+ * across threads.
+ */
+#define MATRIX_CONV_PARALLEL_MIN 65536
+
+typedef enum
+{
+    MATRIX_CONV_AUTO   = 0, /**< Direct for few 3x3 kernels, else im2col. */
+    MATRIX_CONV_IM2COL = 1, /**< im2col + blocked GEMM, any kernel size. */
+    MATRIX_CONV_DIRECT = 2, /**< Direct, 3x3 kernels only. */
+} matrix_conv_algorithm_t;
+
+/**
+ * Shape of a 2D convolution. Rows and columns of the input are padded with
+ * pad_rows and pad_cols zeros on both sides, and the kernel is moved
+ * stride_rows and stride_cols elements at a time.
+ */
+typedef struct
+{
+    size_t                  kernel_rows; /**< Kernel height (> 0). */
+    size_t                  kernel_cols; /**< Kernel width (> 0). */
+    size_t                  stride_rows; /**< Vertical step (> 0). */
+    size_t                  stride_cols; /**< Horizontal step (> 0). */
+    size_t                  pad_rows;    /**< Zero rows above and below. */
+    size_t                  pad_cols;    /**< Zero columns left and right. */
+    matrix_conv_algorithm_t algorithm;
+} matrix_conv_params_t;
+
+/**
+ * @brief Compute the output size of a convolution.
+ *
+ * out_rows = (rows + 2 * pad_rows - kernel_rows) / stride_rows + 1, and
+ * likewise for columns.
+ *
+ * @param rows Input rows.
+ * @param cols Input columns.
+ * @param p_params Pointer to the convolution shape.
+ * @param p_out_rows Output parameter for the output rows.
+ * @param p_out_cols Output parameter for the output columns.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_INVALID_ARGUMENT if a size or
+ *         stride is 0 or the kernel is larger than the padded input.
+ */
+matrix_error_code_t matrix_conv2d_size(
+    size_t                      rows,
+    size_t                      cols,
+    const matrix_conv_params_t *p_params,
+    size_t                     *p_out_rows,
+    size_t                     *p_out_cols);
+
+/**
+ * @brief 2D convolution of one input with several kernels.
+ *
+ * As is usual for feature extraction, kernels are not flipped, so this is
+ * a cross-correlation: out(y, x) = sum over (i, j) of
+ * kernel(i, j) * in(y * stride_rows + i - pad_rows,
+ *                   x * stride_cols + j - pad_cols).
+ *
+ * Each kernel is stored as one row of p_kernels, flattened row-major, and
+ * each output map as the matching row of p_output. A row of p_output can be
+ * viewed as an out_rows x out_cols matrix with matrix_view followed by
+ * matrix_reshape.
+ *
+ * MATRIX_CONV_IM2COL gathers the input samples under each output pixel into
+ * panels of MATRIX_CONV_PANEL elements and multiplies all kernels against
+ * each panel with matrix_gemm. MATRIX_CONV_DIRECT handles 3x3 kernels
+ * without the gather, computing a row of output pixels at a time with
+ * vector loads. MATRIX_CONV_AUTO picks the direct path for at most
+ * MATRIX_CONV_DIRECT_MAX_KERNELS 3x3 kernels. Both paths split work across
+ * threads with parallel_for.
+ *
+ * @param p_input Pointer to the input matrix or view.
+ * @param p_kernels Pointer to the kernels, one per row, each
+ *                  kernel_rows * kernel_cols wide.
+ * @param p_params Pointer to the convolution shape.
+ * @param p_output Pointer to the output, one row per kernel, each
+ *                 out_rows * out_cols wide. Must not overlap the inputs.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_conv2d(const matrix_t             *p_input,
+                                  const matrix_t             *p_kernels,
+                                  const matrix_conv_params_t *p_params,
+                                  matrix_t                   *p_output);
+
+#endif // MATRIX_CONV_H
+
+/*** end of file ***/
@@ -0,0 +1,129 @@
+/**
+ * @file    matrix_expr.h
+ * @brief   Header file for `matrix_expr.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef MATRIX_EXPR_H
+#define MATRIX_EXPR_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+typedef enum
+{
+    MATRIX_EXPR_LEAF     = 0, /**< Reference to an existing matrix. */
+    MATRIX_EXPR_SCALE    = 1, /**< scalar * left. */
+    MATRIX_EXPR_ADD      = 2, /**< left + right. */
+    MATRIX_EXPR_MULTIPLY = 3, /**< left * right (matrix product). */
+} matrix_expr_op_t;
+
+/**
+ * Node of a lazily evaluated matrix expression. Nodes own their children;
+ * leaves only reference their matrix, which must outlive evaluation. A node
+ * may be used as an operand only once, but the same matrix may appear in
+ * any number of leaves.
+ */
+typedef struct matrix_expr
+{
+    matrix_expr_op_t    op;
+    size_t              rows;
+    size_t              cols;
+    double              scalar;   /**< Factor of MATRIX_EXPR_SCALE. */
+    const matrix_t     *p_matrix; /**< Operand of MATRIX_EXPR_LEAF. */
+    struct matrix_expr *p_left;
+    struct matrix_expr *p_right;
+} matrix_expr_t;
+
+/**
+ * @brief Create an expression leaf referring to a matrix or view.
+ *
+ * @param p_matrix Pointer to the matrix. Not copied.
+ *
+ * @return Pointer to the new node, or NULL on failure.
+ */
+matrix_expr_t *matrix_expr_leaf(const matrix_t *p_matrix);
+
+/**
+ * @brief Create the expression scalar * p_expr.
+ *
+ * Takes ownership of p_expr, which is destroyed if creation fails.
+ *
+ * @param scalar Scale factor.
+ * @param p_expr Operand.
+ *
+ * @return Pointer to the new node, or NULL on failure.
+ */
+matrix_expr_t *matrix_expr_scale(double scalar, matrix_expr_t *p_expr);
+
+/**
+ * @brief Create the expression p_left + p_right.
+ *
+ * Takes ownership of both operands, which are destroyed if creation fails.
+ *
+ * @param p_left First operand.
+ * @param p_right Second operand, same dimensions as p_left.
+ *
+ * @return Pointer to the new node, or NULL on failure or size mismatch.
+ */
+matrix_expr_t *matrix_expr_add(matrix_expr_t *p_left, matrix_expr_t *p_right);
+
+/**
+ * @brief Create the expression p_left - p_right.
+ *
+ * Takes ownership of both operands, which are destroyed if creation fails.
+ *
+ * @param p_left First operand.
+ * @param p_right Second operand, same dimensions as p_left.
+ *
+ * @return Pointer to the new node, or NULL on failure or size mismatch.
+ */
+matrix_expr_t *matrix_expr_subtract(matrix_expr_t *p_left,
+                                    matrix_expr_t *p_right);
+
+/**
+ * @brief Create the matrix product p_left * p_right.
+ *
+ * Takes ownership of both operands, which are destroyed if creation fails.
+ *
+ * @param p_left First operand (m x k).
+ * @param p_right Second operand (k x n).
+ *
+ * @return Pointer to the new node, or NULL on failure or size mismatch.
+ */
+matrix_expr_t *matrix_expr_multiply(matrix_expr_t *p_left,
+                                    matrix_expr_t *p_right);
+
+/**
+ * @brief Destroy an expression and all of its children.
+ *
+ * Matrices referenced by leaves are not touched.
+ *
+ * @param p_expr Pointer to the expression (NULL safe).
+ */
+void matrix_expr_destroy(matrix_expr_t *p_expr);
+
+/**
+ * @brief Evaluate an expression into a pre-allocated matrix.
+ *
+ * The expression is flattened into a sum of scaled terms. Every product
+ * term becomes one matrix_gemm call with its scalars folded into alpha,
+ * and all element-wise terms are combined in a single pass over the
+ * result, so `C = alpha*A*B + beta*C + D` runs as one fused element-wise
+ * pass plus one GEMM with no temporaries. Temporaries are only created for
+ * product operands that are not plain (scaled) matrices, and when p_result
+ * overlaps a product operand.
+ *
+ * @param p_expr Pointer to the expression.
+ * @param p_result Pointer to the output matrix or view. May appear in the
+ *                 expression.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_expr_evaluate(const matrix_expr_t *p_expr,
+                                         matrix_t            *p_result);
+
+#endif // MATRIX_EXPR_H
+
+/*** end of file ***/
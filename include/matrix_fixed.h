@@ -0,0 +1,87 @@
+/**
+ * @file    matrix_fixed.h
+ * @brief   Header file for `matrix_fixed.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef MATRIX_FIXED_H
+#define MATRIX_FIXED_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+/**
+ * Number of matrices interleaved in one pack. Eight doubles are one AVX-512
+ * register or two AVX registers, so every element of a pack is loaded with
+ * one or two full-width vector loads.
+ */
+#define MATRIX_FIXED_LANES 8
+
+/**
+ * @brief Declare the fixed-size matrix types and functions for order N.
+ *
+ * For N in {2, 3, 4} this declares:
+ *
+ * - `matrixN_t`: one row-major N x N matrix, element (r, c) at m[r * N + c].
+ * - `matrixN_pack_t`: MATRIX_FIXED_LANES matrices in structure-of-arrays
+ *   layout, element (r, c) of matrix `lane` at m[r * N + c][lane].
+ * - `matrixN_multiply(a, b, c)`: c = a * b. c may alias a or b.
+ * - `matrixN_determinant(a, p_det)`.
+ * - `matrixN_inverse(a, inv)`: MATRIX_SINGULAR if the determinant is
+ *   exactly zero, in which case inv is untouched. inv may alias a.
+ * - `matrixN_pack(src, count, dst)` and `matrixN_unpack(src, count, dst)`:
+ *   convert count matrices to and from ceil(count / MATRIX_FIXED_LANES)
+ *   packs. Unused lanes of the last pack are filled with the identity.
+ * - `matrixN_multiply_batch`, `matrixN_determinant_batch` and
+ *   `matrixN_inverse_batch`: the same operations on `packs` packs, one SIMD
+ *   lane per matrix. Determinants are written to
+ *   p_det[pack * MATRIX_FIXED_LANES + lane]. The batched inverse returns
+ *   MATRIX_SINGULAR if any matrix is singular. It still writes every
+ *   result, and the singular entries are not finite.
+ *
+ * All functions return MATRIX_INVALID_ARGUMENT for NULL pointers.
+ */
+#define MATRIX_FIXED_DECLARE(N)                                              \
+    typedef struct                                                          \
+    {                                                                       \
+        double m[(N) * (N)];                                                \
+    } matrix##N##_t;                                                        \
+                                                                            \
+    typedef struct                                                          \
+    {                                                                       \
+        double m[(N) * (N)][MATRIX_FIXED_LANES];                            \
+    } matrix##N##_pack_t;                                                   \
+                                                                            \
+    matrix_error_code_t matrix##N##_multiply(const matrix##N##_t *p_a,      \
+                                             const matrix##N##_t *p_b,      \
+                                             matrix##N##_t       *p_c);     \
+    matrix_error_code_t matrix##N##_determinant(const matrix##N##_t *p_a,   \
+                                                double              *p_det); \
+    matrix_error_code_t matrix##N##_inverse(const matrix##N##_t *p_a,       \
+                                            matrix##N##_t       *p_inv);    \
+    matrix_error_code_t matrix##N##_pack(const matrix##N##_t *p_src,        \
+                                         size_t               count,        \
+                                         matrix##N##_pack_t  *p_dst);       \
+    matrix_error_code_t matrix##N##_unpack(const matrix##N##_pack_t *p_src, \
+                                           size_t                    count, \
+                                           matrix##N##_t            *p_dst); \
+    matrix_error_code_t matrix##N##_multiply_batch(                         \
+        const matrix##N##_pack_t *p_a,                                      \
+        const matrix##N##_pack_t *p_b,                                      \
+        matrix##N##_pack_t       *p_c,                                      \
+        size_t                    packs);                                   \
+    matrix_error_code_t matrix##N##_determinant_batch(                      \
+        const matrix##N##_pack_t *p_a, double *p_det, size_t packs);        \
+    matrix_error_code_t matrix##N##_inverse_batch(                          \
+        const matrix##N##_pack_t *p_a,                                      \
+        matrix##N##_pack_t       *p_inv,                                    \
+        size_t                    packs);
+
+MATRIX_FIXED_DECLARE(2)
+MATRIX_FIXED_DECLARE(3)
+MATRIX_FIXED_DECLARE(4)
+
+#endif // MATRIX_FIXED_H
+
+/*** end of file ***/
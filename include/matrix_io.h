@@ -0,0 +1,174 @@
+/**
+ * @file    matrix_io.h
+ * @brief   Header file for `matrix_io.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef MATRIX_IO_H
+#define MATRIX_IO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix.h"
+
+/**
+ * File signature, stored without a terminating NUL.
+ */
+#define MATRIX_IO_MAGIC "CDSMATRX"
+
+#define MATRIX_IO_VERSION 1U
+
+/**
+ * Alignment of the payload within the file. Mappings start on a page
+ * boundary, so a mapped payload is aligned in memory as well.
+ */
+#define MATRIX_IO_ALIGNMENT 64U
+
+/**
+ * Written as a native integer so a reader can detect a foreign byte order.
+ */
+#define MATRIX_IO_BYTE_ORDER 0x01020304U
+
+/**
+ * Bytes of CSV text per parallel task in matrix_load_csv. Tasks are cut at
+ * line ends, so each holds at least one whole row.
+ */
+#define MATRIX_CSV_CHUNK (1U << 20)
+
+typedef enum
+{
+    MATRIX_IO_DTYPE_F64 = 1, /**< IEEE-754 binary64. */
+} matrix_io_dtype_t;
+
+typedef enum
+{
+    MATRIX_IO_ROW_MAJOR = 1, /**< Row r starts at payload + r * ld. */
+} matrix_io_layout_t;
+
+typedef enum
+{
+    MATRIX_MAP_READ_ONLY     = 0, /**< Shared, writes fault. */
+    MATRIX_MAP_COPY_ON_WRITE = 1, /**< Private, writes stay in memory. */
+} matrix_map_mode_t;
+
+/**
+ * On-disk header, followed by padding up to payload_offset and then rows * ld
+ * elements of dtype. All fields are in the producer's native byte order.
+ */
+typedef struct
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t dtype;
+    uint32_t layout;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t ld;             /**< Row stride of the payload in elements. */
+    uint64_t alignment;      /**< Alignment of payload_offset in bytes. */
+    uint64_t payload_offset; /**< Byte offset of the first element. */
+} matrix_file_header_t;
+
+/**
+ * A matrix backed by a memory-mapped file. The matrix member is a view of the
+ * mapping, so matrix_destroy on it does nothing; release it with
+ * matrix_unmap.
+ */
+typedef struct
+{
+    matrix_t matrix;
+    void    *p_map;
+    size_t   map_size;
+} matrix_mapping_t;
+
+/**
+ * @brief Write a matrix to a binary file.
+ *
+ * Rows are written back to back (ld == cols) after a header padded to
+ * MATRIX_IO_ALIGNMENT bytes. Views are written as their visible block.
+ *
+ * @param p_matrix Pointer to the matrix to save.
+ * @param p_path Path of the file to create or truncate.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_FAILURE on an I/O error, error
+ *         code otherwise.
+ */
+matrix_error_code_t matrix_save(const matrix_t *p_matrix, const char *p_path);
+
+/**
+ * @brief Read a binary matrix file into a newly allocated matrix.
+ *
+ * The payload is read with one call per row into a matrix_create buffer.
+ *
+ * @param p_path Path of the file.
+ * @param pp_matrix Output for the new matrix, to be freed with
+ *                  matrix_destroy.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_INVALID_ARGUMENT for a malformed
+ *         file, MATRIX_FAILURE on an I/O error.
+ */
+matrix_error_code_t matrix_load(const char *p_path, matrix_t **pp_matrix);
+
+/**
+ * @brief Map a binary matrix file and use the payload as matrix storage.
+ *
+ * Nothing is copied: pages are faulted in on first access and shared with
+ * every other process mapping the same file through the page cache. In
+ * MATRIX_MAP_READ_ONLY mode any write to the matrix faults. In
+ * MATRIX_MAP_COPY_ON_WRITE mode written pages are privately copied and the
+ * file is never modified.
+ *
+ * @param p_path Path of the file.
+ * @param mode Mapping mode.
+ * @param p_mapping Caller-owned mapping to fill.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_INVALID_ARGUMENT for a malformed
+ *         file, MATRIX_FAILURE on an I/O error.
+ */
+matrix_error_code_t matrix_load_mmap(const char        *p_path,
+                                     matrix_map_mode_t  mode,
+                                     matrix_mapping_t  *p_mapping);
+
+/**
+ * @brief Parse a CSV file of numbers into a newly allocated matrix.
+ *
+ * Each non-blank line is a row of comma-separated numbers, optionally
+ * surrounded by spaces or tabs, ending in LF or CRLF. Every row must have
+ * the same number of fields.
+ *
+ * The file is memory-mapped and cut at line ends into chunks of about
+ * MATRIX_CSV_CHUNK bytes. A first pass counts the rows of each chunk, so
+ * each chunk knows its first row, and a second pass parses the chunks into
+ * their rows; both run across threads with parallel_for. Numbers whose
+ * significant digits fit in 53 bits (about 15 digits) and whose decimal
+ * exponent is within +-22, which covers what spreadsheets and
+ * printf("%.15g") write, are converted exactly with one multiplication or
+ * division. Anything else, including inf and nan, falls back to strtod.
+ *
+ * @param p_path Path of the file.
+ * @param rows Expected number of rows, or 0 to infer.
+ * @param cols Expected number of columns, or 0 to infer from the first
+ *             row.
+ * @param pp_matrix Output for the new matrix, to be freed with
+ *                  matrix_destroy.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_INVALID_ARGUMENT for malformed
+ *         text or a size that does not match a hint, MATRIX_FAILURE on an
+ *         I/O error.
+ */
+matrix_error_code_t matrix_load_csv(const char *p_path,
+                                    size_t      rows,
+                                    size_t      cols,
+                                    matrix_t  **pp_matrix);
+
+/**
+ * @brief Release a mapping created by matrix_load_mmap.
+ *
+ * @param p_mapping Pointer to the mapping (NULL safe). Reset to empty.
+ */
+void matrix_unmap(matrix_mapping_t *p_mapping);
+
+#endif // MATRIX_IO_H
+
+/*** end of file ***/
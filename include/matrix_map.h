@@ -0,0 +1,147 @@
+/**
+ * @file    matrix_map.h
+ * @brief   Header file for `matrix_map.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef MATRIX_MAP_H
+#define MATRIX_MAP_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+/**
+ * Longest run of contiguous elements handed to one callback. Long enough to
+ * amortize the indirect call, short enough that a segment of every operand
+ * stays in L1 while the callback works on it.
+ */
+#define MATRIX_MAP_SEGMENT 2048
+
+/**
+ * Minimum number of elements per thread before the parallel variants split
+ * a map across threads.
+ */
+#define MATRIX_MAP_PARALLEL_MIN 65536
+
+/**
+ * @brief Element-wise kernel for matrix_map.
+ *
+ * Computes p_out[i] = f(p_in[i]) for i in [0, count). p_out is either
+ * p_in itself or does not overlap it.
+ *
+ * @param p_in Pointer to count contiguous input elements.
+ * @param p_out Pointer to count contiguous output elements.
+ * @param count Number of elements, at most MATRIX_MAP_SEGMENT.
+ * @param p_ctx User context passed through from matrix_map.
+ */
+typedef void (*matrix_map_func)(const double *p_in,
+                                double       *p_out,
+                                size_t        count,
+                                void         *p_ctx);
+
+/**
+ * @brief Element-wise kernel for matrix_zip_map.
+ *
+ * Computes p_out[i] = f(p_a[i], p_b[i]) for i in [0, count). p_out is
+ * either one of the inputs or does not overlap them.
+ *
+ * @param p_a Pointer to count contiguous elements of the first input.
+ * @param p_b Pointer to count contiguous elements of the second input.
+ * @param p_out Pointer to count contiguous output elements.
+ * @param count Number of elements, at most MATRIX_MAP_SEGMENT.
+ * @param p_ctx User context passed through from matrix_zip_map.
+ */
+typedef void (*matrix_zip_func)(const double *p_a,
+                                const double *p_b,
+                                double       *p_out,
+                                size_t        count,
+                                void         *p_ctx);
+
+/**
+ * @brief Apply an element-wise function, dst = f(src).
+ *
+ * func is called once per segment of up to MATRIX_MAP_SEGMENT contiguous
+ * elements rather than once per element. Each segment lies within one row,
+ * unless every operand has contiguous rows (ld == cols), in which case the
+ * matrix is treated as one flat row. Segments are processed in row-major
+ * order on the calling thread.
+ *
+ * @param p_src Pointer to the input matrix or view.
+ * @param p_dst Pointer to the output, same dimensions. May be p_src or share
+ *              its storage element for element, but must not otherwise
+ *              overlap it.
+ * @param func Kernel applied to each segment.
+ * @param p_ctx User context passed to func.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_map(const matrix_t *p_src,
+                               matrix_t       *p_dst,
+                               matrix_map_func func,
+                               void           *p_ctx);
+
+/**
+ * @brief Parallel variant of matrix_map.
+ *
+ * Segments are split across threads once there are at least
+ * MATRIX_MAP_PARALLEL_MIN elements per thread, so func may be called
+ * concurrently, in any order, with the same p_ctx. It must only write to
+ * its output segment, or synchronize any other writes itself.
+ *
+ * @param p_src Pointer to the input matrix or view.
+ * @param p_dst Pointer to the output, as for matrix_map.
+ * @param func Thread-safe kernel applied to each segment.
+ * @param p_ctx User context passed to func.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_map_parallel(const matrix_t *p_src,
+                                        matrix_t       *p_dst,
+                                        matrix_map_func func,
+                                        void           *p_ctx);
+
+/**
+ * @brief Apply a binary element-wise function, dst = f(a, b).
+ *
+ * Segments are formed as for matrix_map.
+ *
+ * @param p_a Pointer to the first input matrix or view.
+ * @param p_b Pointer to the second input, same dimensions.
+ * @param p_dst Pointer to the output, same dimensions. May share storage
+ *              with either input element for element, but must not
+ *              otherwise overlap them.
+ * @param func Kernel applied to each segment.
+ * @param p_ctx User context passed to func.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_zip_map(const matrix_t *p_a,
+                                   const matrix_t *p_b,
+                                   matrix_t       *p_dst,
+                                   matrix_zip_func func,
+                                   void           *p_ctx);
+
+/**
+ * @brief Parallel variant of matrix_zip_map.
+ *
+ * Threading follows matrix_map_parallel, with the same requirements on
+ * func.
+ *
+ * @param p_a Pointer to the first input matrix or view.
+ * @param p_b Pointer to the second input, same dimensions.
+ * @param p_dst Pointer to the output, as for matrix_zip_map.
+ * @param func Thread-safe kernel applied to each segment.
+ * @param p_ctx User context passed to func.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_zip_map_parallel(const matrix_t *p_a,
+                                            const matrix_t *p_b,
+                                            matrix_t       *p_dst,
+                                            matrix_zip_func func,
+                                            void           *p_ctx);
+
+#endif // MATRIX_MAP_H
+
+/*** end of file ***/
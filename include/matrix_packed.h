@@ -0,0 +1,319 @@
+/**
+ * @file    matrix_packed.h
+ * @brief   Header file for `matrix_packed.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef MATRIX_PACKED_H
+#define MATRIX_PACKED_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+typedef enum
+{
+    MATRIX_PACKED_SYMMETRIC  = 0, /**< A == A^T, one triangle stored. */
+    MATRIX_PACKED_TRIANGULAR = 1, /**< Zero outside the stored triangle. */
+} matrix_packed_kind_t;
+
+typedef enum
+{
+    MATRIX_UPPER = 0, /**< Elements with col >= row. */
+    MATRIX_LOWER = 1, /**< Elements with col <= row. */
+} matrix_uplo_t;
+
+/**
+ * Symmetric or triangular n x n matrix holding only one triangle, row by
+ * row, in n * (n + 1) / 2 elements. An upper row i holds columns i..n-1 and
+ * a lower row i holds columns 0..i, so each stored row segment is
+ * contiguous. Row-major upper packing is the same layout as LAPACK's
+ * column-major lower packing, and vice versa.
+ */
+typedef struct
+{
+    matrix_packed_kind_t kind;
+    matrix_uplo_t        uplo;
+    size_t               n;
+    double              *p_data;
+} matrix_packed_t;
+
+/**
+ * Square n x n band matrix with kl sub-diagonals and ku super-diagonals,
+ * stored row by row like LAPACK's general band format transposed. Element
+ * (row, col) lives at p_data[row * ld + (col - row + kl)]. Each row is
+ * ld = 2 * kl + ku + 1 elements wide. The kl extra columns to the right of
+ * the band are zero until matrix_band_lu stores fill-in from row pivoting
+ * there.
+ */
+typedef struct
+{
+    size_t  n;
+    size_t  kl;     /**< Number of sub-diagonals. */
+    size_t  ku;     /**< Number of super-diagonals. */
+    size_t  ld;     /**< Row width of the band storage in elements. */
+    double *p_data; /**< n * ld elements. */
+} matrix_band_t;
+
+/**
+ * @brief Create a packed matrix initialized to 0.0.
+ *
+ * @param kind Symmetric or triangular.
+ * @param uplo Stored triangle.
+ * @param n Order of the matrix (> 0).
+ *
+ * @return Pointer to newly allocated matrix_packed_t, or NULL on failure.
+ */
+matrix_packed_t *matrix_packed_create(matrix_packed_kind_t kind,
+                                      matrix_uplo_t        uplo,
+                                      size_t               n);
+
+/**
+ * @brief Destroy a packed matrix and free all associated memory.
+ *
+ * @param p_packed Pointer to packed matrix to destroy (NULL safe).
+ */
+void matrix_packed_destroy(matrix_packed_t *p_packed);
+
+/**
+ * @brief Pack one triangle of a square dense matrix.
+ *
+ * The other triangle is ignored. Symmetry is not checked.
+ *
+ * @param p_dense Pointer to the square dense matrix or view.
+ * @param kind Symmetric or triangular.
+ * @param uplo Triangle to keep.
+ *
+ * @return Pointer to newly allocated matrix_packed_t, or NULL on failure.
+ */
+matrix_packed_t *matrix_packed_from_dense(const matrix_t      *p_dense,
+                                          matrix_packed_kind_t kind,
+                                          matrix_uplo_t        uplo);
+
+/**
+ * @brief Expand a packed matrix into a pre-allocated dense matrix.
+ *
+ * Symmetric matrices are mirrored; triangular ones are zero-filled.
+ *
+ * @param p_packed Pointer to the packed matrix.
+ * @param p_dense Pointer to an n x n dense matrix or view.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_packed_to_dense(const matrix_packed_t *p_packed,
+                                           matrix_t              *p_dense);
+
+/**
+ * @brief Retrieve an element.
+ *
+ * Symmetric matrices read the mirrored element. Triangular matrices read
+ * 0.0 outside the stored triangle.
+ *
+ * @param p_packed Pointer to the packed matrix.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ * @param p_out Output parameter to hold the retrieved element.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_packed_get(const matrix_packed_t *p_packed,
+                                      size_t                 row,
+                                      size_t                 col,
+                                      double                *p_out);
+
+/**
+ * @brief Set an element.
+ *
+ * Setting (row, col) of a symmetric matrix also sets (col, row).
+ *
+ * @param p_packed Pointer to the packed matrix.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ * @param value Value to store.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_OUT_OF_BOUNDS outside the matrix
+ *         or outside the stored triangle of a triangular matrix.
+ */
+matrix_error_code_t matrix_packed_set(matrix_packed_t *p_packed,
+                                      size_t           row,
+                                      size_t           col,
+                                      double           value);
+
+/**
+ * @brief Matrix-vector multiply, y = alpha * A * x + beta * y.
+ *
+ * Each stored row segment is read once. For symmetric matrices the same
+ * segment feeds a dot product for its own row and a scaled update of the
+ * mirrored column, so the product costs one pass over half the matrix.
+ * When beta is 0.0, y is not read.
+ *
+ * @param p_packed Pointer to A (n x n).
+ * @param alpha Scale applied to A * x.
+ * @param p_x Pointer to x, n contiguous elements.
+ * @param beta Scale applied to y before accumulation.
+ * @param p_y Pointer to y, n contiguous elements. Must not overlap x.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_packed_gemv(const matrix_packed_t *p_packed,
+                                       double                 alpha,
+                                       const double          *p_x,
+                                       double                 beta,
+                                       double                *p_y);
+
+/**
+ * @brief Create a band matrix initialized to 0.0.
+ *
+ * @param n Order of the matrix (> 0).
+ * @param kl Number of sub-diagonals (< n).
+ * @param ku Number of super-diagonals (< n).
+ *
+ * @return Pointer to newly allocated matrix_band_t, or NULL on failure.
+ */
+matrix_band_t *matrix_band_create(size_t n, size_t kl, size_t ku);
+
+/**
+ * @brief Destroy a band matrix and free all associated memory.
+ *
+ * @param p_band Pointer to band matrix to destroy (NULL safe).
+ */
+void matrix_band_destroy(matrix_band_t *p_band);
+
+/**
+ * @brief Copy the band of a square dense matrix.
+ *
+ * Elements outside the band are ignored.
+ *
+ * @param p_dense Pointer to the square dense matrix or view.
+ * @param kl Number of sub-diagonals to keep.
+ * @param ku Number of super-diagonals to keep.
+ *
+ * @return Pointer to newly allocated matrix_band_t, or NULL on failure.
+ */
+matrix_band_t *matrix_band_from_dense(const matrix_t *p_dense,
+                                      size_t          kl,
+                                      size_t          ku);
+
+/**
+ * @brief Expand a band matrix into a pre-allocated dense matrix.
+ *
+ * Elements outside the band are set to 0.0.
+ *
+ * @param p_band Pointer to the band matrix (not factored).
+ * @param p_dense Pointer to an n x n dense matrix or view.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_band_to_dense(const matrix_band_t *p_band,
+                                         matrix_t            *p_dense);
+
+/**
+ * @brief Retrieve an element. Elements outside the band read as 0.0.
+ *
+ * @param p_band Pointer to the band matrix.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ * @param p_out Output parameter to hold the retrieved element.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_band_get(const matrix_band_t *p_band,
+                                    size_t               row,
+                                    size_t               col,
+                                    double              *p_out);
+
+/**
+ * @brief Set an element inside the band.
+ *
+ * @param p_band Pointer to the band matrix.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ * @param value Value to store.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_OUT_OF_BOUNDS outside the matrix
+ *         or outside the band.
+ */
+matrix_error_code_t matrix_band_set(matrix_band_t *p_band,
+                                    size_t         row,
+                                    size_t         col,
+                                    double         value);
+
+/**
+ * @brief Matrix-vector multiply, y = alpha * A * x + beta * y.
+ *
+ * Costs O(n * (kl + ku)). When beta is 0.0, y is not read.
+ *
+ * @param p_band Pointer to A (n x n, not factored).
+ * @param alpha Scale applied to A * x.
+ * @param p_x Pointer to x, n contiguous elements.
+ * @param beta Scale applied to y before accumulation.
+ * @param p_y Pointer to y, n contiguous elements. Must not overlap x.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_band_gemv(const matrix_band_t *p_band,
+                                     double               alpha,
+                                     const double        *p_x,
+                                     double               beta,
+                                     double              *p_y);
+
+/**
+ * @brief Factor a band matrix in place, P * A = L * U, with partial
+ * pivoting.
+ *
+ * Pivots are searched among the kl rows below the diagonal, so U gains at
+ * most kl extra super-diagonals. They are stored in the spare columns of
+ * the band, and the cost is O(n * kl * (kl + ku)) rather than O(n^3). As
+ * with LAPACK's gbtrf, the multipliers of L are stored where they were
+ * computed and later row swaps do not permute them. Only
+ * matrix_band_lu_solve understands the factored form.
+ *
+ * @param p_band Pointer to the band matrix, overwritten by the factors.
+ * @param p_pivots Output array of n pivot rows; row k was swapped with row
+ *                 p_pivots[k] at step k.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_SINGULAR if a zero pivot was met
+ *         (the factors are still complete), error code on failure.
+ */
+matrix_error_code_t matrix_band_lu(matrix_band_t *p_band, size_t *p_pivots);
+
+/**
+ * @brief Solve A * X = B using factors computed by matrix_band_lu.
+ *
+ * Costs O(n * (2 * kl + ku) * nrhs).
+ *
+ * @param p_lu Pointer to the factored band matrix.
+ * @param p_pivots Pivot array produced by matrix_band_lu.
+ * @param p_b Pointer to the right-hand side matrix (n x nrhs).
+ * @param p_x Pointer to the solution matrix (n x nrhs). May be p_b or share
+ *            its storage exactly, but must not partially overlap it.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_SINGULAR if U has a zero on the
+ *         diagonal, error code on failure.
+ */
+matrix_error_code_t matrix_band_lu_solve(const matrix_band_t *p_lu,
+                                         const size_t        *p_pivots,
+                                         const matrix_t      *p_b,
+                                         matrix_t            *p_x);
+
+/**
+ * @brief Solve A * X = B for a band matrix A without modifying it.
+ *
+ * Factors a copy of A with matrix_band_lu and solves with
+ * matrix_band_lu_solve.
+ *
+ * @param p_band Pointer to A (n x n, not factored).
+ * @param p_b Pointer to the right-hand side matrix (n x nrhs).
+ * @param p_x Pointer to the solution matrix (n x nrhs). May be p_b or share
+ *            its storage exactly, but must not partially overlap it.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_SINGULAR if A is singular, error
+ *         code on failure.
+ */
+matrix_error_code_t matrix_band_solve(const matrix_band_t *p_band,
+                                      const matrix_t      *p_b,
+                                      matrix_t            *p_x);
+
+#endif // MATRIX_PACKED_H
+
+/*** end of file ***/
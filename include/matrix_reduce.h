@@ -0,0 +1,130 @@
+/**
+ * @file    matrix_reduce.h
+ * @brief   Header file for `matrix_reduce.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef MATRIX_REDUCE_H
+#define MATRIX_REDUCE_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+/**
+ * Minimum number of elements per thread before a reduction is split across
+ * threads. Reductions do one operation per element loaded, so only large
+ * inputs benefit.
+ */
+#define MATRIX_REDUCE_PARALLEL_MIN 131072
+
+typedef enum
+{
+    MATRIX_REDUCE_SUM      = 0, /**< Sum of elements. */
+    MATRIX_REDUCE_MEAN     = 1, /**< Arithmetic mean. */
+    MATRIX_REDUCE_MIN      = 2, /**< Smallest element. */
+    MATRIX_REDUCE_MAX      = 3, /**< Largest element. */
+    MATRIX_REDUCE_NORM_L1  = 4, /**< Sum of absolute values. */
+    MATRIX_REDUCE_NORM_L2  = 5, /**< Square root of the sum of squares. */
+    MATRIX_REDUCE_NORM_INF = 6, /**< Largest absolute value. */
+} matrix_reduce_op_t;
+
+typedef enum
+{
+    MATRIX_AXIS_ALL  = 0, /**< One result for the whole matrix. */
+    MATRIX_AXIS_ROWS = 1, /**< One result per row. */
+    MATRIX_AXIS_COLS = 2, /**< One result per column. */
+} matrix_axis_t;
+
+typedef enum
+{
+    MATRIX_NORM_ONE       = 0, /**< Largest absolute column sum. */
+    MATRIX_NORM_INF       = 1, /**< Largest absolute row sum. */
+    MATRIX_NORM_FROBENIUS = 2, /**< Square root of the sum of squares. */
+} matrix_norm_t;
+
+/**
+ * @brief Reduce a matrix, or each of its rows or columns, to one value.
+ *
+ * Rows are reduced with AVX in 4 independent vector accumulators.
+ * Partial results of row segments are combined pairwise, and column sums
+ * are accumulated in blocks of rows, so rounding error grows with the log
+ * of the size rather than linearly. Large inputs are split across threads.
+ * Norms treat the matrix, row or column as a flat vector, so NORM_L2 over
+ * MATRIX_AXIS_ALL is the Frobenius norm. NaN elements are not ordered, so
+ * MIN, MAX and NORM_INF are unspecified for inputs containing NaN.
+ *
+ * @param p_matrix Pointer to the matrix or view.
+ * @param op Reduction to apply.
+ * @param axis What to reduce over.
+ * @param p_out Output for 1, rows or cols values depending on axis.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_reduce(const matrix_t    *p_matrix,
+                                  matrix_reduce_op_t op,
+                                  matrix_axis_t      axis,
+                                  double            *p_out);
+
+/**
+ * @brief Locate the element selected by MIN, MAX or NORM_INF.
+ *
+ * The first occurrence in row-major order wins ties. Over MATRIX_AXIS_ALL
+ * the output is the flat index row * cols + col, over MATRIX_AXIS_ROWS the
+ * column within each row, and over MATRIX_AXIS_COLS the row within each
+ * column.
+ *
+ * @param p_matrix Pointer to the matrix or view.
+ * @param op MATRIX_REDUCE_MIN, MATRIX_REDUCE_MAX or MATRIX_REDUCE_NORM_INF.
+ * @param axis What to reduce over.
+ * @param p_out Output for 1, rows or cols indices depending on axis.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_reduce_index(const matrix_t    *p_matrix,
+                                        matrix_reduce_op_t op,
+                                        matrix_axis_t      axis,
+                                        size_t            *p_out);
+
+/**
+ * @brief Find the position of the smallest element.
+ *
+ * @param p_matrix Pointer to the matrix or view.
+ * @param p_row Output row index.
+ * @param p_col Output column index.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_argmin(const matrix_t *p_matrix,
+                                  size_t         *p_row,
+                                  size_t         *p_col);
+
+/**
+ * @brief Find the position of the largest element.
+ *
+ * @param p_matrix Pointer to the matrix or view.
+ * @param p_row Output row index.
+ * @param p_col Output column index.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_argmax(const matrix_t *p_matrix,
+                                  size_t         *p_row,
+                                  size_t         *p_col);
+
+/**
+ * @brief Compute a matrix norm.
+ *
+ * @param p_matrix Pointer to the matrix or view.
+ * @param norm Norm to compute.
+ * @param p_out Output for the norm.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_norm(const matrix_t *p_matrix,
+                                matrix_norm_t   norm,
+                                double         *p_out);
+
+#endif // MATRIX_REDUCE_H
+
+/*** end of file ***/
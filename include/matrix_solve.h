@@ -0,0 +1,121 @@
+/**
+ * @file    matrix_solve.h
+ * @brief   Header file for `matrix_solve.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef MATRIX_SOLVE_H
+#define MATRIX_SOLVE_H
+
+#include "matrix.h"
+
+/**
+ * Panel width of the blocked Cholesky factorization.
+ */
+#define MATRIX_CHOLESKY_BLOCK 64
+
+/**
+ * Number of Householder reflectors aggregated into one block reflector by
+ * the blocked QR factorization.
+ */
+#define MATRIX_QR_BLOCK 32
+
+typedef enum
+{
+    MATRIX_SOLVE_AUTO     = 0, /**< Choose from shape and symmetry. */
+    MATRIX_SOLVE_LU       = 1, /**< LU with partial pivoting (square). */
+    MATRIX_SOLVE_CHOLESKY = 2, /**< Cholesky (symmetric positive definite). */
+    MATRIX_SOLVE_QR       = 3, /**< Householder QR (least squares). */
+} matrix_solve_method_t;
+
+typedef struct
+{
+    matrix_solve_method_t method;   /**< Method actually used. */
+    size_t                rows;     /**< Rows of the factored matrix. */
+    size_t                cols;     /**< Columns of the factored matrix. */
+    matrix_t             *p_factor; /**< LU, Cholesky L, or QR R + V. */
+    size_t               *p_pivots; /**< LU row pivots. */
+    double               *p_tau;    /**< QR reflector scales. */
+    double               *p_t;      /**< QR block reflector triangles. */
+} matrix_factor_t;
+
+/**
+ * @brief Factor a matrix once so it can be solved against many right-hand
+ * sides.
+ *
+ * With MATRIX_SOLVE_AUTO, non-square matrices (rows > cols) use QR, square
+ * symmetric matrices with a positive diagonal try Cholesky and fall back to
+ * LU if they turn out not to be positive definite, and everything else uses
+ * LU.
+ *
+ * @param p_matrix Pointer to the matrix to factor. Not modified.
+ * @param method Factorization to use.
+ * @param pp_factor Output for the newly allocated factorization.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_SINGULAR or
+ *         MATRIX_NOT_POSITIVE_DEFINITE when the factorization does not
+ *         exist, error code on failure. No factorization is returned on
+ *         failure.
+ */
+matrix_error_code_t matrix_factorize(const matrix_t        *p_matrix,
+                                     matrix_solve_method_t  method,
+                                     matrix_factor_t      **pp_factor);
+
+/**
+ * @brief Destroy a factorization and free all associated memory.
+ *
+ * @param p_factor Pointer to factorization to destroy (NULL safe).
+ */
+void matrix_factor_destroy(matrix_factor_t *p_factor);
+
+/**
+ * @brief Solve A * X = B using a factorization of A.
+ *
+ * For QR the solution minimizes ||A * X - B|| in the least squares sense.
+ *
+ * @param p_factor Pointer to the factorization of A (rows x cols).
+ * @param p_b Pointer to the right-hand sides (rows x nrhs).
+ * @param p_x Pointer to the solution (cols x nrhs). May be p_b when A is
+ *            square.
+ *
+ * @return MATRIX_SUCCESS on success, MATRIX_SINGULAR if A is singular or
+ *         rank deficient, error code on failure.
+ */
+matrix_error_code_t matrix_factor_solve(const matrix_factor_t *p_factor,
+                                        const matrix_t        *p_b,
+                                        matrix_t              *p_x);
+
+/**
+ * @brief Solve A * X = B, choosing the factorization automatically.
+ *
+ * Equivalent to matrix_solve_using() with MATRIX_SOLVE_AUTO.
+ *
+ * @param p_matrix Pointer to A (rows x cols, rows >= cols).
+ * @param p_b Pointer to the right-hand sides (rows x nrhs).
+ * @param p_x Pointer to the solution (cols x nrhs).
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_solve(const matrix_t *p_matrix,
+                                 const matrix_t *p_b,
+                                 matrix_t       *p_x);
+
+/**
+ * @brief Solve A * X = B with an explicitly chosen factorization.
+ *
+ * @param p_matrix Pointer to A (rows x cols, rows >= cols).
+ * @param method Factorization to use.
+ * @param p_b Pointer to the right-hand sides (rows x nrhs).
+ * @param p_x Pointer to the solution (cols x nrhs).
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_solve_using(const matrix_t       *p_matrix,
+                                       matrix_solve_method_t method,
+                                       const matrix_t       *p_b,
+                                       matrix_t             *p_x);
+
+#endif // MATRIX_SOLVE_H
+
+/*** end of file ***/
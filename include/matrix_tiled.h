@@ -0,0 +1,163 @@
+/**
+ * @file    matrix_tiled.h
+ * @brief   Header file for `matrix_tiled.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef MATRIX_TILED_H
+#define MATRIX_TILED_H
+
+#include <stddef.h>
+#include "matrix.h"
+
+/**
+ * Side length in elements of a square tile. A tile is 32 KiB of doubles,
+ * small enough that the tiles touched by one kernel step stay in L2.
+ */
+#define MATRIX_TILE_SIZE 64
+
+/**
+ * Matrix stored as MATRIX_TILE_SIZE x MATRIX_TILE_SIZE tiles. Each tile is
+ * row-major and contiguous, and tiles are laid out in Z (Morton) order of
+ * their (tile row, tile column) coordinates, so tiles that are close in
+ * either direction are also close in memory. Walking down a column touches
+ * one new cache line per element only within a tile instead of across the
+ * whole matrix. Tiles on the right and bottom edges are stored full size
+ * with zero padding.
+ */
+typedef struct
+{
+    size_t  rows;
+    size_t  cols;
+    size_t  tile_rows; /**< Number of tiles down, ceil(rows / tile). */
+    size_t  tile_cols; /**< Number of tiles across, ceil(cols / tile). */
+    size_t *p_slot;    /**< Slot of tile (tr, tc) at tr * tile_cols + tc. */
+    size_t *p_tile;    /**< Tile index tr * tile_cols + tc in each slot. */
+    double *p_data;    /**< One MATRIX_TILE_SIZE^2 block per slot. */
+} matrix_tiled_t;
+
+/**
+ * @brief Create a tiled matrix initialized to 0.0.
+ *
+ * @param rows Number of rows (> 0).
+ * @param cols Number of columns (> 0).
+ *
+ * @return Pointer to newly allocated matrix_tiled_t, or NULL on failure.
+ */
+matrix_tiled_t *matrix_tiled_create(size_t rows, size_t cols);
+
+/**
+ * @brief Destroy a tiled matrix and free all associated memory.
+ *
+ * @param p_tiled Pointer to tiled matrix to destroy (NULL safe).
+ */
+void matrix_tiled_destroy(matrix_tiled_t *p_tiled);
+
+/**
+ * @brief Convert a row-major matrix to tiled layout.
+ *
+ * Every tile row is copied as one contiguous run, so conversion streams
+ * through both layouts at memcpy speed.
+ *
+ * @param p_matrix Pointer to the matrix or view.
+ *
+ * @return Pointer to newly allocated matrix_tiled_t, or NULL on failure.
+ */
+matrix_tiled_t *matrix_tiled_from_matrix(const matrix_t *p_matrix);
+
+/**
+ * @brief Convert a tiled matrix back to a pre-allocated row-major matrix.
+ *
+ * @param p_tiled Pointer to the tiled matrix.
+ * @param p_matrix Pointer to the output matrix or view, same dimensions.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_tiled_to_matrix(const matrix_tiled_t *p_tiled,
+                                           matrix_t             *p_matrix);
+
+/**
+ * @brief Retrieve an element.
+ *
+ * @param p_tiled Pointer to the tiled matrix.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ * @param p_out Output parameter to hold the retrieved element.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_tiled_get(const matrix_tiled_t *p_tiled,
+                                     size_t                row,
+                                     size_t                col,
+                                     double               *p_out);
+
+/**
+ * @brief Set an element.
+ *
+ * @param p_tiled Pointer to the tiled matrix.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ * @param value Value to store.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_tiled_set(matrix_tiled_t *p_tiled,
+                                     size_t          row,
+                                     size_t          col,
+                                     double          value);
+
+/**
+ * @brief Describe one tile as a row-major matrix_t view.
+ *
+ * The view has ld == MATRIX_TILE_SIZE and covers only the real elements of
+ * edge tiles, so any matrix_t kernel can be run tile by tile.
+ *
+ * @param p_tiled Pointer to the tiled matrix.
+ * @param tile_row Tile row (< tile_rows).
+ * @param tile_col Tile column (< tile_cols).
+ * @param p_view Output view.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_tiled_tile_view(const matrix_tiled_t *p_tiled,
+                                           size_t                tile_row,
+                                           size_t                tile_col,
+                                           matrix_t             *p_view);
+
+/**
+ * @brief Transpose a tiled matrix into another.
+ *
+ * Tile (tr, tc) of the source becomes tile (tc, tr) of the result and is
+ * transposed while both tiles are cache resident, so no pass strides
+ * through the full matrix.
+ *
+ * @param p_src Pointer to the source (rows x cols).
+ * @param p_dst Pointer to the result (cols x rows), distinct from p_src.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_tiled_transpose(const matrix_tiled_t *p_src,
+                                           matrix_tiled_t       *p_dst);
+
+/**
+ * @brief Multiply two tiled matrices, C = A * B.
+ *
+ * Each result tile is accumulated from tile products with matrix_gemm on
+ * contiguous tiles, so no operand needs repacking across tiles. Result tiles
+ * are independent and are split across threads with parallel_for, in
+ * storage order so each thread's share is a compact Z-order region.
+ *
+ * @param p_a Pointer to A (m x k).
+ * @param p_b Pointer to B (k x n).
+ * @param p_c Pointer to C (m x n), distinct from A and B.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_tiled_multiply(const matrix_tiled_t *p_a,
+                                          const matrix_tiled_t *p_b,
+                                          matrix_tiled_t       *p_c);
+
+#endif // MATRIX_TILED_H
+
+/*** end of file ***/
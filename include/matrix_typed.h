@@ -0,0 +1,314 @@
+/**
+ * @file    matrix_typed.h
+ * @brief   Header file for `matrix_typed.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef MATRIX_TYPED_H
+#define MATRIX_TYPED_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix.h"
+
+/**
+ * Largest magnitude of a quantized value. The range is kept symmetric
+ * (-127..127) so that negating a quantized matrix cannot overflow.
+ */
+#define MATRIX_I8_MAX 127
+
+/**
+ * Largest inner dimension matrix_i8_gemm accepts. An int8 product is at most
+ * 128 * 128 = 2^14 in magnitude, so 2^17 - 1 of them always fit in an int32
+ * accumulator that starts at zero. For quantized data the limit would be
+ * 2^31 / 127^2, about 133k.
+ */
+#define MATRIX_I8_GEMM_MAX_K 131071
+
+/**
+ * Single-precision row-major matrix. Element (row, col) lives at
+ * p_data[row * ld + col].
+ */
+typedef struct
+{
+    size_t rows;
+    size_t cols;
+    size_t ld;     /**< Row stride in elements, at least cols. */
+    float *p_data; /**< Row-major element storage. */
+} matrix_f32_t;
+
+/**
+ * Symmetrically quantized int8 row-major matrix. The real value of element
+ * (row, col) is scale * p_data[row * ld + col].
+ */
+typedef struct
+{
+    size_t  rows;
+    size_t  cols;
+    size_t  ld;     /**< Row stride in elements, at least cols. */
+    float   scale;  /**< Dequantization factor. */
+    int8_t *p_data; /**< Row-major quantized storage. */
+} matrix_i8_t;
+
+/**
+ * @brief Create a new float matrix initialized to 0.0f.
+ *
+ * @param rows Number of rows (> 0).
+ * @param cols Number of columns (> 0).
+ *
+ * @return Pointer to newly allocated matrix_f32_t, or NULL on failure.
+ */
+matrix_f32_t *matrix_f32_create(size_t rows, size_t cols);
+
+/**
+ * @brief Destroy a float matrix and free all associated memory.
+ *
+ * @param p_matrix Pointer to matrix to destroy (NULL safe).
+ */
+void matrix_f32_destroy(matrix_f32_t *p_matrix);
+
+/**
+ * @brief Fill the entire float matrix with a given value.
+ *
+ * @param p_matrix Pointer to matrix.
+ * @param value Value to fill the matrix with.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_f32_fill(matrix_f32_t *p_matrix, float value);
+
+/**
+ * @brief Retrieve the value at a specific row and column.
+ *
+ * @param p_matrix Pointer to matrix.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ * @param p_out Output parameter to hold the retrieved element.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_f32_get(const matrix_f32_t *p_matrix,
+                                   size_t              row,
+                                   size_t              col,
+                                   float              *p_out);
+
+/**
+ * @brief Set the value at a specific row and column.
+ *
+ * @param p_matrix Pointer to matrix.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ * @param value Value to set.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_f32_set(matrix_f32_t *p_matrix,
+                                   size_t        row,
+                                   size_t        col,
+                                   float         value);
+
+/**
+ * @brief Create a new int8 matrix initialized to 0 with scale 1.0f.
+ *
+ * @param rows Number of rows (> 0).
+ * @param cols Number of columns (> 0).
+ *
+ * @return Pointer to newly allocated matrix_i8_t, or NULL on failure.
+ */
+matrix_i8_t *matrix_i8_create(size_t rows, size_t cols);
+
+/**
+ * @brief Destroy an int8 matrix and free all associated memory.
+ *
+ * @param p_matrix Pointer to matrix to destroy (NULL safe).
+ */
+void matrix_i8_destroy(matrix_i8_t *p_matrix);
+
+/**
+ * @brief Fill the entire int8 matrix with a given quantized value.
+ *
+ * @param p_matrix Pointer to matrix.
+ * @param value Quantized value to fill the matrix with.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_i8_fill(matrix_i8_t *p_matrix, int8_t value);
+
+/**
+ * @brief Retrieve the quantized value at a specific row and column.
+ *
+ * @param p_matrix Pointer to matrix.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ * @param p_out Output parameter to hold the retrieved element.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_i8_get(const matrix_i8_t *p_matrix,
+                                  size_t             row,
+                                  size_t             col,
+                                  int8_t            *p_out);
+
+/**
+ * @brief Set the quantized value at a specific row and column.
+ *
+ * @param p_matrix Pointer to matrix.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ * @param value Quantized value to set.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_i8_set(matrix_i8_t *p_matrix,
+                                  size_t       row,
+                                  size_t       col,
+                                  int8_t       value);
+
+/**
+ * @brief Round a double matrix to single precision.
+ *
+ * @param p_src Pointer to the source matrix.
+ * @param p_dst Pointer to a float matrix of the same dimensions.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_f32_from_matrix(const matrix_t *p_src,
+                                           matrix_f32_t   *p_dst);
+
+/**
+ * @brief Widen a float matrix to double precision.
+ *
+ * @param p_src Pointer to the source matrix.
+ * @param p_dst Pointer to a double matrix of the same dimensions.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_f32_to_matrix(const matrix_f32_t *p_src,
+                                         matrix_t           *p_dst);
+
+/**
+ * @brief Quantize a float matrix to int8 with a single symmetric scale.
+ *
+ * The scale maps the largest magnitude in p_src to MATRIX_I8_MAX and values
+ * are rounded to nearest, so the error per element is at most scale / 2.
+ *
+ * @param p_src Pointer to the source matrix.
+ * @param p_dst Pointer to an int8 matrix of the same dimensions. Its scale
+ *              is overwritten.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_i8_quantize(const matrix_f32_t *p_src,
+                                       matrix_i8_t        *p_dst);
+
+/**
+ * @brief Expand an int8 matrix back to float using its scale.
+ *
+ * @param p_src Pointer to the source matrix.
+ * @param p_dst Pointer to a float matrix of the same dimensions.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_i8_dequantize(const matrix_i8_t *p_src,
+                                         matrix_f32_t      *p_dst);
+
+/**
+ * @brief Single-precision general matrix multiply on raw buffers.
+ *
+ * Computes C = alpha * A * B + beta * C with the same cache blocking as
+ * matrix_gemm. The AVX micro-kernel works on 8 floats per register, twice
+ * the width of the double kernel. When beta is 0.0f, C is not read.
+ *
+ * @param m Number of rows of A and C.
+ * @param n Number of columns of B and C.
+ * @param k Number of columns of A and rows of B.
+ * @param alpha Scale applied to A * B.
+ * @param p_a Pointer to the first element of A.
+ * @param lda Leading dimension of A, at least k.
+ * @param p_b Pointer to the first element of B.
+ * @param ldb Leading dimension of B, at least n.
+ * @param beta Scale applied to C before accumulation.
+ * @param p_c Pointer to the first element of C. Must not overlap A or B.
+ * @param ldc Leading dimension of C, at least n.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_f32_gemm(size_t       m,
+                                    size_t       n,
+                                    size_t       k,
+                                    float        alpha,
+                                    const float *p_a,
+                                    size_t       lda,
+                                    const float *p_b,
+                                    size_t       ldb,
+                                    float        beta,
+                                    float       *p_c,
+                                    size_t       ldc);
+
+/**
+ * @brief Multiply two float matrices, C = A * B.
+ *
+ * @param p_a Pointer to A (m x k).
+ * @param p_b Pointer to B (k x n).
+ * @param p_c Pointer to pre-allocated C (m x n). Must not be A or B.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_f32_multiply(const matrix_f32_t *p_a,
+                                        const matrix_f32_t *p_b,
+                                        matrix_f32_t       *p_c);
+
+/**
+ * @brief Integer matrix multiply on raw int8 buffers, C += A * B.
+ *
+ * Products are accumulated exactly in int32. With AVX2, pairs of int8
+ * values are widened to int16 and multiplied with a horizontal
+ * multiply-add, giving 16 multiply-accumulates per instruction.
+ *
+ * The sum can only be exact while it fits in int32, so k is limited to
+ * MATRIX_I8_GEMM_MAX_K, and C must start close enough to zero to absorb
+ * the rest of the range.
+ *
+ * @param m Number of rows of A and C.
+ * @param n Number of columns of B and C.
+ * @param k Number of columns of A and rows of B, at most
+ *          MATRIX_I8_GEMM_MAX_K.
+ * @param p_a Pointer to the first element of A.
+ * @param lda Leading dimension of A, at least k.
+ * @param p_b Pointer to the first element of B.
+ * @param ldb Leading dimension of B, at least n.
+ * @param p_c Pointer to the first element of the int32 accumulator C.
+ * @param ldc Leading dimension of C, at least n.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_i8_gemm(size_t        m,
+                                   size_t        n,
+                                   size_t        k,
+                                   const int8_t *p_a,
+                                   size_t        lda,
+                                   const int8_t *p_b,
+                                   size_t        ldb,
+                                   int32_t      *p_c,
+                                   size_t        ldc);
+
+/**
+ * @brief Multiply two quantized matrices into a float result.
+ *
+ * Computes C = (A.scale * B.scale) * (A_q * B_q) with exact int32
+ * accumulation before the single rescale.
+ *
+ * @param p_a Pointer to A (m x k).
+ * @param p_b Pointer to B (k x n).
+ * @param p_c Pointer to pre-allocated float C (m x n).
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+matrix_error_code_t matrix_i8_multiply(const matrix_i8_t *p_a,
+                                       const matrix_i8_t *p_b,
+                                       matrix_f32_t      *p_c);
+
+#endif // MATRIX_TYPED_H
+
+/*** end of file ***/
@@ -0,0 +1,85 @@
+/**
+ * @file    parallel.h
+ * @brief   Header file for `parallel.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Upper bound on the number of worker threads used by parallel_for.
+ */
+#define PARALLEL_MAX_THREADS 64
+
+/**
+ * @brief Function pointer type for processing a range of work items.
+ *
+ * Called once per chunk with a half-open range [begin, end). Chunks never
+ * overlap, so implementations may write to per-item outputs without
+ * synchronization.
+ *
+ * @param begin First item of the chunk.
+ * @param end One past the last item of the chunk.
+ * @param p_ctx User context passed through from parallel_for.
+ */
+typedef void (*parallel_func)(size_t begin, size_t end, void *p_ctx);
+
+/**
+ * @brief Get the number of threads parallel_for will use.
+ *
+ * Defaults to the number of online processors.
+ *
+ * @return Thread count (>= 1).
+ */
+size_t parallel_get_threads(void);
+
+/**
+ * @brief Override the number of threads parallel_for will use.
+ *
+ * @param count Thread count, or 0 to restore the default.
+ */
+void parallel_set_threads(size_t count);
+
+/**
+ * @brief Pin the threads of subsequent parallel_for calls to fixed CPUs.
+ *
+ * Enabling takes a snapshot of the CPUs the calling thread may run on, pins
+ * the calling thread to the first of them, and from then on pins the thread
+ * running chunk i to CPU i of the snapshot (modulo its size). Disabling
+ * restores the calling thread's original mask. Call it from the thread that
+ * calls parallel_for. Pinning keeps benchmark timings stable; it rarely
+ * helps throughput otherwise.
+ *
+ * @param b_pin True to pin, false to let the scheduler place threads.
+ *
+ * @return 0 on success, -1 if the affinity could not be queried or set (in
+ *         which case nothing is pinned).
+ */
+int parallel_set_affinity(bool b_pin);
+
+/**
+ * @brief Split [0, count) into contiguous chunks and process them
+ * concurrently.
+ *
+ * The calling thread processes the first chunk itself. Work smaller than
+ * two chunks of min_chunk items runs inline without creating threads, and if
+ * a thread cannot be created its chunk also runs inline.
+ *
+ * @param count Number of work items.
+ * @param min_chunk Minimum number of items per chunk (0 treated as 1).
+ * @param func Function applied to each chunk.
+ * @param p_ctx User context passed to func.
+ */
+void parallel_for(size_t        count,
+                  size_t        min_chunk,
+                  parallel_func func,
+                  void         *p_ctx);
+
+#endif // PARALLEL_H
+
+/*** end of file ***/
@@ -0,0 +1,181 @@
+/**
+ * @file    sparse_matrix.h
+ * @brief   Header file for `sparse_matrix.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "matrix.h"
+
+/**
+ * Minimum number of non-zeros per thread before SpMV and SpMM are split
+ * across threads. Smaller products do not amortize thread start-up.
+ */
+#define SPARSE_PARALLEL_MIN_NNZ 32768
+
+typedef enum
+{
+    SPARSE_SUCCESS            = 0,  /**< Operation succeeded. */
+    SPARSE_NOT_FOUND          = -1, /**< Element not found. */
+    SPARSE_OUT_OF_BOUNDS      = -2, /**< Index out of range. */
+    SPARSE_INVALID_ARGUMENT   = -3, /**< Invalid argument provided. */
+    SPARSE_ALLOCATION_FAILURE = -4, /**< Memory allocation failed. */
+    SPARSE_FAILURE            = -5, /**< Generic failure. */
+    SPARSE_NOT_CONVERGED      = -6, /**< Iterative solve did not converge. */
+} sparse_error_code_t;
+
+typedef enum
+{
+    SPARSE_CSR = 0, /**< Compressed sparse row. */
+    SPARSE_CSC = 1, /**< Compressed sparse column. */
+} sparse_format_t;
+
+/**
+ * Compressed sparse matrix. For CSR the major dimension is rows: p_ptr has
+ * rows + 1 entries and p_idx holds column indices. For CSC the roles of rows
+ * and columns are swapped. Indices are sorted within each major slice.
+ */
+typedef struct
+{
+    sparse_format_t format;
+    size_t          rows;
+    size_t          cols;
+    size_t          nnz;      /**< Number of stored entries. */
+    size_t         *p_ptr;    /**< Slice offsets into p_idx / p_values. */
+    size_t         *p_idx;    /**< Minor index of each entry. */
+    double         *p_values; /**< Value of each entry. */
+} sparse_matrix_t;
+
+/**
+ * @brief Create a sparse matrix from the non-zero entries of a dense matrix.
+ *
+ * @param p_dense Pointer to the dense matrix.
+ * @param format Storage format of the result.
+ *
+ * @return Pointer to newly allocated sparse_matrix_t, or NULL on failure.
+ */
+sparse_matrix_t *sparse_from_dense(const matrix_t *p_dense,
+                                   sparse_format_t format);
+
+/**
+ * @brief Create a sparse matrix from coordinate (row, col, value) triplets.
+ *
+ * Triplets may be in any order; duplicates are summed. Runs in
+ * O(nnz + rows + cols) using two counting sorts.
+ *
+ * @param rows Number of rows (> 0).
+ * @param cols Number of columns (> 0).
+ * @param count Number of triplets.
+ * @param p_row_idx Row index of each triplet.
+ * @param p_col_idx Column index of each triplet.
+ * @param p_values Value of each triplet.
+ * @param format Storage format of the result.
+ *
+ * @return Pointer to newly allocated sparse_matrix_t, or NULL on failure or
+ *         if an index is out of range.
+ */
+sparse_matrix_t *sparse_from_triplets(size_t          rows,
+                                      size_t          cols,
+                                      size_t          count,
+                                      const size_t   *p_row_idx,
+                                      const size_t   *p_col_idx,
+                                      const double   *p_values,
+                                      sparse_format_t format);
+
+/**
+ * @brief Destroy a sparse matrix and free all associated memory.
+ *
+ * @param p_sparse Pointer to sparse matrix to destroy (NULL safe).
+ */
+void sparse_destroy(sparse_matrix_t *p_sparse);
+
+/**
+ * @brief Expand a sparse matrix into a pre-allocated dense matrix.
+ *
+ * @param p_sparse Pointer to the sparse matrix.
+ * @param p_dense Pointer to a dense matrix of the same dimensions.
+ *
+ * @return SPARSE_SUCCESS on success, error code on failure.
+ */
+sparse_error_code_t sparse_to_dense(const sparse_matrix_t *p_sparse,
+                                    matrix_t              *p_dense);
+
+/**
+ * @brief Retrieve the value at a specific row and column.
+ *
+ * Binary searches the row (CSR) or column (CSC). Entries that are not
+ * stored read as 0.0.
+ *
+ * @param p_sparse Pointer to the sparse matrix.
+ * @param row Row index (0-based).
+ * @param col Column index (0-based).
+ * @param p_out Output parameter to hold the retrieved element.
+ *
+ * @return SPARSE_SUCCESS on success, error code on failure.
+ */
+sparse_error_code_t sparse_get(const sparse_matrix_t *p_sparse,
+                               size_t                 row,
+                               size_t                 col,
+                               double                *p_out);
+
+/**
+ * @brief Create the transpose of a sparse matrix in the same format.
+ *
+ * @param p_sparse Pointer to the sparse matrix.
+ *
+ * @return Pointer to newly allocated transpose, or NULL on failure.
+ */
+sparse_matrix_t *sparse_transpose(const sparse_matrix_t *p_sparse);
+
+/**
+ * @brief Create a copy of a sparse matrix in the requested format.
+ *
+ * @param p_sparse Pointer to the sparse matrix.
+ * @param format Storage format of the result.
+ *
+ * @return Pointer to newly allocated sparse_matrix_t, or NULL on failure.
+ */
+sparse_matrix_t *sparse_convert(const sparse_matrix_t *p_sparse,
+                                sparse_format_t        format);
+
+/**
+ * @brief Sparse matrix times dense vector, y = A * x.
+ *
+ * CSR products are split across threads by row ranges holding equal
+ * shares of the non-zeros. CSC products scatter into y and run serially.
+ *
+ * @param p_sparse Pointer to A (rows x cols).
+ * @param p_x Input vector of cols elements.
+ * @param p_y Output vector of rows elements. Must not overlap p_x.
+ *
+ * @return SPARSE_SUCCESS on success, error code on failure.
+ */
+sparse_error_code_t sparse_spmv(const sparse_matrix_t *p_sparse,
+                                const double          *p_x,
+                                double                *p_y);
+
+/**
+ * @brief Sparse matrix times dense matrix, C = A * B.
+ *
+ * Each stored entry of A scales one contiguous row of B, so the cost is
+ * O(nnz * B->cols). CSR products are split across threads like
+ * sparse_spmv.
+ *
+ * @param p_sparse Pointer to A (rows x cols).
+ * @param p_b Pointer to B (cols x n).
+ * @param p_c Pointer to pre-allocated C (rows x n). Must not overlap p_b.
+ *
+ * @return SPARSE_SUCCESS on success, error code on failure.
+ */
+sparse_error_code_t sparse_spmm(const sparse_matrix_t *p_sparse,
+                                const matrix_t        *p_b,
+                                matrix_t              *p_c);
+
+#endif // SPARSE_MATRIX_H
+
+/*** end of file ***/
@@ -0,0 +1,157 @@
+/**
+ * @file    sparse_solve.h
+ * @brief   Header file for `sparse_solve.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef SPARSE_SOLVE_H
+#define SPARSE_SOLVE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "sparse_matrix.h"
+
+/**
+ * Number of vector elements per work item of the dot products and vector
+ * updates. Dot products sum one partial per block in block order, so
+ * results do not depend on the thread count, and vectors shorter than two
+ * blocks are processed without threads.
+ */
+#define SPARSE_SOLVE_BLOCK 65536
+
+/**
+ * Relative residual used when sparse_solve_params_t::tolerance is not
+ * positive.
+ */
+#define SPARSE_SOLVE_TOLERANCE 1e-8
+
+/**
+ * GMRES Krylov subspace dimension used when sparse_solve_params_t::restart
+ * is 0.
+ */
+#define SPARSE_SOLVE_RESTART 30
+
+typedef enum
+{
+    SPARSE_SOLVE_CG       = 0, /**< Conjugate gradient, SPD only. */
+    SPARSE_SOLVE_BICGSTAB = 1, /**< BiCGSTAB, general square systems. */
+    SPARSE_SOLVE_GMRES    = 2, /**< Restarted GMRES, general systems. */
+} sparse_solve_method_t;
+
+typedef enum
+{
+    SPARSE_PRECOND_NONE   = 0, /**< No preconditioning. */
+    SPARSE_PRECOND_JACOBI = 1, /**< Inverse of the diagonal. */
+    SPARSE_PRECOND_ILU0   = 2, /**< Incomplete LU without fill-in. */
+} sparse_precond_t;
+
+/**
+ * @brief Linear operator callback computing y = A * x.
+ *
+ * @param p_x Input vector. Must not be modified.
+ * @param p_y Output vector. Never overlaps p_x.
+ * @param p_ctx User context from sparse_operator_t.
+ *
+ * @return SPARSE_SUCCESS on success; any other code aborts the solve and
+ *         is returned from it.
+ */
+typedef sparse_error_code_t (*sparse_apply_func)(const double *p_x,
+                                                 double       *p_y,
+                                                 void         *p_ctx);
+
+/**
+ * Square linear operator of dimension size, given only by its action on a
+ * vector.
+ */
+typedef struct
+{
+    size_t            size;  /**< Dimension of x and y. */
+    sparse_apply_func apply; /**< Computes y = A * x. */
+    void             *p_ctx; /**< Passed through to apply. */
+} sparse_operator_t;
+
+/**
+ * Solver settings. A zero-initialized struct selects CG without
+ * preconditioning and the default limits.
+ */
+typedef struct
+{
+    sparse_solve_method_t method;
+    sparse_precond_t      precond;        /**< Used by sparse_solve only. */
+    size_t                max_iterations; /**< 0 for 10 * size. */
+    size_t                restart;        /**< GMRES only, 0 for default. */
+    double                tolerance;      /**< Target ||b - A x|| / ||b||. */
+} sparse_solve_params_t;
+
+typedef struct
+{
+    size_t iterations;  /**< Iterations (GMRES inner steps) performed. */
+    size_t matvecs;     /**< Operator applications. */
+    double residual;    /**< Relative residual as tracked by the solver. */
+    bool   b_converged; /**< Whether residual reached the tolerance. */
+} sparse_solve_stats_t;
+
+/**
+ * @brief Solve A * x = b iteratively for a square sparse A.
+ *
+ * CSC matrices are converted to CSR first so that every product runs in
+ * parallel through sparse_spmv. The Jacobi and ILU(0) preconditioners are
+ * built from the CSR entries before iterating; ILU(0) keeps the sparsity
+ * pattern of A, so memory stays O(nnz + n). ILU(0) triangular solves are
+ * sequential.
+ *
+ * @param p_sparse Pointer to A (n x n).
+ * @param p_b Right-hand side of n elements.
+ * @param p_x Initial guess of n elements, overwritten with the solution.
+ *            Must not overlap p_b.
+ * @param p_params Pointer to the solver settings, or NULL for defaults.
+ * @param p_stats Output for the convergence statistics, or NULL.
+ *
+ * @return SPARSE_SUCCESS when the tolerance was reached,
+ *         SPARSE_NOT_CONVERGED when the iteration limit was hit or the
+ *         method broke down (p_x then holds the last iterate),
+ *         SPARSE_FAILURE when the preconditioner does not exist because a
+ *         diagonal entry or ILU(0) pivot is zero, error code on failure.
+ */
+sparse_error_code_t sparse_solve(const sparse_matrix_t       *p_sparse,
+                                 const double                *p_b,
+                                 double                      *p_x,
+                                 const sparse_solve_params_t *p_params,
+                                 sparse_solve_stats_t        *p_stats);
+
+/**
+ * @brief Solve A * x = b iteratively for an operator given as a callback.
+ *
+ * All temporary vectors are allocated once before iterating: 4 for CG, 7
+ * for BiCGSTAB and restart + 3 for GMRES, each of size elements. CG uses
+ * the preconditioner as M^-1 in the usual PCG recurrence, so both A and M
+ * must be symmetric positive definite. BiCGSTAB and GMRES precondition on
+ * the right, so the tracked residual is that of the original system.
+ *
+ * @param p_operator Pointer to A.
+ * @param p_precond Pointer to M^-1, applied as z = M^-1 * r, or NULL for
+ *                  none. Must have the same size as p_operator.
+ * @param p_b Right-hand side of size elements.
+ * @param p_x Initial guess of size elements, overwritten with the solution.
+ *            Must not overlap p_b.
+ * @param p_params Pointer to the solver settings, or NULL for defaults.
+ *                 The precond field is ignored.
+ * @param p_stats Output for the convergence statistics, or NULL.
+ *
+ * @return SPARSE_SUCCESS when the tolerance was reached,
+ *         SPARSE_NOT_CONVERGED when the iteration limit was hit or the
+ *         method broke down (p_x then holds the last iterate), error code
+ *         on failure.
+ */
+sparse_error_code_t sparse_solve_operator(
+    const sparse_operator_t     *p_operator,
+    const sparse_operator_t     *p_precond,
+    const double                *p_b,
+    double                      *p_x,
+    const sparse_solve_params_t *p_params,
+    sparse_solve_stats_t        *p_stats);
+
+#endif // SPARSE_SOLVE_H
+
+/*** end of file ***/
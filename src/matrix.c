@@ -1,12 +1,17 @@
 /**
  * @file matrix.c
- * @brief Implementation of a matrix data structure using a dynamic array.
+ * @brief Implementation of a dense matrix data structure.
  *
- * This matrix is represented as a contiguous 1D dynamic array internally,
+ * This matrix is represented as a single contiguous buffer of `double`,
  * enabling efficient memory access and compact storage. Elements are laid out
  * in row-major order, which improves performance due to better cache locality
- * compared to pointer-based 2D grids. Matrix dimensions are flexible and
- * support resizing as needed.
+ * compared to pointer-based 2D grids, and allows kernels to stream whole rows
+ * with vector loads.
+ *
+ * Every kernel addresses rows through the leading dimension `ld` rather than
+ * `cols`, so a view of a block inside a larger buffer is just another
+ * matrix_t with a different p_data, rows, cols and ld. Nothing in this file
+ * assumes that rows are adjacent in memory.
  *
  * This matrix implementation stores elements as `double`, supporting
  * basic matrix operations such as create, destroy, set, get, find, and clone.
@@ -18,56 +23,555 @@
  * @author heapbadger
  */
 
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "matrix.h"
+#include "matrix_internal.h"
+#include "parallel.h"
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define ROW_MAJOR_IDX(row, col, ld) ((row) * (ld) + (col))
+
+/**
+ * Register block of the GEMM micro-kernel: GEMM_MR rows of A against GEMM_NR
+ * columns of B, which is two 4-wide vectors per row with AVX.
+ */
+#define GEMM_MR 4
+#define GEMM_NR 8
+
+/**
+ * Number of dot products or row updates the GEMV kernels keep in flight.
+ */
+#define GEMV_BLOCK 4
+
+/**
+ * Arguments shared by the GEMV range workers. Input vectors are the rows of
+ * p_x and outputs the rows of p_y; a single GEMV is a batch of one.
+ */
+typedef struct
+{
+    const matrix_t *p_matrix;
+    const double   *p_x;
+    size_t          ldx;
+    double         *p_y;
+    size_t          ldy;
+    double         *p_partial; /**< Per-band sums of the transposed GEMV. */
+    size_t          count;
+    size_t          parts;
+    double          alpha;
+    double          beta;
+} gemv_ctx_t;
+
+/**
+ * Arguments shared by the batched GEMM range workers, already reduced to a
+ * row-major product. Each work unit is one MATRIX_GEMM_MC row band of one
+ * product; bands is 1 when the batch alone keeps every thread busy. Part p
+ * owns the pack buffers at p_pack + p * pack_size.
+ */
+typedef struct
+{
+    const double *p_a;
+    const double *p_b;
+    double       *p_c;
+    double       *p_pack;
+    size_t        m;
+    size_t        n;
+    size_t        k;
+    size_t        lda;
+    size_t        ldb;
+    size_t        ldc;
+    size_t        stride_a;
+    size_t        stride_b;
+    size_t        stride_c;
+    size_t        bands;
+    size_t        units;
+    size_t        parts;
+    size_t        pack_size;
+    double        alpha;
+    double        beta;
+    bool          b_trans_a;
+    bool          b_trans_b;
+} gemm_batch_ctx_t;
+
+/**
+ * Matrix chain and the split points chosen by matrix_chain_multiply.
+ * Matrix idx is p_dims[idx] x p_dims[idx + 1], and the product of matrices
+ * first..last is split after p_split[first * count + last].
+ */
+typedef struct
+{
+    const matrix_t *const *pp_matrices;
+    const size_t          *p_dims;
+    const size_t          *p_split;
+    size_t                 count;
+} chain_plan_t;
+
+/**
+ * @brief Transpose a 4x4 block from p_src into p_dst.
+ *
+ * @param p_src Pointer to the top-left source element.
+ * @param lds Leading dimension (row stride) of the source.
+ * @param p_dst Pointer to the top-left destination element.
+ * @param ldd Leading dimension (row stride) of the destination.
+ */
+static void transpose_4x4(const double *p_src,
+                          size_t        lds,
+                          double       *p_dst,
+                          size_t        ldd);
+
+/**
+ * @brief Transpose a block small enough to be cache resident.
+ *
+ * @param p_src Pointer to the top-left source element.
+ * @param lds Leading dimension (row stride) of the source.
+ * @param p_dst Pointer to the top-left destination element.
+ * @param ldd Leading dimension (row stride) of the destination.
+ * @param rows Number of source rows in the block.
+ * @param cols Number of source columns in the block.
+ */
+static void transpose_tile(const double *p_src,
+                           size_t        lds,
+                           double       *p_dst,
+                           size_t        ldd,
+                           size_t        rows,
+                           size_t        cols);
+
+/**
+ * @brief Cache-oblivious out-of-place transpose.
+ *
+ * Recursively splits the larger dimension until the block fits in a tile.
+ *
+ * @param p_src Pointer to the top-left source element.
+ * @param lds Leading dimension (row stride) of the source.
+ * @param p_dst Pointer to the top-left destination element.
+ * @param ldd Leading dimension (row stride) of the destination.
+ * @param rows Number of source rows in the block.
+ * @param cols Number of source columns in the block.
+ */
+static void transpose_recursive(const double *p_src,
+                                size_t        lds,
+                                double       *p_dst,
+                                size_t        ldd,
+                                size_t        rows,
+                                size_t        cols);
+
+/**
+ * @brief In-place transpose of an n x n block of doubles.
+ *
+ * @param p_data Pointer to the first element.
+ * @param n Number of rows and columns.
+ * @param ld Leading dimension (row stride).
+ */
+static void transpose_square_inplace(double *p_data, size_t n, size_t ld);
+
+/**
+ * @brief In-place transpose of a contiguous rows x cols buffer by cycle
+ * following.
+ *
+ * @param p_data Pointer to the buffer.
+ * @param rows Number of rows before transposition.
+ * @param cols Number of columns before transposition.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+static matrix_error_code_t transpose_cycles_inplace(double *p_data,
+                                                    size_t  rows,
+                                                    size_t  cols);
+
+/**
+ * @brief Number of doubles gemm_blocked needs for its two pack buffers.
+ *
+ * @param m Number of rows of op(A) and C.
+ * @param n Number of columns of op(B) and C.
+ * @param k Inner dimension.
+ *
+ * @return Size of the A panel followed by the B panel, in elements.
+ */
+static size_t gemm_pack_size(size_t m, size_t n, size_t k);
+
+/**
+ * @brief Row-major C = alpha * op(A) * op(B) + beta * C with caller-owned
+ * pack buffers.
+ *
+ * Arguments are assumed valid. Single-threaded, so independent products
+ * can run concurrently with separate buffers.
+ *
+ * @param b_trans_a Whether A is stored transposed.
+ * @param b_trans_b Whether B is stored transposed.
+ * @param m Number of rows of op(A) and C.
+ * @param n Number of columns of op(B) and C.
+ * @param k Inner dimension.
+ * @param alpha Scale applied to op(A) * op(B).
+ * @param p_a Pointer to the first element of A as stored.
+ * @param lda Leading dimension of A.
+ * @param p_b Pointer to the first element of B as stored.
+ * @param ldb Leading dimension of B.
+ * @param beta Scale applied to C before accumulation.
+ * @param p_c Pointer to the first element of C.
+ * @param ldc Leading dimension of C.
+ * @param p_pack Buffer of at least gemm_pack_size(m, n, k) elements.
+ */
+static void gemm_blocked(bool          b_trans_a,
+                         bool          b_trans_b,
+                         size_t        m,
+                         size_t        n,
+                         size_t        k,
+                         double        alpha,
+                         const double *p_a,
+                         size_t        lda,
+                         const double *p_b,
+                         size_t        ldb,
+                         double        beta,
+                         double       *p_c,
+                         size_t        ldc,
+                         double       *p_pack);
+
+/**
+ * @brief parallel_for worker running a range of batched GEMM parts.
+ *
+ * @param begin First part.
+ * @param end One past the last part.
+ * @param p_ctx Pointer to a gemm_batch_ctx_t.
+ */
+static void gemm_batch_range(size_t begin, size_t end, void *p_ctx);
+
+/**
+ * @brief Pack an mc x kc block of A into GEMM_MR-row slivers.
+ *
+ * Rows past mc are zero padded so the micro-kernel never branches. Element
+ * (i, p) of the block is read from p_a[i * row_step + p * col_step], so a
+ * transposed A is packed by swapping the steps.
+ *
+ * @param mc Number of rows in the block.
+ * @param kc Number of columns in the block.
+ * @param p_a Pointer to the top-left element of the block.
+ * @param row_step Distance between rows of A.
+ * @param col_step Distance between columns of A.
+ * @param p_pack Destination buffer.
+ */
+static void gemm_pack_a(size_t        mc,
+                        size_t        kc,
+                        const double *p_a,
+                        size_t        row_step,
+                        size_t        col_step,
+                        double       *p_pack);
+
+/**
+ * @brief Pack a kc x nc block of B into GEMM_NR-column slivers.
+ *
+ * Columns past nc are zero padded so the micro-kernel never branches.
+ * Element (p, j) of the block is read from
+ * p_b[p * row_step + j * col_step].
+ *
+ * @param kc Number of rows in the block.
+ * @param nc Number of columns in the block.
+ * @param p_b Pointer to the top-left element of the block.
+ * @param row_step Distance between rows of B.
+ * @param col_step Distance between columns of B.
+ * @param p_pack Destination buffer.
+ */
+static void gemm_pack_b(size_t        kc,
+                        size_t        nc,
+                        const double *p_b,
+                        size_t        row_step,
+                        size_t        col_step,
+                        double       *p_pack);
+
+/**
+ * @brief Multiply one packed A sliver by one packed B sliver and accumulate
+ * alpha times the product into C.
+ *
+ * @param kc Depth of the slivers.
+ * @param alpha Scale applied to the product.
+ * @param p_a Packed GEMM_MR x kc sliver of A.
+ * @param p_b Packed kc x GEMM_NR sliver of B.
+ * @param p_c Pointer to the top-left element of the C block.
+ * @param ldc Leading dimension of C.
+ * @param mr Number of valid rows (<= GEMM_MR).
+ * @param nr Number of valid columns (<= GEMM_NR).
+ */
+static void gemm_micro_kernel(size_t        kc,
+                              double        alpha,
+                              const double *p_a,
+                              const double *p_b,
+                              double       *p_c,
+                              size_t        ldc,
+                              size_t        mr,
+                              size_t        nr);
+
+/**
+ * @brief Compute GEMV_BLOCK dot products of length n at once.
+ *
+ * Pointers may repeat, so the same row can be reduced against several
+ * vectors or the same vector against several rows.
+ *
+ * @param p_a Left operands.
+ * @param p_x Right operands.
+ * @param n Length of each operand.
+ * @param p_out Output for the GEMV_BLOCK sums.
+ */
+static void gemv_dot_block(const double *const p_a[GEMV_BLOCK],
+                           const double *const p_x[GEMV_BLOCK],
+                           size_t              n,
+                           double              p_out[GEMV_BLOCK]);
+
+/**
+ * @brief Add GEMV_BLOCK scaled rows into y, y += sum(coef[i] * a[i]).
+ *
+ * @param p_a Rows to add.
+ * @param p_coef Scale of each row.
+ * @param p_y Accumulator of length n.
+ * @param n Row length.
+ */
+static void gemv_axpy_block(const double *const p_a[GEMV_BLOCK],
+                            const double        p_coef[GEMV_BLOCK],
+                            double             *p_y,
+                            size_t              n);
+
+/**
+ * @brief parallel_func computing Y = alpha * X * A^T + beta * Y over a range
+ * of row bands of A.
+ */
+static void gemv_range(size_t begin, size_t end, void *p_ctx);
+
+/**
+ * @brief parallel_func accumulating alpha * A^T * x over a range of row bands
+ * of A. Band 0 adds into y, the others into their slot of p_partial.
+ */
+static void gemv_transposed_range(size_t begin, size_t end, void *p_ctx);
+
+/**
+ * @brief Number of row bands worth running for a GEMV.
+ *
+ * @param p_matrix Pointer to A.
+ * @param count Number of vectors multiplied per row.
+ *
+ * @return Band count in [1, rows].
+ */
+static size_t gemv_partition_count(const matrix_t *p_matrix, size_t count);
+
+/**
+ * @brief Scale n contiguous values by beta, writing zeros when beta is 0.0.
+ */
+static void gemv_scale(double *p_y, size_t n, double beta);
+
+/**
+ * @brief Blocked LU factorization with partial pivoting on a raw buffer.
+ *
+ * @param p_a Pointer to the n x n matrix, overwritten with the factors.
+ * @param n Matrix order.
+ * @param lda Leading dimension.
+ * @param p_pivots Output pivot rows.
+ * @param p_sign Output permutation parity.
+ *
+ * @return MATRIX_SUCCESS, MATRIX_SINGULAR, or an allocation error.
+ */
+static matrix_error_code_t lu_factor(double *p_a,
+                                     size_t  n,
+                                     size_t  lda,
+                                     size_t *p_pivots,
+                                     int    *p_sign);
+
+/**
+ * @brief Solve L * U * X = P * X in place on a raw buffer.
+ *
+ * @param p_lu Pointer to the packed n x n factors.
+ * @param ldlu Leading dimension of the factors.
+ * @param p_pivots Pivot rows produced by lu_factor.
+ * @param n Matrix order.
+ * @param p_x Right-hand sides on entry, solutions on exit (n x nrhs).
+ * @param nrhs Number of right-hand sides.
+ * @param ldx Leading dimension of X.
+ *
+ * @return MATRIX_SUCCESS, MATRIX_SINGULAR, or an allocation error.
+ */
+static matrix_error_code_t lu_solve(const double *p_lu,
+                                    size_t        ldlu,
+                                    const size_t *p_pivots,
+                                    size_t        n,
+                                    double       *p_x,
+                                    size_t        nrhs,
+                                    size_t        ldx);
 
-#define ROW_MAJOR_IDX(row, col, num_cols) ((row) * (num_cols) + (col))
+/**
+ * @brief Factor a square matrix into a freshly allocated LU copy.
+ *
+ * @param p_matrix Pointer to input square matrix.
+ * @param pp_lu Output for the allocated factors.
+ * @param pp_pivots Output for the allocated pivot array.
+ * @param p_sign Output permutation parity.
+ *
+ * @return MATRIX_SUCCESS or MATRIX_SINGULAR with outputs allocated, error
+ *         code otherwise.
+ */
+static matrix_error_code_t lu_factor_copy(const matrix_t *p_matrix,
+                                          matrix_t      **pp_lu,
+                                          size_t        **pp_pivots,
+                                          int            *p_sign);
+
+/**
+ * @brief Workspace needed to evaluate the product of matrices first..last.
+ *
+ * Mirrors chain_evaluate: the left temporary is held while the left operand
+ * is computed, and both temporaries while the right one is.
+ *
+ * @param p_plan Pointer to the chain plan.
+ * @param first Index of the first matrix.
+ * @param last Index of the last matrix.
+ *
+ * @return Number of doubles of workspace.
+ */
+static size_t chain_workspace(const chain_plan_t *p_plan,
+                              size_t              first,
+                              size_t              last);
 
 /**
- * @brief Convert an array module return code to a matrix module error code.
+ * @brief Compute the product of matrices first..last (first < last) into
+ *        p_out, using p_work as a stack for intermediate products.
  *
- * @param ret Return code from array function.
+ * @param p_plan Pointer to the chain plan.
+ * @param first Index of the first matrix.
+ * @param last Index of the last matrix.
+ * @param p_out Pointer to the output block, not overlapping any input.
+ * @param ldo Leading dimension of the output.
+ * @param p_work Workspace of chain_workspace(p_plan, first, last) doubles.
  *
- * @return Corresponding matrix_error_code_t.
+ * @return MATRIX_SUCCESS on success, error code on failure.
  */
-static matrix_error_code_t matrix_error_from_array(array_error_code_t ret);
+static matrix_error_code_t chain_evaluate(const chain_plan_t *p_plan,
+                                          size_t              first,
+                                          size_t              last,
+                                          double             *p_out,
+                                          size_t              ldo,
+                                          double             *p_work);
 
 /**
- * @brief Custom delete function for handling double data types.
+ * @brief Allocate a zeroed, MATRIX_ALIGNMENT aligned buffer for rows rows of
+ *        ld elements.
  *
- * @param p_data Pointer to the double type data.
+ * @param rows Number of rows.
+ * @param ld Row stride in elements.
+ * @param p_capacity Output for the number of elements allocated, which may
+ *                   exceed rows * ld after rounding.
+ *
+ * @return Pointer to the buffer, or NULL on overflow or allocation failure.
  */
-static void double_del(void *p_data);
+static double *matrix_alloc_data(size_t rows, size_t ld, size_t *p_capacity);
 
 /**
- * @brief Custom compare function for handling double data types.
+ * @brief Give an owned matrix a new shape with the padded stride of cols,
+ *        reusing its buffer when the capacity allows.
+ *
+ * @param p_matrix Pointer to the owned matrix.
+ * @param rows New number of rows.
+ * @param cols New number of columns.
+ * @param b_keep Preserve the common top-left block and zero the rest;
+ *               otherwise the contents are left unspecified.
  *
- * @param p_double_a Pointer to first double type value.
- * @param p_double_b Pointer to second double type value.
+ * @return MATRIX_SUCCESS on success, error code on failure.
  */
-static int double_cmp(const void *p_double_a, const void *p_double_b);
+static matrix_error_code_t matrix_restride(matrix_t *p_matrix,
+                                           size_t    rows,
+                                           size_t    cols,
+                                           bool      b_keep);
 
 /**
- * @brief Custom print function for handling double data types.
+ * @brief Leading dimension for reshaping an owned matrix to rows x cols.
  *
- * @param p_data Pointer to the double type data.
- * @param index Data index.
+ * @param p_matrix Pointer to the owned matrix whose buffer is reused.
+ * @param rows New number of rows.
+ * @param cols New number of columns.
+ *
+ * @return matrix_padded_ld(cols) if the padded shape fits in the buffer of
+ *         p_matrix, cols otherwise.
  */
-static void double_print(void *p_data, size_t index);
+static size_t matrix_reshaped_ld(const matrix_t *p_matrix,
+                                 size_t          rows,
+                                 size_t          cols);
 
 /**
- * @brief Custom copy function for handling double data types.
+ * @brief Compute p_result = alpha * A + beta * B element-wise.
+ *
+ * Each element is read before it is written, so p_result may share storage
+ * with A or B element for element. Partial overlaps are resolved through a
+ * temporary.
  *
- * @param p_data Pointer to the double type data.
+ * @param p_a Pointer to A.
+ * @param alpha Scale applied to A.
+ * @param p_b Pointer to B, or NULL to compute alpha * A only.
+ * @param beta Scale applied to B.
+ * @param p_result Pointer to the output, same dimensions as A.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
  */
-static void *double_cpy(const void *p_src);
+static matrix_error_code_t elementwise_combine(const matrix_t *p_a,
+                                               double          alpha,
+                                               const matrix_t *p_b,
+                                               double          beta,
+                                               matrix_t       *p_result);
 
 static bool matrix_is_same_row_size(const matrix_t *p_matrix_a,
                                     const matrix_t *p_matrix_b);
 static bool matrix_is_same_col_size(const matrix_t *p_matrix_a,
                                     const matrix_t *p_matrix_b);
 
+/**
+ * @brief Check whether two doubles are close in the sense of
+ * matrix_is_close.
+ */
+static bool close_scalar(double a, double b, double rtol, double atol);
+
+/**
+ * @brief Number of representable doubles between a and b.
+ *
+ * @return Distance, meaningless if either value is NaN.
+ */
+static uint64_t close_ulp_distance(double a, double b);
+
+/**
+ * @brief Check whether every element of a row is close to its partner.
+ *
+ * @param p_a First row.
+ * @param p_b Second row.
+ * @param cols Number of elements.
+ * @param rtol Relative tolerance.
+ * @param atol Absolute tolerance.
+ *
+ * @return true if all pairs are close, false at the first that is not.
+ */
+static bool close_row(const double *p_a,
+                      const double *p_b,
+                      size_t        cols,
+                      double        rtol,
+                      double        atol);
+
+/**
+ * @brief Check whether every element of a row is within max_ulps of its
+ * partner.
+ */
+static bool close_ulps_row(const double *p_a,
+                           const double *p_b,
+                           size_t        cols,
+                           uint64_t      max_ulps);
+
+/**
+ * @brief Index of the first element of a row close to key.
+ *
+ * @return Column index, or cols if no element is close.
+ */
+static size_t close_find_row(const double *p_row,
+                             size_t        cols,
+                             double        key,
+                             double        rtol,
+                             double        atol);
+
 matrix_t *
 matrix_create (size_t rows, size_t cols)
 {
@@ -85,25 +589,49 @@ matrix_create (size_t rows, size_t cols)
         return NULL;
     }
 
-    size_t cap       = rows * cols;
-    p_matrix->p_flat = array_create(cap,
-                                    (del_func)double_del,
-                                    (cmp_func)double_cmp,
-                                    (print_func)double_print,
-                                    (copy_func)double_cpy);
-    p_matrix->cols   = cols;
-    p_matrix->rows   = rows;
-    matrix_fill(p_matrix, 0.0);
+    size_t ld        = matrix_padded_ld(cols);
+    p_matrix->p_data = matrix_alloc_data(rows, ld, &p_matrix->capacity);
+
+    if (NULL == p_matrix->p_data)
+    {
+        free(p_matrix);
+        return NULL;
+    }
+
+    p_matrix->cols = cols;
+    p_matrix->rows = rows;
+    p_matrix->ld   = ld;
     return p_matrix;
 }
 
+size_t
+matrix_padded_ld (size_t cols)
+{
+    const size_t line = MATRIX_ALIGNMENT / sizeof(double);
+
+    // Narrow rows stay packed; huge ones are left for matrix_create to reject
+    if ((cols < line) || (cols > SIZE_MAX / 2U))
+    {
+        return cols;
+    }
+
+    size_t ld = ROUND_UP(cols, line);
+
+    if (0U == ((ld * sizeof(double)) % MATRIX_ALIAS_STRIDE))
+    {
+        ld += line;
+    }
+
+    return ld;
+}
+
 void
 matrix_destroy (matrix_t *p_matrix)
 {
-    if ((NULL != p_matrix) && (NULL != p_matrix->p_flat))
+    if ((NULL != p_matrix) && (false == p_matrix->b_view))
     {
-        array_destroy(p_matrix->p_flat);
-        p_matrix->p_flat = NULL;
+        free(p_matrix->p_data);
+        p_matrix->p_data = NULL;
         p_matrix->cols   = 0U;
         p_matrix->rows   = 0U;
         free(p_matrix);
@@ -111,53 +639,107 @@ matrix_destroy (matrix_t *p_matrix)
     }
 }
 
-void
-matrix_del_ele (matrix_t *p_matrix, void *p_data)
+matrix_error_code_t
+matrix_view (const matrix_t *p_matrix,
+             size_t          row,
+             size_t          col,
+             size_t          rows,
+             size_t          cols,
+             matrix_t       *p_view)
+{
+    return matrix_view_strided(p_matrix, row, col, rows, cols, 1U, p_view);
+}
+
+matrix_error_code_t
+matrix_view_strided (const matrix_t *p_matrix,
+                     size_t          row,
+                     size_t          col,
+                     size_t          rows,
+                     size_t          cols,
+                     size_t          row_step,
+                     matrix_t       *p_view)
 {
-    if ((NULL != p_matrix) && (NULL != p_data))
+    if ((NULL == p_matrix) || (NULL == p_matrix->p_data) || (NULL == p_view)
+        || (0U == rows) || (0U == cols) || (0U == row_step))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    // Last selected row is row + (rows - 1) * row_step; check without overflow
+    if ((row >= p_matrix->rows) || (col >= p_matrix->cols)
+        || (cols > p_matrix->cols - col)
+        || ((rows - 1U) > (p_matrix->rows - 1U - row) / row_step))
     {
-        array_del_ele(p_matrix->p_flat, p_data);
+        return MATRIX_OUT_OF_BOUNDS;
     }
+
+    p_view->rows     = rows;
+    p_view->cols     = cols;
+    p_view->ld       = p_matrix->ld * row_step;
+    p_view->capacity = 0U;
+    p_view->b_view   = true;
+    p_view->p_data = p_matrix->p_data + ROW_MAJOR_IDX(row, col, p_matrix->ld);
+    return MATRIX_SUCCESS;
 }
 
 matrix_error_code_t
-matrix_fill (matrix_t *p_matrix, double value)
+matrix_row_view (const matrix_t *p_matrix, size_t row, matrix_t *p_view)
 {
     if (NULL == p_matrix)
     {
         return MATRIX_INVALID_ARGUMENT;
     }
 
-    return matrix_error_from_array(
-        array_fill(p_matrix->p_flat, (void *)&value));
+    return matrix_view(p_matrix, row, 0U, 1U, p_matrix->cols, p_view);
 }
 
 matrix_error_code_t
-matrix_get (const matrix_t *p_matrix, size_t row, size_t col, double *p_out)
+matrix_column_view (const matrix_t *p_matrix, size_t col, matrix_t *p_view)
 {
-    if ((NULL == p_matrix) || (NULL == p_out))
+    if (NULL == p_matrix)
     {
         return MATRIX_INVALID_ARGUMENT;
     }
 
-    if ((row >= p_matrix->rows) || (col >= p_matrix->cols))
+    return matrix_view(p_matrix, 0U, col, p_matrix->rows, 1U, p_view);
+}
+
+matrix_error_code_t
+matrix_fill (matrix_t *p_matrix, double value)
+{
+    if ((NULL == p_matrix) || (NULL == p_matrix->p_data))
     {
-        return MATRIX_OUT_OF_BOUNDS;
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    for (size_t row = 0U; row < p_matrix->rows; ++row)
+    {
+        double *p_row = p_matrix->p_data + (row * p_matrix->ld);
+
+        for (size_t col = 0U; col < p_matrix->cols; ++col)
+        {
+            p_row[col] = value;
+        }
     }
 
-    matrix_error_code_t ret;
-    void               *p_val = NULL;
-    size_t              idx;
+    return MATRIX_SUCCESS;
+}
 
-    idx = ROW_MAJOR_IDX(row, col, p_matrix->cols);
-    ret = matrix_error_from_array(array_get(p_matrix->p_flat, idx, &p_val));
+matrix_error_code_t
+matrix_get (const matrix_t *p_matrix, size_t row, size_t col, double *p_out)
+{
+    if ((NULL == p_matrix) || (NULL == p_out))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
 
-    if ((MATRIX_SUCCESS == ret) && (NULL != p_val))
+    if ((row >= p_matrix->rows) || (col >= p_matrix->cols))
     {
-        *p_out = *(double *)p_val;
+        return MATRIX_OUT_OF_BOUNDS;
     }
 
-    return ret;
+    *p_out = p_matrix->p_data[ROW_MAJOR_IDX(row, col, p_matrix->ld)];
+    return MATRIX_SUCCESS;
 }
 
 matrix_error_code_t
@@ -173,55 +755,114 @@ matrix_set (matrix_t *p_matrix, size_t row, size_t col, double value)
         return MATRIX_OUT_OF_BOUNDS;
     }
 
-    double *p_val = calloc(1, sizeof(double));
+    p_matrix->p_data[ROW_MAJOR_IDX(row, col, p_matrix->ld)] = value;
+    return MATRIX_SUCCESS;
+}
+
+bool
+matrix_is_equal (const matrix_t *p_matrix_a, const matrix_t *p_matrix_b)
+{
+    // |a - b| <= 0 holds exactly when a == b
+    return matrix_is_close(p_matrix_a, p_matrix_b, 0.0, 0.0);
+}
 
-    if (NULL == p_val)
+bool
+matrix_is_close (const matrix_t *p_matrix_a,
+                 const matrix_t *p_matrix_b,
+                 double          rtol,
+                 double          atol)
+{
+    if ((NULL == p_matrix_a) && (NULL == p_matrix_b))
     {
-        return MATRIX_ALLOCATION_FAILURE;
+        return true;
     }
 
-    matrix_error_code_t ret;
-    size_t              idx = ROW_MAJOR_IDX(row, col, p_matrix->cols);
-    *p_val                  = value;
-    ret = matrix_error_from_array(array_set(p_matrix->p_flat, idx, p_val));
+    if ((NULL == p_matrix_a) || (NULL == p_matrix_b) || !(0.0 <= rtol)
+        || !(0.0 <= atol))
+    {
+        return false;
+    }
 
-    if (MATRIX_SUCCESS != ret)
+    if ((p_matrix_a->rows != p_matrix_b->rows)
+        || (p_matrix_a->cols != p_matrix_b->cols))
     {
-        free(p_val);
+        return false;
     }
 
-    return ret;
+    for (size_t row = 0U; row < p_matrix_a->rows; ++row)
+    {
+        if (false
+            == close_row(p_matrix_a->p_data + (row * p_matrix_a->ld),
+                         p_matrix_b->p_data + (row * p_matrix_b->ld),
+                         p_matrix_a->cols,
+                         rtol,
+                         atol))
+        {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 bool
-matrix_is_equal (const matrix_t *p_matrix_a, const matrix_t *p_matrix_b)
+matrix_is_close_ulps (const matrix_t *p_matrix_a,
+                      const matrix_t *p_matrix_b,
+                      uint64_t        max_ulps)
 {
     if ((NULL == p_matrix_a) && (NULL == p_matrix_b))
     {
         return true;
     }
 
-    if ((NULL == p_matrix_a) || (NULL == p_matrix_b))
+    if ((NULL == p_matrix_a) || (NULL == p_matrix_b)
+        || (p_matrix_a->rows != p_matrix_b->rows)
+        || (p_matrix_a->cols != p_matrix_b->cols))
     {
         return false;
     }
 
-    if ((p_matrix_a->rows != p_matrix_b->rows)
-        || (p_matrix_a->cols != p_matrix_b->cols))
+    for (size_t row = 0U; row < p_matrix_a->rows; ++row)
     {
-        return false;
+        if (false
+            == close_ulps_row(p_matrix_a->p_data + (row * p_matrix_a->ld),
+                              p_matrix_b->p_data + (row * p_matrix_b->ld),
+                              p_matrix_a->cols,
+                              max_ulps))
+        {
+            return false;
+        }
     }
 
-    return array_is_equal(p_matrix_a->p_flat, p_matrix_b->p_flat);
+    return true;
 }
 
 void
 matrix_print (const matrix_t *p_matrix)
 {
-    if (NULL != p_matrix)
+    if ((NULL == p_matrix) || (NULL == p_matrix->p_data))
+    {
+        return;
+    }
+
+    size_t count = p_matrix->rows * p_matrix->cols;
+    printf("[");
+
+    for (size_t idx = 0U; idx < count; ++idx)
     {
-        array_print(p_matrix->p_flat);
+        size_t row = idx / p_matrix->cols;
+        size_t col = idx % p_matrix->cols;
+        printf("(%zu: %f)",
+               idx,
+               p_matrix->p_data[ROW_MAJOR_IDX(row, col, p_matrix->ld)]);
+
+        if (idx < count - 1U)
+        {
+            printf(", ");
+        }
     }
+
+    printf("]\n");
 }
 
 matrix_error_code_t
@@ -251,18 +892,37 @@ matrix_column_size (const matrix_t *p_matrix, size_t *p_size)
 matrix_error_code_t
 matrix_find (const matrix_t *p_matrix, double key, size_t *p_row, size_t *p_col)
 {
-    if ((NULL == p_matrix) || (NULL == p_row) || (NULL == p_col))
+    return matrix_find_close(p_matrix, key, 0.0, 0.0, p_row, p_col);
+}
+
+matrix_error_code_t
+matrix_find_close (const matrix_t *p_matrix,
+                   double          key,
+                   double          rtol,
+                   double          atol,
+                   size_t         *p_row,
+                   size_t         *p_col)
+{
+    if ((NULL == p_matrix) || (NULL == p_row) || (NULL == p_col)
+        || !(0.0 <= rtol) || !(0.0 <= atol))
     {
         return MATRIX_INVALID_ARGUMENT;
     }
 
-    size_t flat_idx = 0;
-
-    if (ARRAY_SUCCESS == array_find(p_matrix->p_flat, (void *)&key, &flat_idx))
+    for (size_t row = 0U; row < p_matrix->rows; ++row)
     {
-        *p_row = flat_idx / p_matrix->cols;
-        *p_col = flat_idx % p_matrix->cols;
-        return MATRIX_SUCCESS;
+        size_t col = close_find_row(p_matrix->p_data + (row * p_matrix->ld),
+                                    p_matrix->cols,
+                                    key,
+                                    rtol,
+                                    atol);
+
+        if (col < p_matrix->cols)
+        {
+            *p_row = row;
+            *p_col = col;
+            return MATRIX_SUCCESS;
+        }
     }
 
     return MATRIX_NOT_FOUND;
@@ -275,13 +935,16 @@ matrix_clone (const matrix_t *p_ori)
 
     if (NULL != p_ori)
     {
-        p_new = (matrix_t *)calloc(1U, sizeof(matrix_t));
+        p_new = matrix_create(p_ori->rows, p_ori->cols);
 
         if (NULL != p_new)
         {
-            p_new->cols   = p_ori->cols;
-            p_new->rows   = p_ori->rows;
-            p_new->p_flat = array_clone(p_ori->p_flat);
+            matrix_copy_block(p_ori->p_data,
+                              p_ori->ld,
+                              p_new->p_data,
+                              p_new->ld,
+                              p_ori->rows,
+                              p_ori->cols);
         }
     }
 
@@ -289,134 +952,2411 @@ matrix_clone (const matrix_t *p_ori)
 }
 
 matrix_error_code_t
-matrix_add (const matrix_t *p_matrix_a,
-            const matrix_t *p_matrix_b,
-            matrix_t       *p_result)
+matrix_copy_into (matrix_t *p_dst, const matrix_t *p_src)
 {
-    if ((NULL == p_matrix_a) || (NULL == p_matrix_b) || (NULL == p_result)
-        || (false == matrix_is_same_col_size(p_matrix_a, p_matrix_b))
-        || (false == matrix_is_same_row_size(p_matrix_a, p_matrix_b)))
+    if ((NULL == p_dst) || (NULL == p_src) || (NULL == p_src->p_data)
+        || (NULL == p_dst->p_data))
     {
         return MATRIX_INVALID_ARGUMENT;
     }
 
+    if (p_dst == p_src)
+    {
+        return MATRIX_SUCCESS;
+    }
+
+    if (matrix_is_overlapping(p_src, p_dst))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if ((p_dst->rows != p_src->rows) || (p_dst->cols != p_src->cols))
+    {
+        matrix_error_code_t ret
+            = matrix_restride(p_dst, p_src->rows, p_src->cols, false);
+
+        if (MATRIX_SUCCESS != ret)
+        {
+            return ret;
+        }
+    }
+
+    matrix_copy_block(p_src->p_data,
+                      p_src->ld,
+                      p_dst->p_data,
+                      p_dst->ld,
+                      p_src->rows,
+                      p_src->cols);
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_reshape (matrix_t *p_matrix, size_t rows, size_t cols)
+{
+    if ((NULL == p_matrix) || (NULL == p_matrix->p_data) || (0U == rows)
+        || (0U == cols) || (rows > SIZE_MAX / cols)
+        || ((rows * cols) != (p_matrix->rows * p_matrix->cols)))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    // Contiguous rows already are the flat element sequence
+    if ((p_matrix->ld == p_matrix->cols) || (1U == p_matrix->rows))
+    {
+        p_matrix->rows = rows;
+        p_matrix->cols = cols;
+        p_matrix->ld   = cols;
+        return MATRIX_SUCCESS;
+    }
+
+    if (p_matrix->b_view)
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    // Squeeze out the padding, then spread the rows to the new stride
+    double *p_data = p_matrix->p_data;
+    size_t  ld     = matrix_reshaped_ld(p_matrix, rows, cols);
+
+    matrix_copy_block(p_data,
+                      p_matrix->ld,
+                      p_data,
+                      p_matrix->cols,
+                      p_matrix->rows,
+                      p_matrix->cols);
+    matrix_copy_block(p_data, cols, p_data, ld, rows, cols);
+    p_matrix->rows = rows;
+    p_matrix->cols = cols;
+    p_matrix->ld   = ld;
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_resize (matrix_t *p_matrix, size_t rows, size_t cols)
+{
+    if ((NULL == p_matrix) || (NULL == p_matrix->p_data) || (0U == rows)
+        || (0U == cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if ((rows == p_matrix->rows) && (cols == p_matrix->cols))
+    {
+        return MATRIX_SUCCESS;
+    }
+
+    return matrix_restride(p_matrix, rows, cols, true);
+}
+
+matrix_error_code_t
+matrix_add (const matrix_t *p_matrix_a,
+            const matrix_t *p_matrix_b,
+            matrix_t       *p_result)
+{
+    if ((NULL == p_matrix_a) || (NULL == p_matrix_b) || (NULL == p_result)
+        || (false == matrix_is_same_col_size(p_matrix_a, p_matrix_b))
+        || (false == matrix_is_same_row_size(p_matrix_a, p_matrix_b))
+        || (p_result->rows != p_matrix_a->rows)
+        || (p_result->cols != p_matrix_a->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    return elementwise_combine(p_matrix_a, 1.0, p_matrix_b, 1.0, p_result);
+}
+
+matrix_error_code_t
+matrix_subtract (const matrix_t *p_matrix_a,
+                 const matrix_t *p_matrix_b,
+                 matrix_t       *p_result)
+{
+    if ((NULL == p_matrix_a) || (NULL == p_matrix_b) || (NULL == p_result)
+        || (false == matrix_is_same_col_size(p_matrix_a, p_matrix_b))
+        || (false == matrix_is_same_row_size(p_matrix_a, p_matrix_b))
+        || (p_result->rows != p_matrix_a->rows)
+        || (p_result->cols != p_matrix_a->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    return elementwise_combine(p_matrix_a, 1.0, p_matrix_b, -1.0, p_result);
+}
+
+matrix_error_code_t
+matrix_multiply (const matrix_t *p_matrix_a,
+                 const matrix_t *p_matrix_b,
+                 matrix_t       *p_result)
+{
+    return matrix_multiply_ex(
+        p_matrix_a, MATRIX_OP_NONE, p_matrix_b, MATRIX_OP_NONE, p_result);
+}
+
+matrix_error_code_t
+matrix_multiply_ex (const matrix_t *p_matrix_a,
+                    matrix_op_t     op_a,
+                    const matrix_t *p_matrix_b,
+                    matrix_op_t     op_b,
+                    matrix_t       *p_result)
+{
+    if ((NULL == p_matrix_a) || (NULL == p_matrix_b) || (NULL == p_result))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    bool   b_trans_a = (MATRIX_OP_TRANSPOSE == op_a);
+    bool   b_trans_b = (MATRIX_OP_TRANSPOSE == op_b);
+
+    size_t m = b_trans_a ? p_matrix_a->cols : p_matrix_a->rows;
+    size_t k = b_trans_a ? p_matrix_a->rows : p_matrix_a->cols;
+    size_t n = b_trans_b ? p_matrix_b->rows : p_matrix_b->cols;
+
+    if ((k != (b_trans_b ? p_matrix_b->cols : p_matrix_b->rows))
+        || (m != p_result->rows) || (n != p_result->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    // GEMM must not write to its own inputs, so alias through workspace
+    if (matrix_is_overlapping(p_result, p_matrix_a)
+        || matrix_is_overlapping(p_result, p_matrix_b))
+    {
+        matrix_t *p_work = matrix_create(p_result->rows, p_result->cols);
+
+        if (NULL == p_work)
+        {
+            return MATRIX_ALLOCATION_FAILURE;
+        }
+
+        matrix_error_code_t ret
+            = matrix_multiply_ex(p_matrix_a, op_a, p_matrix_b, op_b, p_work);
+
+        if (MATRIX_SUCCESS == ret)
+        {
+            matrix_copy_block(p_work->p_data,
+                              p_work->ld,
+                              p_result->p_data,
+                              p_result->ld,
+                              p_result->rows,
+                              p_result->cols);
+        }
+
+        matrix_destroy(p_work);
+        return ret;
+    }
+
+    return matrix_gemm_ex(MATRIX_LAYOUT_ROW_MAJOR,
+                          op_a,
+                          op_b,
+                          m,
+                          n,
+                          k,
+                          1.0,
+                          p_matrix_a->p_data,
+                          p_matrix_a->ld,
+                          p_matrix_b->p_data,
+                          p_matrix_b->ld,
+                          0.0,
+                          p_result->p_data,
+                          p_result->ld);
+}
+
+matrix_error_code_t
+matrix_pow (const matrix_t *p_matrix, size_t exponent, matrix_t *p_result)
+{
+    if ((NULL == p_matrix) || (NULL == p_result)
+        || (p_matrix->rows != p_matrix->cols)
+        || (p_result->rows != p_matrix->rows)
+        || (p_result->cols != p_matrix->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t n = p_matrix->rows;
+
+    if (0U == exponent)
+    {
+        for (size_t row = 0U; row < n; ++row)
+        {
+            double *p_row = &p_result->p_data[row * p_result->ld];
+
+            memset(p_row, 0, n * sizeof(double));
+            p_row[row] = 1.0;
+        }
+
+        return MATRIX_SUCCESS;
+    }
+
+    // The product ping-pongs between p_result and p_work; A itself is read
+    // from a private copy when p_result would overwrite it
+    bool    b_alias = matrix_is_overlapping(p_matrix, p_result);
+    double *p_work  = (double *)malloc((b_alias ? 2U : 1U) * n * n
+                                      * sizeof(double));
+
+    if (NULL == p_work)
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    const double *p_base  = p_matrix->p_data;
+    size_t        ld_base = p_matrix->ld;
+
+    if (b_alias)
+    {
+        matrix_copy_block(
+            p_matrix->p_data, p_matrix->ld, &p_work[n * n], n, n, n);
+        p_base  = &p_work[n * n];
+        ld_base = n;
+    }
+
+    double *p_buf[2] = { p_result->p_data, p_work };
+    size_t  ld[2]    = { p_result->ld, n };
+    size_t  top      = 0U;
+    size_t  products = 0U;
+
+    for (size_t bits = exponent; bits > 1U; bits >>= 1)
+    {
+        top += 1U;
+        products += (bits & 1U);
+    }
+
+    // Each squaring and each extra multiply flips buffers; start where an
+    // even number of flips ends in p_result
+    size_t cur = (top + products) & 1U;
+    matrix_copy_block(p_base, ld_base, p_buf[cur], ld[cur], n, n);
+    matrix_error_code_t ret = MATRIX_SUCCESS;
+
+    for (size_t bit = top; (bit > 0U) && (MATRIX_SUCCESS == ret); --bit)
+    {
+        ret = matrix_gemm(n,
+                          n,
+                          n,
+                          1.0,
+                          p_buf[cur],
+                          ld[cur],
+                          p_buf[cur],
+                          ld[cur],
+                          0.0,
+                          p_buf[cur ^ 1U],
+                          ld[cur ^ 1U]);
+        cur ^= 1U;
+
+        if ((MATRIX_SUCCESS == ret) && (0U != ((exponent >> (bit - 1U)) & 1U)))
+        {
+            ret = matrix_gemm(n,
+                              n,
+                              n,
+                              1.0,
+                              p_buf[cur],
+                              ld[cur],
+                              p_base,
+                              ld_base,
+                              0.0,
+                              p_buf[cur ^ 1U],
+                              ld[cur ^ 1U]);
+            cur ^= 1U;
+        }
+    }
+
+    free(p_work);
+    return ret;
+}
+
+matrix_error_code_t
+matrix_chain_multiply (const matrix_t *const *pp_matrices,
+                       size_t                 count,
+                       matrix_t              *p_result)
+{
+    if ((NULL == pp_matrices) || (0U == count) || (NULL == p_result))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    for (size_t idx = 0U; idx < count; ++idx)
+    {
+        if ((NULL == pp_matrices[idx])
+            || ((idx > 0U)
+                && (pp_matrices[idx - 1U]->cols != pp_matrices[idx]->rows)))
+        {
+            return MATRIX_INVALID_ARGUMENT;
+        }
+    }
+
+    if ((p_result->rows != pp_matrices[0]->rows)
+        || (p_result->cols != pp_matrices[count - 1U]->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if (2U == count)
+    {
+        return matrix_multiply(pp_matrices[0], pp_matrices[1], p_result);
+    }
+
+    if ((1U == count) && matrix_is_same_storage(p_result, pp_matrices[0]))
+    {
+        return MATRIX_SUCCESS;
+    }
+
+    for (size_t idx = 0U; idx < count; ++idx)
+    {
+        if (matrix_is_overlapping(p_result, pp_matrices[idx]))
+        {
+            matrix_t *p_work = matrix_create(p_result->rows, p_result->cols);
+
+            if (NULL == p_work)
+            {
+                return MATRIX_ALLOCATION_FAILURE;
+            }
+
+            matrix_error_code_t ret
+                = matrix_chain_multiply(pp_matrices, count, p_work);
+
+            if (MATRIX_SUCCESS == ret)
+            {
+                matrix_copy_block(p_work->p_data,
+                                  p_work->ld,
+                                  p_result->p_data,
+                                  p_result->ld,
+                                  p_result->rows,
+                                  p_result->cols);
+            }
+
+            matrix_destroy(p_work);
+            return ret;
+        }
+    }
+
+    if (1U == count)
+    {
+        return matrix_copy_into(p_result, pp_matrices[0]);
+    }
+
+    matrix_error_code_t ret     = MATRIX_ALLOCATION_FAILURE;
+    size_t             *p_dims  = malloc((count + 1U) * sizeof(size_t));
+    size_t             *p_split = malloc(count * count * sizeof(size_t));
+    double             *p_cost  = malloc(count * count * sizeof(double));
+    double             *p_work  = NULL;
+
+    if ((NULL == p_dims) || (NULL == p_split) || (NULL == p_cost))
+    {
+        goto CLEANUP;
+    }
+
+    for (size_t idx = 0U; idx < count; ++idx)
+    {
+        p_dims[idx] = pp_matrices[idx]->rows;
+    }
+
+    p_dims[count] = pp_matrices[count - 1U]->cols;
+
+    // p_cost[first * count + last] is the fewest multiply-adds for the
+    // product of matrices first..last; costs are doubles so huge chains
+    // cannot overflow
+    for (size_t idx = 0U; idx < count; ++idx)
+    {
+        p_cost[(idx * count) + idx] = 0.0;
+    }
+
+    for (size_t len = 2U; len <= count; ++len)
+    {
+        for (size_t first = 0U; first + len <= count; ++first)
+        {
+            size_t last = first + len - 1U;
+            double best = INFINITY;
+
+            for (size_t split = first; split < last; ++split)
+            {
+                double cost = p_cost[(first * count) + split]
+                              + p_cost[((split + 1U) * count) + last]
+                              + ((double)p_dims[first]
+                                 * (double)p_dims[split + 1U]
+                                 * (double)p_dims[last + 1U]);
+
+                if (cost < best)
+                {
+                    best                            = cost;
+                    p_split[(first * count) + last] = split;
+                }
+            }
+
+            p_cost[(first * count) + last] = best;
+        }
+    }
+
+    chain_plan_t plan = {
+        .pp_matrices = pp_matrices,
+        .p_dims      = p_dims,
+        .p_split     = p_split,
+        .count       = count,
+    };
+    size_t workspace = chain_workspace(&plan, 0U, count - 1U);
+
+    // Workspace is at least one intermediate product, never empty
+    p_work = (double *)malloc(workspace * sizeof(double));
+
+    if (NULL == p_work)
+    {
+        goto CLEANUP;
+    }
+
+    ret = chain_evaluate(
+        &plan, 0U, count - 1U, p_result->p_data, p_result->ld, p_work);
+
+CLEANUP:
+    free(p_dims);
+    free(p_split);
+    free(p_cost);
+    free(p_work);
+    return ret;
+}
+
+matrix_error_code_t
+matrix_gemm (size_t        m,
+             size_t        n,
+             size_t        k,
+             double        alpha,
+             const double *p_a,
+             size_t        lda,
+             const double *p_b,
+             size_t        ldb,
+             double        beta,
+             double       *p_c,
+             size_t        ldc)
+{
+    return matrix_gemm_ex(MATRIX_LAYOUT_ROW_MAJOR,
+                          MATRIX_OP_NONE,
+                          MATRIX_OP_NONE,
+                          m,
+                          n,
+                          k,
+                          alpha,
+                          p_a,
+                          lda,
+                          p_b,
+                          ldb,
+                          beta,
+                          p_c,
+                          ldc);
+}
+
+matrix_error_code_t
+matrix_gemm_ex (matrix_layout_t layout,
+                matrix_op_t     op_a,
+                matrix_op_t     op_b,
+                size_t          m,
+                size_t          n,
+                size_t          k,
+                double          alpha,
+                const double   *p_a,
+                size_t          lda,
+                const double   *p_b,
+                size_t          ldb,
+                double          beta,
+                double         *p_c,
+                size_t          ldc)
+{
+    if (((MATRIX_LAYOUT_ROW_MAJOR != layout)
+         && (MATRIX_LAYOUT_COL_MAJOR != layout))
+        || ((MATRIX_OP_NONE != op_a) && (MATRIX_OP_TRANSPOSE != op_a))
+        || ((MATRIX_OP_NONE != op_b) && (MATRIX_OP_TRANSPOSE != op_b)))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    // A column-major buffer read row-major is the transpose, and
+    // C^T = op(B)^T * op(A)^T, so swapping the operands and m with n turns
+    // a column-major product into a row-major one with the same flags
+    if (MATRIX_LAYOUT_COL_MAJOR == layout)
+    {
+        return matrix_gemm_ex(MATRIX_LAYOUT_ROW_MAJOR,
+                              op_b,
+                              op_a,
+                              n,
+                              m,
+                              k,
+                              alpha,
+                              p_b,
+                              ldb,
+                              p_a,
+                              lda,
+                              beta,
+                              p_c,
+                              ldc);
+    }
+
+    bool   b_trans_a = (MATRIX_OP_TRANSPOSE == op_a);
+    bool   b_trans_b = (MATRIX_OP_TRANSPOSE == op_b);
+    size_t a_cols    = b_trans_a ? m : k;
+    size_t b_cols    = b_trans_b ? k : n;
+
+    if ((NULL == p_c) || (ldc < n)
+        || ((0U < k)
+            && ((NULL == p_a) || (NULL == p_b) || (lda < a_cols)
+                || (ldb < b_cols))))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t  pack_size = gemm_pack_size(m, n, k);
+    double *p_pack    = (double *)malloc(pack_size * sizeof(double));
+
+    if ((0U < pack_size) && (NULL == p_pack))
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    gemm_blocked(b_trans_a,
+                 b_trans_b,
+                 m,
+                 n,
+                 k,
+                 alpha,
+                 p_a,
+                 lda,
+                 p_b,
+                 ldb,
+                 beta,
+                 p_c,
+                 ldc,
+                 p_pack);
+    free(p_pack);
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_gemm_batched_strided (matrix_layout_t layout,
+                             matrix_op_t     op_a,
+                             matrix_op_t     op_b,
+                             size_t          m,
+                             size_t          n,
+                             size_t          k,
+                             double          alpha,
+                             const double   *p_a,
+                             size_t          lda,
+                             size_t          stride_a,
+                             const double   *p_b,
+                             size_t          ldb,
+                             size_t          stride_b,
+                             double          beta,
+                             double         *p_c,
+                             size_t          ldc,
+                             size_t          stride_c,
+                             size_t          batch_count)
+{
+    if (((MATRIX_LAYOUT_ROW_MAJOR != layout)
+         && (MATRIX_LAYOUT_COL_MAJOR != layout))
+        || ((MATRIX_OP_NONE != op_a) && (MATRIX_OP_TRANSPOSE != op_a))
+        || ((MATRIX_OP_NONE != op_b) && (MATRIX_OP_TRANSPOSE != op_b)))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    // Same reduction to row-major as matrix_gemm_ex
+    if (MATRIX_LAYOUT_COL_MAJOR == layout)
+    {
+        return matrix_gemm_batched_strided(MATRIX_LAYOUT_ROW_MAJOR,
+                                           op_b,
+                                           op_a,
+                                           n,
+                                           m,
+                                           k,
+                                           alpha,
+                                           p_b,
+                                           ldb,
+                                           stride_b,
+                                           p_a,
+                                           lda,
+                                           stride_a,
+                                           beta,
+                                           p_c,
+                                           ldc,
+                                           stride_c,
+                                           batch_count);
+    }
+
+    bool   b_trans_a = (MATRIX_OP_TRANSPOSE == op_a);
+    bool   b_trans_b = (MATRIX_OP_TRANSPOSE == op_b);
+    size_t a_cols    = b_trans_a ? m : k;
+    size_t b_cols    = b_trans_b ? k : n;
+
+    if ((0U == batch_count) || (0U == m) || (0U == n))
+    {
+        return MATRIX_SUCCESS;
+    }
+
+    // Outputs must not overlap; inputs may, and a stride of 0 shares one
+    // operand across the whole batch
+    if ((NULL == p_c) || (ldc < n)
+        || ((1U < batch_count) && (stride_c < (((m - 1U) * ldc) + n)))
+        || ((0U < k)
+            && ((NULL == p_a) || (NULL == p_b) || (lda < a_cols)
+                || (ldb < b_cols))))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    gemm_batch_ctx_t ctx = { 0 };
+    ctx.p_a              = p_a;
+    ctx.p_b              = p_b;
+    ctx.p_c              = p_c;
+    ctx.m                = m;
+    ctx.n                = n;
+    ctx.k                = k;
+    ctx.lda              = lda;
+    ctx.ldb              = ldb;
+    ctx.ldc              = ldc;
+    ctx.stride_a         = stride_a;
+    ctx.stride_b         = stride_b;
+    ctx.stride_c         = stride_c;
+    ctx.alpha            = alpha;
+    ctx.beta             = beta;
+    ctx.b_trans_a        = b_trans_a;
+    ctx.b_trans_b        = b_trans_b;
+    ctx.pack_size        = gemm_pack_size(MIN(m, (size_t)MATRIX_GEMM_MC), n, k);
+
+    // Only work / MATRIX_GEMM_PARALLEL_MIN matters, so the multiply-add count
+    // saturates instead of wrapping; m * n cannot wrap since C holds it
+    size_t depth = (0U == k) ? 1U : k;
+    size_t work  = m * n;
+    work = (depth > (SIZE_MAX / work)) ? SIZE_MAX : (work * depth);
+    work = (batch_count > (SIZE_MAX / work)) ? SIZE_MAX : (work * batch_count);
+
+    // Small batches of tall products also split each product into row
+    // bands, so the threads the batch cannot fill work inside the products
+    size_t threads = parallel_get_threads();
+    ctx.bands = (batch_count < threads) ? ((m + MATRIX_GEMM_MC - 1U)
+                                           / MATRIX_GEMM_MC)
+                                        : 1U;
+    ctx.units = batch_count * ctx.bands;
+    ctx.parts = MIN(MIN(threads, ctx.units), work / MATRIX_GEMM_PARALLEL_MIN);
+    ctx.parts = (0U == ctx.parts) ? 1U : ctx.parts;
+
+    ctx.p_pack = (double *)malloc(ctx.parts * ctx.pack_size * sizeof(double));
+
+    if ((0U < ctx.pack_size) && (NULL == ctx.p_pack))
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    parallel_for(ctx.parts, 1U, gemm_batch_range, &ctx);
+    free(ctx.p_pack);
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_gemv (const matrix_t *p_matrix,
+             double          alpha,
+             const double   *p_x,
+             double          beta,
+             double         *p_y)
+{
+    if ((NULL == p_matrix) || (NULL == p_x) || (NULL == p_y))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if (0.0 == alpha)
+    {
+        gemv_scale(p_y, p_matrix->rows, beta);
+        return MATRIX_SUCCESS;
+    }
+
+    gemv_ctx_t ctx = { 0 };
+    ctx.p_matrix   = p_matrix;
+    ctx.p_x        = p_x;
+    ctx.ldx        = p_matrix->cols;
+    ctx.p_y        = p_y;
+    ctx.ldy        = p_matrix->rows;
+    ctx.count      = 1U;
+    ctx.alpha      = alpha;
+    ctx.beta       = beta;
+    ctx.parts      = gemv_partition_count(p_matrix, 1U);
+    parallel_for(ctx.parts, 1U, gemv_range, &ctx);
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_gemv_transposed (const matrix_t *p_matrix,
+                        double          alpha,
+                        const double   *p_x,
+                        double          beta,
+                        double         *p_y)
+{
+    if ((NULL == p_matrix) || (NULL == p_x) || (NULL == p_y))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t cols = p_matrix->cols;
+    gemv_scale(p_y, cols, beta);
+
+    if (0.0 == alpha)
+    {
+        return MATRIX_SUCCESS;
+    }
+
+    gemv_ctx_t ctx = { 0 };
+    ctx.p_matrix   = p_matrix;
+    ctx.p_x        = p_x;
+    ctx.p_y        = p_y;
+    ctx.alpha      = alpha;
+    ctx.parts      = gemv_partition_count(p_matrix, 1U);
+
+    // Band 0 accumulates straight into y; without scratch, stay on one band
+    if (1U < ctx.parts)
+    {
+        ctx.p_partial
+            = (double *)malloc((ctx.parts - 1U) * cols * sizeof(double));
+        ctx.parts = (NULL == ctx.p_partial) ? 1U : ctx.parts;
+    }
+
+    parallel_for(ctx.parts, 1U, gemv_transposed_range, &ctx);
+
+    for (size_t part = 1U; part < ctx.parts; ++part)
+    {
+        const double *p_sum = ctx.p_partial + ((part - 1U) * cols);
+
+        for (size_t col = 0U; col < cols; ++col)
+        {
+            p_y[col] += p_sum[col];
+        }
+    }
+
+    free(ctx.p_partial);
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_gemv_batched (const matrix_t *p_matrix,
+                     double          alpha,
+                     const matrix_t *p_x,
+                     double          beta,
+                     matrix_t       *p_y)
+{
+    if ((NULL == p_matrix) || (NULL == p_x) || (NULL == p_y)
+        || (p_y == p_x) || (p_y == p_matrix)
+        || (p_x->cols != p_matrix->cols) || (p_y->cols != p_matrix->rows)
+        || (p_x->rows != p_y->rows))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if (0.0 == alpha)
+    {
+        for (size_t vec = 0U; vec < p_y->rows; ++vec)
+        {
+            gemv_scale(p_y->p_data + (vec * p_y->ld), p_y->cols, beta);
+        }
+
+        return MATRIX_SUCCESS;
+    }
+
+    gemv_ctx_t ctx = { 0 };
+    ctx.p_matrix   = p_matrix;
+    ctx.p_x        = p_x->p_data;
+    ctx.ldx        = p_x->ld;
+    ctx.p_y        = p_y->p_data;
+    ctx.ldy        = p_y->ld;
+    ctx.count      = p_x->rows;
+    ctx.alpha      = alpha;
+    ctx.beta       = beta;
+    ctx.parts      = gemv_partition_count(p_matrix, ctx.count);
+    parallel_for(ctx.parts, 1U, gemv_range, &ctx);
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_scalar_multiply (const matrix_t *p_matrix,
+                        double          scalar,
+                        matrix_t       *p_result)
+{
+    if ((NULL == p_matrix) || (NULL == p_result)
+        || (p_result->rows != p_matrix->rows)
+        || (p_result->cols != p_matrix->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    return elementwise_combine(p_matrix, scalar, NULL, 0.0, p_result);
+}
+
+matrix_error_code_t
+matrix_transpose (const matrix_t *p_matrix, matrix_t *p_result)
+{
+    if ((NULL == p_matrix) || (NULL == p_result))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    bool b_self = (p_matrix == p_result);
+
+    if ((!b_self)
+        && ((p_matrix->rows != p_result->cols)
+            || (p_matrix->cols != p_result->rows)))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if (b_self && (p_matrix->rows == p_matrix->cols))
+    {
+        transpose_square_inplace(
+            p_result->p_data, p_result->rows, p_result->ld);
+        return MATRIX_SUCCESS;
+    }
+
+    // Swapping the dimensions is only meaningful for an owned buffer
+    if (b_self && p_result->b_view)
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if (!matrix_is_overlapping(p_matrix, p_result))
+    {
+        transpose_recursive(p_matrix->p_data,
+                            p_matrix->ld,
+                            p_result->p_data,
+                            p_result->ld,
+                            p_matrix->rows,
+                            p_matrix->cols);
+        return MATRIX_SUCCESS;
+    }
+
+    size_t  rows   = p_matrix->rows;
+    size_t  cols   = p_matrix->cols;
+    double *p_work = (double *)malloc(rows * cols * sizeof(double));
+
+    if (NULL == p_work)
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    transpose_recursive(
+        p_matrix->p_data, p_matrix->ld, p_work, rows, rows, cols);
+
+    if (b_self)
+    {
+        p_result->ld   = matrix_reshaped_ld(p_result, cols, rows);
+        p_result->rows = cols;
+        p_result->cols = rows;
+    }
+
+    matrix_copy_block(p_work, rows, p_result->p_data, p_result->ld, cols, rows);
+    free(p_work);
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_transpose_inplace (matrix_t *p_matrix)
+{
+    if ((NULL == p_matrix) || (NULL == p_matrix->p_data))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if (p_matrix->rows == p_matrix->cols)
+    {
+        transpose_square_inplace(
+            p_matrix->p_data, p_matrix->rows, p_matrix->ld);
+        return MATRIX_SUCCESS;
+    }
+
+    // Swapping the dimensions is only meaningful for an owned buffer
+    if (p_matrix->b_view)
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    // The cycle walk needs packed rows, so padding is squeezed out first and
+    // put back for the new shape afterwards
+    double *p_data = p_matrix->p_data;
+    size_t  rows   = p_matrix->rows;
+    size_t  cols   = p_matrix->cols;
+    size_t  ld     = matrix_reshaped_ld(p_matrix, cols, rows);
+
+    matrix_copy_block(p_data, p_matrix->ld, p_data, cols, rows, cols);
+    matrix_error_code_t ret = transpose_cycles_inplace(p_data, rows, cols);
+
+    if (MATRIX_SUCCESS != ret)
+    {
+        matrix_copy_block(p_data, cols, p_data, p_matrix->ld, rows, cols);
+        return ret;
+    }
+
+    matrix_copy_block(p_data, rows, p_data, ld, cols, rows);
+    p_matrix->rows = cols;
+    p_matrix->cols = rows;
+    p_matrix->ld   = ld;
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_lu (const matrix_t *p_matrix,
+           matrix_t       *p_lu,
+           size_t         *p_pivots,
+           int            *p_sign)
+{
+    if ((NULL == p_matrix) || (NULL == p_lu) || (NULL == p_pivots)
+        || (p_matrix->rows != p_matrix->cols)
+        || (p_lu->rows != p_matrix->rows) || (p_lu->cols != p_matrix->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if (p_lu != p_matrix)
+    {
+        matrix_copy_block(p_matrix->p_data,
+                          p_matrix->ld,
+                          p_lu->p_data,
+                          p_lu->ld,
+                          p_matrix->rows,
+                          p_matrix->cols);
+    }
+
+    int                 sign = 1;
+    matrix_error_code_t ret
+        = lu_factor(p_lu->p_data, p_lu->rows, p_lu->ld, p_pivots, &sign);
+
+    if (NULL != p_sign)
+    {
+        *p_sign = sign;
+    }
+
+    return ret;
+}
+
+matrix_error_code_t
+matrix_lu_solve (const matrix_t *p_lu,
+                 const size_t   *p_pivots,
+                 const matrix_t *p_b,
+                 matrix_t       *p_x)
+{
+    if ((NULL == p_lu) || (NULL == p_pivots) || (NULL == p_b) || (NULL == p_x)
+        || (p_lu->rows != p_lu->cols) || (p_b->rows != p_lu->rows)
+        || (p_x->rows != p_b->rows) || (p_x->cols != p_b->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if (p_x != p_b)
+    {
+        matrix_copy_block(p_b->p_data,
+                          p_b->ld,
+                          p_x->p_data,
+                          p_x->ld,
+                          p_b->rows,
+                          p_b->cols);
+    }
+
+    return lu_solve(p_lu->p_data,
+                    p_lu->ld,
+                    p_pivots,
+                    p_lu->rows,
+                    p_x->p_data,
+                    p_x->cols,
+                    p_x->ld);
+}
+
+matrix_error_code_t
+matrix_determinant (const matrix_t *p_matrix, double *p_result)
+{
+    if ((NULL == p_matrix) || (NULL == p_result)
+        || (p_matrix->rows != p_matrix->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_t           *p_lu     = NULL;
+    size_t             *p_pivots = NULL;
+    int                 sign     = 1;
+    matrix_error_code_t ret = lu_factor_copy(p_matrix, &p_lu, &p_pivots, &sign);
+
+    if (MATRIX_SINGULAR == ret)
+    {
+        *p_result = 0.0;
+        ret       = MATRIX_SUCCESS;
+    }
+    else if (MATRIX_SUCCESS == ret)
+    {
+        double det = (double)sign;
+
+        for (size_t idx = 0U; idx < p_lu->rows; ++idx)
+        {
+            det *= p_lu->p_data[ROW_MAJOR_IDX(idx, idx, p_lu->ld)];
+        }
+
+        *p_result = det;
+    }
+
+    matrix_destroy(p_lu);
+    free(p_pivots);
+    return ret;
+}
+
+matrix_error_code_t
+matrix_log_determinant (const matrix_t *p_matrix,
+                        double         *p_log_abs,
+                        int            *p_sign)
+{
+    if ((NULL == p_matrix) || (NULL == p_log_abs) || (NULL == p_sign)
+        || (p_matrix->rows != p_matrix->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_t           *p_lu     = NULL;
+    size_t             *p_pivots = NULL;
+    int                 sign     = 1;
+    matrix_error_code_t ret = lu_factor_copy(p_matrix, &p_lu, &p_pivots, &sign);
+
+    if (MATRIX_SINGULAR == ret)
+    {
+        *p_log_abs = -INFINITY;
+        *p_sign    = 0;
+        ret        = MATRIX_SUCCESS;
+    }
+    else if (MATRIX_SUCCESS == ret)
+    {
+        double log_abs = 0.0;
+
+        for (size_t idx = 0U; idx < p_lu->rows; ++idx)
+        {
+            double diag = p_lu->p_data[ROW_MAJOR_IDX(idx, idx, p_lu->ld)];
+            log_abs += log(fabs(diag));
+            sign = (diag < 0.0) ? -sign : sign;
+        }
+
+        *p_log_abs = log_abs;
+        *p_sign    = sign;
+    }
+
+    matrix_destroy(p_lu);
+    free(p_pivots);
+    return ret;
+}
+
+matrix_error_code_t
+matrix_inverse (const matrix_t *p_matrix, matrix_t *p_result)
+{
+    if ((NULL == p_matrix) || (NULL == p_result)
+        || (p_matrix->rows != p_matrix->cols)
+        || (p_result->rows != p_matrix->rows)
+        || (p_result->cols != p_matrix->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_t           *p_lu     = NULL;
+    size_t             *p_pivots = NULL;
+    matrix_error_code_t ret = lu_factor_copy(p_matrix, &p_lu, &p_pivots, NULL);
+
+    if (MATRIX_SUCCESS == ret)
+    {
+        size_t n = p_matrix->rows;
+        matrix_fill(p_result, 0.0);
+
+        for (size_t idx = 0U; idx < n; ++idx)
+        {
+            p_result->p_data[ROW_MAJOR_IDX(idx, idx, p_result->ld)] = 1.0;
+        }
+
+        ret = lu_solve(p_lu->p_data,
+                       p_lu->ld,
+                       p_pivots,
+                       n,
+                       p_result->p_data,
+                       n,
+                       p_result->ld);
+    }
+
+    matrix_destroy(p_lu);
+    free(p_pivots);
+    return ret;
+}
+
+static void
+transpose_4x4 (const double *p_src, size_t lds, double *p_dst, size_t ldd)
+{
+#if defined(__AVX__)
+    __m256d row0 = _mm256_loadu_pd(p_src);
+    __m256d row1 = _mm256_loadu_pd(p_src + lds);
+    __m256d row2 = _mm256_loadu_pd(p_src + (2U * lds));
+    __m256d row3 = _mm256_loadu_pd(p_src + (3U * lds));
+
+    // Interleave pairs of rows, then swap 128-bit halves across the pairs
+    __m256d lo01 = _mm256_unpacklo_pd(row0, row1);
+    __m256d hi01 = _mm256_unpackhi_pd(row0, row1);
+    __m256d lo23 = _mm256_unpacklo_pd(row2, row3);
+    __m256d hi23 = _mm256_unpackhi_pd(row2, row3);
+
+    _mm256_storeu_pd(p_dst, _mm256_permute2f128_pd(lo01, lo23, 0x20));
+    _mm256_storeu_pd(p_dst + ldd, _mm256_permute2f128_pd(hi01, hi23, 0x20));
+    _mm256_storeu_pd(p_dst + (2U * ldd),
+                     _mm256_permute2f128_pd(lo01, lo23, 0x31));
+    _mm256_storeu_pd(p_dst + (3U * ldd),
+                     _mm256_permute2f128_pd(hi01, hi23, 0x31));
+#elif defined(__SSE2__)
+    // Four 2x2 register transposes
+    for (size_t row = 0U; row < 4U; row += 2U)
+    {
+        for (size_t col = 0U; col < 4U; col += 2U)
+        {
+            __m128d upper = _mm_loadu_pd(p_src + (row * lds) + col);
+            __m128d lower = _mm_loadu_pd(p_src + ((row + 1U) * lds) + col);
+
+            _mm_storeu_pd(p_dst + (col * ldd) + row,
+                          _mm_unpacklo_pd(upper, lower));
+            _mm_storeu_pd(p_dst + ((col + 1U) * ldd) + row,
+                          _mm_unpackhi_pd(upper, lower));
+        }
+    }
+#else
+    for (size_t row = 0U; row < 4U; ++row)
+    {
+        for (size_t col = 0U; col < 4U; ++col)
+        {
+            p_dst[(col * ldd) + row] = p_src[(row * lds) + col];
+        }
+    }
+#endif
+}
+
+static void
+transpose_tile (const double *p_src,
+                size_t        lds,
+                double       *p_dst,
+                size_t        ldd,
+                size_t        rows,
+                size_t        cols)
+{
+    size_t rows_4 = rows & ~(size_t)3U;
+    size_t cols_4 = cols & ~(size_t)3U;
+
+    for (size_t row = 0U; row < rows_4; row += 4U)
+    {
+        for (size_t col = 0U; col < cols_4; col += 4U)
+        {
+            transpose_4x4(
+                p_src + (row * lds) + col, lds, p_dst + (col * ldd) + row, ldd);
+        }
+
+        for (size_t col = cols_4; col < cols; ++col)
+        {
+            for (size_t idx = row; idx < row + 4U; ++idx)
+            {
+                p_dst[(col * ldd) + idx] = p_src[(idx * lds) + col];
+            }
+        }
+    }
+
+    for (size_t row = rows_4; row < rows; ++row)
+    {
+        for (size_t col = 0U; col < cols; ++col)
+        {
+            p_dst[(col * ldd) + row] = p_src[(row * lds) + col];
+        }
+    }
+}
+
+static void
+transpose_recursive (const double *p_src,
+                     size_t        lds,
+                     double       *p_dst,
+                     size_t        ldd,
+                     size_t        rows,
+                     size_t        cols)
+{
+    if ((rows <= MATRIX_TRANSPOSE_TILE) && (cols <= MATRIX_TRANSPOSE_TILE))
+    {
+        transpose_tile(p_src, lds, p_dst, ldd, rows, cols);
+        return;
+    }
+
+    // Split on a multiple of four so the 4x4 kernel covers interior tiles
+    if (rows >= cols)
+    {
+        size_t half = (rows / 2U) & ~(size_t)3U;
+        transpose_recursive(p_src, lds, p_dst, ldd, half, cols);
+        transpose_recursive(
+            p_src + (half * lds), lds, p_dst + half, ldd, rows - half, cols);
+    }
+    else
+    {
+        size_t half = (cols / 2U) & ~(size_t)3U;
+        transpose_recursive(p_src, lds, p_dst, ldd, rows, half);
+        transpose_recursive(
+            p_src + half, lds, p_dst + (half * ldd), ldd, rows, cols - half);
+    }
+}
+
+static void
+transpose_square_inplace (double *p_data, size_t n, size_t ld)
+{
+    size_t n_4 = n & ~(size_t)3U;
+    double tmp[16];
+
+    // Walk tile pairs so both mirrored tiles stay cache resident
+    for (size_t tile_row = 0U; tile_row < n_4;
+         tile_row += MATRIX_TRANSPOSE_TILE)
+    {
+        size_t row_end = tile_row + MATRIX_TRANSPOSE_TILE;
+        row_end        = (row_end < n_4) ? row_end : n_4;
+
+        for (size_t tile_col = tile_row; tile_col < n_4;
+             tile_col += MATRIX_TRANSPOSE_TILE)
+        {
+            size_t col_end = tile_col + MATRIX_TRANSPOSE_TILE;
+            col_end        = (col_end < n_4) ? col_end : n_4;
+
+            for (size_t row = tile_row; row < row_end; row += 4U)
+            {
+                size_t col = (tile_row == tile_col) ? row : tile_col;
+
+                for (; col < col_end; col += 4U)
+                {
+                    double *p_upper = p_data + (row * ld) + col;
+                    double *p_lower = p_data + (col * ld) + row;
+
+                    // Diagonal blocks map onto themselves
+                    transpose_4x4(p_upper, ld, tmp, 4U);
+
+                    if (p_upper != p_lower)
+                    {
+                        transpose_4x4(p_lower, ld, p_upper, ld);
+                    }
+
+                    for (size_t idx = 0U; idx < 4U; ++idx)
+                    {
+                        memcpy(p_lower + (idx * ld),
+                               &tmp[idx * 4U],
+                               4U * sizeof(double));
+                    }
+                }
+            }
+        }
+    }
+
+    // Remaining rows/columns that do not fill a 4x4 block
+    for (size_t row = 0U; row < n; ++row)
+    {
+        for (size_t col = (row < n_4) ? n_4 : row + 1U; col < n; ++col)
+        {
+            double swap              = p_data[(row * ld) + col];
+            p_data[(row * ld) + col] = p_data[(col * ld) + row];
+            p_data[(col * ld) + row] = swap;
+        }
+    }
+}
+
+static matrix_error_code_t
+transpose_cycles_inplace (double *p_data, size_t rows, size_t cols)
+{
+    size_t   count    = rows * cols;
+    size_t   last     = count - 1U;
+    uint8_t *p_visits = (uint8_t *)calloc((count + 7U) / 8U, 1U);
+
+    if (NULL == p_visits)
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    // Element at flat index i moves to (i * rows) mod (count - 1); the first
+    // and last elements never move.
+    for (size_t start = 1U; start < last; ++start)
+    {
+        if (0U != (p_visits[start / 8U] & (1U << (start % 8U))))
+        {
+            continue;
+        }
+
+        size_t idx   = start;
+        double carry = p_data[start];
+
+        do
+        {
+            size_t next = (size_t)(((unsigned long long)idx * rows) % last);
+            double swap  = p_data[next];
+            p_data[next] = carry;
+            carry        = swap;
+            p_visits[idx / 8U] |= (uint8_t)(1U << (idx % 8U));
+            idx = next;
+        } while (idx != start);
+    }
+
+    free(p_visits);
     return MATRIX_SUCCESS;
 }
 
-matrix_error_code_t
-matrix_subtract (const matrix_t *p_matrix_a,
-                 const matrix_t *p_matrix_b,
-                 matrix_t       *p_result)
+static size_t
+gemm_pack_size (size_t m, size_t n, size_t k)
+{
+    size_t kc_max = MIN(k, (size_t)MATRIX_GEMM_KC);
+    size_t mc_pad = ROUND_UP(MIN(m, (size_t)MATRIX_GEMM_MC), GEMM_MR);
+    size_t nc_pad = ROUND_UP(MIN(n, (size_t)MATRIX_GEMM_NC), GEMM_NR);
+
+    return (mc_pad + nc_pad) * kc_max;
+}
+
+static void
+gemm_blocked (bool          b_trans_a,
+              bool          b_trans_b,
+              size_t        m,
+              size_t        n,
+              size_t        k,
+              double        alpha,
+              const double *p_a,
+              size_t        lda,
+              const double *p_b,
+              size_t        ldb,
+              double        beta,
+              double       *p_c,
+              size_t        ldc,
+              double       *p_pack)
+{
+    // Apply beta once up front so the micro-kernel only accumulates
+    if (1.0 != beta)
+    {
+        for (size_t row = 0U; row < m; ++row)
+        {
+            double *p_row = p_c + (row * ldc);
+
+            for (size_t col = 0U; col < n; ++col)
+            {
+                p_row[col] = (0.0 == beta) ? 0.0 : beta * p_row[col];
+            }
+        }
+    }
+
+    if ((0U == m) || (0U == n) || (0U == k) || (0.0 == alpha))
+    {
+        return;
+    }
+
+    // Transposes are absorbed by reading the operands with swapped steps
+    size_t a_row_step = b_trans_a ? 1U : lda;
+    size_t a_col_step = b_trans_a ? lda : 1U;
+    size_t b_row_step = b_trans_b ? 1U : ldb;
+    size_t b_col_step = b_trans_b ? ldb : 1U;
+
+    double *p_pack_a = p_pack;
+    double *p_pack_b = p_pack
+                       + (ROUND_UP(MIN(m, (size_t)MATRIX_GEMM_MC), GEMM_MR)
+                          * MIN(k, (size_t)MATRIX_GEMM_KC));
+
+    for (size_t jc = 0U; jc < n; jc += MATRIX_GEMM_NC)
+    {
+        size_t nc = MIN(n - jc, (size_t)MATRIX_GEMM_NC);
+
+        for (size_t pc = 0U; pc < k; pc += MATRIX_GEMM_KC)
+        {
+            size_t kc = MIN(k - pc, (size_t)MATRIX_GEMM_KC);
+            gemm_pack_b(kc,
+                        nc,
+                        p_b + (pc * b_row_step) + (jc * b_col_step),
+                        b_row_step,
+                        b_col_step,
+                        p_pack_b);
+
+            for (size_t ic = 0U; ic < m; ic += MATRIX_GEMM_MC)
+            {
+                size_t mc = MIN(m - ic, (size_t)MATRIX_GEMM_MC);
+                gemm_pack_a(mc,
+                            kc,
+                            p_a + (ic * a_row_step) + (pc * a_col_step),
+                            a_row_step,
+                            a_col_step,
+                            p_pack_a);
+
+                for (size_t jr = 0U; jr < nc; jr += GEMM_NR)
+                {
+                    for (size_t ir = 0U; ir < mc; ir += GEMM_MR)
+                    {
+                        gemm_micro_kernel(kc,
+                                          alpha,
+                                          p_pack_a + (ir * kc),
+                                          p_pack_b + (jr * kc),
+                                          p_c + ((ic + ir) * ldc) + jc + jr,
+                                          ldc,
+                                          MIN(mc - ir, (size_t)GEMM_MR),
+                                          MIN(nc - jr, (size_t)GEMM_NR));
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void
+gemm_batch_range (size_t begin, size_t end, void *p_ctx)
+{
+    const gemm_batch_ctx_t *p_batch = (const gemm_batch_ctx_t *)p_ctx;
+    size_t  first      = (begin * p_batch->units) / p_batch->parts;
+    size_t  last       = (end * p_batch->units) / p_batch->parts;
+    size_t  a_row_step = p_batch->b_trans_a ? 1U : p_batch->lda;
+    double *p_pack     = p_batch->p_pack + (begin * p_batch->pack_size);
+
+    for (size_t unit = first; unit < last; ++unit)
+    {
+        size_t item  = unit / p_batch->bands;
+        size_t row   = (unit % p_batch->bands) * MATRIX_GEMM_MC;
+        size_t rows  = MIN(p_batch->m - row, (size_t)MATRIX_GEMM_MC);
+        size_t a_off = (item * p_batch->stride_a) + (row * a_row_step);
+        rows         = (1U == p_batch->bands) ? p_batch->m : rows;
+
+        gemm_blocked(p_batch->b_trans_a,
+                     p_batch->b_trans_b,
+                     rows,
+                     p_batch->n,
+                     p_batch->k,
+                     p_batch->alpha,
+                     p_batch->p_a + a_off,
+                     p_batch->lda,
+                     p_batch->p_b + (item * p_batch->stride_b),
+                     p_batch->ldb,
+                     p_batch->beta,
+                     p_batch->p_c + (item * p_batch->stride_c)
+                         + (row * p_batch->ldc),
+                     p_batch->ldc,
+                     p_pack);
+    }
+}
+
+static void
+gemm_pack_a (size_t        mc,
+             size_t        kc,
+             const double *p_a,
+             size_t        row_step,
+             size_t        col_step,
+             double       *p_pack)
+{
+    for (size_t row = 0U; row < mc; row += GEMM_MR)
+    {
+        size_t mr = MIN(mc - row, (size_t)GEMM_MR);
+
+        for (size_t depth = 0U; depth < kc; ++depth)
+        {
+            const double *p_col = p_a + (row * row_step) + (depth * col_step);
+
+            for (size_t idx = 0U; idx < GEMM_MR; ++idx)
+            {
+                *p_pack++ = (idx < mr) ? p_col[idx * row_step] : 0.0;
+            }
+        }
+    }
+}
+
+static void
+gemm_pack_b (size_t        kc,
+             size_t        nc,
+             const double *p_b,
+             size_t        row_step,
+             size_t        col_step,
+             double       *p_pack)
+{
+    for (size_t col = 0U; col < nc; col += GEMM_NR)
+    {
+        size_t nr = MIN(nc - col, (size_t)GEMM_NR);
+
+        for (size_t depth = 0U; depth < kc; ++depth)
+        {
+            const double *p_row = p_b + (depth * row_step) + (col * col_step);
+
+            // Plain B packs straight from contiguous rows
+            if ((1U == col_step) && (GEMM_NR == nr))
+            {
+                memcpy(p_pack, p_row, GEMM_NR * sizeof(double));
+                p_pack += GEMM_NR;
+                continue;
+            }
+
+            for (size_t idx = 0U; idx < GEMM_NR; ++idx)
+            {
+                *p_pack++ = (idx < nr) ? p_row[idx * col_step] : 0.0;
+            }
+        }
+    }
+}
+
+static void
+gemm_micro_kernel (size_t        kc,
+                   double        alpha,
+                   const double *p_a,
+                   const double *p_b,
+                   double       *p_c,
+                   size_t        ldc,
+                   size_t        mr,
+                   size_t        nr)
+{
+    double acc[GEMM_MR][GEMM_NR];
+
+#if defined(__AVX__)
+    __m256d acc_lo[GEMM_MR];
+    __m256d acc_hi[GEMM_MR];
+
+    for (size_t row = 0U; row < GEMM_MR; ++row)
+    {
+        acc_lo[row] = _mm256_setzero_pd();
+        acc_hi[row] = _mm256_setzero_pd();
+    }
+
+    for (size_t depth = 0U; depth < kc; ++depth)
+    {
+        __m256d b_lo = _mm256_loadu_pd(p_b);
+        __m256d b_hi = _mm256_loadu_pd(p_b + 4);
+
+        for (size_t row = 0U; row < GEMM_MR; ++row)
+        {
+            __m256d a_val = _mm256_broadcast_sd(p_a + row);
+#if defined(__FMA__)
+            acc_lo[row] = _mm256_fmadd_pd(a_val, b_lo, acc_lo[row]);
+            acc_hi[row] = _mm256_fmadd_pd(a_val, b_hi, acc_hi[row]);
+#else
+            acc_lo[row]
+                = _mm256_add_pd(acc_lo[row], _mm256_mul_pd(a_val, b_lo));
+            acc_hi[row]
+                = _mm256_add_pd(acc_hi[row], _mm256_mul_pd(a_val, b_hi));
+#endif
+        }
+
+        p_a += GEMM_MR;
+        p_b += GEMM_NR;
+    }
+
+    for (size_t row = 0U; row < GEMM_MR; ++row)
+    {
+        _mm256_storeu_pd(&acc[row][0], acc_lo[row]);
+        _mm256_storeu_pd(&acc[row][4], acc_hi[row]);
+    }
+#else
+    memset(acc, 0, sizeof(acc));
+
+    for (size_t depth = 0U; depth < kc; ++depth)
+    {
+        for (size_t row = 0U; row < GEMM_MR; ++row)
+        {
+            double a_val = p_a[row];
+
+            for (size_t col = 0U; col < GEMM_NR; ++col)
+            {
+                acc[row][col] += a_val * p_b[col];
+            }
+        }
+
+        p_a += GEMM_MR;
+        p_b += GEMM_NR;
+    }
+#endif
+
+    for (size_t row = 0U; row < mr; ++row)
+    {
+        double *p_row = p_c + (row * ldc);
+
+        for (size_t col = 0U; col < nr; ++col)
+        {
+            p_row[col] += alpha * acc[row][col];
+        }
+    }
+}
+
+static void
+gemv_dot_block (const double *const p_a[GEMV_BLOCK],
+                const double *const p_x[GEMV_BLOCK],
+                size_t              n,
+                double              p_out[GEMV_BLOCK])
+{
+    size_t idx = 0U;
+
+#if defined(__AVX__)
+    __m256d acc[GEMV_BLOCK];
+
+    for (size_t lane = 0U; lane < GEMV_BLOCK; ++lane)
+    {
+        acc[lane] = _mm256_setzero_pd();
+    }
+
+    // One independent accumulator chain per dot product
+    for (; idx + 4U <= n; idx += 4U)
+    {
+        for (size_t lane = 0U; lane < GEMV_BLOCK; ++lane)
+        {
+            __m256d a_val = _mm256_loadu_pd(p_a[lane] + idx);
+            __m256d x_val = _mm256_loadu_pd(p_x[lane] + idx);
+#if defined(__FMA__)
+            acc[lane] = _mm256_fmadd_pd(a_val, x_val, acc[lane]);
+#else
+            acc[lane] = _mm256_add_pd(acc[lane], _mm256_mul_pd(a_val, x_val));
+#endif
+        }
+    }
+
+    // Reduce the four vectors to one vector holding the four sums
+    __m256d pair_01 = _mm256_hadd_pd(acc[0], acc[1]);
+    __m256d pair_23 = _mm256_hadd_pd(acc[2], acc[3]);
+    __m256d sums    = _mm256_add_pd(
+        _mm256_permute2f128_pd(pair_01, pair_23, 0x20),
+        _mm256_permute2f128_pd(pair_01, pair_23, 0x31));
+    _mm256_storeu_pd(p_out, sums);
+#else
+    for (size_t lane = 0U; lane < GEMV_BLOCK; ++lane)
+    {
+        p_out[lane] = 0.0;
+    }
+
+    for (; idx + 2U <= n; idx += 2U)
+    {
+        for (size_t lane = 0U; lane < GEMV_BLOCK; ++lane)
+        {
+            p_out[lane] += (p_a[lane][idx] * p_x[lane][idx])
+                           + (p_a[lane][idx + 1U] * p_x[lane][idx + 1U]);
+        }
+    }
+#endif
+
+    for (; idx < n; ++idx)
+    {
+        for (size_t lane = 0U; lane < GEMV_BLOCK; ++lane)
+        {
+            p_out[lane] += p_a[lane][idx] * p_x[lane][idx];
+        }
+    }
+}
+
+static void
+gemv_axpy_block (const double *const p_a[GEMV_BLOCK],
+                 const double        p_coef[GEMV_BLOCK],
+                 double             *p_y,
+                 size_t              n)
+{
+    size_t idx = 0U;
+
+#if defined(__AVX__)
+    __m256d coef[GEMV_BLOCK];
+
+    for (size_t lane = 0U; lane < GEMV_BLOCK; ++lane)
+    {
+        coef[lane] = _mm256_set1_pd(p_coef[lane]);
+    }
+
+    // y is loaded and stored once per GEMV_BLOCK rows
+    for (; idx + 4U <= n; idx += 4U)
+    {
+        __m256d y_val = _mm256_loadu_pd(p_y + idx);
+
+        for (size_t lane = 0U; lane < GEMV_BLOCK; ++lane)
+        {
+            __m256d a_val = _mm256_loadu_pd(p_a[lane] + idx);
+#if defined(__FMA__)
+            y_val = _mm256_fmadd_pd(coef[lane], a_val, y_val);
+#else
+            y_val = _mm256_add_pd(y_val, _mm256_mul_pd(coef[lane], a_val));
+#endif
+        }
+
+        _mm256_storeu_pd(p_y + idx, y_val);
+    }
+#endif
+
+    for (; idx < n; ++idx)
+    {
+        double sum = p_y[idx];
+
+        for (size_t lane = 0U; lane < GEMV_BLOCK; ++lane)
+        {
+            sum += p_coef[lane] * p_a[lane][idx];
+        }
+
+        p_y[idx] = sum;
+    }
+}
+
+static void
+gemv_range (size_t begin, size_t end, void *p_ctx)
 {
-    return MATRIX_SUCCESS;
+    const gemv_ctx_t *p_gemv = (const gemv_ctx_t *)p_ctx;
+    const matrix_t   *p_a    = p_gemv->p_matrix;
+    size_t            first  = (begin * p_a->rows) / p_gemv->parts;
+    size_t            last   = (end * p_a->rows) / p_gemv->parts;
+    const double     *p_rows[GEMV_BLOCK];
+    const double     *p_vecs[GEMV_BLOCK];
+    double            dots[GEMV_BLOCK];
+
+    // Short blocks repeat their last operand and drop the extra sums
+    for (size_t row = first; row < last;)
+    {
+        size_t rows = MIN(last - row, (size_t)GEMV_BLOCK);
+        rows        = (1U == p_gemv->count) ? rows : 1U;
+
+        for (size_t vec = 0U; vec < p_gemv->count;)
+        {
+            size_t vecs = MIN(p_gemv->count - vec, (size_t)GEMV_BLOCK);
+            vecs        = (1U == rows) ? vecs : 1U;
+
+            for (size_t lane = 0U; lane < GEMV_BLOCK; ++lane)
+            {
+                size_t row_off = MIN(lane, rows - 1U);
+                size_t vec_off = MIN(lane, vecs - 1U);
+                p_rows[lane]   = p_a->p_data + ((row + row_off) * p_a->ld);
+                p_vecs[lane]   = p_gemv->p_x + ((vec + vec_off) * p_gemv->ldx);
+            }
+
+            gemv_dot_block(p_rows, p_vecs, p_a->cols, dots);
+
+            for (size_t lane = 0U; lane < (rows * vecs); ++lane)
+            {
+                size_t  out_row = row + ((1U < rows) ? lane : 0U);
+                size_t  out_vec = vec + ((1U < vecs) ? lane : 0U);
+                double *p_out
+                    = p_gemv->p_y + (out_vec * p_gemv->ldy) + out_row;
+                *p_out = (p_gemv->alpha * dots[lane])
+                         + ((0.0 == p_gemv->beta) ? 0.0
+                                                  : p_gemv->beta * *p_out);
+            }
+
+            vec += vecs;
+        }
+
+        row += rows;
+    }
 }
 
-matrix_error_code_t
-matrix_multiply (const matrix_t *p_matrix_a,
-                 const matrix_t *p_matrix_b,
-                 matrix_t       *p_result)
+static void
+gemv_transposed_range (size_t begin, size_t end, void *p_ctx)
 {
-    return MATRIX_SUCCESS;
+    const gemv_ctx_t *p_gemv = (const gemv_ctx_t *)p_ctx;
+    const matrix_t   *p_a    = p_gemv->p_matrix;
+    size_t            cols   = p_a->cols;
+    const double     *p_rows[GEMV_BLOCK];
+    double            coef[GEMV_BLOCK];
+
+    for (size_t part = begin; part < end; ++part)
+    {
+        size_t  first = (part * p_a->rows) / p_gemv->parts;
+        size_t  last  = ((part + 1U) * p_a->rows) / p_gemv->parts;
+        double *p_sum = p_gemv->p_y;
+
+        if (0U != part)
+        {
+            p_sum = p_gemv->p_partial + ((part - 1U) * cols);
+            memset(p_sum, 0, cols * sizeof(double));
+        }
+
+        size_t row = first;
+
+        for (; row + GEMV_BLOCK <= last; row += GEMV_BLOCK)
+        {
+            for (size_t lane = 0U; lane < GEMV_BLOCK; ++lane)
+            {
+                p_rows[lane] = p_a->p_data + ((row + lane) * p_a->ld);
+                coef[lane]   = p_gemv->alpha * p_gemv->p_x[row + lane];
+            }
+
+            gemv_axpy_block(p_rows, coef, p_sum, cols);
+        }
+
+        for (; row < last; ++row)
+        {
+            const double *p_row = p_a->p_data + (row * p_a->ld);
+            double        scale = p_gemv->alpha * p_gemv->p_x[row];
+
+            for (size_t col = 0U; col < cols; ++col)
+            {
+                p_sum[col] += scale * p_row[col];
+            }
+        }
+    }
 }
 
-matrix_error_code_t
-matrix_scalar_multiply (const matrix_t *p_matrix,
-                        double          scalar,
-                        matrix_t       *p_result)
+static size_t
+gemv_partition_count (const matrix_t *p_matrix, size_t count)
 {
-    return MATRIX_SUCCESS;
+    size_t work  = p_matrix->rows * p_matrix->cols * count;
+    size_t parts = work / MATRIX_GEMV_PARALLEL_MIN;
+    size_t limit = MIN(parallel_get_threads(), p_matrix->rows);
+
+    parts = (parts > limit) ? limit : parts;
+    return (0U == parts) ? 1U : parts;
 }
 
-matrix_error_code_t
-matrix_transpose (const matrix_t *p_matrix, matrix_t *p_result)
+static void
+gemv_scale (double *p_y, size_t n, double beta)
 {
-    return MATRIX_SUCCESS;
+    if (1.0 == beta)
+    {
+        return;
+    }
+
+    for (size_t idx = 0U; idx < n; ++idx)
+    {
+        p_y[idx] = (0.0 == beta) ? 0.0 : beta * p_y[idx];
+    }
 }
 
-matrix_error_code_t
-matrix_determinant (const matrix_t *p_matrix, double *p_result)
+static matrix_error_code_t
+lu_factor (double *p_a, size_t n, size_t lda, size_t *p_pivots, int *p_sign)
 {
-    return MATRIX_SUCCESS;
+    bool b_singular = false;
+    int  sign       = 1;
+
+    for (size_t panel = 0U; panel < n; panel += MATRIX_LU_BLOCK)
+    {
+        size_t width = MIN(n - panel, (size_t)MATRIX_LU_BLOCK);
+        size_t end   = panel + width;
+
+        // Unblocked factorization of the tall panel A[panel:n, panel:end]
+        for (size_t col = panel; col < end; ++col)
+        {
+            size_t pivot   = col;
+            double max_abs = fabs(p_a[(col * lda) + col]);
+
+            for (size_t row = col + 1U; row < n; ++row)
+            {
+                double cand = fabs(p_a[(row * lda) + col]);
+
+                if (cand > max_abs)
+                {
+                    max_abs = cand;
+                    pivot   = row;
+                }
+            }
+
+            p_pivots[col] = pivot;
+
+            if (pivot != col)
+            {
+                // Swap the full rows so L and the trailing matrix follow
+                double *p_upper = p_a + (col * lda);
+                double *p_lower = p_a + (pivot * lda);
+
+                for (size_t idx = 0U; idx < n; ++idx)
+                {
+                    double swap  = p_upper[idx];
+                    p_upper[idx] = p_lower[idx];
+                    p_lower[idx] = swap;
+                }
+
+                sign = -sign;
+            }
+
+            double diag = p_a[(col * lda) + col];
+
+            if (0.0 == diag)
+            {
+                b_singular = true;
+                continue;
+            }
+
+            const double *p_pivot_row = p_a + (col * lda);
+
+            for (size_t row = col + 1U; row < n; ++row)
+            {
+                double *p_row = p_a + (row * lda);
+                double  mult  = p_row[col] / diag;
+                p_row[col]    = mult;
+
+                for (size_t idx = col + 1U; idx < end; ++idx)
+                {
+                    p_row[idx] -= mult * p_pivot_row[idx];
+                }
+            }
+        }
+
+        if (end < n)
+        {
+            // U12 = L11^-1 * A12 by unit lower forward substitution
+            for (size_t col = panel; col < end; ++col)
+            {
+                const double *p_src = p_a + (col * lda);
+
+                for (size_t row = col + 1U; row < end; ++row)
+                {
+                    double *p_row = p_a + (row * lda);
+                    double  mult  = p_row[col];
+
+                    for (size_t idx = end; idx < n; ++idx)
+                    {
+                        p_row[idx] -= mult * p_src[idx];
+                    }
+                }
+            }
+
+            // A22 -= L21 * U12
+            matrix_error_code_t ret = matrix_gemm(n - end,
+                                                  n - end,
+                                                  width,
+                                                  -1.0,
+                                                  p_a + (end * lda) + panel,
+                                                  lda,
+                                                  p_a + (panel * lda) + end,
+                                                  lda,
+                                                  1.0,
+                                                  p_a + (end * lda) + end,
+                                                  lda);
+
+            if (MATRIX_SUCCESS != ret)
+            {
+                return ret;
+            }
+        }
+    }
+
+    *p_sign = sign;
+    return b_singular ? MATRIX_SINGULAR : MATRIX_SUCCESS;
 }
 
-matrix_error_code_t
-matrix_inverse (const matrix_t *p_matrix, matrix_t *p_result)
+static matrix_error_code_t
+lu_solve (const double *p_lu,
+          size_t        ldlu,
+          const size_t *p_pivots,
+          size_t        n,
+          double       *p_x,
+          size_t        nrhs,
+          size_t        ldx)
 {
-    return MATRIX_SUCCESS;
+    matrix_error_code_t ret = MATRIX_SUCCESS;
+
+    // Apply the row interchanges in factorization order
+    for (size_t row = 0U; row < n; ++row)
+    {
+        if (p_pivots[row] != row)
+        {
+            double *p_upper = p_x + (row * ldx);
+            double *p_lower = p_x + (p_pivots[row] * ldx);
+
+            for (size_t col = 0U; col < nrhs; ++col)
+            {
+                double swap  = p_upper[col];
+                p_upper[col] = p_lower[col];
+                p_lower[col] = swap;
+            }
+        }
+    }
+
+    // Forward substitution with unit lower L, one block row at a time
+    for (size_t blk = 0U; blk < n; blk += MATRIX_LU_BLOCK)
+    {
+        size_t width = MIN(n - blk, (size_t)MATRIX_LU_BLOCK);
+        size_t end   = blk + width;
+
+        for (size_t row = blk + 1U; row < end; ++row)
+        {
+            double *p_row = p_x + (row * ldx);
+
+            for (size_t idx = blk; idx < row; ++idx)
+            {
+                double        mult  = p_lu[(row * ldlu) + idx];
+                const double *p_src = p_x + (idx * ldx);
+
+                for (size_t col = 0U; col < nrhs; ++col)
+                {
+                    p_row[col] -= mult * p_src[col];
+                }
+            }
+        }
+
+        if (end < n)
+        {
+            ret = matrix_gemm(n - end,
+                              nrhs,
+                              width,
+                              -1.0,
+                              p_lu + (end * ldlu) + blk,
+                              ldlu,
+                              p_x + (blk * ldx),
+                              ldx,
+                              1.0,
+                              p_x + (end * ldx),
+                              ldx);
+
+            if (MATRIX_SUCCESS != ret)
+            {
+                return ret;
+            }
+        }
+    }
+
+    // Back substitution with U, last block row first
+    for (size_t blk_end = n; blk_end > 0U;)
+    {
+        size_t width = MIN(blk_end, (size_t)MATRIX_LU_BLOCK);
+        size_t blk   = blk_end - width;
+
+        for (size_t row = blk_end; row-- > blk;)
+        {
+            double *p_row = p_x + (row * ldx);
+            double  diag  = p_lu[(row * ldlu) + row];
+
+            if (0.0 == diag)
+            {
+                return MATRIX_SINGULAR;
+            }
+
+            for (size_t idx = row + 1U; idx < blk_end; ++idx)
+            {
+                double        mult  = p_lu[(row * ldlu) + idx];
+                const double *p_src = p_x + (idx * ldx);
+
+                for (size_t col = 0U; col < nrhs; ++col)
+                {
+                    p_row[col] -= mult * p_src[col];
+                }
+            }
+
+            for (size_t col = 0U; col < nrhs; ++col)
+            {
+                p_row[col] /= diag;
+            }
+        }
+
+        if (0U < blk)
+        {
+            ret = matrix_gemm(blk,
+                              nrhs,
+                              width,
+                              -1.0,
+                              p_lu + blk,
+                              ldlu,
+                              p_x + (blk * ldx),
+                              ldx,
+                              1.0,
+                              p_x,
+                              ldx);
+
+            if (MATRIX_SUCCESS != ret)
+            {
+                return ret;
+            }
+        }
+
+        blk_end = blk;
+    }
+
+    return ret;
 }
 
 static matrix_error_code_t
-matrix_error_from_array (array_error_code_t ret)
+lu_factor_copy (const matrix_t *p_matrix,
+                matrix_t      **pp_lu,
+                size_t        **pp_pivots,
+                int            *p_sign)
 {
-    switch (ret)
+    int sign   = 1;
+    *pp_lu     = matrix_clone(p_matrix);
+    *pp_pivots = (size_t *)malloc(p_matrix->rows * sizeof(size_t));
+
+    if ((NULL == *pp_lu) || (NULL == *pp_pivots))
     {
-        case ARRAY_SUCCESS:
-            return MATRIX_SUCCESS;
-        case ARRAY_NOT_FOUND:
-            return MATRIX_NOT_FOUND;
-        case ARRAY_OUT_OF_BOUNDS:
-            return MATRIX_OUT_OF_BOUNDS;
-        case ARRAY_INVALID_ARGUMENT:
-            return MATRIX_INVALID_ARGUMENT;
-        case ARRAY_ALLOCATION_FAILURE:
-            return MATRIX_ALLOCATION_FAILURE;
-        default:
-            return MATRIX_FAILURE;
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    matrix_error_code_t ret = lu_factor((*pp_lu)->p_data,
+                                        (*pp_lu)->rows,
+                                        (*pp_lu)->ld,
+                                        *pp_pivots,
+                                        &sign);
+
+    if (NULL != p_sign)
+    {
+        *p_sign = sign;
     }
+
+    return ret;
 }
 
-static void
-double_del (void *p_data)
+static size_t
+chain_workspace (const chain_plan_t *p_plan, size_t first, size_t last)
 {
-    free(p_data);
+    if (first == last)
+    {
+        return 0U;
+    }
+
+    const size_t *p_dims     = p_plan->p_dims;
+    size_t        split      = p_plan->p_split[(first * p_plan->count) + last];
+    size_t        left       = (first < split)
+                                   ? (p_dims[first] * p_dims[split + 1U])
+                                   : 0U;
+    size_t        right      = ((split + 1U) < last)
+                                   ? (p_dims[split + 1U] * p_dims[last + 1U])
+                                   : 0U;
+    size_t        left_need  = chain_workspace(p_plan, first, split);
+    size_t        right_need = right
+                               + chain_workspace(p_plan, split + 1U, last);
+
+    return left + ((left_need > right_need) ? left_need : right_need);
 }
 
-static int
-double_cmp (const void *p_double_a, const void *p_double_b)
+static matrix_error_code_t
+chain_evaluate (const chain_plan_t *p_plan,
+                size_t              first,
+                size_t              last,
+                double             *p_out,
+                size_t              ldo,
+                double             *p_work)
 {
-    double double_a = *(const double *)p_double_a;
-    double double_b = *(const double *)p_double_b;
+    const size_t       *p_dims  = p_plan->p_dims;
+    size_t              split   = p_plan->p_split[(first * p_plan->count)
+                                                + last];
+    const double       *p_left  = p_plan->pp_matrices[first]->p_data;
+    size_t              ldl     = p_plan->pp_matrices[first]->ld;
+    const double       *p_right = p_plan->pp_matrices[last]->p_data;
+    size_t              ldr     = p_plan->pp_matrices[last]->ld;
+    matrix_error_code_t ret     = MATRIX_SUCCESS;
+
+    // Operands that are products live on the workspace stack, left first
+    if (first < split)
+    {
+        ldl = p_dims[split + 1U];
+        ret = chain_evaluate(p_plan,
+                             first,
+                             split,
+                             p_work,
+                             ldl,
+                             p_work + (p_dims[first] * ldl));
+        p_left = p_work;
+        p_work += p_dims[first] * ldl;
+    }
 
-    if (double_a < double_b)
+    if ((MATRIX_SUCCESS == ret) && ((split + 1U) < last))
     {
-        return -1;
+        ldr = p_dims[last + 1U];
+        ret = chain_evaluate(p_plan,
+                             split + 1U,
+                             last,
+                             p_work,
+                             ldr,
+                             p_work + (p_dims[split + 1U] * ldr));
+        p_right = p_work;
     }
 
-    if (double_a > double_b)
+    if (MATRIX_SUCCESS != ret)
     {
-        return 1;
+        return ret;
     }
 
-    return 0;
+    return matrix_gemm(p_dims[first],
+                       p_dims[last + 1U],
+                       p_dims[split + 1U],
+                       1.0,
+                       p_left,
+                       ldl,
+                       p_right,
+                       ldr,
+                       0.0,
+                       p_out,
+                       ldo);
 }
 
-static void
-double_print (void *p_data, size_t index)
+static double *
+matrix_alloc_data (size_t rows, size_t ld, size_t *p_capacity)
 {
-    if (p_data != NULL)
+    if ((0U == ld)
+        || (rows > ((SIZE_MAX - MATRIX_ALIGNMENT) / sizeof(double)) / ld))
+    {
+        return NULL;
+    }
+
+    // aligned_alloc requires a size that is a multiple of the alignment
+    size_t  size   = ROUND_UP(rows * ld * sizeof(double), MATRIX_ALIGNMENT);
+    double *p_data = (double *)aligned_alloc(MATRIX_ALIGNMENT, size);
+
+    if (NULL != p_data)
     {
-        printf("(%zu: %f)", index, *(const double *)p_data);
+        // All-zero bits are 0.0 for IEEE-754 doubles; padding is zeroed too
+        memset(p_data, 0, size);
+        *p_capacity = size / sizeof(double);
     }
 
-    return;
+    return p_data;
 }
 
-static void *
-double_cpy (const void *p_src)
+static matrix_error_code_t
+matrix_restride (matrix_t *p_matrix, size_t rows, size_t cols, bool b_keep)
 {
-    if (NULL == p_src)
+    // Only an owned buffer can change shape
+    if (p_matrix->b_view)
     {
-        return NULL;
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t ld        = matrix_padded_ld(cols);
+    size_t keep_rows = b_keep ? MIN(rows, p_matrix->rows) : 0U;
+    size_t keep_cols = MIN(cols, p_matrix->cols);
+
+    if (rows <= p_matrix->capacity / ld)
+    {
+        double *p_data = p_matrix->p_data;
+
+        if (0U < keep_rows)
+        {
+            matrix_copy_block(
+                p_data, p_matrix->ld, p_data, ld, keep_rows, keep_cols);
+        }
+
+        // Clear stale values outside the kept block, padding included, so
+        // the buffer looks as if matrix_create had just made it
+        for (size_t row = 0U; row < rows; ++row)
+        {
+            size_t first = (row < keep_rows) ? keep_cols : (b_keep ? 0U : cols);
+
+            memset(&p_data[ROW_MAJOR_IDX(row, first, ld)],
+                   0,
+                   (ld - first) * sizeof(double));
+        }
+    }
+    else
+    {
+        size_t  capacity = 0U;
+        double *p_data   = matrix_alloc_data(rows, ld, &capacity);
+
+        if (NULL == p_data)
+        {
+            return MATRIX_ALLOCATION_FAILURE;
+        }
+
+        if (0U < keep_rows)
+        {
+            matrix_copy_block(p_matrix->p_data,
+                              p_matrix->ld,
+                              p_data,
+                              ld,
+                              keep_rows,
+                              keep_cols);
+        }
+
+        free(p_matrix->p_data);
+        p_matrix->p_data   = p_data;
+        p_matrix->capacity = capacity;
+    }
+
+    p_matrix->rows = rows;
+    p_matrix->cols = cols;
+    p_matrix->ld   = ld;
+    return MATRIX_SUCCESS;
+}
+
+static size_t
+matrix_reshaped_ld (const matrix_t *p_matrix, size_t rows, size_t cols)
+{
+    size_t ld = matrix_padded_ld(cols);
+
+    if (rows <= p_matrix->capacity / ld)
+    {
+        return ld;
+    }
+
+    return cols;
+}
+
+void
+matrix_copy_block (const double *p_src,
+                   size_t        lds,
+                   double       *p_dst,
+                   size_t        ldd,
+                   size_t        rows,
+                   size_t        cols)
+{
+    if ((lds == cols) && (ldd == cols))
+    {
+        memmove(p_dst, p_src, rows * cols * sizeof(double));
+        return;
+    }
+
+    if ((p_dst + ((rows - 1U) * ldd)) > (p_src + ((rows - 1U) * lds)))
+    {
+        for (size_t row = rows; row > 0U; --row)
+        {
+            memmove(p_dst + ((row - 1U) * ldd),
+                    p_src + ((row - 1U) * lds),
+                    cols * sizeof(double));
+        }
+
+        return;
     }
 
-    double *p_copy = calloc(1, sizeof(double));
+    for (size_t row = 0U; row < rows; ++row)
+    {
+        memmove(
+            p_dst + (row * ldd), p_src + (row * lds), cols * sizeof(double));
+    }
+}
+
+static matrix_error_code_t
+elementwise_combine (const matrix_t *p_a,
+                     double          alpha,
+                     const matrix_t *p_b,
+                     double          beta,
+                     matrix_t       *p_result)
+{
+    if (matrix_is_unsafe_alias(p_a, p_result)
+        || ((NULL != p_b) && matrix_is_unsafe_alias(p_b, p_result)))
+    {
+        matrix_t *p_work = matrix_create(p_result->rows, p_result->cols);
+
+        if (NULL == p_work)
+        {
+            return MATRIX_ALLOCATION_FAILURE;
+        }
+
+        elementwise_combine(p_a, alpha, p_b, beta, p_work);
+        matrix_copy_block(p_work->p_data,
+                          p_work->ld,
+                          p_result->p_data,
+                          p_result->ld,
+                          p_result->rows,
+                          p_result->cols);
+        matrix_destroy(p_work);
+        return MATRIX_SUCCESS;
+    }
 
-    if (NULL != p_copy)
+    for (size_t row = 0U; row < p_a->rows; ++row)
     {
-        *p_copy = *(const double *)p_src;
+        const double *p_row_a = p_a->p_data + (row * p_a->ld);
+        double       *p_out   = p_result->p_data + (row * p_result->ld);
+
+        if (NULL == p_b)
+        {
+            for (size_t col = 0U; col < p_a->cols; ++col)
+            {
+                p_out[col] = alpha * p_row_a[col];
+            }
+        }
+        else
+        {
+            const double *p_row_b = p_b->p_data + (row * p_b->ld);
+
+            for (size_t col = 0U; col < p_a->cols; ++col)
+            {
+                p_out[col] = (alpha * p_row_a[col]) + (beta * p_row_b[col]);
+            }
+        }
     }
 
-    return p_copy;
+    return MATRIX_SUCCESS;
+}
+
+bool
+matrix_is_overlapping (const matrix_t *p_a, const matrix_t *p_b)
+{
+    uintptr_t a_begin = (uintptr_t)p_a->p_data;
+    uintptr_t b_begin = (uintptr_t)p_b->p_data;
+    uintptr_t a_end   = (uintptr_t)(p_a->p_data + ((p_a->rows - 1U) * p_a->ld)
+                                  + p_a->cols);
+    uintptr_t b_end   = (uintptr_t)(p_b->p_data + ((p_b->rows - 1U) * p_b->ld)
+                                  + p_b->cols);
+
+    return (a_begin < b_end) && (b_begin < a_end);
+}
+
+bool
+matrix_is_same_storage (const matrix_t *p_a, const matrix_t *p_b)
+{
+    return (p_a->p_data == p_b->p_data) && (p_a->ld == p_b->ld);
+}
+
+bool
+matrix_is_unsafe_alias (const matrix_t *p_input, const matrix_t *p_result)
+{
+    return matrix_is_overlapping(p_input, p_result)
+           && !matrix_is_same_storage(p_input, p_result);
 }
 
 static bool
@@ -459,4 +3399,187 @@ matrix_is_same_col_size (const matrix_t *p_matrix_a, const matrix_t *p_matrix_b)
     return false;
 }
 
+static bool
+close_scalar (double a, double b, double rtol, double atol)
+{
+    // Capping the bound keeps an infinite difference from passing against
+    // an infinite or NaN bound
+    double bound = atol + (rtol * fmax(fabs(a), fabs(b)));
+    bound        = (bound < DBL_MAX) ? bound : DBL_MAX;
+    return (a == b) || (fabs(a - b) <= bound);
+}
+
+static uint64_t
+close_ulp_distance (double a, double b)
+{
+    int64_t bits_a = 0;
+    int64_t bits_b = 0;
+    memcpy(&bits_a, &a, sizeof(bits_a));
+    memcpy(&bits_b, &b, sizeof(bits_b));
+
+    // Map sign-magnitude onto a monotonic two's complement scale on which
+    // -0.0 and +0.0 both land on 0
+    bits_a = (0 > bits_a) ? INT64_MIN - bits_a : bits_a;
+    bits_b = (0 > bits_b) ? INT64_MIN - bits_b : bits_b;
+    return (bits_a > bits_b) ? (uint64_t)bits_a - (uint64_t)bits_b
+                             : (uint64_t)bits_b - (uint64_t)bits_a;
+}
+
+static bool
+close_row (const double *p_a,
+           const double *p_b,
+           size_t        cols,
+           double        rtol,
+           double        atol)
+{
+    size_t col = 0U;
+
+#if defined(__AVX__)
+    const __m256d sign   = _mm256_set1_pd(-0.0);
+    const __m256d cap    = _mm256_set1_pd(DBL_MAX);
+    const __m256d v_rtol = _mm256_set1_pd(rtol);
+    const __m256d v_atol = _mm256_set1_pd(atol);
+
+    for (; col + 4U <= cols; col += 4U)
+    {
+        __m256d a_val = _mm256_loadu_pd(p_a + col);
+        __m256d b_val = _mm256_loadu_pd(p_b + col);
+        __m256d diff  = _mm256_andnot_pd(sign, _mm256_sub_pd(a_val, b_val));
+        __m256d mag   = _mm256_max_pd(_mm256_andnot_pd(sign, a_val),
+                                    _mm256_andnot_pd(sign, b_val));
+        __m256d bound = _mm256_add_pd(v_atol, _mm256_mul_pd(v_rtol, mag));
+
+        // min returns its second operand for a NaN bound
+        bound      = _mm256_min_pd(bound, cap);
+        __m256d ok = _mm256_or_pd(_mm256_cmp_pd(a_val, b_val, _CMP_EQ_OQ),
+                                  _mm256_cmp_pd(diff, bound, _CMP_LE_OQ));
+
+        if (0xF != _mm256_movemask_pd(ok))
+        {
+            return false;
+        }
+    }
+#endif
+
+    for (; col < cols; ++col)
+    {
+        if (false == close_scalar(p_a[col], p_b[col], rtol, atol))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool
+close_ulps_row (const double *p_a,
+                const double *p_b,
+                size_t        cols,
+                uint64_t      max_ulps)
+{
+    size_t col = 0U;
+
+#if defined(__AVX2__)
+    // AVX2 only compares signed 64-bit lanes, so distances and the limit
+    // are biased by 2^63 to compare them as unsigned
+    const __m256i v_min   = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i zero    = _mm256_setzero_si256();
+    const __m256i v_limit = _mm256_set1_epi64x(
+        (long long)(max_ulps ^ (uint64_t)INT64_MIN));
+
+    for (; col + 4U <= cols; col += 4U)
+    {
+        __m256d a_val  = _mm256_loadu_pd(p_a + col);
+        __m256d b_val  = _mm256_loadu_pd(p_b + col);
+        __m256i bits_a = _mm256_castpd_si256(a_val);
+        __m256i bits_b = _mm256_castpd_si256(b_val);
+        __m256i neg_a  = _mm256_cmpgt_epi64(zero, bits_a);
+        __m256i neg_b  = _mm256_cmpgt_epi64(zero, bits_b);
+
+        bits_a = _mm256_blendv_epi8(
+            bits_a, _mm256_sub_epi64(v_min, bits_a), neg_a);
+        bits_b = _mm256_blendv_epi8(
+            bits_b, _mm256_sub_epi64(v_min, bits_b), neg_b);
+
+        __m256i dist = _mm256_blendv_epi8(_mm256_sub_epi64(bits_b, bits_a),
+                                          _mm256_sub_epi64(bits_a, bits_b),
+                                          _mm256_cmpgt_epi64(bits_a, bits_b));
+        __m256i nan  = _mm256_castpd_si256(
+            _mm256_cmp_pd(a_val, b_val, _CMP_UNORD_Q));
+        __m256i far  = _mm256_cmpgt_epi64(_mm256_xor_si256(dist, v_min),
+                                         v_limit);
+        __m256i bad  = _mm256_or_si256(nan, far);
+
+        if (0 != _mm256_movemask_epi8(bad))
+        {
+            return false;
+        }
+    }
+#endif
+
+    for (; col < cols; ++col)
+    {
+        if (isnan(p_a[col]) || isnan(p_b[col])
+            || (max_ulps < close_ulp_distance(p_a[col], p_b[col])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static size_t
+close_find_row (const double *p_row,
+                size_t        cols,
+                double        key,
+                double        rtol,
+                double        atol)
+{
+    size_t col = 0U;
+
+#if defined(__AVX__)
+    const __m256d sign    = _mm256_set1_pd(-0.0);
+    const __m256d cap     = _mm256_set1_pd(DBL_MAX);
+    const __m256d v_key   = _mm256_set1_pd(key);
+    const __m256d v_rtol  = _mm256_set1_pd(rtol);
+    const __m256d v_atol  = _mm256_set1_pd(atol);
+    const __m256d key_abs = _mm256_andnot_pd(sign, v_key);
+
+    for (; col + 4U <= cols; col += 4U)
+    {
+        __m256d val   = _mm256_loadu_pd(p_row + col);
+        __m256d diff  = _mm256_andnot_pd(sign, _mm256_sub_pd(val, v_key));
+        __m256d mag   = _mm256_max_pd(_mm256_andnot_pd(sign, val), key_abs);
+        __m256d bound = _mm256_min_pd(
+            _mm256_add_pd(v_atol, _mm256_mul_pd(v_rtol, mag)), cap);
+        int     hits  = _mm256_movemask_pd(
+            _mm256_or_pd(_mm256_cmp_pd(val, v_key, _CMP_EQ_OQ),
+                         _mm256_cmp_pd(diff, bound, _CMP_LE_OQ)));
+
+        if (0 != hits)
+        {
+            while (0 == (hits & 1))
+            {
+                hits >>= 1;
+                col += 1U;
+            }
+
+            return col;
+        }
+    }
+#endif
+
+    for (; col < cols; ++col)
+    {
+        if (close_scalar(p_row[col], key, rtol, atol))
+        {
+            return col;
+        }
+    }
+
+    return cols;
+}
+
 /*** end of file ***/
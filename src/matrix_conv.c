@@ -0,0 +1,549 @@
+/**
+ * @file matrix_conv.c
+ * @brief 2D convolution by im2col + GEMM and by a direct 3x3 kernel.
+ *
+ * A convolution evaluated as nested loops over each output pixel and each
+ * kernel tap runs at scalar speed and re-reads the input once per kernel.
+ * The general path here lowers it to matrix multiplication instead: the
+ * input samples under a run of output pixels are gathered (im2col) into a
+ * panel with one column per pixel and one row per kernel tap, and the
+ * kernels, one per row, are multiplied against the panel with the blocked
+ * GEMM. The panel is bounded by MATRIX_CONV_PANEL, so the gather stays in
+ * cache and memory use does not grow with the image.
+ *
+ * For a few 3x3 kernels the gather costs more than it saves, so the direct
+ * path computes output rows straight from the three input rows under them,
+ * eight pixels at a time in vector registers.
+ *
+ * @author heapbadger
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_conv.h"
+#include "matrix_internal.h"
+#include "parallel.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+typedef struct
+{
+    const matrix_t             *p_input;
+    const matrix_t             *p_kernels;
+    const matrix_conv_params_t *p_params;
+    matrix_t                   *p_output;
+    size_t                      out_rows;
+    size_t                      out_cols;
+    size_t                      panel_cols; /**< Output pixels per panel. */
+    matrix_error_code_t        *p_status;   /**< Result of each panel. */
+} conv_ctx_t;
+
+/**
+ * @brief Find the steps whose sample lies inside the unpadded input.
+ *
+ * Step idx in [0, count) samples padded coordinate start + idx * stride,
+ * which is inside the input when pad <= coordinate < pad + size.
+ *
+ * @param start Padded coordinate of step 0.
+ * @param stride Distance between steps.
+ * @param count Number of steps.
+ * @param pad Padding before the input.
+ * @param size Input size.
+ * @param p_first Output parameter for the first step inside.
+ * @param p_last Output parameter for one past the last step inside, never
+ *               less than *p_first.
+ */
+static void conv_valid_range(size_t  start,
+                             size_t  stride,
+                             size_t  count,
+                             size_t  pad,
+                             size_t  size,
+                             size_t *p_first,
+                             size_t *p_last);
+
+/**
+ * @brief Gather the im2col panel of output pixels [first, first + width).
+ *
+ * @param p_ctx Pointer to the convolution context.
+ * @param first First output pixel, in row-major order over the output map.
+ * @param width Number of output pixels.
+ * @param p_panel Output panel, one row of width samples per kernel tap.
+ */
+static void conv_gather(const conv_ctx_t *p_ctx,
+                        size_t            first,
+                        size_t            width,
+                        double           *p_panel);
+
+/**
+ * @brief Gather and multiply panels [begin, end) (parallel_func signature).
+ *
+ * @param begin First panel.
+ * @param end One past the last panel.
+ * @param p_arg Pointer to the conv_ctx_t.
+ */
+static void conv_im2col_range(size_t begin, size_t end, void *p_arg);
+
+/**
+ * @brief Compute output rows [begin, end) of every 3x3 kernel directly
+ *        (parallel_func signature).
+ *
+ * @param begin First output row.
+ * @param end One past the last output row.
+ * @param p_arg Pointer to the conv_ctx_t.
+ */
+static void conv_direct_range(size_t begin, size_t end, void *p_arg);
+
+/**
+ * @brief Compute one output row of one 3x3 kernel.
+ *
+ * @param p_ctx Pointer to the convolution context.
+ * @param pp_rows The three input rows under the output row, NULL where a
+ *                row falls in the padding.
+ * @param p_weights Pointer to the 9 kernel weights, row-major.
+ * @param p_out Pointer to the output row.
+ */
+static void conv_direct_row(const conv_ctx_t    *p_ctx,
+                            const double *const *pp_rows,
+                            const double        *p_weights,
+                            double              *p_out);
+
+/**
+ * @brief Compute one output pixel of a 3x3 kernel whose window reaches into
+ *        the left or right padding.
+ *
+ * @param p_ctx Pointer to the convolution context.
+ * @param pp_rows The three input rows, as for conv_direct_row.
+ * @param p_weights Pointer to the 9 kernel weights, row-major.
+ * @param out_col Output column.
+ *
+ * @return Output value.
+ */
+static double conv_direct_edge(const conv_ctx_t    *p_ctx,
+                               const double *const *pp_rows,
+                               const double        *p_weights,
+                               size_t               out_col);
+
+matrix_error_code_t
+matrix_conv2d_size (size_t                      rows,
+                    size_t                      cols,
+                    const matrix_conv_params_t *p_params,
+                    size_t                     *p_out_rows,
+                    size_t                     *p_out_cols)
+{
+    if ((NULL == p_params) || (NULL == p_out_rows) || (NULL == p_out_cols)
+        || (0U == rows) || (0U == cols) || (0U == p_params->kernel_rows)
+        || (0U == p_params->kernel_cols) || (0U == p_params->stride_rows)
+        || (0U == p_params->stride_cols)
+        || (p_params->pad_rows > (SIZE_MAX - rows) / 2U)
+        || (p_params->pad_cols > (SIZE_MAX - cols) / 2U))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t padded_rows = rows + (2U * p_params->pad_rows);
+    size_t padded_cols = cols + (2U * p_params->pad_cols);
+
+    if ((p_params->kernel_rows > padded_rows)
+        || (p_params->kernel_cols > padded_cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    *p_out_rows
+        = ((padded_rows - p_params->kernel_rows) / p_params->stride_rows) + 1U;
+    *p_out_cols
+        = ((padded_cols - p_params->kernel_cols) / p_params->stride_cols) + 1U;
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_conv2d (const matrix_t             *p_input,
+               const matrix_t             *p_kernels,
+               const matrix_conv_params_t *p_params,
+               matrix_t                   *p_output)
+{
+    size_t out_rows = 0U;
+    size_t out_cols = 0U;
+
+    if ((NULL == p_input) || (NULL == p_kernels) || (NULL == p_output)
+        || (NULL == p_input->p_data) || (NULL == p_kernels->p_data)
+        || (NULL == p_output->p_data)
+        || (MATRIX_SUCCESS
+            != matrix_conv2d_size(
+                p_input->rows, p_input->cols, p_params, &out_rows, &out_cols)))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t kernel_rows = p_params->kernel_rows;
+    size_t kernel_cols = p_params->kernel_cols;
+    size_t kernels     = p_kernels->rows;
+
+    if ((kernel_rows > SIZE_MAX / kernel_cols)
+        || (p_kernels->cols != kernel_rows * kernel_cols) || (0U == kernels)
+        || (p_output->rows != kernels) || (out_rows > SIZE_MAX / out_cols)
+        || (p_output->cols != out_rows * out_cols)
+        || matrix_is_overlapping(p_output, p_input)
+        || matrix_is_overlapping(p_output, p_kernels))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    bool b_3x3    = (3U == kernel_rows) && (3U == kernel_cols);
+    bool b_direct = (MATRIX_CONV_DIRECT == p_params->algorithm)
+                    || ((MATRIX_CONV_AUTO == p_params->algorithm) && b_3x3
+                        && (kernels <= MATRIX_CONV_DIRECT_MAX_KERNELS));
+
+    if ((MATRIX_CONV_DIRECT == p_params->algorithm) && (false == b_3x3))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    conv_ctx_t ctx = {
+        .p_input   = p_input,
+        .p_kernels = p_kernels,
+        .p_params  = p_params,
+        .p_output  = p_output,
+        .out_rows  = out_rows,
+        .out_cols  = out_cols,
+    };
+    size_t taps = kernel_rows * kernel_cols;
+
+    if (b_direct)
+    {
+        size_t row_work = out_cols * kernels * taps;
+        parallel_for(out_rows,
+                     (MATRIX_CONV_PARALLEL_MIN + row_work - 1U) / row_work,
+                     conv_direct_range,
+                     &ctx);
+        return MATRIX_SUCCESS;
+    }
+
+    size_t pixels  = out_rows * out_cols;
+    ctx.panel_cols = MIN(pixels, MAX((size_t)8U, MATRIX_CONV_PANEL / taps));
+    size_t panels  = (pixels + ctx.panel_cols - 1U) / ctx.panel_cols;
+    ctx.p_status   = malloc(panels * sizeof(matrix_error_code_t));
+
+    if (NULL == ctx.p_status)
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    size_t panel_work = ctx.panel_cols * kernels * taps;
+    parallel_for(panels,
+                 (MATRIX_CONV_PARALLEL_MIN + panel_work - 1U) / panel_work,
+                 conv_im2col_range,
+                 &ctx);
+
+    matrix_error_code_t ret = MATRIX_SUCCESS;
+
+    for (size_t panel = 0U; (panel < panels) && (MATRIX_SUCCESS == ret);
+         ++panel)
+    {
+        ret = ctx.p_status[panel];
+    }
+
+    free(ctx.p_status);
+    return ret;
+}
+
+static void
+conv_valid_range (size_t  start,
+                  size_t  stride,
+                  size_t  count,
+                  size_t  pad,
+                  size_t  size,
+                  size_t *p_first,
+                  size_t *p_last)
+{
+    size_t first = 0U;
+    size_t last  = 0U;
+
+    if (start < pad + size)
+    {
+        first = (start >= pad) ? 0U : (pad - start + stride - 1U) / stride;
+        last  = ((pad + size - 1U - start) / stride) + 1U;
+    }
+
+    last     = MIN(last, count);
+    *p_first = MIN(first, last);
+    *p_last  = last;
+}
+
+static void
+conv_gather (const conv_ctx_t *p_ctx,
+             size_t            first,
+             size_t            width,
+             double           *p_panel)
+{
+    const matrix_t             *p_input  = p_ctx->p_input;
+    const matrix_conv_params_t *p_params = p_ctx->p_params;
+    size_t                      taps
+        = p_params->kernel_rows * p_params->kernel_cols;
+
+    for (size_t tap = 0U; tap < taps; ++tap)
+    {
+        size_t  kernel_row = tap / p_params->kernel_cols;
+        size_t  kernel_col = tap % p_params->kernel_cols;
+        double *p_dst      = p_panel + (tap * width);
+        size_t  done       = 0U;
+
+        // Walk the pixels one output row at a time; within a run the input
+        // row is fixed and only the column advances
+        while (done < width)
+        {
+            size_t  out_row = (first + done) / p_ctx->out_cols;
+            size_t  out_col = (first + done) % p_ctx->out_cols;
+            size_t  run     = MIN(p_ctx->out_cols - out_col, width - done);
+            size_t  in_row  = (out_row * p_params->stride_rows) + kernel_row;
+            size_t  in_col  = (out_col * p_params->stride_cols) + kernel_col;
+            size_t  lo      = 0U;
+            size_t  hi      = 0U;
+            double *p_run   = p_dst + done;
+
+            if ((in_row >= p_params->pad_rows)
+                && (in_row - p_params->pad_rows < p_input->rows))
+            {
+                conv_valid_range(in_col,
+                                 p_params->stride_cols,
+                                 run,
+                                 p_params->pad_cols,
+                                 p_input->cols,
+                                 &lo,
+                                 &hi);
+            }
+
+            memset(p_run, 0, lo * sizeof(double));
+
+            if (lo < hi)
+            {
+                const double *p_src
+                    = p_input->p_data
+                      + ((in_row - p_params->pad_rows) * p_input->ld)
+                      + (in_col + (lo * p_params->stride_cols))
+                      - p_params->pad_cols;
+
+                if (1U == p_params->stride_cols)
+                {
+                    memcpy(p_run + lo, p_src, (hi - lo) * sizeof(double));
+                }
+                else
+                {
+                    for (size_t idx = lo; idx < hi; ++idx)
+                    {
+                        p_run[idx]
+                            = p_src[(idx - lo) * p_params->stride_cols];
+                    }
+                }
+            }
+
+            memset(p_run + hi, 0, (run - hi) * sizeof(double));
+            done += run;
+        }
+    }
+}
+
+static void
+conv_im2col_range (size_t begin, size_t end, void *p_arg)
+{
+    const conv_ctx_t *p_ctx     = (const conv_ctx_t *)p_arg;
+    const matrix_t   *p_kernels = p_ctx->p_kernels;
+    matrix_t         *p_output  = p_ctx->p_output;
+    size_t            pixels    = p_ctx->out_rows * p_ctx->out_cols;
+    double           *p_panel   = (double *)malloc(
+        p_kernels->cols * p_ctx->panel_cols * sizeof(double));
+
+    for (size_t panel = begin; panel < end; ++panel)
+    {
+        size_t first = panel * p_ctx->panel_cols;
+        size_t width = MIN(p_ctx->panel_cols, pixels - first);
+
+        if (NULL == p_panel)
+        {
+            p_ctx->p_status[panel] = MATRIX_ALLOCATION_FAILURE;
+            continue;
+        }
+
+        conv_gather(p_ctx, first, width, p_panel);
+        p_ctx->p_status[panel] = matrix_gemm(p_kernels->rows,
+                                             width,
+                                             p_kernels->cols,
+                                             1.0,
+                                             p_kernels->p_data,
+                                             p_kernels->ld,
+                                             p_panel,
+                                             width,
+                                             0.0,
+                                             p_output->p_data + first,
+                                             p_output->ld);
+    }
+
+    free(p_panel);
+}
+
+static void
+conv_direct_range (size_t begin, size_t end, void *p_arg)
+{
+    const conv_ctx_t           *p_ctx     = (const conv_ctx_t *)p_arg;
+    const matrix_t             *p_input   = p_ctx->p_input;
+    const matrix_t             *p_kernels = p_ctx->p_kernels;
+    const matrix_conv_params_t *p_params  = p_ctx->p_params;
+
+    for (size_t out_row = begin; out_row < end; ++out_row)
+    {
+        const double *p_rows[3];
+
+        for (size_t dy = 0U; dy < 3U; ++dy)
+        {
+            size_t in_row = (out_row * p_params->stride_rows) + dy;
+
+            p_rows[dy] = ((in_row >= p_params->pad_rows)
+                          && (in_row - p_params->pad_rows < p_input->rows))
+                             ? p_input->p_data
+                                   + ((in_row - p_params->pad_rows)
+                                      * p_input->ld)
+                             : NULL;
+        }
+
+        // All kernels share the three input rows while they are in L1
+        for (size_t kernel = 0U; kernel < p_kernels->rows; ++kernel)
+        {
+            conv_direct_row(p_ctx,
+                            p_rows,
+                            p_kernels->p_data + (kernel * p_kernels->ld),
+                            p_ctx->p_output->p_data
+                                + (kernel * p_ctx->p_output->ld)
+                                + (out_row * p_ctx->out_cols));
+        }
+    }
+}
+
+static void
+conv_direct_row (const conv_ctx_t    *p_ctx,
+                 const double *const *pp_rows,
+                 const double        *p_weights,
+                 double              *p_out)
+{
+    size_t stride   = p_ctx->p_params->stride_cols;
+    size_t pad      = p_ctx->p_params->pad_cols;
+    size_t out_cols = p_ctx->out_cols;
+    size_t first    = 0U;
+    size_t last     = 0U;
+    size_t unused   = 0U;
+
+    // Interior pixels have all three kernel columns inside the input: the
+    // left column bounds them from below, the right one from above
+    conv_valid_range(
+        0U, stride, out_cols, pad, p_ctx->p_input->cols, &first, &unused);
+    conv_valid_range(
+        2U, stride, out_cols, pad, p_ctx->p_input->cols, &unused, &last);
+    last = MAX(first, last);
+
+    for (size_t out_col = 0U; out_col < first; ++out_col)
+    {
+        p_out[out_col] = conv_direct_edge(p_ctx, pp_rows, p_weights, out_col);
+    }
+
+    for (size_t out_col = last; out_col < out_cols; ++out_col)
+    {
+        p_out[out_col] = conv_direct_edge(p_ctx, pp_rows, p_weights, out_col);
+    }
+
+    size_t out_col = first;
+
+#if defined(__AVX__)
+    if (1U == stride)
+    {
+        __m256d weights[9];
+
+        for (size_t tap = 0U; tap < 9U; ++tap)
+        {
+            weights[tap] = _mm256_set1_pd(p_weights[tap]);
+        }
+
+        for (; out_col + 8U <= last; out_col += 8U)
+        {
+            __m256d acc_lo = _mm256_setzero_pd();
+            __m256d acc_hi = _mm256_setzero_pd();
+
+            for (size_t dy = 0U; dy < 3U; ++dy)
+            {
+                if (NULL == pp_rows[dy])
+                {
+                    continue;
+                }
+
+                const double *p_in = pp_rows[dy] + out_col - pad;
+
+                for (size_t dx = 0U; dx < 3U; ++dx)
+                {
+                    __m256d weight = weights[(3U * dy) + dx];
+                    __m256d lo     = _mm256_loadu_pd(p_in + dx);
+                    __m256d hi     = _mm256_loadu_pd(p_in + dx + 4U);
+#if defined(__FMA__)
+                    acc_lo = _mm256_fmadd_pd(weight, lo, acc_lo);
+                    acc_hi = _mm256_fmadd_pd(weight, hi, acc_hi);
+#else
+                    acc_lo = _mm256_add_pd(acc_lo, _mm256_mul_pd(weight, lo));
+                    acc_hi = _mm256_add_pd(acc_hi, _mm256_mul_pd(weight, hi));
+#endif
+                }
+            }
+
+            _mm256_storeu_pd(p_out + out_col, acc_lo);
+            _mm256_storeu_pd(p_out + out_col + 4U, acc_hi);
+        }
+    }
+#endif
+
+    for (; out_col < last; ++out_col)
+    {
+        size_t base = (out_col * stride) - pad;
+        double sum  = 0.0;
+
+        for (size_t dy = 0U; dy < 3U; ++dy)
+        {
+            const double *p_w = p_weights + (3U * dy);
+
+            if (NULL != pp_rows[dy])
+            {
+                sum += (p_w[0] * pp_rows[dy][base])
+                       + (p_w[1] * pp_rows[dy][base + 1U])
+                       + (p_w[2] * pp_rows[dy][base + 2U]);
+            }
+        }
+
+        p_out[out_col] = sum;
+    }
+}
+
+static double
+conv_direct_edge (const conv_ctx_t    *p_ctx,
+                  const double *const *pp_rows,
+                  const double        *p_weights,
+                  size_t               out_col)
+{
+    size_t pad     = p_ctx->p_params->pad_cols;
+    size_t in_cols = p_ctx->p_input->cols;
+    double sum     = 0.0;
+
+    for (size_t dy = 0U; dy < 3U; ++dy)
+    {
+        for (size_t dx = 0U; (dx < 3U) && (NULL != pp_rows[dy]); ++dx)
+        {
+            size_t in_col = (out_col * p_ctx->p_params->stride_cols) + dx;
+
+            if ((in_col >= pad) && (in_col - pad < in_cols))
+            {
+                sum += p_weights[(3U * dy) + dx] * pp_rows[dy][in_col - pad];
+            }
+        }
+    }
+
+    return sum;
+}
+
+/*** end of file ***/
@@ -0,0 +1,523 @@
+/**
+ * @file matrix_expr.c
+ * @brief Implementation of lazily evaluated, fused matrix expressions.
+ *
+ * Calling matrix_add, matrix_scalar_multiply and matrix_multiply one after
+ * another materializes every intermediate result, costing an allocation and
+ * a full read and write of memory per operation. Here an expression is first
+ * built as a tree and only evaluated once the whole computation is known.
+ *
+ * Evaluation distributes scalars over sums and flattens the tree into a list
+ * of scaled terms, each of which is either a plain matrix or a product.
+ * Plain matrices are combined in one cache-blocked pass over the result, and
+ * each product is handed to matrix_gemm, which accumulates straight into the
+ * result with the term's scalars as alpha. A GEMM-shaped expression such as
+ * `alpha*A*B + beta*C` therefore runs as a single GEMM with no temporaries.
+ *
+ * @author heapbadger
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_expr.h"
+#include "matrix_internal.h"
+
+/**
+ * Number of columns combined per step of the element-wise pass, so that the
+ * output segment stays in L1 while every input term is added into it.
+ */
+#define EXPR_BLOCK 512
+
+typedef struct
+{
+    double               coef;
+    const matrix_expr_t *p_node; /**< MATRIX_EXPR_LEAF or _MULTIPLY node. */
+} expr_term_t;
+
+typedef struct
+{
+    const matrix_t *p_matrix; /**< Matrix to multiply. */
+    double          coef;     /**< Scalars folded out of the operand. */
+    matrix_t       *p_temp;   /**< Owned temporary, or NULL. */
+} expr_operand_t;
+
+/**
+ * @brief Allocate an expression node.
+ *
+ * @param op Node operation.
+ * @param rows Number of rows of the node's value.
+ * @param cols Number of columns of the node's value.
+ *
+ * @return Pointer to the zero-initialized node, or NULL on failure.
+ */
+static matrix_expr_t *expr_node_create(matrix_expr_op_t op,
+                                       size_t           rows,
+                                       size_t           cols);
+
+/**
+ * @brief Count the terms of the flattened expression.
+ *
+ * @param p_expr Pointer to the expression.
+ *
+ * @return Number of leaf and product nodes reachable through scales and sums.
+ */
+static size_t expr_count_terms(const matrix_expr_t *p_expr);
+
+/**
+ * @brief Flatten an expression into scaled leaf and product terms.
+ *
+ * @param p_expr Pointer to the expression.
+ * @param coef Scale accumulated from the enclosing nodes.
+ * @param p_terms Output term array.
+ * @param p_count In: number of terms written so far. Out: updated count.
+ */
+static void expr_collect_terms(const matrix_expr_t *p_expr,
+                               double               coef,
+                               expr_term_t         *p_terms,
+                               size_t              *p_count);
+
+/**
+ * @brief Reduce a product operand to a scaled matrix.
+ *
+ * Scales are folded into the coefficient. Anything other than a scaled leaf
+ * is evaluated into a temporary.
+ *
+ * @param p_expr Pointer to the operand expression.
+ * @param p_operand Output operand description.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+static matrix_error_code_t expr_resolve_operand(const matrix_expr_t *p_expr,
+                                                expr_operand_t      *p_operand);
+
+/**
+ * @brief Sum all leaf terms into p_target in one blocked pass.
+ *
+ * Leaves that are p_target itself scale it in place instead of being read
+ * as separate inputs.
+ *
+ * @param p_terms Term array.
+ * @param count Number of terms.
+ * @param p_target Pointer to the output.
+ *
+ * @return true if p_target was written, false if there are no leaf terms.
+ */
+static bool expr_combine_leaves(const expr_term_t *p_terms,
+                                size_t             count,
+                                matrix_t          *p_target);
+
+matrix_expr_t *
+matrix_expr_leaf (const matrix_t *p_matrix)
+{
+    if ((NULL == p_matrix) || (NULL == p_matrix->p_data))
+    {
+        return NULL;
+    }
+
+    matrix_expr_t *p_expr
+        = expr_node_create(MATRIX_EXPR_LEAF, p_matrix->rows, p_matrix->cols);
+
+    if (NULL != p_expr)
+    {
+        p_expr->p_matrix = p_matrix;
+    }
+
+    return p_expr;
+}
+
+matrix_expr_t *
+matrix_expr_scale (double scalar, matrix_expr_t *p_expr)
+{
+    if (NULL == p_expr)
+    {
+        return NULL;
+    }
+
+    matrix_expr_t *p_node
+        = expr_node_create(MATRIX_EXPR_SCALE, p_expr->rows, p_expr->cols);
+
+    if (NULL == p_node)
+    {
+        matrix_expr_destroy(p_expr);
+        return NULL;
+    }
+
+    p_node->scalar = scalar;
+    p_node->p_left = p_expr;
+    return p_node;
+}
+
+matrix_expr_t *
+matrix_expr_add (matrix_expr_t *p_left, matrix_expr_t *p_right)
+{
+    matrix_expr_t *p_node = NULL;
+
+    if ((NULL != p_left) && (NULL != p_right) && (p_left->rows == p_right->rows)
+        && (p_left->cols == p_right->cols))
+    {
+        p_node = expr_node_create(MATRIX_EXPR_ADD, p_left->rows, p_left->cols);
+    }
+
+    if (NULL == p_node)
+    {
+        matrix_expr_destroy(p_left);
+        matrix_expr_destroy(p_right);
+        return NULL;
+    }
+
+    p_node->p_left  = p_left;
+    p_node->p_right = p_right;
+    return p_node;
+}
+
+matrix_expr_t *
+matrix_expr_subtract (matrix_expr_t *p_left, matrix_expr_t *p_right)
+{
+    if (NULL == p_right)
+    {
+        matrix_expr_destroy(p_left);
+        return NULL;
+    }
+
+    return matrix_expr_add(p_left, matrix_expr_scale(-1.0, p_right));
+}
+
+matrix_expr_t *
+matrix_expr_multiply (matrix_expr_t *p_left, matrix_expr_t *p_right)
+{
+    matrix_expr_t *p_node = NULL;
+
+    if ((NULL != p_left) && (NULL != p_right)
+        && (p_left->cols == p_right->rows))
+    {
+        p_node = expr_node_create(
+            MATRIX_EXPR_MULTIPLY, p_left->rows, p_right->cols);
+    }
+
+    if (NULL == p_node)
+    {
+        matrix_expr_destroy(p_left);
+        matrix_expr_destroy(p_right);
+        return NULL;
+    }
+
+    p_node->p_left  = p_left;
+    p_node->p_right = p_right;
+    return p_node;
+}
+
+void
+matrix_expr_destroy (matrix_expr_t *p_expr)
+{
+    if (NULL != p_expr)
+    {
+        matrix_expr_destroy(p_expr->p_left);
+        matrix_expr_destroy(p_expr->p_right);
+        free(p_expr);
+    }
+}
+
+matrix_error_code_t
+matrix_expr_evaluate (const matrix_expr_t *p_expr, matrix_t *p_result)
+{
+    if ((NULL == p_expr) || (NULL == p_result) || (NULL == p_result->p_data)
+        || (p_expr->rows != p_result->rows) || (p_expr->cols != p_result->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_error_code_t ret        = MATRIX_SUCCESS;
+    matrix_t           *p_target   = p_result;
+    matrix_t           *p_scratch  = NULL;
+    size_t              count      = expr_count_terms(p_expr);
+    size_t              collected  = 0U;
+    expr_term_t        *p_terms    = NULL;
+    expr_operand_t     *p_operands = NULL;
+
+    p_terms    = (expr_term_t *)malloc(count * sizeof(expr_term_t));
+    p_operands = (expr_operand_t *)calloc(2U * count, sizeof(expr_operand_t));
+
+    if ((NULL == p_terms) || (NULL == p_operands))
+    {
+        ret   = MATRIX_ALLOCATION_FAILURE;
+        count = 0U;
+        goto CLEANUP;
+    }
+
+    expr_collect_terms(p_expr, 1.0, p_terms, &collected);
+
+    // Resolve every product operand before the result is written, since a
+    // nested operand may itself read the result
+    bool b_alias = false;
+
+    for (size_t idx = 0U; idx < count; ++idx)
+    {
+        const matrix_expr_t *p_node = p_terms[idx].p_node;
+
+        if (MATRIX_EXPR_LEAF == p_node->op)
+        {
+            b_alias = b_alias
+                      || matrix_is_unsafe_alias(p_node->p_matrix, p_result);
+            continue;
+        }
+
+        for (size_t side = 0U; side < 2U; ++side)
+        {
+            const matrix_expr_t *p_side
+                = (0U == side) ? p_node->p_left : p_node->p_right;
+            expr_operand_t *p_operand = &p_operands[(2U * idx) + side];
+            ret = expr_resolve_operand(p_side, p_operand);
+
+            if (MATRIX_SUCCESS != ret)
+            {
+                goto CLEANUP;
+            }
+
+            b_alias = b_alias
+                      || matrix_is_overlapping(p_operand->p_matrix, p_result);
+        }
+    }
+
+    if (b_alias)
+    {
+        // GEMM must not write to its own inputs
+        p_scratch = matrix_create(p_result->rows, p_result->cols);
+
+        if (NULL == p_scratch)
+        {
+            ret = MATRIX_ALLOCATION_FAILURE;
+            goto CLEANUP;
+        }
+
+        p_target = p_scratch;
+    }
+
+    double beta = expr_combine_leaves(p_terms, count, p_target) ? 1.0 : 0.0;
+
+    for (size_t idx = 0U; idx < count; ++idx)
+    {
+        if (MATRIX_EXPR_MULTIPLY != p_terms[idx].p_node->op)
+        {
+            continue;
+        }
+
+        const expr_operand_t *p_lhs = &p_operands[2U * idx];
+        const expr_operand_t *p_rhs = &p_operands[(2U * idx) + 1U];
+        ret = matrix_gemm(p_lhs->p_matrix->rows,
+                          p_rhs->p_matrix->cols,
+                          p_lhs->p_matrix->cols,
+                          p_terms[idx].coef * p_lhs->coef * p_rhs->coef,
+                          p_lhs->p_matrix->p_data,
+                          p_lhs->p_matrix->ld,
+                          p_rhs->p_matrix->p_data,
+                          p_rhs->p_matrix->ld,
+                          beta,
+                          p_target->p_data,
+                          p_target->ld);
+
+        if (MATRIX_SUCCESS != ret)
+        {
+            goto CLEANUP;
+        }
+
+        beta = 1.0;
+    }
+
+    if (NULL != p_scratch)
+    {
+        for (size_t row = 0U; row < p_result->rows; ++row)
+        {
+            memcpy(p_result->p_data + (row * p_result->ld),
+                   p_scratch->p_data + (row * p_scratch->ld),
+                   p_result->cols * sizeof(double));
+        }
+    }
+
+CLEANUP:
+    for (size_t idx = 0U; idx < 2U * count; ++idx)
+    {
+        matrix_destroy(p_operands[idx].p_temp);
+    }
+
+    matrix_destroy(p_scratch);
+    free(p_operands);
+    free(p_terms);
+    return ret;
+}
+
+static matrix_expr_t *
+expr_node_create (matrix_expr_op_t op, size_t rows, size_t cols)
+{
+    matrix_expr_t *p_expr = (matrix_expr_t *)calloc(1U, sizeof(matrix_expr_t));
+
+    if (NULL != p_expr)
+    {
+        p_expr->op     = op;
+        p_expr->rows   = rows;
+        p_expr->cols   = cols;
+        p_expr->scalar = 1.0;
+    }
+
+    return p_expr;
+}
+
+static size_t
+expr_count_terms (const matrix_expr_t *p_expr)
+{
+    switch (p_expr->op)
+    {
+        case MATRIX_EXPR_SCALE:
+            return expr_count_terms(p_expr->p_left);
+
+        case MATRIX_EXPR_ADD:
+            return expr_count_terms(p_expr->p_left)
+                   + expr_count_terms(p_expr->p_right);
+
+        default:
+            return 1U;
+    }
+}
+
+static void
+expr_collect_terms (const matrix_expr_t *p_expr,
+                    double               coef,
+                    expr_term_t         *p_terms,
+                    size_t              *p_count)
+{
+    switch (p_expr->op)
+    {
+        case MATRIX_EXPR_SCALE:
+            expr_collect_terms(
+                p_expr->p_left, coef * p_expr->scalar, p_terms, p_count);
+            break;
+
+        case MATRIX_EXPR_ADD:
+            expr_collect_terms(p_expr->p_left, coef, p_terms, p_count);
+            expr_collect_terms(p_expr->p_right, coef, p_terms, p_count);
+            break;
+
+        default:
+            p_terms[*p_count].coef   = coef;
+            p_terms[*p_count].p_node = p_expr;
+            (*p_count)++;
+            break;
+    }
+}
+
+static matrix_error_code_t
+expr_resolve_operand (const matrix_expr_t *p_expr, expr_operand_t *p_operand)
+{
+    double coef = 1.0;
+
+    while (MATRIX_EXPR_SCALE == p_expr->op)
+    {
+        coef *= p_expr->scalar;
+        p_expr = p_expr->p_left;
+    }
+
+    p_operand->coef = coef;
+
+    if (MATRIX_EXPR_LEAF == p_expr->op)
+    {
+        p_operand->p_matrix = p_expr->p_matrix;
+        return MATRIX_SUCCESS;
+    }
+
+    p_operand->p_temp = matrix_create(p_expr->rows, p_expr->cols);
+
+    if (NULL == p_operand->p_temp)
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    p_operand->p_matrix = p_operand->p_temp;
+    return matrix_expr_evaluate(p_expr, p_operand->p_temp);
+}
+
+static bool
+expr_combine_leaves (const expr_term_t *p_terms,
+                     size_t             count,
+                     matrix_t          *p_target)
+{
+    double self_coef = 0.0;
+    bool   b_self    = false;
+    bool   b_any     = false;
+
+    for (size_t idx = 0U; idx < count; ++idx)
+    {
+        const matrix_expr_t *p_node = p_terms[idx].p_node;
+
+        if (MATRIX_EXPR_LEAF != p_node->op)
+        {
+            continue;
+        }
+
+        b_any = true;
+
+        if (matrix_is_same_storage(p_node->p_matrix, p_target))
+        {
+            self_coef += p_terms[idx].coef;
+            b_self = true;
+        }
+    }
+
+    if (false == b_any)
+    {
+        return false;
+    }
+
+    for (size_t row = 0U; row < p_target->rows; ++row)
+    {
+        double *p_out = p_target->p_data + (row * p_target->ld);
+
+        for (size_t col = 0U; col < p_target->cols; col += EXPR_BLOCK)
+        {
+            size_t width   = MIN(p_target->cols - col, (size_t)EXPR_BLOCK);
+            bool   b_first = !b_self;
+
+            if (b_self && (1.0 != self_coef))
+            {
+                for (size_t idx = col; idx < col + width; ++idx)
+                {
+                    p_out[idx] *= self_coef;
+                }
+            }
+
+            for (size_t term = 0U; term < count; ++term)
+            {
+                const matrix_expr_t *p_node = p_terms[term].p_node;
+
+                if ((MATRIX_EXPR_LEAF != p_node->op)
+                    || matrix_is_same_storage(p_node->p_matrix, p_target))
+                {
+                    continue;
+                }
+
+                double        coef = p_terms[term].coef;
+                const double *p_in = p_node->p_matrix->p_data
+                                     + (row * p_node->p_matrix->ld);
+
+                if (b_first)
+                {
+                    for (size_t idx = col; idx < col + width; ++idx)
+                    {
+                        p_out[idx] = coef * p_in[idx];
+                    }
+
+                    b_first = false;
+                }
+                else
+                {
+                    for (size_t idx = col; idx < col + width; ++idx)
+                    {
+                        p_out[idx] += coef * p_in[idx];
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+/*** end of file ***/
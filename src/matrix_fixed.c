@@ -0,0 +1,392 @@
+/**
+ * @file matrix_fixed.c
+ * @brief Implementation of fixed-size 2x2, 3x3 and 4x4 matrices.
+ *
+ * Small transforms are dominated by overhead in the general matrix_t path:
+ * a heap allocation per matrix, runtime dimension checks and loops whose
+ * trip count is too short to amortize their control flow. Here the order is
+ * a compile-time constant and every kernel is written out element by
+ * element, so a 4x4 multiply is 64 multiplies and 48 adds with no loops and
+ * no branches.
+ *
+ * Each kernel body is a macro over its element type, its load macro and its
+ * store macro. The body is written once and instantiated twice:
+ *
+ * - with `double` and plain array access for the single-matrix functions;
+ * - with a SIMD vector type for the batched functions. A pack stores element
+ *   e of MATRIX_FIXED_LANES matrices contiguously, so loading element e
+ *   loads it for a whole lane group, and the unchanged scalar formula
+ *   computes that many matrices at once. The vector types use GCC/Clang
+ *   vector arithmetic, so `a * b + c` means the same thing in both
+ *   instantiations.
+ *
+ * The inverse is the adjugate scaled by the reciprocal of the determinant.
+ * It uses no pivoting, so it is exact in the same cases that the closed
+ * form is. For ill-conditioned matrices prefer matrix_inverse.
+ *
+ * @author heapbadger
+ */
+
+#include <string.h>
+#include "matrix_fixed.h"
+
+#if defined(__AVX512F__) || defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Lane group processed by one batched kernel instance: a whole pack with
+ * AVX-512, half a pack with AVX, and one matrix at a time otherwise.
+ */
+#if defined(__AVX512F__)
+typedef __m512d fixed_lane_t;
+#define FIXED_STEP           8
+#define FIXED_LOAD(p)        _mm512_loadu_pd(p)
+#define FIXED_STORE(p, v)    _mm512_storeu_pd((p), (v))
+#define FIXED_SPLAT(x)       _mm512_set1_pd(x)
+#elif defined(__AVX__)
+typedef __m256d fixed_lane_t;
+#define FIXED_STEP           4
+#define FIXED_LOAD(p)        _mm256_loadu_pd(p)
+#define FIXED_STORE(p, v)    _mm256_storeu_pd((p), (v))
+#define FIXED_SPLAT(x)       _mm256_set1_pd(x)
+#else
+typedef double fixed_lane_t;
+#define FIXED_STEP           1
+#define FIXED_LOAD(p)        (*(p))
+#define FIXED_STORE(p, v)    (*(p) = (v))
+#define FIXED_SPLAT(x)       (x)
+#endif
+
+_Static_assert(0 == (MATRIX_FIXED_LANES % FIXED_STEP),
+               "a pack must hold a whole number of lane groups");
+
+/**
+ * Element access used by the kernel bodies. The single-matrix functions read
+ * `p_a` and `p_b`, the batched functions read lane group `lane` of pack
+ * `pack`, and both write to a local `out` array so that outputs may alias
+ * inputs.
+ */
+#define SCALAR_A(e)     (p_a->m[e])
+#define SCALAR_B(e)     (p_b->m[e])
+#define LANES_A(e)      FIXED_LOAD(&p_a[pack].m[e][lane])
+#define LANES_B(e)      FIXED_LOAD(&p_b[pack].m[e][lane])
+#define FIXED_OUT(e, v) (out[e] = (v))
+
+/**
+ * Entry (r, c) of the product for each order, and the full product written
+ * row by row.
+ */
+#define FIXED_DOT_2(A, B, r, c)                                              \
+    ((A(2 * (r)) * B(c)) + (A(2 * (r) + 1) * B(2 + (c))))
+#define FIXED_DOT_3(A, B, r, c)                                              \
+    ((A(3 * (r)) * B(c)) + (A(3 * (r) + 1) * B(3 + (c)))                     \
+     + (A(3 * (r) + 2) * B(6 + (c))))
+#define FIXED_DOT_4(A, B, r, c)                                              \
+    (((A(4 * (r)) * B(c)) + (A(4 * (r) + 1) * B(4 + (c))))                   \
+     + ((A(4 * (r) + 2) * B(8 + (c))) + (A(4 * (r) + 3) * B(12 + (c)))))
+
+#define FIXED_ROW_2(A, B, ST, r)                                             \
+    ST(2 * (r), FIXED_DOT_2(A, B, r, 0));                                    \
+    ST(2 * (r) + 1, FIXED_DOT_2(A, B, r, 1));
+#define FIXED_ROW_3(A, B, ST, r)                                             \
+    ST(3 * (r), FIXED_DOT_3(A, B, r, 0));                                    \
+    ST(3 * (r) + 1, FIXED_DOT_3(A, B, r, 1));                                \
+    ST(3 * (r) + 2, FIXED_DOT_3(A, B, r, 2));
+#define FIXED_ROW_4(A, B, ST, r)                                             \
+    ST(4 * (r), FIXED_DOT_4(A, B, r, 0));                                    \
+    ST(4 * (r) + 1, FIXED_DOT_4(A, B, r, 1));                                \
+    ST(4 * (r) + 2, FIXED_DOT_4(A, B, r, 2));                                \
+    ST(4 * (r) + 3, FIXED_DOT_4(A, B, r, 3));
+
+#define FIXED_MUL_2(A, B, ST) FIXED_ROW_2(A, B, ST, 0) FIXED_ROW_2(A, B, ST, 1)
+#define FIXED_MUL_3(A, B, ST)                                                \
+    FIXED_ROW_3(A, B, ST, 0) FIXED_ROW_3(A, B, ST, 1) FIXED_ROW_3(A, B, ST, 2)
+#define FIXED_MUL_4(A, B, ST)                                                \
+    FIXED_ROW_4(A, B, ST, 0) FIXED_ROW_4(A, B, ST, 1)                        \
+    FIXED_ROW_4(A, B, ST, 2) FIXED_ROW_4(A, B, ST, 3)
+
+/**
+ * Determinant and adjugate for each order. FIXED_MINORS_N declares the
+ * cofactor terms shared by FIXED_DET_N and FIXED_ADJ_N.
+ */
+#define FIXED_MINORS_2(T, A)
+#define FIXED_DET_2(A) ((A(0) * A(3)) - (A(1) * A(2)))
+#define FIXED_ADJ_2(A, ST)                                                   \
+    ST(0, A(3));                                                             \
+    ST(1, -A(1));                                                            \
+    ST(2, -A(2));                                                            \
+    ST(3, A(0));
+
+#define FIXED_MINORS_3(T, A)                                                 \
+    T c00 = (A(4) * A(8)) - (A(5) * A(7));                                   \
+    T c01 = (A(5) * A(6)) - (A(3) * A(8));                                   \
+    T c02 = (A(3) * A(7)) - (A(4) * A(6));
+#define FIXED_DET_3(A) ((A(0) * c00) + (A(1) * c01) + (A(2) * c02))
+#define FIXED_ADJ_3(A, ST)                                                   \
+    ST(0, c00);                                                              \
+    ST(1, (A(2) * A(7)) - (A(1) * A(8)));                                    \
+    ST(2, (A(1) * A(5)) - (A(2) * A(4)));                                    \
+    ST(3, c01);                                                              \
+    ST(4, (A(0) * A(8)) - (A(2) * A(6)));                                    \
+    ST(5, (A(2) * A(3)) - (A(0) * A(5)));                                    \
+    ST(6, c02);                                                              \
+    ST(7, (A(1) * A(6)) - (A(0) * A(7)));                                    \
+    ST(8, (A(0) * A(4)) - (A(1) * A(3)));
+
+// 2x2 minors of the top two rows (s) and the bottom two rows (c)
+#define FIXED_MINORS_4(T, A)                                                 \
+    T s0 = (A(0) * A(5)) - (A(4) * A(1));                                    \
+    T s1 = (A(0) * A(6)) - (A(4) * A(2));                                    \
+    T s2 = (A(0) * A(7)) - (A(4) * A(3));                                    \
+    T s3 = (A(1) * A(6)) - (A(5) * A(2));                                    \
+    T s4 = (A(1) * A(7)) - (A(5) * A(3));                                    \
+    T s5 = (A(2) * A(7)) - (A(6) * A(3));                                    \
+    T c5 = (A(10) * A(15)) - (A(14) * A(11));                                \
+    T c4 = (A(9) * A(15)) - (A(13) * A(11));                                 \
+    T c3 = (A(9) * A(14)) - (A(13) * A(10));                                 \
+    T c2 = (A(8) * A(15)) - (A(12) * A(11));                                 \
+    T c1 = (A(8) * A(14)) - (A(12) * A(10));                                 \
+    T c0 = (A(8) * A(13)) - (A(12) * A(9));
+#define FIXED_DET_4(A)                                                       \
+    (((s0 * c5) - (s1 * c4)) + ((s2 * c3) + (s3 * c2))                       \
+     + ((s5 * c0) - (s4 * c1)))
+#define FIXED_ADJ_4(A, ST)                                                   \
+    ST(0, (A(5) * c5) - (A(6) * c4) + (A(7) * c3));                          \
+    ST(1, (A(2) * c4) - (A(1) * c5) - (A(3) * c3));                          \
+    ST(2, (A(13) * s5) - (A(14) * s4) + (A(15) * s3));                       \
+    ST(3, (A(10) * s4) - (A(9) * s5) - (A(11) * s3));                        \
+    ST(4, (A(6) * c2) - (A(4) * c5) - (A(7) * c1));                          \
+    ST(5, (A(0) * c5) - (A(2) * c2) + (A(3) * c1));                          \
+    ST(6, (A(14) * s2) - (A(12) * s5) - (A(15) * s1));                       \
+    ST(7, (A(8) * s5) - (A(10) * s2) + (A(11) * s1));                        \
+    ST(8, (A(4) * c4) - (A(5) * c2) + (A(7) * c0));                          \
+    ST(9, (A(1) * c2) - (A(0) * c4) - (A(3) * c0));                          \
+    ST(10, (A(12) * s4) - (A(13) * s2) + (A(15) * s0));                      \
+    ST(11, (A(9) * s2) - (A(8) * s4) - (A(11) * s0));                        \
+    ST(12, (A(5) * c1) - (A(4) * c3) - (A(6) * c0));                         \
+    ST(13, (A(0) * c3) - (A(1) * c1) + (A(2) * c0));                         \
+    ST(14, (A(13) * s1) - (A(12) * s3) - (A(14) * s0));                      \
+    ST(15, (A(8) * s3) - (A(9) * s1) + (A(10) * s0));
+
+/**
+ * @brief Define the single-matrix functions for order N.
+ */
+#define FIXED_SCALAR_DEFINE(N)                                               \
+    matrix_error_code_t matrix##N##_multiply(const matrix##N##_t *p_a,      \
+                                             const matrix##N##_t *p_b,      \
+                                             matrix##N##_t       *p_c)      \
+    {                                                                       \
+        if ((NULL == p_a) || (NULL == p_b) || (NULL == p_c))                \
+        {                                                                   \
+            return MATRIX_INVALID_ARGUMENT;                                 \
+        }                                                                   \
+                                                                            \
+        double out[(N) * (N)];                                              \
+        FIXED_MUL_##N(SCALAR_A, SCALAR_B, FIXED_OUT)                        \
+        memcpy(p_c->m, out, sizeof(out));                                   \
+        return MATRIX_SUCCESS;                                              \
+    }                                                                       \
+                                                                            \
+    matrix_error_code_t matrix##N##_determinant(const matrix##N##_t *p_a,   \
+                                                double              *p_det) \
+    {                                                                       \
+        if ((NULL == p_a) || (NULL == p_det))                               \
+        {                                                                   \
+            return MATRIX_INVALID_ARGUMENT;                                 \
+        }                                                                   \
+                                                                            \
+        FIXED_MINORS_##N(double, SCALAR_A)                                  \
+        *p_det = FIXED_DET_##N(SCALAR_A);                                   \
+        return MATRIX_SUCCESS;                                              \
+    }                                                                       \
+                                                                            \
+    matrix_error_code_t matrix##N##_inverse(const matrix##N##_t *p_a,       \
+                                            matrix##N##_t       *p_inv)     \
+    {                                                                       \
+        if ((NULL == p_a) || (NULL == p_inv))                               \
+        {                                                                   \
+            return MATRIX_INVALID_ARGUMENT;                                 \
+        }                                                                   \
+                                                                            \
+        double out[(N) * (N)];                                              \
+        FIXED_MINORS_##N(double, SCALAR_A)                                  \
+        double det = FIXED_DET_##N(SCALAR_A);                               \
+                                                                            \
+        if (0.0 == det)                                                     \
+        {                                                                   \
+            return MATRIX_SINGULAR;                                         \
+        }                                                                   \
+                                                                            \
+        FIXED_ADJ_##N(SCALAR_A, FIXED_OUT)                                  \
+        double inv_det = 1.0 / det;                                         \
+                                                                            \
+        for (size_t e = 0U; e < ((N) * (N)); ++e)                           \
+        {                                                                   \
+            p_inv->m[e] = out[e] * inv_det;                                 \
+        }                                                                   \
+                                                                            \
+        return MATRIX_SUCCESS;                                              \
+    }
+
+/**
+ * @brief Define pack/unpack and the batched functions for order N.
+ *
+ * The lane loop runs MATRIX_FIXED_LANES / FIXED_STEP times per pack, once
+ * with AVX-512.
+ */
+#define FIXED_BATCH_DEFINE(N)                                                \
+    matrix_error_code_t matrix##N##_pack(const matrix##N##_t *p_src,        \
+                                         size_t               count,        \
+                                         matrix##N##_pack_t  *p_dst)        \
+    {                                                                       \
+        if ((0U < count) && ((NULL == p_src) || (NULL == p_dst)))           \
+        {                                                                   \
+            return MATRIX_INVALID_ARGUMENT;                                 \
+        }                                                                   \
+                                                                            \
+        size_t padded = ((count + MATRIX_FIXED_LANES - 1U)                  \
+                         / MATRIX_FIXED_LANES)                              \
+                        * MATRIX_FIXED_LANES;                               \
+                                                                            \
+        for (size_t idx = 0U; idx < padded; ++idx)                          \
+        {                                                                   \
+            matrix##N##_pack_t *p_pack = p_dst + (idx / MATRIX_FIXED_LANES); \
+            size_t              lane   = idx % MATRIX_FIXED_LANES;          \
+                                                                            \
+            for (size_t e = 0U; e < ((N) * (N)); ++e)                       \
+            {                                                               \
+                p_pack->m[e][lane] = (idx < count)                          \
+                                         ? p_src[idx].m[e]                  \
+                                         : (double)(0U == (e % ((N) + 1U))); \
+            }                                                               \
+        }                                                                   \
+                                                                            \
+        return MATRIX_SUCCESS;                                              \
+    }                                                                       \
+                                                                            \
+    matrix_error_code_t matrix##N##_unpack(const matrix##N##_pack_t *p_src, \
+                                           size_t                    count, \
+                                           matrix##N##_t            *p_dst) \
+    {                                                                       \
+        if ((0U < count) && ((NULL == p_src) || (NULL == p_dst)))           \
+        {                                                                   \
+            return MATRIX_INVALID_ARGUMENT;                                 \
+        }                                                                   \
+                                                                            \
+        for (size_t idx = 0U; idx < count; ++idx)                           \
+        {                                                                   \
+            const matrix##N##_pack_t *p_pack                                \
+                = p_src + (idx / MATRIX_FIXED_LANES);                       \
+                                                                            \
+            for (size_t e = 0U; e < ((N) * (N)); ++e)                       \
+            {                                                               \
+                p_dst[idx].m[e] = p_pack->m[e][idx % MATRIX_FIXED_LANES];   \
+            }                                                               \
+        }                                                                   \
+                                                                            \
+        return MATRIX_SUCCESS;                                              \
+    }                                                                       \
+                                                                            \
+    matrix_error_code_t matrix##N##_multiply_batch(                         \
+        const matrix##N##_pack_t *p_a,                                      \
+        const matrix##N##_pack_t *p_b,                                      \
+        matrix##N##_pack_t       *p_c,                                      \
+        size_t                    packs)                                    \
+    {                                                                       \
+        if ((0U < packs)                                                    \
+            && ((NULL == p_a) || (NULL == p_b) || (NULL == p_c)))           \
+        {                                                                   \
+            return MATRIX_INVALID_ARGUMENT;                                 \
+        }                                                                   \
+                                                                            \
+        for (size_t pack = 0U; pack < packs; ++pack)                        \
+        {                                                                   \
+            for (size_t lane = 0U; lane < MATRIX_FIXED_LANES;               \
+                 lane += FIXED_STEP)                                        \
+            {                                                               \
+                fixed_lane_t out[(N) * (N)];                                \
+                FIXED_MUL_##N(LANES_A, LANES_B, FIXED_OUT)                  \
+                                                                            \
+                for (size_t e = 0U; e < ((N) * (N)); ++e)                   \
+                {                                                           \
+                    FIXED_STORE(&p_c[pack].m[e][lane], out[e]);             \
+                }                                                           \
+            }                                                               \
+        }                                                                   \
+                                                                            \
+        return MATRIX_SUCCESS;                                              \
+    }                                                                       \
+                                                                            \
+    matrix_error_code_t matrix##N##_determinant_batch(                      \
+        const matrix##N##_pack_t *p_a, double *p_det, size_t packs)         \
+    {                                                                       \
+        if ((0U < packs) && ((NULL == p_a) || (NULL == p_det)))             \
+        {                                                                   \
+            return MATRIX_INVALID_ARGUMENT;                                 \
+        }                                                                   \
+                                                                            \
+        for (size_t pack = 0U; pack < packs; ++pack)                        \
+        {                                                                   \
+            for (size_t lane = 0U; lane < MATRIX_FIXED_LANES;               \
+                 lane += FIXED_STEP)                                        \
+            {                                                               \
+                FIXED_MINORS_##N(fixed_lane_t, LANES_A)                     \
+                FIXED_STORE(p_det + (pack * MATRIX_FIXED_LANES) + lane,     \
+                            FIXED_DET_##N(LANES_A));                        \
+            }                                                               \
+        }                                                                   \
+                                                                            \
+        return MATRIX_SUCCESS;                                              \
+    }                                                                       \
+                                                                            \
+    matrix_error_code_t matrix##N##_inverse_batch(                          \
+        const matrix##N##_pack_t *p_a,                                      \
+        matrix##N##_pack_t       *p_inv,                                    \
+        size_t                    packs)                                    \
+    {                                                                       \
+        if ((0U < packs) && ((NULL == p_a) || (NULL == p_inv)))             \
+        {                                                                   \
+            return MATRIX_INVALID_ARGUMENT;                                 \
+        }                                                                   \
+                                                                            \
+        bool b_singular = false;                                            \
+                                                                            \
+        for (size_t pack = 0U; pack < packs; ++pack)                        \
+        {                                                                   \
+            for (size_t lane = 0U; lane < MATRIX_FIXED_LANES;               \
+                 lane += FIXED_STEP)                                        \
+            {                                                               \
+                fixed_lane_t out[(N) * (N)];                                \
+                double       dets[FIXED_STEP];                              \
+                FIXED_MINORS_##N(fixed_lane_t, LANES_A)                     \
+                fixed_lane_t det = FIXED_DET_##N(LANES_A);                  \
+                FIXED_ADJ_##N(LANES_A, FIXED_OUT)                           \
+                FIXED_STORE(dets, det);                                     \
+                                                                            \
+                for (size_t idx = 0U; idx < FIXED_STEP; ++idx)              \
+                {                                                           \
+                    b_singular |= (0.0 == dets[idx]);                       \
+                }                                                           \
+                                                                            \
+                fixed_lane_t inv_det = FIXED_SPLAT(1.0) / det;              \
+                                                                            \
+                for (size_t e = 0U; e < ((N) * (N)); ++e)                   \
+                {                                                           \
+                    FIXED_STORE(&p_inv[pack].m[e][lane], out[e] * inv_det); \
+                }                                                           \
+            }                                                               \
+        }                                                                   \
+                                                                            \
+        return b_singular ? MATRIX_SINGULAR : MATRIX_SUCCESS;               \
+    }
+
+FIXED_SCALAR_DEFINE(2)
+FIXED_SCALAR_DEFINE(3)
+FIXED_SCALAR_DEFINE(4)
+
+FIXED_BATCH_DEFINE(2)
+FIXED_BATCH_DEFINE(3)
+FIXED_BATCH_DEFINE(4)
+
+/*** end of file ***/
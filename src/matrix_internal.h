@@ -0,0 +1,78 @@
+/**
+ * @file    matrix_internal.h
+ * @brief   Helpers shared by the matrix translation units.
+ *
+ * Not installed with the public headers; only files under src/ include it.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef MATRIX_INTERNAL_H
+#define MATRIX_INTERNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "matrix.h"
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+#define ROUND_UP(value, step) ((((value) + (step) - 1U) / (step)) * (step))
+
+/**
+ * @brief Copy a rows x cols block between buffers with independent strides.
+ *
+ * Rows are copied last to first when the last destination row starts after
+ * the last source row, so a block can be re-strided in place in either
+ * direction.
+ *
+ * @param p_src Pointer to the top-left source element.
+ * @param lds Leading dimension of the source.
+ * @param p_dst Pointer to the top-left destination element.
+ * @param ldd Leading dimension of the destination.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ */
+void matrix_copy_block(const double *p_src,
+                       size_t        lds,
+                       double       *p_dst,
+                       size_t        ldd,
+                       size_t        rows,
+                       size_t        cols);
+
+/**
+ * @brief Check whether two matrices share any storage.
+ *
+ * @param p_a Pointer to the first matrix.
+ * @param p_b Pointer to the second matrix.
+ *
+ * @return True if the address ranges of the two matrices intersect.
+ */
+bool matrix_is_overlapping(const matrix_t *p_a, const matrix_t *p_b);
+
+/**
+ * @brief Check whether two matrices map every element to the same address.
+ *
+ * @param p_a Pointer to the first matrix.
+ * @param p_b Pointer to the second matrix, same dimensions as the first.
+ *
+ * @return True if both start at the same element with the same stride.
+ */
+bool matrix_is_same_storage(const matrix_t *p_a, const matrix_t *p_b);
+
+/**
+ * @brief Check whether p_result overlaps p_input other than element for
+ * element, in which case an element-wise kernel could read a value it has
+ * already overwritten.
+ *
+ * @param p_input Pointer to an input matrix.
+ * @param p_result Pointer to the output matrix.
+ *
+ * @return True if writing p_result can clobber unread input elements.
+ */
+bool matrix_is_unsafe_alias(const matrix_t *p_input, const matrix_t *p_result);
+
+#endif // MATRIX_INTERNAL_H
+
+/*** end of file ***/
@@ -0,0 +1,825 @@
+/**
+ * @file matrix_io.c
+ * @brief Binary file storage for dense matrices.
+ *
+ * A matrix file is a fixed 64-byte header followed by the raw row-major
+ * payload, starting at an offset aligned to MATRIX_IO_ALIGNMENT. Because the
+ * payload is exactly the in-memory layout of a matrix_t with the stored
+ * leading dimension, a mapped file can be used as matrix storage without
+ * reading or converting anything: matrix_load_mmap only validates the header
+ * and points a view at the mapping. Loading a multi-gigabyte table is then
+ * constant time, and the kernel's page cache shares one physical copy
+ * between every process that maps it.
+ *
+ * The header records the producer's byte order instead of converting, so
+ * files are only portable between machines of the same endianness; a foreign
+ * file is rejected rather than silently misread.
+ *
+ * CSV text is loaded from a mapping too, in two parallel passes over chunks
+ * cut at line ends: one to count rows, so every chunk knows where its rows
+ * land, and one to parse straight into the matrix. Numbers are converted by
+ * a fast path that is exact for ordinary decimal input, see csv_parse_number.
+ *
+ * @author heapbadger
+ */
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "matrix_internal.h"
+#include "matrix_io.h"
+#include "parallel.h"
+
+/**
+ * Largest integer mantissa and power of ten that are both exact doubles, so
+ * that their product or quotient is correctly rounded.
+ */
+#define CSV_EXACT_MANTISSA (1ULL << 53)
+#define CSV_EXACT_POW10    22
+
+/**
+ * Significant digits kept in the 64-bit mantissa; 10^19 - 1 < 2^64.
+ */
+#define CSV_MAX_DIGITS 19U
+
+/**
+ * Longest field handed to the strtod fallback.
+ */
+#define CSV_TOKEN_MAX 128U
+
+typedef struct
+{
+    const char         *p_begin;
+    const char         *p_end;     /**< Just past a newline, or end of file. */
+    size_t              first_row; /**< Matrix row of the first line. */
+    size_t              rows;      /**< Non-blank lines in the chunk. */
+    matrix_error_code_t status;
+} csv_chunk_t;
+
+typedef struct
+{
+    csv_chunk_t *p_chunks;
+    matrix_t    *p_matrix; /**< NULL during the counting pass. */
+} csv_ctx_t;
+
+_Static_assert(sizeof(matrix_file_header_t) == 64U,
+               "matrix file header must stay 64 bytes");
+
+/**
+ * @brief Validate a header against the size of the file that holds it.
+ *
+ * @param p_header Pointer to the header.
+ * @param file_size Size of the whole file in bytes.
+ *
+ * @return MATRIX_SUCCESS if the payload described by the header fits in the
+ *         file, MATRIX_INVALID_ARGUMENT otherwise.
+ */
+static matrix_error_code_t matrix_io_check_header(
+    const matrix_file_header_t *p_header, uint64_t file_size);
+
+/**
+ * @brief Check whether a line holds nothing but spaces, tabs and CR.
+ */
+static bool csv_is_blank(const char *p_line, const char *p_eol);
+
+/**
+ * @brief Count (p_matrix NULL) or parse the rows of chunks [begin, end)
+ *        (parallel_func signature).
+ *
+ * @param begin First chunk.
+ * @param end One past the last chunk.
+ * @param p_arg Pointer to the csv_ctx_t.
+ */
+static void csv_chunk_range(size_t begin, size_t end, void *p_arg);
+
+/**
+ * @brief Parse one line into cols elements.
+ *
+ * @param p_line First character of the line.
+ * @param p_eol Newline or end of file ending the line.
+ * @param p_row Output row.
+ * @param cols Number of fields the line must have.
+ *
+ * @return True if the line holds exactly cols numbers.
+ */
+static bool csv_parse_row(const char *p_line,
+                          const char *p_eol,
+                          double     *p_row,
+                          size_t      cols);
+
+/**
+ * @brief Accumulate a run of decimal digits into a mantissa.
+ *
+ * Leading zeros of a zero mantissa are skipped without being counted.
+ * Digits past CSV_MAX_DIGITS significant ones are dropped and counted, and
+ * clear *p_exact unless they are zero.
+ *
+ * @param p_pos First character of the run.
+ * @param p_end End of the text that may be read.
+ * @param p_mantissa Mantissa to extend.
+ * @param p_kept Significant digits in the mantissa, updated.
+ * @param p_dropped Digits dropped so far, updated.
+ * @param p_exact Cleared when a nonzero digit is dropped.
+ *
+ * @return Pointer past the run.
+ */
+static const char *csv_parse_digits(const char *p_pos,
+                                    const char *p_end,
+                                    uint64_t   *p_mantissa,
+                                    size_t     *p_kept,
+                                    size_t     *p_dropped,
+                                    bool       *p_exact);
+
+/**
+ * @brief Parse one number and advance past it.
+ *
+ * Digits are accumulated into a 64-bit mantissa and a decimal exponent.
+ * When the mantissa is at most 2^53 and the exponent at most 22 in
+ * magnitude, both are exact doubles, and IEEE multiplication or division
+ * rounds their product correctly, so the fast path is exact (Clinger's
+ * algorithm). Longer mantissas, larger exponents, inf and nan are copied to
+ * a terminated buffer and handed to strtod.
+ *
+ * @param pp_pos Pointer to the parse position, advanced past the number.
+ * @param p_end End of the text that may be read.
+ * @param p_value Output value.
+ *
+ * @return True if a number was parsed.
+ */
+static bool csv_parse_number(const char **pp_pos,
+                             const char  *p_end,
+                             double      *p_value);
+
+matrix_error_code_t
+matrix_save (const matrix_t *p_matrix, const char *p_path)
+{
+    static const char padding[MATRIX_IO_ALIGNMENT] = { 0 };
+
+    if ((NULL == p_matrix) || (NULL == p_matrix->p_data) || (NULL == p_path))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_file_header_t header = { 0 };
+    memcpy(header.magic, MATRIX_IO_MAGIC, sizeof(header.magic));
+    header.version        = MATRIX_IO_VERSION;
+    header.byte_order     = MATRIX_IO_BYTE_ORDER;
+    header.dtype          = MATRIX_IO_DTYPE_F64;
+    header.layout         = MATRIX_IO_ROW_MAJOR;
+    header.rows           = p_matrix->rows;
+    header.cols           = p_matrix->cols;
+    header.ld             = p_matrix->cols;
+    header.alignment      = MATRIX_IO_ALIGNMENT;
+    header.payload_offset = ROUND_UP(sizeof(header), MATRIX_IO_ALIGNMENT);
+
+    matrix_error_code_t ret    = MATRIX_SUCCESS;
+    size_t              pad    = header.payload_offset - sizeof(header);
+    FILE               *p_file = fopen(p_path, "wb");
+
+    if (NULL == p_file)
+    {
+        return MATRIX_FAILURE;
+    }
+
+    if ((1U != fwrite(&header, sizeof(header), 1U, p_file))
+        || ((0U < pad) && (1U != fwrite(padding, pad, 1U, p_file))))
+    {
+        ret = MATRIX_FAILURE;
+        goto CLEANUP;
+    }
+
+    for (size_t row = 0U; row < p_matrix->rows; ++row)
+    {
+        const double *p_row = p_matrix->p_data + (row * p_matrix->ld);
+
+        if (p_matrix->cols
+            != fwrite(p_row, sizeof(double), p_matrix->cols, p_file))
+        {
+            ret = MATRIX_FAILURE;
+            goto CLEANUP;
+        }
+    }
+
+CLEANUP:
+    if (0 != fclose(p_file))
+    {
+        ret = MATRIX_FAILURE;
+    }
+
+    return ret;
+}
+
+matrix_error_code_t
+matrix_load (const char *p_path, matrix_t **pp_matrix)
+{
+    if ((NULL == p_path) || (NULL == pp_matrix))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_error_code_t  ret      = MATRIX_SUCCESS;
+    matrix_file_header_t header   = { 0 };
+    matrix_t            *p_matrix = NULL;
+    struct stat          info     = { 0 };
+    FILE                *p_file   = fopen(p_path, "rb");
+    *pp_matrix                    = NULL;
+
+    if (NULL == p_file)
+    {
+        return MATRIX_FAILURE;
+    }
+
+    if (0 != fstat(fileno(p_file), &info))
+    {
+        ret = MATRIX_FAILURE;
+        goto CLEANUP;
+    }
+
+    if (1U != fread(&header, sizeof(header), 1U, p_file))
+    {
+        ret = MATRIX_INVALID_ARGUMENT;
+        goto CLEANUP;
+    }
+
+    ret = matrix_io_check_header(&header, (uint64_t)info.st_size);
+
+    if (MATRIX_SUCCESS != ret)
+    {
+        goto CLEANUP;
+    }
+
+    p_matrix = matrix_create(header.rows, header.cols);
+
+    if (NULL == p_matrix)
+    {
+        ret = MATRIX_ALLOCATION_FAILURE;
+        goto CLEANUP;
+    }
+
+    for (size_t row = 0U; row < p_matrix->rows; ++row)
+    {
+        off_t offset = (off_t)(header.payload_offset
+                               + (row * header.ld * sizeof(double)));
+
+        if ((0 != fseeko(p_file, offset, SEEK_SET))
+            || (p_matrix->cols
+                != fread(p_matrix->p_data + (row * p_matrix->ld),
+                         sizeof(double),
+                         p_matrix->cols,
+                         p_file)))
+        {
+            ret = MATRIX_FAILURE;
+            goto CLEANUP;
+        }
+    }
+
+    *pp_matrix = p_matrix;
+    p_matrix   = NULL;
+
+CLEANUP:
+    matrix_destroy(p_matrix);
+    fclose(p_file);
+    return ret;
+}
+
+matrix_error_code_t
+matrix_load_mmap (const char        *p_path,
+                  matrix_map_mode_t  mode,
+                  matrix_mapping_t  *p_mapping)
+{
+    if ((NULL == p_path) || (NULL == p_mapping)
+        || ((MATRIX_MAP_READ_ONLY != mode)
+            && (MATRIX_MAP_COPY_ON_WRITE != mode)))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    memset(p_mapping, 0, sizeof(*p_mapping));
+
+    matrix_error_code_t ret   = MATRIX_SUCCESS;
+    struct stat         info  = { 0 };
+    void               *p_map = MAP_FAILED;
+    int                 fd    = open(p_path, O_RDONLY);
+
+    if (0 > fd)
+    {
+        return MATRIX_FAILURE;
+    }
+
+    if (0 != fstat(fd, &info))
+    {
+        ret = MATRIX_FAILURE;
+        goto CLEANUP;
+    }
+
+    if ((uint64_t)info.st_size < sizeof(matrix_file_header_t))
+    {
+        ret = MATRIX_INVALID_ARGUMENT;
+        goto CLEANUP;
+    }
+
+    // A private writable mapping of a read-only descriptor is allowed and
+    // never writes back, which is exactly copy-on-write
+    int prot  = PROT_READ;
+    int flags = MAP_SHARED;
+
+    if (MATRIX_MAP_COPY_ON_WRITE == mode)
+    {
+        prot |= PROT_WRITE;
+        flags = MAP_PRIVATE;
+    }
+
+    p_map = mmap(NULL, (size_t)info.st_size, prot, flags, fd, 0);
+
+    if (MAP_FAILED == p_map)
+    {
+        ret = MATRIX_FAILURE;
+        goto CLEANUP;
+    }
+
+    matrix_file_header_t header = { 0 };
+    memcpy(&header, p_map, sizeof(header));
+    ret = matrix_io_check_header(&header, (uint64_t)info.st_size);
+
+    if (MATRIX_SUCCESS != ret)
+    {
+        munmap(p_map, (size_t)info.st_size);
+        goto CLEANUP;
+    }
+
+    p_mapping->p_map         = p_map;
+    p_mapping->map_size      = (size_t)info.st_size;
+    p_mapping->matrix.rows   = header.rows;
+    p_mapping->matrix.cols   = header.cols;
+    p_mapping->matrix.ld     = header.ld;
+    p_mapping->matrix.b_view = true;
+    p_mapping->matrix.p_data
+        = (double *)((char *)p_map + header.payload_offset);
+
+CLEANUP:
+    close(fd);
+    return ret;
+}
+
+matrix_error_code_t
+matrix_load_csv (const char *p_path,
+                 size_t      rows,
+                 size_t      cols,
+                 matrix_t  **pp_matrix)
+{
+    if ((NULL == p_path) || (NULL == pp_matrix))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_error_code_t ret      = MATRIX_SUCCESS;
+    struct stat         info     = { 0 };
+    const char         *p_text   = MAP_FAILED;
+    csv_chunk_t        *p_chunks = NULL;
+    matrix_t           *p_matrix = NULL;
+    int                 fd       = open(p_path, O_RDONLY);
+    *pp_matrix                   = NULL;
+
+    if (0 > fd)
+    {
+        return MATRIX_FAILURE;
+    }
+
+    if (0 != fstat(fd, &info))
+    {
+        ret = MATRIX_FAILURE;
+        goto CLEANUP;
+    }
+
+    if (0 == info.st_size)
+    {
+        ret = MATRIX_INVALID_ARGUMENT;
+        goto CLEANUP;
+    }
+
+    size_t size = (size_t)info.st_size;
+    p_text      = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (MAP_FAILED == p_text)
+    {
+        ret = MATRIX_FAILURE;
+        goto CLEANUP;
+    }
+
+    const char *p_end = p_text + size;
+
+    // The first non-blank line fixes the column count unless a hint does
+    if (0U == cols)
+    {
+        const char *p_line = p_text;
+        const char *p_eol  = memchr(p_text, '\n', size);
+        p_eol              = (NULL == p_eol) ? p_end : p_eol;
+
+        while (csv_is_blank(p_line, p_eol) && (p_eol < p_end))
+        {
+            p_line = p_eol + 1;
+            p_eol  = memchr(p_line, '\n', (size_t)(p_end - p_line));
+            p_eol  = (NULL == p_eol) ? p_end : p_eol;
+        }
+
+        for (const char *p_pos = p_line; p_pos < p_eol; ++p_pos)
+        {
+            cols += (',' == *p_pos) ? 1U : 0U;
+        }
+
+        cols += 1U;
+    }
+
+    size_t chunks = (size + MATRIX_CSV_CHUNK - 1U) / MATRIX_CSV_CHUNK;
+    p_chunks      = calloc(chunks, sizeof(csv_chunk_t));
+
+    if (NULL == p_chunks)
+    {
+        ret = MATRIX_ALLOCATION_FAILURE;
+        goto CLEANUP;
+    }
+
+    // Move each nominal boundary to the start of the next line; a line
+    // longer than a chunk leaves the chunks it covers empty
+    for (size_t chunk = 0U; chunk < chunks; ++chunk)
+    {
+        const char *p_begin = p_text + (chunk * MATRIX_CSV_CHUNK);
+
+        if ((0U < chunk) && (p_begin < p_chunks[chunk - 1U].p_begin))
+        {
+            p_begin = p_chunks[chunk - 1U].p_begin;
+        }
+        else if ((0U < chunk) && ('\n' != p_begin[-1]))
+        {
+            p_begin = memchr(p_begin, '\n', (size_t)(p_end - p_begin));
+            p_begin = (NULL == p_begin) ? p_end : p_begin + 1;
+        }
+
+        p_chunks[chunk].p_begin = p_begin;
+    }
+
+    for (size_t chunk = 0U; chunk < chunks; ++chunk)
+    {
+        p_chunks[chunk].p_end = (chunk + 1U < chunks)
+                                    ? p_chunks[chunk + 1U].p_begin
+                                    : p_end;
+    }
+
+    csv_ctx_t ctx = { .p_chunks = p_chunks, .p_matrix = NULL };
+    parallel_for(chunks, 1U, csv_chunk_range, &ctx);
+
+    size_t total = 0U;
+
+    for (size_t chunk = 0U; chunk < chunks; ++chunk)
+    {
+        p_chunks[chunk].first_row = total;
+        total += p_chunks[chunk].rows;
+    }
+
+    if ((0U == total) || ((0U != rows) && (rows != total)))
+    {
+        ret = MATRIX_INVALID_ARGUMENT;
+        goto CLEANUP;
+    }
+
+    p_matrix = matrix_create(total, cols);
+
+    if (NULL == p_matrix)
+    {
+        ret = MATRIX_ALLOCATION_FAILURE;
+        goto CLEANUP;
+    }
+
+    ctx.p_matrix = p_matrix;
+    parallel_for(chunks, 1U, csv_chunk_range, &ctx);
+
+    for (size_t chunk = 0U; (chunk < chunks) && (MATRIX_SUCCESS == ret);
+         ++chunk)
+    {
+        ret = p_chunks[chunk].status;
+    }
+
+    if (MATRIX_SUCCESS == ret)
+    {
+        *pp_matrix = p_matrix;
+        p_matrix   = NULL;
+    }
+
+CLEANUP:
+    if (MAP_FAILED != p_text)
+    {
+        munmap((void *)p_text, (size_t)info.st_size);
+    }
+
+    matrix_destroy(p_matrix);
+    free(p_chunks);
+    close(fd);
+    return ret;
+}
+
+void
+matrix_unmap (matrix_mapping_t *p_mapping)
+{
+    if (NULL == p_mapping)
+    {
+        return;
+    }
+
+    if (NULL != p_mapping->p_map)
+    {
+        munmap(p_mapping->p_map, p_mapping->map_size);
+    }
+
+    memset(p_mapping, 0, sizeof(*p_mapping));
+}
+
+static matrix_error_code_t
+matrix_io_check_header (const matrix_file_header_t *p_header,
+                        uint64_t                    file_size)
+{
+    if ((0 != memcmp(p_header->magic, MATRIX_IO_MAGIC, sizeof(p_header->magic)))
+        || (MATRIX_IO_VERSION != p_header->version)
+        || (MATRIX_IO_BYTE_ORDER != p_header->byte_order)
+        || (MATRIX_IO_DTYPE_F64 != p_header->dtype)
+        || (MATRIX_IO_ROW_MAJOR != p_header->layout))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if ((0U == p_header->rows) || (0U == p_header->cols)
+        || (p_header->ld < p_header->cols)
+        || (p_header->rows > (SIZE_MAX / sizeof(double)) / p_header->ld))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    // The payload must be element aligned for the mapping to be usable
+    if ((0U == p_header->alignment)
+        || (0U != (p_header->alignment % sizeof(double)))
+        || (0U != (p_header->payload_offset % p_header->alignment))
+        || (p_header->payload_offset < sizeof(matrix_file_header_t))
+        || (p_header->payload_offset > file_size))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    uint64_t span = ((p_header->rows - 1U) * p_header->ld) + p_header->cols;
+
+    if ((span * sizeof(double)) > (file_size - p_header->payload_offset))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+static bool
+csv_is_blank (const char *p_line, const char *p_eol)
+{
+    for (const char *p_pos = p_line; p_pos < p_eol; ++p_pos)
+    {
+        if ((' ' != *p_pos) && ('\t' != *p_pos) && ('\r' != *p_pos))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void
+csv_chunk_range (size_t begin, size_t end, void *p_arg)
+{
+    const csv_ctx_t *p_ctx    = (const csv_ctx_t *)p_arg;
+    matrix_t        *p_matrix = p_ctx->p_matrix;
+
+    for (size_t chunk = begin; chunk < end; ++chunk)
+    {
+        csv_chunk_t *p_chunk = &p_ctx->p_chunks[chunk];
+        const char  *p_line  = p_chunk->p_begin;
+        size_t       row     = p_chunk->first_row;
+
+        while (p_line < p_chunk->p_end)
+        {
+            const char *p_eol
+                = memchr(p_line, '\n', (size_t)(p_chunk->p_end - p_line));
+            p_eol = (NULL == p_eol) ? p_chunk->p_end : p_eol;
+
+            if (false == csv_is_blank(p_line, p_eol))
+            {
+                if ((NULL != p_matrix)
+                    && (false
+                        == csv_parse_row(p_line,
+                                         p_eol,
+                                         p_matrix->p_data
+                                             + (row * p_matrix->ld),
+                                         p_matrix->cols)))
+                {
+                    p_chunk->status = MATRIX_INVALID_ARGUMENT;
+                    break;
+                }
+
+                row += 1U;
+            }
+
+            p_line = p_eol + 1;
+        }
+
+        if (NULL == p_matrix)
+        {
+            p_chunk->rows = row - p_chunk->first_row;
+        }
+    }
+}
+
+static bool
+csv_parse_row (const char *p_line,
+               const char *p_eol,
+               double     *p_row,
+               size_t      cols)
+{
+    const char *p_pos = p_line;
+
+    for (size_t col = 0U; col < cols; ++col)
+    {
+        while ((p_pos < p_eol) && ((' ' == *p_pos) || ('\t' == *p_pos)))
+        {
+            ++p_pos;
+        }
+
+        if (false == csv_parse_number(&p_pos, p_eol, &p_row[col]))
+        {
+            return false;
+        }
+
+        while ((p_pos < p_eol)
+               && ((' ' == *p_pos) || ('\t' == *p_pos) || ('\r' == *p_pos)))
+        {
+            ++p_pos;
+        }
+
+        // Every field but the last is followed by a comma, the last by
+        // nothing at all
+        if (col + 1U < cols)
+        {
+            if ((p_pos == p_eol) || (',' != *p_pos))
+            {
+                return false;
+            }
+
+            ++p_pos;
+        }
+    }
+
+    return p_pos == p_eol;
+}
+
+static const char *
+csv_parse_digits (const char *p_pos,
+                  const char *p_end,
+                  uint64_t   *p_mantissa,
+                  size_t     *p_kept,
+                  size_t     *p_dropped,
+                  bool       *p_exact)
+{
+    uint64_t mantissa = *p_mantissa;
+    size_t   kept     = *p_kept;
+
+    while ((0U == mantissa) && (p_pos < p_end) && ('0' == *p_pos))
+    {
+        ++p_pos;
+    }
+
+    for (; (p_pos < p_end) && (9U >= (unsigned int)(*p_pos - '0')); ++p_pos)
+    {
+        unsigned int digit = (unsigned int)(*p_pos - '0');
+
+        if (CSV_MAX_DIGITS > kept)
+        {
+            mantissa = (mantissa * 10U) + digit;
+            kept += 1U;
+        }
+        else
+        {
+            *p_exact = *p_exact && (0U == digit);
+            *p_dropped += 1U;
+        }
+    }
+
+    *p_mantissa = mantissa;
+    *p_kept     = kept;
+    return p_pos;
+}
+
+static bool
+csv_parse_number (const char **pp_pos, const char *p_end, double *p_value)
+{
+    static const double pow10[CSV_EXACT_POW10 + 1] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    const char *p_start    = *pp_pos;
+    const char *p_pos      = p_start;
+    bool        b_negative = false;
+    bool        b_digits   = false;
+    bool        b_exact    = true;
+    uint64_t    mantissa   = 0U;
+    size_t      kept       = 0U;
+    size_t      dropped    = 0U;
+    long        exponent   = 0;
+
+    if ((p_pos < p_end) && (('-' == *p_pos) || ('+' == *p_pos)))
+    {
+        b_negative = ('-' == *p_pos);
+        ++p_pos;
+    }
+
+    // Integer digits past the kept ones scale the mantissa up, and every
+    // kept or skipped fraction digit scales it down
+    const char *p_digits = p_pos;
+    p_pos    = csv_parse_digits(
+        p_pos, p_end, &mantissa, &kept, &dropped, &b_exact);
+    exponent = (long)dropped;
+    b_digits = (p_pos != p_digits);
+
+    if ((p_pos < p_end) && ('.' == *p_pos))
+    {
+        size_t before = dropped;
+        p_digits      = ++p_pos;
+        p_pos         = csv_parse_digits(
+            p_pos, p_end, &mantissa, &kept, &dropped, &b_exact);
+        exponent -= (long)((size_t)(p_pos - p_digits) - (dropped - before));
+        b_digits = b_digits || (p_pos != p_digits);
+    }
+
+    if (b_digits && (p_pos < p_end) && (('e' == *p_pos) || ('E' == *p_pos)))
+    {
+        const char *p_exp     = p_pos + 1;
+        bool        b_exp_neg = false;
+        long        exp_value = 0;
+
+        if ((p_exp < p_end) && (('-' == *p_exp) || ('+' == *p_exp)))
+        {
+            b_exp_neg = ('-' == *p_exp);
+            ++p_exp;
+        }
+
+        if ((p_exp == p_end) || (9U < (unsigned int)(*p_exp - '0')))
+        {
+            return false;
+        }
+
+        for (; (p_exp < p_end) && (9U >= (unsigned int)(*p_exp - '0'));
+             ++p_exp)
+        {
+            exp_value = (100000 > exp_value)
+                            ? (exp_value * 10) + (*p_exp - '0')
+                            : exp_value;
+        }
+
+        p_pos = p_exp;
+        exponent += b_exp_neg ? -exp_value : exp_value;
+    }
+
+    if (b_digits && b_exact && (CSV_EXACT_MANTISSA >= mantissa)
+        && (-CSV_EXACT_POW10 <= exponent) && (CSV_EXACT_POW10 >= exponent))
+    {
+        double value = (double)mantissa;
+        value        = (0 <= exponent) ? value * pow10[exponent]
+                                       : value / pow10[-exponent];
+        *p_value     = b_negative ? -value : value;
+        *pp_pos      = p_pos;
+        return true;
+    }
+
+    // Slow path: the field runs to the next separator
+    char   token[CSV_TOKEN_MAX];
+    char  *p_stop = NULL;
+    size_t length = 0U;
+
+    while ((p_start + length < p_end) && (CSV_TOKEN_MAX > length + 1U)
+           && (NULL == memchr(", \t\r\n", p_start[length], 5U)))
+    {
+        token[length] = p_start[length];
+        length += 1U;
+    }
+
+    token[length] = '\0';
+    *p_value      = strtod(token, &p_stop);
+
+    if ((0U == length) || (p_stop != token + length))
+    {
+        return false;
+    }
+
+    *pp_pos = p_start + length;
+    return true;
+}
+
+/*** end of file ***/
@@ -0,0 +1,238 @@
+/**
+ * @file matrix_map.c
+ * @brief Element-wise maps over matrices with user-supplied kernels.
+ *
+ * Calling a function pointer per element costs more than most element-wise
+ * kernels themselves, and keeps the compiler from vectorizing them. Kernels
+ * here take a whole segment of contiguous elements instead, so the call is
+ * amortized over up to MATRIX_MAP_SEGMENT elements and the kernel's own
+ * loop can be vectorized.
+ *
+ * Rows are cut into segments exactly like the reductions do, and segments
+ * are the unit of threading. When every operand stores its rows back to
+ * back, the whole matrix is one flat row and padding never splits a
+ * segment.
+ *
+ * @author heapbadger
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include "matrix_internal.h"
+#include "matrix_map.h"
+#include "parallel.h"
+
+typedef struct
+{
+    const double   *p_a;
+    size_t          lda;
+    const double   *p_b; /**< NULL for a unary map. */
+    size_t          ldb;
+    double         *p_out;
+    size_t          ldo;
+    size_t          cols; /**< Length of each (possibly flattened) row. */
+    size_t          seg_per_row;
+    matrix_map_func map_func;
+    matrix_zip_func zip_func;
+    void           *p_ctx;
+} map_ctx_t;
+
+/**
+ * @brief Validate operands and run the segments of a unary or binary map.
+ *
+ * @param p_a Pointer to the first input.
+ * @param p_b Pointer to the second input, or NULL for a unary map.
+ * @param p_dst Pointer to the output.
+ * @param map_func Unary kernel, used when p_b is NULL.
+ * @param zip_func Binary kernel, used when p_b is not NULL.
+ * @param p_ctx User context.
+ * @param b_parallel Split segments across threads.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+static matrix_error_code_t map_run(const matrix_t *p_a,
+                                   const matrix_t *p_b,
+                                   matrix_t       *p_dst,
+                                   matrix_map_func map_func,
+                                   matrix_zip_func zip_func,
+                                   void           *p_ctx,
+                                   bool            b_parallel);
+
+/**
+ * @brief Process segments [begin, end) (parallel_func signature).
+ *
+ * @param begin First segment.
+ * @param end One past the last segment.
+ * @param p_arg Pointer to the map_ctx_t.
+ */
+static void map_segment_range(size_t begin, size_t end, void *p_arg);
+
+/**
+ * @brief Check whether rows are stored back to back.
+ */
+static bool map_is_contiguous(const matrix_t *p_matrix);
+
+matrix_error_code_t
+matrix_map (const matrix_t *p_src,
+            matrix_t       *p_dst,
+            matrix_map_func func,
+            void           *p_ctx)
+{
+    if (NULL == func)
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    return map_run(p_src, NULL, p_dst, func, NULL, p_ctx, false);
+}
+
+matrix_error_code_t
+matrix_map_parallel (const matrix_t *p_src,
+                     matrix_t       *p_dst,
+                     matrix_map_func func,
+                     void           *p_ctx)
+{
+    if (NULL == func)
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    return map_run(p_src, NULL, p_dst, func, NULL, p_ctx, true);
+}
+
+matrix_error_code_t
+matrix_zip_map (const matrix_t *p_a,
+                const matrix_t *p_b,
+                matrix_t       *p_dst,
+                matrix_zip_func func,
+                void           *p_ctx)
+{
+    if ((NULL == p_b) || (NULL == func))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    return map_run(p_a, p_b, p_dst, NULL, func, p_ctx, false);
+}
+
+matrix_error_code_t
+matrix_zip_map_parallel (const matrix_t *p_a,
+                         const matrix_t *p_b,
+                         matrix_t       *p_dst,
+                         matrix_zip_func func,
+                         void           *p_ctx)
+{
+    if ((NULL == p_b) || (NULL == func))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    return map_run(p_a, p_b, p_dst, NULL, func, p_ctx, true);
+}
+
+static matrix_error_code_t
+map_run (const matrix_t *p_a,
+         const matrix_t *p_b,
+         matrix_t       *p_dst,
+         matrix_map_func map_func,
+         matrix_zip_func zip_func,
+         void           *p_ctx,
+         bool            b_parallel)
+{
+    if ((NULL == p_a) || (NULL == p_dst) || (NULL == p_a->p_data)
+        || (NULL == p_dst->p_data) || (p_dst->rows != p_a->rows)
+        || (p_dst->cols != p_a->cols) || (0U == p_a->rows)
+        || (0U == p_a->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if ((NULL != p_b)
+        && ((NULL == p_b->p_data) || (p_b->rows != p_a->rows)
+            || (p_b->cols != p_a->cols)))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if (matrix_is_unsafe_alias(p_a, p_dst)
+        || ((NULL != p_b) && matrix_is_unsafe_alias(p_b, p_dst)))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    map_ctx_t ctx = {
+        .p_a      = p_a->p_data,
+        .lda      = p_a->ld,
+        .p_b      = (NULL != p_b) ? p_b->p_data : NULL,
+        .ldb      = (NULL != p_b) ? p_b->ld : 0U,
+        .p_out    = p_dst->p_data,
+        .ldo      = p_dst->ld,
+        .cols     = p_a->cols,
+        .map_func = map_func,
+        .zip_func = zip_func,
+        .p_ctx    = p_ctx,
+    };
+    size_t rows = p_a->rows;
+
+    if (map_is_contiguous(p_a) && map_is_contiguous(p_dst)
+        && ((NULL == p_b) || map_is_contiguous(p_b)))
+    {
+        ctx.cols = rows * p_a->cols;
+        rows     = 1U;
+    }
+
+    ctx.seg_per_row = (ctx.cols + MATRIX_MAP_SEGMENT - 1U) / MATRIX_MAP_SEGMENT;
+    size_t segments = rows * ctx.seg_per_row;
+
+    if (b_parallel)
+    {
+        size_t seg_len = MIN(ctx.cols, (size_t)MATRIX_MAP_SEGMENT);
+        parallel_for(segments,
+                     MATRIX_MAP_PARALLEL_MIN / seg_len,
+                     map_segment_range,
+                     &ctx);
+    }
+    else
+    {
+        map_segment_range(0U, segments, &ctx);
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+static void
+map_segment_range (size_t begin, size_t end, void *p_arg)
+{
+    const map_ctx_t *p_ctx = (const map_ctx_t *)p_arg;
+
+    for (size_t seg = begin; seg < end; ++seg)
+    {
+        size_t        row   = seg / p_ctx->seg_per_row;
+        size_t        first = (seg % p_ctx->seg_per_row) * MATRIX_MAP_SEGMENT;
+        size_t        count = MIN((size_t)MATRIX_MAP_SEGMENT,
+                                  p_ctx->cols - first);
+        const double *p_a   = p_ctx->p_a + (row * p_ctx->lda) + first;
+        double       *p_out = p_ctx->p_out + (row * p_ctx->ldo) + first;
+
+        if (NULL == p_ctx->p_b)
+        {
+            p_ctx->map_func(p_a, p_out, count, p_ctx->p_ctx);
+        }
+        else
+        {
+            p_ctx->zip_func(p_a,
+                            p_ctx->p_b + (row * p_ctx->ldb) + first,
+                            p_out,
+                            count,
+                            p_ctx->p_ctx);
+        }
+    }
+}
+
+static bool
+map_is_contiguous (const matrix_t *p_matrix)
+{
+    return (p_matrix->ld == p_matrix->cols) || (1U == p_matrix->rows);
+}
+
+/*** end of file ***/
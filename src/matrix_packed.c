@@ -0,0 +1,737 @@
+/**
+ * @file matrix_packed.c
+ * @brief Packed triangular/symmetric and banded matrix storage.
+ *
+ * A symmetric or triangular matrix needs only one triangle, and a band
+ * matrix only its diagonals. Storing just those halves the memory traffic
+ * of a symmetric product and turns the O(n^2) storage and O(n^3) LU of a
+ * band matrix into O(n * bw) and O(n * bw^2).
+ *
+ * Both layouts are row-major so every stored row segment is contiguous and
+ * the inner loops are plain dot products and AXPYs over unit-stride data.
+ *
+ * @author heapbadger
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_internal.h"
+#include "matrix_packed.h"
+
+/**
+ * @brief Offset of (row, col) in packed storage.
+ *
+ * The element must lie in the stored triangle.
+ *
+ * @param p_packed Pointer to the packed matrix.
+ * @param row Row index.
+ * @param col Column index.
+ *
+ * @return Index into p_packed->p_data.
+ */
+static size_t packed_offset(const matrix_packed_t *p_packed,
+                            size_t                 row,
+                            size_t                 col);
+
+/**
+ * @brief Check whether (row, col) lies inside the declared band.
+ *
+ * @param p_band Pointer to the band matrix.
+ * @param row Row index (< n).
+ * @param col Column index (< n).
+ *
+ * @return true if kl sub-diagonals and ku super-diagonals cover the element.
+ */
+static bool band_contains(const matrix_band_t *p_band, size_t row, size_t col);
+
+/**
+ * @brief Scale y by beta, writing zeros when beta is 0.0 so NaNs in y are
+ *        not propagated.
+ *
+ * @param p_y Pointer to y.
+ * @param n Number of elements.
+ * @param beta Scale.
+ */
+static void scale_vector(double *p_y, size_t n, double beta);
+
+matrix_packed_t *
+matrix_packed_create (matrix_packed_kind_t kind, matrix_uplo_t uplo, size_t n)
+{
+    if ((0U == n) || (n >= (SIZE_MAX / sizeof(double)) / n)
+        || ((MATRIX_PACKED_SYMMETRIC != kind)
+            && (MATRIX_PACKED_TRIANGULAR != kind))
+        || ((MATRIX_UPPER != uplo) && (MATRIX_LOWER != uplo)))
+    {
+        return NULL;
+    }
+
+    matrix_packed_t *p_packed = calloc(1U, sizeof(matrix_packed_t));
+
+    if (NULL == p_packed)
+    {
+        return NULL;
+    }
+
+    p_packed->p_data = calloc((n * (n + 1U)) / 2U, sizeof(double));
+
+    if (NULL == p_packed->p_data)
+    {
+        free(p_packed);
+        return NULL;
+    }
+
+    p_packed->kind = kind;
+    p_packed->uplo = uplo;
+    p_packed->n    = n;
+    return p_packed;
+}
+
+void
+matrix_packed_destroy (matrix_packed_t *p_packed)
+{
+    if (NULL != p_packed)
+    {
+        free(p_packed->p_data);
+        free(p_packed);
+    }
+}
+
+matrix_packed_t *
+matrix_packed_from_dense (const matrix_t      *p_dense,
+                          matrix_packed_kind_t kind,
+                          matrix_uplo_t        uplo)
+{
+    if ((NULL == p_dense) || (p_dense->rows != p_dense->cols))
+    {
+        return NULL;
+    }
+
+    size_t           n        = p_dense->rows;
+    matrix_packed_t *p_packed = matrix_packed_create(kind, uplo, n);
+
+    if (NULL == p_packed)
+    {
+        return NULL;
+    }
+
+    double *p_out = p_packed->p_data;
+
+    for (size_t row = 0U; row < n; ++row)
+    {
+        size_t first = (MATRIX_UPPER == uplo) ? row : 0U;
+        size_t count = (MATRIX_UPPER == uplo) ? (n - row) : (row + 1U);
+
+        memcpy(p_out,
+               &p_dense->p_data[(row * p_dense->ld) + first],
+               count * sizeof(double));
+        p_out += count;
+    }
+
+    return p_packed;
+}
+
+matrix_error_code_t
+matrix_packed_to_dense (const matrix_packed_t *p_packed, matrix_t *p_dense)
+{
+    if ((NULL == p_packed) || (NULL == p_dense)
+        || (p_dense->rows != p_packed->n) || (p_dense->cols != p_packed->n))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t        n    = p_packed->n;
+    const double *p_in = p_packed->p_data;
+
+    for (size_t row = 0U; row < n; ++row)
+    {
+        double *p_row = &p_dense->p_data[row * p_dense->ld];
+        size_t  first = (MATRIX_UPPER == p_packed->uplo) ? row : 0U;
+        size_t  count = (MATRIX_UPPER == p_packed->uplo) ? (n - row)
+                                                         : (row + 1U);
+
+        memset(p_row, 0, n * sizeof(double));
+        memcpy(&p_row[first], p_in, count * sizeof(double));
+        p_in += count;
+    }
+
+    if (MATRIX_PACKED_SYMMETRIC == p_packed->kind)
+    {
+        // Mirror the stored triangle onto the zeroed one
+        for (size_t row = 0U; row < n; ++row)
+        {
+            for (size_t col = row + 1U; col < n; ++col)
+            {
+                double *p_upper = &p_dense->p_data[(row * p_dense->ld) + col];
+                double *p_lower = &p_dense->p_data[(col * p_dense->ld) + row];
+
+                if (MATRIX_UPPER == p_packed->uplo)
+                {
+                    *p_lower = *p_upper;
+                }
+                else
+                {
+                    *p_upper = *p_lower;
+                }
+            }
+        }
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_packed_get (const matrix_packed_t *p_packed,
+                   size_t                 row,
+                   size_t                 col,
+                   double                *p_out)
+{
+    if ((NULL == p_packed) || (NULL == p_out))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if ((row >= p_packed->n) || (col >= p_packed->n))
+    {
+        return MATRIX_OUT_OF_BOUNDS;
+    }
+
+    bool b_stored = (MATRIX_UPPER == p_packed->uplo) ? (col >= row)
+                                                     : (col <= row);
+
+    if (b_stored)
+    {
+        *p_out = p_packed->p_data[packed_offset(p_packed, row, col)];
+    }
+    else if (MATRIX_PACKED_SYMMETRIC == p_packed->kind)
+    {
+        *p_out = p_packed->p_data[packed_offset(p_packed, col, row)];
+    }
+    else
+    {
+        *p_out = 0.0;
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_packed_set (matrix_packed_t *p_packed,
+                   size_t           row,
+                   size_t           col,
+                   double           value)
+{
+    if (NULL == p_packed)
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if ((row >= p_packed->n) || (col >= p_packed->n))
+    {
+        return MATRIX_OUT_OF_BOUNDS;
+    }
+
+    bool b_stored = (MATRIX_UPPER == p_packed->uplo) ? (col >= row)
+                                                     : (col <= row);
+
+    if (b_stored)
+    {
+        p_packed->p_data[packed_offset(p_packed, row, col)] = value;
+    }
+    else if (MATRIX_PACKED_SYMMETRIC == p_packed->kind)
+    {
+        p_packed->p_data[packed_offset(p_packed, col, row)] = value;
+    }
+    else
+    {
+        return MATRIX_OUT_OF_BOUNDS;
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_packed_gemv (const matrix_packed_t *p_packed,
+                    double                 alpha,
+                    const double          *p_x,
+                    double                 beta,
+                    double                *p_y)
+{
+    if ((NULL == p_packed) || (NULL == p_x) || (NULL == p_y))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t        n         = p_packed->n;
+    bool          b_upper   = (MATRIX_UPPER == p_packed->uplo);
+    bool          b_mirror  = (MATRIX_PACKED_SYMMETRIC == p_packed->kind);
+    const double *p_segment = p_packed->p_data;
+
+    scale_vector(p_y, n, beta);
+
+    for (size_t row = 0U; row < n; ++row)
+    {
+        // The stored segment of this row, minus the diagonal, and the
+        // matching slice of x and y it pairs with
+        size_t        first = b_upper ? (row + 1U) : 0U;
+        size_t        count = b_upper ? (n - row - 1U) : row;
+        const double *p_off = b_upper ? &p_segment[1] : p_segment;
+        double        diag  = b_upper ? p_segment[0] : p_segment[row];
+        double        sum   = diag * p_x[row];
+        double        x_row = alpha * p_x[row];
+
+        for (size_t idx = 0U; idx < count; ++idx)
+        {
+            sum += p_off[idx] * p_x[first + idx];
+        }
+
+        if (b_mirror)
+        {
+            // A(first + idx, row) == A(row, first + idx)
+            for (size_t idx = 0U; idx < count; ++idx)
+            {
+                p_y[first + idx] += p_off[idx] * x_row;
+            }
+        }
+
+        p_y[row] += alpha * sum;
+        p_segment += count + 1U;
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_band_t *
+matrix_band_create (size_t n, size_t kl, size_t ku)
+{
+    if ((0U == n) || (kl >= n) || (ku >= n))
+    {
+        return NULL;
+    }
+
+    size_t ld = (2U * kl) + ku + 1U;
+
+    if (n > (SIZE_MAX / sizeof(double)) / ld)
+    {
+        return NULL;
+    }
+
+    matrix_band_t *p_band = calloc(1U, sizeof(matrix_band_t));
+
+    if (NULL == p_band)
+    {
+        return NULL;
+    }
+
+    p_band->p_data = calloc(n * ld, sizeof(double));
+
+    if (NULL == p_band->p_data)
+    {
+        free(p_band);
+        return NULL;
+    }
+
+    p_band->n  = n;
+    p_band->kl = kl;
+    p_band->ku = ku;
+    p_band->ld = ld;
+    return p_band;
+}
+
+void
+matrix_band_destroy (matrix_band_t *p_band)
+{
+    if (NULL != p_band)
+    {
+        free(p_band->p_data);
+        free(p_band);
+    }
+}
+
+matrix_band_t *
+matrix_band_from_dense (const matrix_t *p_dense, size_t kl, size_t ku)
+{
+    if ((NULL == p_dense) || (p_dense->rows != p_dense->cols))
+    {
+        return NULL;
+    }
+
+    size_t         n      = p_dense->rows;
+    matrix_band_t *p_band = matrix_band_create(n, kl, ku);
+
+    if (NULL == p_band)
+    {
+        return NULL;
+    }
+
+    for (size_t row = 0U; row < n; ++row)
+    {
+        size_t first = (row > kl) ? (row - kl) : 0U;
+        size_t last  = MIN(n - 1U, row + ku);
+
+        memcpy(&p_band->p_data[(row * p_band->ld) + (first + kl - row)],
+               &p_dense->p_data[(row * p_dense->ld) + first],
+               (last - first + 1U) * sizeof(double));
+    }
+
+    return p_band;
+}
+
+matrix_error_code_t
+matrix_band_to_dense (const matrix_band_t *p_band, matrix_t *p_dense)
+{
+    if ((NULL == p_band) || (NULL == p_dense) || (p_dense->rows != p_band->n)
+        || (p_dense->cols != p_band->n))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t n = p_band->n;
+
+    for (size_t row = 0U; row < n; ++row)
+    {
+        double *p_row = &p_dense->p_data[row * p_dense->ld];
+        size_t  first = (row > p_band->kl) ? (row - p_band->kl) : 0U;
+        size_t  last  = MIN(n - 1U, row + p_band->ku);
+
+        memset(p_row, 0, n * sizeof(double));
+        memcpy(&p_row[first],
+               &p_band->p_data[(row * p_band->ld) + (first + p_band->kl - row)],
+               (last - first + 1U) * sizeof(double));
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_band_get (const matrix_band_t *p_band,
+                 size_t               row,
+                 size_t               col,
+                 double              *p_out)
+{
+    if ((NULL == p_band) || (NULL == p_out))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if ((row >= p_band->n) || (col >= p_band->n))
+    {
+        return MATRIX_OUT_OF_BOUNDS;
+    }
+
+    *p_out = band_contains(p_band, row, col)
+                 ? p_band->p_data[(row * p_band->ld) + (col + p_band->kl - row)]
+                 : 0.0;
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_band_set (matrix_band_t *p_band, size_t row, size_t col, double value)
+{
+    if (NULL == p_band)
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if ((row >= p_band->n) || (col >= p_band->n)
+        || (!band_contains(p_band, row, col)))
+    {
+        return MATRIX_OUT_OF_BOUNDS;
+    }
+
+    p_band->p_data[(row * p_band->ld) + (col + p_band->kl - row)] = value;
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_band_gemv (const matrix_band_t *p_band,
+                  double               alpha,
+                  const double        *p_x,
+                  double               beta,
+                  double              *p_y)
+{
+    if ((NULL == p_band) || (NULL == p_x) || (NULL == p_y))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t n  = p_band->n;
+    size_t kl = p_band->kl;
+
+    scale_vector(p_y, n, beta);
+
+    for (size_t row = 0U; row < n; ++row)
+    {
+        size_t        first = (row > kl) ? (row - kl) : 0U;
+        size_t        last  = MIN(n - 1U, row + p_band->ku);
+        const double *p_row = &p_band->p_data[(row * p_band->ld) + kl - row];
+        double        sum   = 0.0;
+
+        // p_row is indexed by column; only [first, last] is dereferenced
+        for (size_t col = first; col <= last; ++col)
+        {
+            sum += p_row[col] * p_x[col];
+        }
+
+        p_y[row] += alpha * sum;
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_band_lu (matrix_band_t *p_band, size_t *p_pivots)
+{
+    if ((NULL == p_band) || (NULL == p_pivots))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t              n     = p_band->n;
+    size_t              kl    = p_band->kl;
+    size_t              ld    = p_band->ld;
+    size_t              width = kl + p_band->ku;
+    double             *p_a   = p_band->p_data;
+    matrix_error_code_t ret   = MATRIX_SUCCESS;
+
+#define BAND_AT(row, col) p_a[((row) * ld) + ((col) + kl - (row))]
+
+    for (size_t k = 0U; k < n; ++k)
+    {
+        size_t last_row = MIN(n - 1U, k + kl);
+        size_t last_col = MIN(n - 1U, k + width);
+        size_t pivot    = k;
+        double max_abs  = fabs(BAND_AT(k, k));
+
+        for (size_t row = k + 1U; row <= last_row; ++row)
+        {
+            if (fabs(BAND_AT(row, k)) > max_abs)
+            {
+                max_abs = fabs(BAND_AT(row, k));
+                pivot   = row;
+            }
+        }
+
+        p_pivots[k] = pivot;
+
+        if (0.0 == max_abs)
+        {
+            // Nothing to eliminate in this column; keep going so the
+            // factors are complete, as matrix_lu does
+            ret = MATRIX_SINGULAR;
+            continue;
+        }
+
+        if (pivot != k)
+        {
+            // Row pivot has nonzeros up to pivot + ku <= k + width, all of
+            // which fit in row k's storage thanks to the kl spare columns
+            double *p_k = &BAND_AT(k, k);
+            double *p_p = &BAND_AT(pivot, k);
+
+            for (size_t idx = 0U; idx <= last_col - k; ++idx)
+            {
+                double tmp = p_k[idx];
+                p_k[idx]   = p_p[idx];
+                p_p[idx]   = tmp;
+            }
+        }
+
+        const double *p_urow = &BAND_AT(k, k);
+        double        inv    = 1.0 / p_urow[0];
+
+        for (size_t row = k + 1U; row <= last_row; ++row)
+        {
+            double *p_row = &BAND_AT(row, k);
+            double  l     = p_row[0] * inv;
+
+            p_row[0] = l;
+
+            for (size_t idx = 1U; idx <= last_col - k; ++idx)
+            {
+                p_row[idx] -= l * p_urow[idx];
+            }
+        }
+    }
+
+#undef BAND_AT
+
+    return ret;
+}
+
+matrix_error_code_t
+matrix_band_lu_solve (const matrix_band_t *p_lu,
+                      const size_t        *p_pivots,
+                      const matrix_t      *p_b,
+                      matrix_t            *p_x)
+{
+    if ((NULL == p_lu) || (NULL == p_pivots) || (NULL == p_b) || (NULL == p_x)
+        || (p_b->rows != p_lu->n) || (p_x->rows != p_b->rows)
+        || (p_x->cols != p_b->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    // Solving in place needs X to be B element for element
+    bool b_in_place = matrix_is_same_storage(p_b, p_x);
+
+    if ((false == b_in_place) && matrix_is_overlapping(p_b, p_x))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t        n     = p_lu->n;
+    size_t        kl    = p_lu->kl;
+    size_t        width = kl + p_lu->ku;
+    size_t        nrhs  = p_x->cols;
+    size_t        ldx   = p_x->ld;
+    const double *p_a   = p_lu->p_data;
+    double       *p_out = p_x->p_data;
+
+    if (false == b_in_place)
+    {
+        matrix_copy_block(p_b->p_data, p_b->ld, p_out, ldx, n, nrhs);
+    }
+
+    // Forward: apply each swap and its column of L in factorization order
+    for (size_t k = 0U; k < n; ++k)
+    {
+        double *p_k = &p_out[k * ldx];
+
+        if (p_pivots[k] >= n)
+        {
+            return MATRIX_INVALID_ARGUMENT;
+        }
+
+        if (p_pivots[k] != k)
+        {
+            double *p_p = &p_out[p_pivots[k] * ldx];
+
+            for (size_t col = 0U; col < nrhs; ++col)
+            {
+                double tmp = p_k[col];
+                p_k[col]   = p_p[col];
+                p_p[col]   = tmp;
+            }
+        }
+
+        for (size_t row = k + 1U; row <= MIN(n - 1U, k + kl); ++row)
+        {
+            double  l     = p_a[(row * p_lu->ld) + (k + kl - row)];
+            double *p_row = &p_out[row * ldx];
+
+            for (size_t col = 0U; col < nrhs; ++col)
+            {
+                p_row[col] -= l * p_k[col];
+            }
+        }
+    }
+
+    // Backward: U has kl + ku super-diagonals after pivoting
+    for (size_t row = n; row-- > 0U;)
+    {
+        const double *p_urow = &p_a[(row * p_lu->ld) + kl];
+        double       *p_row  = &p_out[row * ldx];
+
+        if (0.0 == p_urow[0])
+        {
+            return MATRIX_SINGULAR;
+        }
+
+        for (size_t idx = 1U; idx <= MIN(n - 1U - row, width); ++idx)
+        {
+            const double *p_next = &p_out[(row + idx) * ldx];
+
+            for (size_t col = 0U; col < nrhs; ++col)
+            {
+                p_row[col] -= p_urow[idx] * p_next[col];
+            }
+        }
+
+        double inv = 1.0 / p_urow[0];
+
+        for (size_t col = 0U; col < nrhs; ++col)
+        {
+            p_row[col] *= inv;
+        }
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_band_solve (const matrix_band_t *p_band,
+                   const matrix_t      *p_b,
+                   matrix_t            *p_x)
+{
+    if ((NULL == p_band) || (NULL == p_b) || (NULL == p_x)
+        || (p_b->rows != p_band->n) || (p_x->rows != p_b->rows)
+        || (p_x->cols != p_b->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_error_code_t ret      = MATRIX_ALLOCATION_FAILURE;
+    matrix_band_t      *p_lu     = NULL;
+    size_t             *p_pivots = malloc(p_band->n * sizeof(size_t));
+
+    p_lu = matrix_band_create(p_band->n, p_band->kl, p_band->ku);
+
+    if ((NULL == p_lu) || (NULL == p_pivots))
+    {
+        goto CLEANUP;
+    }
+
+    memcpy(p_lu->p_data,
+           p_band->p_data,
+           p_band->n * p_band->ld * sizeof(double));
+    ret = matrix_band_lu(p_lu, p_pivots);
+
+    if (MATRIX_SUCCESS == ret)
+    {
+        ret = matrix_band_lu_solve(p_lu, p_pivots, p_b, p_x);
+    }
+
+CLEANUP:
+    matrix_band_destroy(p_lu);
+    free(p_pivots);
+    return ret;
+}
+
+static size_t
+packed_offset (const matrix_packed_t *p_packed, size_t row, size_t col)
+{
+    if (MATRIX_UPPER == p_packed->uplo)
+    {
+        // Rows 0..row-1 hold n, n-1, ..., n-row+1 elements
+        return (row * p_packed->n) - ((row * (row - 1U)) / 2U) + (col - row);
+    }
+
+    return ((row * (row + 1U)) / 2U) + col;
+}
+
+static bool
+band_contains (const matrix_band_t *p_band, size_t row, size_t col)
+{
+    return (col + p_band->kl >= row) && (col <= row + p_band->ku);
+}
+
+static void
+scale_vector (double *p_y, size_t n, double beta)
+{
+    if (0.0 == beta)
+    {
+        memset(p_y, 0, n * sizeof(double));
+    }
+    else if (1.0 != beta)
+    {
+        for (size_t idx = 0U; idx < n; ++idx)
+        {
+            p_y[idx] *= beta;
+        }
+    }
+}
+
+/*** end of file ***/
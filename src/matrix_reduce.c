@@ -0,0 +1,765 @@
+/**
+ * @file matrix_reduce.c
+ * @brief Implementation of matrix reductions.
+ *
+ * Every reduction maps to one of a few kinds: sums of a transformed element
+ * (x, |x| or x^2) and extremes of a transformed element with its position.
+ * Row-wise and whole-matrix reductions cut each row into segments of at most
+ * REDUCE_SEGMENT elements. Each segment is reduced with SIMD into a partial
+ * result, and the partials are combined afterwards. Segments are the unit of
+ * threading, so even a single very long row is split across threads.
+ *
+ * Summing a segment with 16 lanes and then adding the segment partials
+ * pairwise keeps rounding error far below that of one running sum, at no
+ * extra cost in bandwidth. Column reductions stream rows in order and add
+ * each row into a band of column accumulators, so they read memory exactly
+ * like the row reductions do. Column sums are first collected in blocks of
+ * REDUCE_ROW_BLOCK rows for the same accuracy reason.
+ *
+ * @author heapbadger
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_internal.h"
+#include "matrix_reduce.h"
+#include "parallel.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Longest run of a row reduced as one partial result.
+ */
+#define REDUCE_SEGMENT 4096
+
+/**
+ * Number of rows summed into a fresh accumulator before it is added to the
+ * column totals.
+ */
+#define REDUCE_ROW_BLOCK 256
+
+/**
+ * Number of columns whose accumulators are kept hot at once.
+ */
+#define REDUCE_COL_BAND 512
+
+/**
+ * Partial counts at or below which pairwise summation adds sequentially.
+ */
+#define REDUCE_PAIRWISE_BASE 8
+
+typedef enum
+{
+    REDUCE_SUM     = 0, /**< Sum of x. */
+    REDUCE_ABS     = 1, /**< Sum of |x|. */
+    REDUCE_SQUARE  = 2, /**< Sum of x^2. */
+    REDUCE_MIN     = 3, /**< Smallest x. */
+    REDUCE_MAX     = 4, /**< Largest x. */
+    REDUCE_ABS_MAX = 5, /**< Largest |x|. */
+} reduce_kind_t;
+
+typedef struct
+{
+    const matrix_t *p_matrix;
+    reduce_kind_t   kind;
+    size_t          seg_per_row;
+    double         *p_value;
+    size_t         *p_index;
+} reduce_ctx_t;
+
+/**
+ * @brief Map a public reduction to its kind.
+ *
+ * @param op Public reduction.
+ * @param p_kind Output kind.
+ *
+ * @return true if op is a valid reduction.
+ */
+static bool reduce_kind(matrix_reduce_op_t op, reduce_kind_t *p_kind);
+
+/**
+ * @brief Check whether a kind selects an element rather than summing.
+ */
+static bool reduce_is_extreme(reduce_kind_t kind);
+
+/**
+ * @brief Apply the element transform of a kind to one value.
+ */
+static double reduce_transform(double value, reduce_kind_t kind);
+
+#if defined(__AVX__)
+/**
+ * @brief Apply the element transform of a kind to four values.
+ */
+static __m256d reduce_transform_pd(__m256d value, reduce_kind_t kind);
+#endif
+
+/**
+ * @brief Reduce n contiguous elements.
+ *
+ * @param p_src Pointer to the first element.
+ * @param n Number of elements (> 0).
+ * @param kind Reduction kind.
+ * @param p_value Output for the sum or the selected transformed value.
+ * @param p_index Output for the offset of the selected element, or 0 for
+ *                sums.
+ */
+static void reduce_contiguous(const double *p_src,
+                              size_t        n,
+                              reduce_kind_t kind,
+                              double       *p_value,
+                              size_t       *p_index);
+
+/**
+ * @brief Add the transformed elements of p_src into p_acc element-wise.
+ */
+static void reduce_accumulate(const double *p_src,
+                              double       *p_acc,
+                              size_t        n,
+                              reduce_kind_t kind);
+
+/**
+ * @brief parallel_func reducing a range of row segments to partials.
+ */
+static void reduce_segment_range(size_t begin, size_t end, void *p_ctx);
+
+/**
+ * @brief parallel_func reducing a range of columns.
+ */
+static void reduce_column_range(size_t begin, size_t end, void *p_ctx);
+
+/**
+ * @brief Sum n values by recursive halving.
+ */
+static double reduce_pairwise(const double *p_values, size_t n);
+
+/**
+ * @brief Position of the first best value among n partials.
+ */
+static size_t reduce_select(const double *p_values,
+                            size_t        n,
+                            reduce_kind_t kind);
+
+/**
+ * @brief Run a reduction kind over an axis.
+ *
+ * @param p_matrix Pointer to the matrix.
+ * @param kind Reduction kind.
+ * @param axis What to reduce over.
+ * @param p_value Output values, one per reduced group.
+ * @param p_index Output positions for extremes, or NULL.
+ *
+ * @return MATRIX_SUCCESS on success, error code on failure.
+ */
+static matrix_error_code_t reduce_run(const matrix_t *p_matrix,
+                                      reduce_kind_t   kind,
+                                      matrix_axis_t   axis,
+                                      double         *p_value,
+                                      size_t         *p_index);
+
+/**
+ * @brief Number of results an axis produces.
+ */
+static size_t reduce_group_count(const matrix_t *p_matrix, matrix_axis_t axis);
+
+matrix_error_code_t
+matrix_reduce (const matrix_t    *p_matrix,
+               matrix_reduce_op_t op,
+               matrix_axis_t      axis,
+               double            *p_out)
+{
+    reduce_kind_t kind = REDUCE_SUM;
+
+    if ((NULL == p_matrix) || (NULL == p_matrix->p_data) || (NULL == p_out)
+        || (0U == reduce_group_count(p_matrix, axis))
+        || (false == reduce_kind(op, &kind)))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_error_code_t ret = reduce_run(p_matrix, kind, axis, p_out, NULL);
+
+    if (MATRIX_SUCCESS != ret)
+    {
+        return ret;
+    }
+
+    size_t groups = reduce_group_count(p_matrix, axis);
+    size_t length = (p_matrix->rows * p_matrix->cols) / groups;
+
+    for (size_t idx = 0U; idx < groups; ++idx)
+    {
+        if (MATRIX_REDUCE_MEAN == op)
+        {
+            p_out[idx] /= (double)length;
+        }
+        else if (MATRIX_REDUCE_NORM_L2 == op)
+        {
+            p_out[idx] = sqrt(p_out[idx]);
+        }
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_reduce_index (const matrix_t    *p_matrix,
+                     matrix_reduce_op_t op,
+                     matrix_axis_t      axis,
+                     size_t            *p_out)
+{
+    reduce_kind_t kind = REDUCE_SUM;
+
+    if ((NULL == p_matrix) || (NULL == p_matrix->p_data) || (NULL == p_out)
+        || (0U == reduce_group_count(p_matrix, axis))
+        || (false == reduce_kind(op, &kind))
+        || (false == reduce_is_extreme(kind)))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t  groups  = reduce_group_count(p_matrix, axis);
+    double *p_value = (double *)malloc(groups * sizeof(double));
+
+    if (NULL == p_value)
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    matrix_error_code_t ret = reduce_run(p_matrix, kind, axis, p_value, p_out);
+    free(p_value);
+    return ret;
+}
+
+matrix_error_code_t
+matrix_argmin (const matrix_t *p_matrix, size_t *p_row, size_t *p_col)
+{
+    size_t flat = 0U;
+
+    if ((NULL == p_row) || (NULL == p_col))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_error_code_t ret = matrix_reduce_index(
+        p_matrix, MATRIX_REDUCE_MIN, MATRIX_AXIS_ALL, &flat);
+
+    if (MATRIX_SUCCESS == ret)
+    {
+        *p_row = flat / p_matrix->cols;
+        *p_col = flat % p_matrix->cols;
+    }
+
+    return ret;
+}
+
+matrix_error_code_t
+matrix_argmax (const matrix_t *p_matrix, size_t *p_row, size_t *p_col)
+{
+    size_t flat = 0U;
+
+    if ((NULL == p_row) || (NULL == p_col))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_error_code_t ret = matrix_reduce_index(
+        p_matrix, MATRIX_REDUCE_MAX, MATRIX_AXIS_ALL, &flat);
+
+    if (MATRIX_SUCCESS == ret)
+    {
+        *p_row = flat / p_matrix->cols;
+        *p_col = flat % p_matrix->cols;
+    }
+
+    return ret;
+}
+
+matrix_error_code_t
+matrix_norm (const matrix_t *p_matrix, matrix_norm_t norm, double *p_out)
+{
+    if ((NULL == p_matrix) || (NULL == p_out))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if (MATRIX_NORM_FROBENIUS == norm)
+    {
+        return matrix_reduce(
+            p_matrix, MATRIX_REDUCE_NORM_L2, MATRIX_AXIS_ALL, p_out);
+    }
+
+    if ((MATRIX_NORM_ONE != norm) && (MATRIX_NORM_INF != norm))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    // Induced norms are the largest absolute column or row sum
+    matrix_axis_t axis
+        = (MATRIX_NORM_ONE == norm) ? MATRIX_AXIS_COLS : MATRIX_AXIS_ROWS;
+    size_t  groups = reduce_group_count(p_matrix, axis);
+    double *p_sums = (double *)malloc(groups * sizeof(double));
+
+    if (NULL == p_sums)
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    matrix_error_code_t ret
+        = matrix_reduce(p_matrix, MATRIX_REDUCE_NORM_L1, axis, p_sums);
+
+    if (MATRIX_SUCCESS == ret)
+    {
+        *p_out = p_sums[reduce_select(p_sums, groups, REDUCE_MAX)];
+    }
+
+    free(p_sums);
+    return ret;
+}
+
+static bool
+reduce_kind (matrix_reduce_op_t op, reduce_kind_t *p_kind)
+{
+    switch (op)
+    {
+        case MATRIX_REDUCE_SUM:
+        case MATRIX_REDUCE_MEAN:
+            *p_kind = REDUCE_SUM;
+            return true;
+        case MATRIX_REDUCE_MIN:
+            *p_kind = REDUCE_MIN;
+            return true;
+        case MATRIX_REDUCE_MAX:
+            *p_kind = REDUCE_MAX;
+            return true;
+        case MATRIX_REDUCE_NORM_L1:
+            *p_kind = REDUCE_ABS;
+            return true;
+        case MATRIX_REDUCE_NORM_L2:
+            *p_kind = REDUCE_SQUARE;
+            return true;
+        case MATRIX_REDUCE_NORM_INF:
+            *p_kind = REDUCE_ABS_MAX;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool
+reduce_is_extreme (reduce_kind_t kind)
+{
+    return (REDUCE_MIN == kind) || (REDUCE_MAX == kind)
+           || (REDUCE_ABS_MAX == kind);
+}
+
+static double
+reduce_transform (double value, reduce_kind_t kind)
+{
+    switch (kind)
+    {
+        case REDUCE_ABS:
+        case REDUCE_ABS_MAX:
+            return fabs(value);
+        case REDUCE_SQUARE:
+            return value * value;
+        default:
+            return value;
+    }
+}
+
+#if defined(__AVX__)
+static __m256d
+reduce_transform_pd (__m256d value, reduce_kind_t kind)
+{
+    switch (kind)
+    {
+        case REDUCE_ABS:
+        case REDUCE_ABS_MAX:
+            return _mm256_andnot_pd(_mm256_set1_pd(-0.0), value);
+        case REDUCE_SQUARE:
+            return _mm256_mul_pd(value, value);
+        default:
+            return value;
+    }
+}
+#endif
+
+static void
+reduce_contiguous (const double *p_src,
+                   size_t        n,
+                   reduce_kind_t kind,
+                   double       *p_value,
+                   size_t       *p_index)
+{
+    size_t idx = 0U;
+
+    if (false == reduce_is_extreme(kind))
+    {
+        double sum = 0.0;
+
+#if defined(__AVX__)
+        __m256d acc[4] = { _mm256_setzero_pd(),
+                           _mm256_setzero_pd(),
+                           _mm256_setzero_pd(),
+                           _mm256_setzero_pd() };
+        double  lanes[4];
+
+        for (; idx + 16U <= n; idx += 16U)
+        {
+            for (size_t vec = 0U; vec < 4U; ++vec)
+            {
+                __m256d val = _mm256_loadu_pd(p_src + idx + (4U * vec));
+                acc[vec]    = _mm256_add_pd(acc[vec],
+                                         reduce_transform_pd(val, kind));
+            }
+        }
+
+        _mm256_storeu_pd(lanes,
+                         _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]),
+                                       _mm256_add_pd(acc[2], acc[3])));
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+        double acc[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+        for (; idx + 4U <= n; idx += 4U)
+        {
+            for (size_t lane = 0U; lane < 4U; ++lane)
+            {
+                acc[lane] += reduce_transform(p_src[idx + lane], kind);
+            }
+        }
+
+        sum = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+
+        for (; idx < n; ++idx)
+        {
+            sum += reduce_transform(p_src[idx], kind);
+        }
+
+        *p_value = sum;
+        *p_index = 0U;
+        return;
+    }
+
+    bool   b_max    = (REDUCE_MIN != kind);
+    double best     = reduce_transform(p_src[0], kind);
+    size_t best_idx = 0U;
+    idx             = 1U;
+
+#if defined(__AVX__)
+    if (8U <= n)
+    {
+        // Track the best value and its position independently per lane
+        __m256d best_val = reduce_transform_pd(_mm256_loadu_pd(p_src), kind);
+        __m256d best_pos = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+        __m256d cur_pos  = best_pos;
+        __m256d step     = _mm256_set1_pd(4.0);
+        double  lane_val[4];
+        double  lane_pos[4];
+
+        for (idx = 4U; idx + 4U <= n; idx += 4U)
+        {
+            __m256d val
+                = reduce_transform_pd(_mm256_loadu_pd(p_src + idx), kind);
+            __m256d mask = b_max ? _mm256_cmp_pd(val, best_val, _CMP_GT_OQ)
+                                 : _mm256_cmp_pd(val, best_val, _CMP_LT_OQ);
+            cur_pos      = _mm256_add_pd(cur_pos, step);
+            best_val     = _mm256_blendv_pd(best_val, val, mask);
+            best_pos     = _mm256_blendv_pd(best_pos, cur_pos, mask);
+        }
+
+        _mm256_storeu_pd(lane_val, best_val);
+        _mm256_storeu_pd(lane_pos, best_pos);
+        best     = lane_val[0];
+        best_idx = (size_t)lane_pos[0];
+
+        for (size_t lane = 1U; lane < 4U; ++lane)
+        {
+            size_t pos      = (size_t)lane_pos[lane];
+            bool   b_better = b_max ? (lane_val[lane] > best)
+                                    : (lane_val[lane] < best);
+
+            if (b_better || ((lane_val[lane] == best) && (pos < best_idx)))
+            {
+                best     = lane_val[lane];
+                best_idx = pos;
+            }
+        }
+    }
+#endif
+
+    for (; idx < n; ++idx)
+    {
+        double val = reduce_transform(p_src[idx], kind);
+
+        if (b_max ? (val > best) : (val < best))
+        {
+            best     = val;
+            best_idx = idx;
+        }
+    }
+
+    *p_value = best;
+    *p_index = best_idx;
+}
+
+static void
+reduce_accumulate (const double *p_src,
+                   double       *p_acc,
+                   size_t        n,
+                   reduce_kind_t kind)
+{
+    size_t idx = 0U;
+
+#if defined(__AVX__)
+    for (; idx + 4U <= n; idx += 4U)
+    {
+        __m256d val = reduce_transform_pd(_mm256_loadu_pd(p_src + idx), kind);
+        _mm256_storeu_pd(p_acc + idx,
+                         _mm256_add_pd(_mm256_loadu_pd(p_acc + idx), val));
+    }
+#endif
+
+    for (; idx < n; ++idx)
+    {
+        p_acc[idx] += reduce_transform(p_src[idx], kind);
+    }
+}
+
+static void
+reduce_segment_range (size_t begin, size_t end, void *p_ctx)
+{
+    const reduce_ctx_t *p_reduce = (const reduce_ctx_t *)p_ctx;
+    const matrix_t     *p_matrix = p_reduce->p_matrix;
+
+    for (size_t seg = begin; seg < end; ++seg)
+    {
+        size_t row   = seg / p_reduce->seg_per_row;
+        size_t first = (seg % p_reduce->seg_per_row) * REDUCE_SEGMENT;
+        size_t len   = MIN(p_matrix->cols - first, (size_t)REDUCE_SEGMENT);
+        reduce_contiguous(p_matrix->p_data + (row * p_matrix->ld) + first,
+                          len,
+                          p_reduce->kind,
+                          &p_reduce->p_value[seg],
+                          &p_reduce->p_index[seg]);
+        p_reduce->p_index[seg] += first;
+    }
+}
+
+static void
+reduce_column_range (size_t begin, size_t end, void *p_ctx)
+{
+    const reduce_ctx_t *p_reduce = (const reduce_ctx_t *)p_ctx;
+    const matrix_t     *p_matrix = p_reduce->p_matrix;
+    reduce_kind_t       kind     = p_reduce->kind;
+    double              block[REDUCE_COL_BAND];
+
+    for (size_t first = begin; first < end; first += REDUCE_COL_BAND)
+    {
+        size_t  width = MIN(end - first, (size_t)REDUCE_COL_BAND);
+        double *p_out = p_reduce->p_value + first;
+
+        if (reduce_is_extreme(kind))
+        {
+            bool    b_max = (REDUCE_MIN != kind);
+            size_t *p_pos = p_reduce->p_index + first;
+
+            for (size_t col = 0U; col < width; ++col)
+            {
+                p_out[col]
+                    = reduce_transform(p_matrix->p_data[first + col], kind);
+                p_pos[col] = 0U;
+            }
+
+            for (size_t row = 1U; row < p_matrix->rows; ++row)
+            {
+                const double *p_src
+                    = p_matrix->p_data + (row * p_matrix->ld) + first;
+
+                for (size_t col = 0U; col < width; ++col)
+                {
+                    double val = reduce_transform(p_src[col], kind);
+
+                    if (b_max ? (val > p_out[col]) : (val < p_out[col]))
+                    {
+                        p_out[col] = val;
+                        p_pos[col] = row;
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        memset(p_out, 0, width * sizeof(double));
+
+        for (size_t top = 0U; top < p_matrix->rows; top += REDUCE_ROW_BLOCK)
+        {
+            size_t bottom = MIN(top + REDUCE_ROW_BLOCK, p_matrix->rows);
+            memset(block, 0, width * sizeof(double));
+
+            for (size_t row = top; row < bottom; ++row)
+            {
+                reduce_accumulate(
+                    p_matrix->p_data + (row * p_matrix->ld) + first,
+                    block,
+                    width,
+                    kind);
+            }
+
+            for (size_t col = 0U; col < width; ++col)
+            {
+                p_out[col] += block[col];
+            }
+        }
+    }
+}
+
+static double
+reduce_pairwise (const double *p_values, size_t n)
+{
+    if (REDUCE_PAIRWISE_BASE >= n)
+    {
+        double sum = 0.0;
+
+        for (size_t idx = 0U; idx < n; ++idx)
+        {
+            sum += p_values[idx];
+        }
+
+        return sum;
+    }
+
+    size_t half = n / 2U;
+    return reduce_pairwise(p_values, half)
+           + reduce_pairwise(p_values + half, n - half);
+}
+
+static size_t
+reduce_select (const double *p_values, size_t n, reduce_kind_t kind)
+{
+    bool   b_max = (REDUCE_MIN != kind);
+    size_t best  = 0U;
+
+    for (size_t idx = 1U; idx < n; ++idx)
+    {
+        if (b_max ? (p_values[idx] > p_values[best])
+                  : (p_values[idx] < p_values[best]))
+        {
+            best = idx;
+        }
+    }
+
+    return best;
+}
+
+static matrix_error_code_t
+reduce_run (const matrix_t *p_matrix,
+            reduce_kind_t   kind,
+            matrix_axis_t   axis,
+            double         *p_value,
+            size_t         *p_index)
+{
+    size_t       rows = p_matrix->rows;
+    size_t       cols = p_matrix->cols;
+    reduce_ctx_t ctx  = { 0 };
+    ctx.p_matrix      = p_matrix;
+    ctx.kind          = kind;
+
+    if (MATRIX_AXIS_COLS == axis)
+    {
+        size_t *p_scratch = NULL;
+
+        if ((NULL == p_index) && reduce_is_extreme(kind))
+        {
+            p_scratch = (size_t *)malloc(cols * sizeof(size_t));
+
+            if (NULL == p_scratch)
+            {
+                return MATRIX_ALLOCATION_FAILURE;
+            }
+        }
+
+        // Bands are at least one AVX vector wide
+        size_t min_chunk = MATRIX_REDUCE_PARALLEL_MIN / rows;
+        ctx.p_value      = p_value;
+        ctx.p_index      = (NULL == p_index) ? p_scratch : p_index;
+        parallel_for(
+            cols, (4U > min_chunk) ? 4U : min_chunk, reduce_column_range, &ctx);
+        free(p_scratch);
+        return MATRIX_SUCCESS;
+    }
+
+    size_t  seg_per_row = (cols + REDUCE_SEGMENT - 1U) / REDUCE_SEGMENT;
+    size_t  segments    = rows * seg_per_row;
+    double *p_seg_value = (double *)malloc(segments * sizeof(double));
+    size_t *p_seg_index = (size_t *)malloc(segments * sizeof(size_t));
+
+    if ((NULL == p_seg_value) || (NULL == p_seg_index))
+    {
+        free(p_seg_value);
+        free(p_seg_index);
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    ctx.seg_per_row = seg_per_row;
+    ctx.p_value     = p_seg_value;
+    ctx.p_index     = p_seg_index;
+    parallel_for(segments,
+                 MATRIX_REDUCE_PARALLEL_MIN / MIN(cols, (size_t)REDUCE_SEGMENT),
+                 reduce_segment_range,
+                 &ctx);
+
+    size_t groups = (MATRIX_AXIS_ROWS == axis) ? rows : 1U;
+    size_t span   = segments / groups;
+
+    for (size_t group = 0U; group < groups; ++group)
+    {
+        const double *p_part = p_seg_value + (group * span);
+
+        if (false == reduce_is_extreme(kind))
+        {
+            p_value[group] = reduce_pairwise(p_part, span);
+            continue;
+        }
+
+        size_t seg     = (group * span) + reduce_select(p_part, span, kind);
+        p_value[group] = p_seg_value[seg];
+
+        if (NULL != p_index)
+        {
+            size_t row     = seg / seg_per_row;
+            p_index[group] = (MATRIX_AXIS_ROWS == axis)
+                                 ? p_seg_index[seg]
+                                 : (row * cols) + p_seg_index[seg];
+        }
+    }
+
+    free(p_seg_value);
+    free(p_seg_index);
+    return MATRIX_SUCCESS;
+}
+
+static size_t
+reduce_group_count (const matrix_t *p_matrix, matrix_axis_t axis)
+{
+    switch (axis)
+    {
+        case MATRIX_AXIS_ALL:
+            return 1U;
+        case MATRIX_AXIS_ROWS:
+            return p_matrix->rows;
+        case MATRIX_AXIS_COLS:
+            return p_matrix->cols;
+        default:
+            return 0U;
+    }
+}
+
+/*** end of file ***/
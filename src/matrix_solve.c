@@ -0,0 +1,919 @@
+/**
+ * @file matrix_solve.c
+ * @brief Direct solvers for dense linear systems.
+ *
+ * Solving A * X = B through a factorization is both cheaper and more
+ * accurate than forming inv(A) and multiplying. Three factorizations are
+ * provided, all blocked so the bulk of the work runs through matrix_gemm:
+ *
+ * - LU with partial pivoting for general square systems (see matrix_lu).
+ * - Cholesky, A = L * L^T, for symmetric positive definite systems. Half the
+ *   work of LU and no pivoting.
+ * - Householder QR, A = Q * R, for overdetermined least squares problems.
+ *   Reflectors are aggregated into compact WY block reflectors,
+ *   I - V * T * V^T, so both factorization and Q^T * B are GEMM bound.
+ *
+ * A factorization is kept in a matrix_factor_t and can be reused for any
+ * number of right-hand sides.
+ *
+ * @author heapbadger
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_internal.h"
+#include "matrix_solve.h"
+
+/**
+ * @brief Blocked right-looking Cholesky factorization of the lower triangle.
+ *
+ * @param p_a Pointer to the n x n matrix, overwritten with L (upper triangle
+ *            zeroed).
+ * @param n Matrix order.
+ * @param lda Leading dimension.
+ *
+ * @return MATRIX_SUCCESS, MATRIX_NOT_POSITIVE_DEFINITE, or an allocation
+ *         error.
+ */
+static matrix_error_code_t cholesky_factor(double *p_a, size_t n, size_t lda);
+
+/**
+ * @brief Blocked Householder QR factorization.
+ *
+ * @param p_a Pointer to the m x n matrix (m >= n), overwritten with R on and
+ *            above the diagonal and the reflector vectors below it.
+ * @param m Number of rows.
+ * @param n Number of columns.
+ * @param lda Leading dimension.
+ * @param p_tau Output reflector scales (n).
+ * @param p_t Output block reflector triangles, one MATRIX_QR_BLOCK square
+ *            per panel.
+ *
+ * @return MATRIX_SUCCESS or an allocation error.
+ */
+static matrix_error_code_t qr_factor(double *p_a,
+                                     size_t  m,
+                                     size_t  n,
+                                     size_t  lda,
+                                     double *p_tau,
+                                     double *p_t);
+
+/**
+ * @brief Apply a block reflector transpose, B = (I - V * T^T * V^T) * B.
+ *
+ * @param p_v Explicit reflector block (rows x width, unit diagonal).
+ * @param p_vt Transpose of p_v (width x rows).
+ * @param p_t Upper triangular T (width x width, leading dimension
+ *            MATRIX_QR_BLOCK).
+ * @param rows Number of rows of V and B.
+ * @param width Number of reflectors.
+ * @param p_b Pointer to B.
+ * @param ncols Number of columns of B.
+ * @param ldb Leading dimension of B.
+ * @param p_work Workspace of width * ncols doubles.
+ *
+ * @return MATRIX_SUCCESS or an allocation error.
+ */
+static matrix_error_code_t qr_apply_block(const double *p_v,
+                                          const double *p_vt,
+                                          const double *p_t,
+                                          size_t        rows,
+                                          size_t        width,
+                                          double       *p_b,
+                                          size_t        ncols,
+                                          size_t        ldb,
+                                          double       *p_work);
+
+/**
+ * @brief Copy the reflectors of one QR panel into explicit V and V^T.
+ *
+ * @param p_a Pointer to the factored matrix at the panel's diagonal element.
+ * @param lda Leading dimension of the factored matrix.
+ * @param rows Number of rows below and including the diagonal.
+ * @param width Number of reflectors in the panel.
+ * @param p_v Output V (rows x width).
+ * @param p_vt Output V^T (width x rows).
+ */
+static void qr_expand_panel(const double *p_a,
+                            size_t        lda,
+                            size_t        rows,
+                            size_t        width,
+                            double       *p_v,
+                            double       *p_vt);
+
+/**
+ * @brief Blocked triangular solve, X = inv(op(T)) * X.
+ *
+ * op(T) is T, or T^T read in place when b_trans is set, so the Cholesky
+ * back substitution runs on L without forming L^T.
+ *
+ * @param p_t Pointer to the n x n triangular matrix as stored.
+ * @param ldt Leading dimension of T.
+ * @param b_trans True to solve with T^T instead of T.
+ * @param b_lower True if op(T) is lower triangular, false if upper.
+ * @param n Matrix order.
+ * @param p_x Right-hand sides on entry, solutions on exit.
+ * @param nrhs Number of right-hand sides.
+ * @param ldx Leading dimension of X.
+ *
+ * @return MATRIX_SUCCESS, MATRIX_SINGULAR, or an allocation error.
+ */
+static matrix_error_code_t triangular_solve(const double *p_t,
+                                            size_t        ldt,
+                                            bool          b_trans,
+                                            bool          b_lower,
+                                            size_t        n,
+                                            double       *p_x,
+                                            size_t        nrhs,
+                                            size_t        ldx);
+
+/**
+ * @brief Check whether a square matrix is exactly symmetric with a positive
+ * diagonal, the precondition for attempting Cholesky.
+ *
+ * @param p_matrix Pointer to the matrix.
+ *
+ * @return true if Cholesky is worth attempting, false otherwise.
+ */
+static bool is_cholesky_candidate(const matrix_t *p_matrix);
+
+matrix_error_code_t
+matrix_factorize (const matrix_t        *p_matrix,
+                  matrix_solve_method_t  method,
+                  matrix_factor_t      **pp_factor)
+{
+    if ((NULL == p_matrix) || (NULL == pp_factor)
+        || (p_matrix->rows < p_matrix->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    bool b_square = (p_matrix->rows == p_matrix->cols);
+
+    if (MATRIX_SOLVE_AUTO == method)
+    {
+        if (false == b_square)
+        {
+            method = MATRIX_SOLVE_QR;
+        }
+        else if (is_cholesky_candidate(p_matrix))
+        {
+            matrix_error_code_t ret
+                = matrix_factorize(p_matrix, MATRIX_SOLVE_CHOLESKY, pp_factor);
+
+            if (MATRIX_NOT_POSITIVE_DEFINITE != ret)
+            {
+                return ret;
+            }
+
+            method = MATRIX_SOLVE_LU;
+        }
+        else
+        {
+            method = MATRIX_SOLVE_LU;
+        }
+    }
+
+    if ((false == b_square) && (MATRIX_SOLVE_QR != method))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_error_code_t ret = MATRIX_SUCCESS;
+    matrix_factor_t    *p_factor
+        = (matrix_factor_t *)calloc(1U, sizeof(matrix_factor_t));
+
+    if (NULL == p_factor)
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    p_factor->method   = method;
+    p_factor->rows     = p_matrix->rows;
+    p_factor->cols     = p_matrix->cols;
+    p_factor->p_factor = matrix_clone(p_matrix);
+
+    if (NULL == p_factor->p_factor)
+    {
+        ret = MATRIX_ALLOCATION_FAILURE;
+        goto EXIT;
+    }
+
+    switch (method)
+    {
+        case MATRIX_SOLVE_LU:
+            p_factor->p_pivots
+                = (size_t *)malloc(p_matrix->rows * sizeof(size_t));
+
+            if (NULL == p_factor->p_pivots)
+            {
+                ret = MATRIX_ALLOCATION_FAILURE;
+                break;
+            }
+
+            ret = matrix_lu(p_factor->p_factor,
+                            p_factor->p_factor,
+                            p_factor->p_pivots,
+                            NULL);
+            break;
+
+        case MATRIX_SOLVE_CHOLESKY:
+            ret = cholesky_factor(p_factor->p_factor->p_data,
+                                  p_factor->rows,
+                                  p_factor->p_factor->ld);
+
+            break;
+
+        case MATRIX_SOLVE_QR:
+        {
+            size_t panels = (p_factor->cols + MATRIX_QR_BLOCK - 1U)
+                            / MATRIX_QR_BLOCK;
+            p_factor->p_tau = (double *)calloc(p_factor->cols, sizeof(double));
+            p_factor->p_t   = (double *)calloc(
+                panels * MATRIX_QR_BLOCK * MATRIX_QR_BLOCK, sizeof(double));
+
+            if ((NULL == p_factor->p_tau) || (NULL == p_factor->p_t))
+            {
+                ret = MATRIX_ALLOCATION_FAILURE;
+                break;
+            }
+
+            ret = qr_factor(p_factor->p_factor->p_data,
+                            p_factor->rows,
+                            p_factor->cols,
+                            p_factor->p_factor->ld,
+                            p_factor->p_tau,
+                            p_factor->p_t);
+            break;
+        }
+
+        default:
+            ret = MATRIX_INVALID_ARGUMENT;
+            break;
+    }
+
+EXIT:
+    if (MATRIX_SUCCESS != ret)
+    {
+        matrix_factor_destroy(p_factor);
+        p_factor = NULL;
+    }
+
+    *pp_factor = p_factor;
+    return ret;
+}
+
+void
+matrix_factor_destroy (matrix_factor_t *p_factor)
+{
+    if (NULL != p_factor)
+    {
+        matrix_destroy(p_factor->p_factor);
+        free(p_factor->p_pivots);
+        free(p_factor->p_tau);
+        free(p_factor->p_t);
+        free(p_factor);
+    }
+}
+
+matrix_error_code_t
+matrix_factor_solve (const matrix_factor_t *p_factor,
+                     const matrix_t        *p_b,
+                     matrix_t              *p_x)
+{
+    if ((NULL == p_factor) || (NULL == p_b) || (NULL == p_x)
+        || (p_b->rows != p_factor->rows) || (p_x->rows != p_factor->cols)
+        || (p_x->cols != p_b->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t              n    = p_factor->cols;
+    size_t              nrhs = p_b->cols;
+    matrix_error_code_t ret  = MATRIX_SUCCESS;
+
+    if (MATRIX_SOLVE_LU == p_factor->method)
+    {
+        return matrix_lu_solve(
+            p_factor->p_factor, p_factor->p_pivots, p_b, p_x);
+    }
+
+    if (MATRIX_SOLVE_CHOLESKY == p_factor->method)
+    {
+        if (p_x != p_b)
+        {
+            matrix_copy_block(
+                p_b->p_data, p_b->ld, p_x->p_data, p_x->ld, n, nrhs);
+        }
+
+        ret = triangular_solve(p_factor->p_factor->p_data,
+                               p_factor->p_factor->ld,
+                               false,
+                               true,
+                               n,
+                               p_x->p_data,
+                               nrhs,
+                               p_x->ld);
+
+        if (MATRIX_SUCCESS == ret)
+        {
+            ret = triangular_solve(p_factor->p_factor->p_data,
+                                   p_factor->p_factor->ld,
+                                   true,
+                                   false,
+                                   n,
+                                   p_x->p_data,
+                                   nrhs,
+                                   p_x->ld);
+        }
+
+        return ret;
+    }
+
+    if (MATRIX_SOLVE_QR != p_factor->method)
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    // Q^T * B is formed in a copy since B has more rows than X
+    size_t  m      = p_factor->rows;
+    size_t  ld_a   = p_factor->p_factor->ld;
+    double *p_qtb  = (double *)malloc(m * nrhs * sizeof(double));
+    double *p_v    = (double *)malloc(m * MATRIX_QR_BLOCK * sizeof(double));
+    double *p_vt   = (double *)malloc(m * MATRIX_QR_BLOCK * sizeof(double));
+    double *p_work = (double *)malloc(MATRIX_QR_BLOCK * nrhs * sizeof(double));
+
+    if ((NULL == p_qtb) || (NULL == p_v) || (NULL == p_vt) || (NULL == p_work))
+    {
+        ret = MATRIX_ALLOCATION_FAILURE;
+        goto CLEANUP;
+    }
+
+    matrix_copy_block(p_b->p_data, p_b->ld, p_qtb, nrhs, m, nrhs);
+
+    for (size_t panel = 0U; panel < n; panel += MATRIX_QR_BLOCK)
+    {
+        size_t width = MIN(n - panel, (size_t)MATRIX_QR_BLOCK);
+        size_t rows  = m - panel;
+        qr_expand_panel(p_factor->p_factor->p_data + (panel * ld_a) + panel,
+                        ld_a,
+                        rows,
+                        width,
+                        p_v,
+                        p_vt);
+        ret = qr_apply_block(p_v,
+                             p_vt,
+                             p_factor->p_t
+                                 + ((panel / MATRIX_QR_BLOCK) * MATRIX_QR_BLOCK
+                                    * MATRIX_QR_BLOCK),
+                             rows,
+                             width,
+                             p_qtb + (panel * nrhs),
+                             nrhs,
+                             nrhs,
+                             p_work);
+
+        if (MATRIX_SUCCESS != ret)
+        {
+            goto CLEANUP;
+        }
+    }
+
+    // Back substitution with the leading n x n block, R
+    matrix_copy_block(p_qtb, nrhs, p_x->p_data, p_x->ld, n, nrhs);
+    ret = triangular_solve(p_factor->p_factor->p_data,
+                           ld_a,
+                           false,
+                           false,
+                           n,
+                           p_x->p_data,
+                           nrhs,
+                           p_x->ld);
+
+CLEANUP:
+    free(p_qtb);
+    free(p_v);
+    free(p_vt);
+    free(p_work);
+    return ret;
+}
+
+matrix_error_code_t
+matrix_solve (const matrix_t *p_matrix, const matrix_t *p_b, matrix_t *p_x)
+{
+    return matrix_solve_using(p_matrix, MATRIX_SOLVE_AUTO, p_b, p_x);
+}
+
+matrix_error_code_t
+matrix_solve_using (const matrix_t       *p_matrix,
+                    matrix_solve_method_t method,
+                    const matrix_t       *p_b,
+                    matrix_t             *p_x)
+{
+    if ((NULL == p_matrix) || (NULL == p_b) || (NULL == p_x))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    matrix_factor_t    *p_factor = NULL;
+    matrix_error_code_t ret = matrix_factorize(p_matrix, method, &p_factor);
+
+    if (MATRIX_SUCCESS == ret)
+    {
+        ret = matrix_factor_solve(p_factor, p_b, p_x);
+    }
+
+    matrix_factor_destroy(p_factor);
+    return ret;
+}
+
+static matrix_error_code_t
+cholesky_factor (double *p_a, size_t n, size_t lda)
+{
+    matrix_error_code_t ret = MATRIX_SUCCESS;
+    double             *p_lt
+        = (double *)malloc(MATRIX_CHOLESKY_BLOCK * n * sizeof(double));
+
+    if (NULL == p_lt)
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    for (size_t panel = 0U; panel < n; panel += MATRIX_CHOLESKY_BLOCK)
+    {
+        size_t width = MIN(n - panel, (size_t)MATRIX_CHOLESKY_BLOCK);
+        size_t end   = panel + width;
+
+        // Unblocked factorization of the diagonal block
+        for (size_t col = panel; col < end; ++col)
+        {
+            double *p_col_row = p_a + (col * lda);
+            double  diag      = p_col_row[col];
+
+            if (!(diag > 0.0))
+            {
+                ret = MATRIX_NOT_POSITIVE_DEFINITE;
+                goto EXIT;
+            }
+
+            diag           = sqrt(diag);
+            p_col_row[col] = diag;
+
+            for (size_t row = col + 1U; row < end; ++row)
+            {
+                p_a[(row * lda) + col] /= diag;
+            }
+
+            for (size_t row = col + 1U; row < end; ++row)
+            {
+                double *p_row = p_a + (row * lda);
+                double  mult  = p_row[col];
+
+                for (size_t idx = col + 1U; idx <= row; ++idx)
+                {
+                    p_row[idx] -= mult * p_a[(idx * lda) + col];
+                }
+            }
+        }
+
+        if (end >= n)
+        {
+            break;
+        }
+
+        // L21 = A21 * inv(L11)^T, one row at a time
+        for (size_t row = end; row < n; ++row)
+        {
+            double *p_row = p_a + (row * lda);
+
+            for (size_t col = panel; col < end; ++col)
+            {
+                const double *p_l11 = p_a + (col * lda);
+                double        sum   = p_row[col];
+
+                for (size_t idx = panel; idx < col; ++idx)
+                {
+                    sum -= p_row[idx] * p_l11[idx];
+                }
+
+                p_row[col] = sum / p_l11[col];
+            }
+        }
+
+        // L21^T as a contiguous width x (n - end) operand
+        size_t rest = n - end;
+
+        for (size_t row = 0U; row < rest; ++row)
+        {
+            for (size_t col = 0U; col < width; ++col)
+            {
+                p_lt[(col * rest) + row]
+                    = p_a[((end + row) * lda) + panel + col];
+            }
+        }
+
+        // A22 -= L21 * L21^T, lower triangle only, one block row at a time
+        for (size_t blk = 0U; blk < rest; blk += MATRIX_CHOLESKY_BLOCK)
+        {
+            size_t rows = MIN(rest - blk, (size_t)MATRIX_CHOLESKY_BLOCK);
+            ret         = matrix_gemm(rows,
+                              blk + rows,
+                              width,
+                              -1.0,
+                              p_a + ((end + blk) * lda) + panel,
+                              lda,
+                              p_lt,
+                              rest,
+                              1.0,
+                              p_a + ((end + blk) * lda) + end,
+                              lda);
+
+            if (MATRIX_SUCCESS != ret)
+            {
+                goto EXIT;
+            }
+        }
+    }
+
+    // Clear the untouched upper triangle so the factor is exactly L
+    for (size_t row = 0U; row < n; ++row)
+    {
+        for (size_t col = row + 1U; col < n; ++col)
+        {
+            p_a[(row * lda) + col] = 0.0;
+        }
+    }
+
+EXIT:
+    free(p_lt);
+    return ret;
+}
+
+static matrix_error_code_t
+qr_factor (double *p_a,
+           size_t  m,
+           size_t  n,
+           size_t  lda,
+           double *p_tau,
+           double *p_t)
+{
+    size_t              panel_size = m * MATRIX_QR_BLOCK * sizeof(double);
+    matrix_error_code_t ret        = MATRIX_SUCCESS;
+    double             *p_v        = (double *)malloc(panel_size);
+    double             *p_vt       = (double *)malloc(panel_size);
+    double             *p_work
+        = (double *)malloc(MATRIX_QR_BLOCK * n * sizeof(double));
+
+    if ((NULL == p_v) || (NULL == p_vt) || (NULL == p_work))
+    {
+        ret = MATRIX_ALLOCATION_FAILURE;
+        goto EXIT;
+    }
+
+    for (size_t panel = 0U; panel < n; panel += MATRIX_QR_BLOCK)
+    {
+        size_t  width   = MIN(n - panel, (size_t)MATRIX_QR_BLOCK);
+        size_t  end     = panel + width;
+        double *p_t_blk = p_t
+                          + ((panel / MATRIX_QR_BLOCK) * MATRIX_QR_BLOCK
+                             * MATRIX_QR_BLOCK);
+
+        // Unblocked Householder factorization of the panel
+        for (size_t col = panel; col < end; ++col)
+        {
+            double alpha = p_a[(col * lda) + col];
+            double sigma = 0.0;
+
+            for (size_t row = col + 1U; row < m; ++row)
+            {
+                double val = p_a[(row * lda) + col];
+                sigma += val * val;
+            }
+
+            if (0.0 == sigma)
+            {
+                p_tau[col] = 0.0;
+                continue;
+            }
+
+            double beta  = -copysign(sqrt((alpha * alpha) + sigma), alpha);
+            double scale = 1.0 / (alpha - beta);
+            p_tau[col]   = (beta - alpha) / beta;
+            p_a[(col * lda) + col] = beta;
+
+            for (size_t row = col + 1U; row < m; ++row)
+            {
+                p_a[(row * lda) + col] *= scale;
+            }
+
+            // Apply H = I - tau * v * v^T to the rest of the panel
+            size_t width_rest = end - col - 1U;
+
+            if (0U == width_rest)
+            {
+                continue;
+            }
+
+            double *p_w = p_work;
+            memcpy(p_w,
+                   p_a + (col * lda) + col + 1U,
+                   width_rest * sizeof(double));
+
+            for (size_t row = col + 1U; row < m; ++row)
+            {
+                const double *p_row = p_a + (row * lda) + col + 1U;
+                double        v_val = p_a[(row * lda) + col];
+
+                for (size_t idx = 0U; idx < width_rest; ++idx)
+                {
+                    p_w[idx] += v_val * p_row[idx];
+                }
+            }
+
+            for (size_t idx = 0U; idx < width_rest; ++idx)
+            {
+                p_w[idx] *= p_tau[col];
+                p_a[(col * lda) + col + 1U + idx] -= p_w[idx];
+            }
+
+            for (size_t row = col + 1U; row < m; ++row)
+            {
+                double *p_row = p_a + (row * lda) + col + 1U;
+                double  v_val = p_a[(row * lda) + col];
+
+                for (size_t idx = 0U; idx < width_rest; ++idx)
+                {
+                    p_row[idx] -= v_val * p_w[idx];
+                }
+            }
+        }
+
+        // Form T so that H(panel) ... H(end - 1) = I - V * T * V^T
+        size_t rows = m - panel;
+        qr_expand_panel(
+            p_a + (panel * lda) + panel, lda, rows, width, p_v, p_vt);
+
+        for (size_t col = 0U; col < width; ++col)
+        {
+            double tau = p_tau[panel + col];
+            p_t_blk[(col * MATRIX_QR_BLOCK) + col] = tau;
+
+            // z = V(:, 0:col)^T * v_col
+            for (size_t idx = 0U; idx < col; ++idx)
+            {
+                const double *p_vi   = p_vt + (idx * rows);
+                const double *p_vcol = p_vt + (col * rows);
+                double        dot    = 0.0;
+
+                for (size_t row = col; row < rows; ++row)
+                {
+                    dot += p_vi[row] * p_vcol[row];
+                }
+
+                p_work[idx] = dot;
+            }
+
+            // T(0:col, col) = -tau * T(0:col, 0:col) * z
+            for (size_t idx = 0U; idx < col; ++idx)
+            {
+                double sum = 0.0;
+
+                for (size_t jdx = idx; jdx < col; ++jdx)
+                {
+                    sum += p_t_blk[(idx * MATRIX_QR_BLOCK) + jdx]
+                           * p_work[jdx];
+                }
+
+                p_t_blk[(idx * MATRIX_QR_BLOCK) + col] = -tau * sum;
+            }
+        }
+
+        // Trailing update with the block reflector
+        if (end < n)
+        {
+            ret = qr_apply_block(p_v,
+                                 p_vt,
+                                 p_t_blk,
+                                 rows,
+                                 width,
+                                 p_a + (panel * lda) + end,
+                                 n - end,
+                                 lda,
+                                 p_work);
+
+            if (MATRIX_SUCCESS != ret)
+            {
+                goto EXIT;
+            }
+        }
+    }
+
+EXIT:
+    free(p_v);
+    free(p_vt);
+    free(p_work);
+    return ret;
+}
+
+static matrix_error_code_t
+qr_apply_block (const double *p_v,
+                const double *p_vt,
+                const double *p_t,
+                size_t        rows,
+                size_t        width,
+                double       *p_b,
+                size_t        ncols,
+                size_t        ldb,
+                double       *p_work)
+{
+    // W = V^T * B
+    matrix_error_code_t ret = matrix_gemm(width,
+                                          ncols,
+                                          rows,
+                                          1.0,
+                                          p_vt,
+                                          rows,
+                                          p_b,
+                                          ldb,
+                                          0.0,
+                                          p_work,
+                                          ncols);
+
+    if (MATRIX_SUCCESS != ret)
+    {
+        return ret;
+    }
+
+    // W = T^T * W in place; row i only needs rows 0..i, so go bottom up
+    for (size_t row = width; row-- > 0U;)
+    {
+        double *p_row = p_work + (row * ncols);
+        double  diag  = p_t[(row * MATRIX_QR_BLOCK) + row];
+
+        for (size_t col = 0U; col < ncols; ++col)
+        {
+            p_row[col] *= diag;
+        }
+
+        for (size_t idx = 0U; idx < row; ++idx)
+        {
+            const double *p_src = p_work + (idx * ncols);
+            double        mult  = p_t[(idx * MATRIX_QR_BLOCK) + row];
+
+            for (size_t col = 0U; col < ncols; ++col)
+            {
+                p_row[col] += mult * p_src[col];
+            }
+        }
+    }
+
+    // B -= V * W
+    return matrix_gemm(
+        rows, ncols, width, -1.0, p_v, width, p_work, ncols, 1.0, p_b, ldb);
+}
+
+static void
+qr_expand_panel (const double *p_a,
+                 size_t        lda,
+                 size_t        rows,
+                 size_t        width,
+                 double       *p_v,
+                 double       *p_vt)
+{
+    for (size_t row = 0U; row < rows; ++row)
+    {
+        for (size_t col = 0U; col < width; ++col)
+        {
+            double val = 0.0;
+
+            if (row == col)
+            {
+                val = 1.0;
+            }
+            else if (row > col)
+            {
+                val = p_a[(row * lda) + col];
+            }
+
+            p_v[(row * width) + col] = val;
+            p_vt[(col * rows) + row] = val;
+        }
+    }
+}
+
+static matrix_error_code_t
+triangular_solve (const double *p_t,
+                  size_t        ldt,
+                  bool          b_trans,
+                  bool          b_lower,
+                  size_t        n,
+                  double       *p_x,
+                  size_t        nrhs,
+                  size_t        ldx)
+{
+    matrix_error_code_t ret  = MATRIX_SUCCESS;
+    size_t              done = 0U;
+
+    // op(T)(row, col) is p_t[row * row_step + col * col_step]
+    size_t row_step = b_trans ? 1U : ldt;
+    size_t col_step = b_trans ? ldt : 1U;
+
+    // Lower solves top down, upper solves bottom up; after each diagonal
+    // block the remaining rows are updated with one GEMM.
+    while (done < n)
+    {
+        size_t width = MIN(n - done, (size_t)MATRIX_LU_BLOCK);
+        size_t blk   = b_lower ? done : (n - done - width);
+        size_t end   = blk + width;
+
+        for (size_t step = 0U; step < width; ++step)
+        {
+            size_t  row   = b_lower ? (blk + step) : (end - 1U - step);
+            double *p_row = p_x + (row * ldx);
+            double  diag  = p_t[(row * ldt) + row];
+            size_t  first = b_lower ? blk : (row + 1U);
+            size_t  last  = b_lower ? row : end;
+
+            if (0.0 == diag)
+            {
+                return MATRIX_SINGULAR;
+            }
+
+            for (size_t idx = first; idx < last; ++idx)
+            {
+                const double *p_src = p_x + (idx * ldx);
+                double        mult  = p_t[(row * row_step) + (idx * col_step)];
+
+                for (size_t col = 0U; col < nrhs; ++col)
+                {
+                    p_row[col] -= mult * p_src[col];
+                }
+            }
+
+            for (size_t col = 0U; col < nrhs; ++col)
+            {
+                p_row[col] /= diag;
+            }
+        }
+
+        // Rows still to solve: below the block if lower, above it if upper
+        size_t first = b_lower ? end : 0U;
+        size_t count = b_lower ? (n - end) : blk;
+
+        if (0U < count)
+        {
+            ret = matrix_gemm_ex(MATRIX_LAYOUT_ROW_MAJOR,
+                                 b_trans ? MATRIX_OP_TRANSPOSE : MATRIX_OP_NONE,
+                                 MATRIX_OP_NONE,
+                                 count,
+                                 nrhs,
+                                 width,
+                                 -1.0,
+                                 p_t + (first * row_step) + (blk * col_step),
+                                 ldt,
+                                 p_x + (blk * ldx),
+                                 ldx,
+                                 1.0,
+                                 p_x + (first * ldx),
+                                 ldx);
+        }
+
+        if (MATRIX_SUCCESS != ret)
+        {
+            return ret;
+        }
+
+        done += width;
+    }
+
+    return ret;
+}
+
+static bool
+is_cholesky_candidate (const matrix_t *p_matrix)
+{
+    size_t n  = p_matrix->rows;
+    size_t ld = p_matrix->ld;
+
+    for (size_t row = 0U; row < n; ++row)
+    {
+        if (!(p_matrix->p_data[(row * ld) + row] > 0.0))
+        {
+            return false;
+        }
+
+        for (size_t col = row + 1U; col < n; ++col)
+        {
+            if (p_matrix->p_data[(row * ld) + col]
+                != p_matrix->p_data[(col * ld) + row])
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/*** end of file ***/
@@ -0,0 +1,832 @@
+/**
+ * @file matrix_typed.c
+ * @brief Implementation of single-precision and int8 quantized matrices.
+ *
+ * matrix_t stores `double`, which is the right default for numerics but
+ * wastes bandwidth and SIMD width on inference workloads: a 256-bit register
+ * holds 4 doubles, 8 floats, or (after widening to int16) 16 int8 pairs.
+ *
+ * Both element types share one implementation through two macro templates.
+ * TYPED_MATRIX_DEFINE generates the create/destroy/fill/get/set family for a
+ * storage type, and TYPED_GEMM_DEFINE generates the cache-blocked GEMM loop
+ * nest around a type specific packing routine and micro-kernel. The loop nest
+ * is the same one matrix_gemm uses for doubles; only the register blocking
+ * differs.
+ *
+ * The int8 GEMM packs A and B as int16 pairs along k, which is the operand
+ * layout of the AVX2 `vpmaddwd` instruction: one instruction multiplies
+ * sixteen pairs and adds each pair into an int32 lane. Accumulation is exact
+ * as long as the sum fits: each product is at most 2^14 in magnitude, so
+ * matrix_i8_gemm rejects k above MATRIX_I8_GEMM_MAX_K rather than wrap.
+ * Splitting k would not help, since the caller's C is int32 as well.
+ *
+ * @author heapbadger
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_internal.h"
+#include "matrix_typed.h"
+
+#if defined(__AVX__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Register blocks of the typed micro-kernels. The float kernel holds 4 rows
+ * of two 8-wide vectors; the int8 kernel holds 4 rows of one vector of eight
+ * int32 accumulators and consumes k two values at a time.
+ */
+#define F32_MR 4
+#define F32_NR 16
+#define I8_MR  4
+#define I8_NR  8
+#define I8_KU  2
+
+/**
+ * @brief Define create/destroy/fill/get/set for a typed matrix.
+ *
+ * @param PREFIX Function name prefix, e.g. matrix_f32.
+ * @param TYPE Matrix struct type.
+ * @param ELEM Element type.
+ * @param INIT Statement run on a freshly created `p_matrix`.
+ */
+#define TYPED_MATRIX_DEFINE(PREFIX, TYPE, ELEM, INIT)                        \
+    TYPE *PREFIX##_create(size_t rows, size_t cols)                         \
+    {                                                                       \
+        if ((0U == rows) || (0U == cols)                                    \
+            || (rows > (SIZE_MAX / sizeof(ELEM)) / cols))                   \
+        {                                                                   \
+            return NULL;                                                    \
+        }                                                                   \
+                                                                            \
+        TYPE *p_matrix = (TYPE *)calloc(1U, sizeof(TYPE));                  \
+                                                                            \
+        if (NULL == p_matrix)                                               \
+        {                                                                   \
+            return NULL;                                                    \
+        }                                                                   \
+                                                                            \
+        p_matrix->p_data = (ELEM *)calloc(rows * cols, sizeof(ELEM));       \
+                                                                            \
+        if (NULL == p_matrix->p_data)                                       \
+        {                                                                   \
+            free(p_matrix);                                                 \
+            return NULL;                                                    \
+        }                                                                   \
+                                                                            \
+        p_matrix->rows = rows;                                              \
+        p_matrix->cols = cols;                                              \
+        p_matrix->ld   = cols;                                              \
+        INIT;                                                               \
+        return p_matrix;                                                    \
+    }                                                                       \
+                                                                            \
+    void PREFIX##_destroy(TYPE *p_matrix)                                   \
+    {                                                                       \
+        if (NULL != p_matrix)                                               \
+        {                                                                   \
+            free(p_matrix->p_data);                                         \
+            free(p_matrix);                                                 \
+        }                                                                   \
+    }                                                                       \
+                                                                            \
+    matrix_error_code_t PREFIX##_fill(TYPE *p_matrix, ELEM value)           \
+    {                                                                       \
+        if ((NULL == p_matrix) || (NULL == p_matrix->p_data))               \
+        {                                                                   \
+            return MATRIX_INVALID_ARGUMENT;                                 \
+        }                                                                   \
+                                                                            \
+        for (size_t row = 0U; row < p_matrix->rows; ++row)                  \
+        {                                                                   \
+            ELEM *p_row = p_matrix->p_data + (row * p_matrix->ld);          \
+                                                                            \
+            for (size_t col = 0U; col < p_matrix->cols; ++col)              \
+            {                                                               \
+                p_row[col] = value;                                         \
+            }                                                               \
+        }                                                                   \
+                                                                            \
+        return MATRIX_SUCCESS;                                              \
+    }                                                                       \
+                                                                            \
+    matrix_error_code_t PREFIX##_get(                                       \
+        const TYPE *p_matrix, size_t row, size_t col, ELEM *p_out)          \
+    {                                                                       \
+        if ((NULL == p_matrix) || (NULL == p_out))                          \
+        {                                                                   \
+            return MATRIX_INVALID_ARGUMENT;                                 \
+        }                                                                   \
+                                                                            \
+        if ((row >= p_matrix->rows) || (col >= p_matrix->cols))             \
+        {                                                                   \
+            return MATRIX_OUT_OF_BOUNDS;                                    \
+        }                                                                   \
+                                                                            \
+        *p_out = p_matrix->p_data[(row * p_matrix->ld) + col];              \
+        return MATRIX_SUCCESS;                                              \
+    }                                                                       \
+                                                                            \
+    matrix_error_code_t PREFIX##_set(                                       \
+        TYPE *p_matrix, size_t row, size_t col, ELEM value)                 \
+    {                                                                       \
+        if (NULL == p_matrix)                                               \
+        {                                                                   \
+            return MATRIX_INVALID_ARGUMENT;                                 \
+        }                                                                   \
+                                                                            \
+        if ((row >= p_matrix->rows) || (col >= p_matrix->cols))             \
+        {                                                                   \
+            return MATRIX_OUT_OF_BOUNDS;                                    \
+        }                                                                   \
+                                                                            \
+        p_matrix->p_data[(row * p_matrix->ld) + col] = value;               \
+        return MATRIX_SUCCESS;                                              \
+    }
+
+/**
+ * @brief Define a cache-blocked GEMM driver, C += alpha * A * B.
+ *
+ * Packing routines must zero pad rows to MR, columns to NR and depth to KU
+ * so the micro-kernel never branches.
+ *
+ * @param NAME Name of the generated static function.
+ * @param ELEM Element type of A and B.
+ * @param PACK Element type of the packed panels.
+ * @param ACC Element type of C and alpha.
+ * @param MR Rows per micro-kernel call.
+ * @param NR Columns per micro-kernel call.
+ * @param KU Depth unroll the packed layout is padded to.
+ * @param PACK_A Routine packing an mc x kc block of A.
+ * @param PACK_B Routine packing a kc x nc block of B.
+ * @param KERNEL Micro-kernel.
+ */
+#define TYPED_GEMM_DEFINE(                                                  \
+    NAME, ELEM, PACK, ACC, MR, NR, KU, PACK_A, PACK_B, KERNEL)              \
+    static matrix_error_code_t NAME(size_t      m,                          \
+                                    size_t      n,                          \
+                                    size_t      k,                          \
+                                    ACC         alpha,                      \
+                                    const ELEM *p_a,                        \
+                                    size_t      lda,                        \
+                                    const ELEM *p_b,                        \
+                                    size_t      ldb,                        \
+                                    ACC        *p_c,                        \
+                                    size_t      ldc)                        \
+    {                                                                       \
+        size_t kc_max   = ROUND_UP(MIN(k, (size_t)MATRIX_GEMM_KC), KU);     \
+        size_t mc_pad   = ROUND_UP(MIN(m, (size_t)MATRIX_GEMM_MC), MR);     \
+        size_t nc_pad   = ROUND_UP(MIN(n, (size_t)MATRIX_GEMM_NC), NR);     \
+        PACK  *p_pack_a = (PACK *)malloc(mc_pad * kc_max * sizeof(PACK));   \
+        PACK  *p_pack_b = (PACK *)malloc(nc_pad * kc_max * sizeof(PACK));   \
+                                                                            \
+        if ((NULL == p_pack_a) || (NULL == p_pack_b))                       \
+        {                                                                   \
+            free(p_pack_a);                                                 \
+            free(p_pack_b);                                                 \
+            return MATRIX_ALLOCATION_FAILURE;                               \
+        }                                                                   \
+                                                                            \
+        for (size_t jc = 0U; jc < n; jc += MATRIX_GEMM_NC)                  \
+        {                                                                   \
+            size_t nc = MIN(n - jc, (size_t)MATRIX_GEMM_NC);                \
+                                                                            \
+            for (size_t pc = 0U; pc < k; pc += MATRIX_GEMM_KC)              \
+            {                                                               \
+                size_t kc     = MIN(k - pc, (size_t)MATRIX_GEMM_KC);        \
+                size_t kc_pad = ROUND_UP(kc, KU);                           \
+                PACK_B(kc, nc, p_b + (pc * ldb) + jc, ldb, p_pack_b);       \
+                                                                            \
+                for (size_t ic = 0U; ic < m; ic += MATRIX_GEMM_MC)          \
+                {                                                           \
+                    size_t mc = MIN(m - ic, (size_t)MATRIX_GEMM_MC);        \
+                    PACK_A(mc, kc, p_a + (ic * lda) + pc, lda, p_pack_a);   \
+                                                                            \
+                    for (size_t jr = 0U; jr < nc; jr += NR)                 \
+                    {                                                       \
+                        for (size_t ir = 0U; ir < mc; ir += MR)             \
+                        {                                                   \
+                            KERNEL(kc_pad,                                  \
+                                   alpha,                                   \
+                                   p_pack_a + (ir * kc_pad),                \
+                                   p_pack_b + (jr * kc_pad),                \
+                                   p_c + ((ic + ir) * ldc) + jc + jr,       \
+                                   ldc,                                     \
+                                   MIN(mc - ir, (size_t)MR),                \
+                                   MIN(nc - jr, (size_t)NR));               \
+                        }                                                   \
+                    }                                                       \
+                }                                                           \
+            }                                                               \
+        }                                                                   \
+                                                                            \
+        free(p_pack_a);                                                     \
+        free(p_pack_b);                                                     \
+        return MATRIX_SUCCESS;                                              \
+    }
+
+/**
+ * @brief Pack an mc x kc block of float A into F32_MR-row slivers.
+ */
+static void f32_pack_a(size_t       mc,
+                       size_t       kc,
+                       const float *p_a,
+                       size_t       lda,
+                       float       *p_pack);
+
+/**
+ * @brief Pack a kc x nc block of float B into F32_NR-column slivers.
+ */
+static void f32_pack_b(size_t       kc,
+                       size_t       nc,
+                       const float *p_b,
+                       size_t       ldb,
+                       float       *p_pack);
+
+/**
+ * @brief Accumulate alpha times one packed float sliver product into C.
+ *
+ * @param kc Depth of the slivers.
+ * @param alpha Scale applied to the product.
+ * @param p_a Packed F32_MR x kc sliver of A.
+ * @param p_b Packed kc x F32_NR sliver of B.
+ * @param p_c Pointer to the top-left element of the C block.
+ * @param ldc Leading dimension of C.
+ * @param mr Number of valid rows.
+ * @param nr Number of valid columns.
+ */
+static void f32_micro_kernel(size_t       kc,
+                             float        alpha,
+                             const float *p_a,
+                             const float *p_b,
+                             float       *p_c,
+                             size_t       ldc,
+                             size_t       mr,
+                             size_t       nr);
+
+/**
+ * @brief Pack an mc x kc block of int8 A into I8_MR-row slivers of
+ * widened (k, k + 1) pairs.
+ */
+static void i8_pack_a(size_t        mc,
+                      size_t        kc,
+                      const int8_t *p_a,
+                      size_t        lda,
+                      int16_t      *p_pack);
+
+/**
+ * @brief Pack a kc x nc block of int8 B into I8_NR-column slivers of
+ * widened (k, k + 1) pairs.
+ */
+static void i8_pack_b(size_t        kc,
+                      size_t        nc,
+                      const int8_t *p_b,
+                      size_t        ldb,
+                      int16_t      *p_pack);
+
+/**
+ * @brief Accumulate alpha times one packed int8 sliver product into C.
+ *
+ * @param kc Depth of the slivers, a multiple of I8_KU.
+ * @param alpha Scale applied to the product.
+ * @param p_a Packed sliver of A.
+ * @param p_b Packed sliver of B.
+ * @param p_c Pointer to the top-left element of the int32 C block.
+ * @param ldc Leading dimension of C.
+ * @param mr Number of valid rows.
+ * @param nr Number of valid columns.
+ */
+static void i8_micro_kernel(size_t         kc,
+                            int32_t        alpha,
+                            const int16_t *p_a,
+                            const int16_t *p_b,
+                            int32_t       *p_c,
+                            size_t         ldc,
+                            size_t         mr,
+                            size_t         nr);
+
+TYPED_MATRIX_DEFINE(matrix_f32, matrix_f32_t, float, (void)p_matrix)
+TYPED_MATRIX_DEFINE(matrix_i8, matrix_i8_t, int8_t, p_matrix->scale = 1.0f)
+
+TYPED_GEMM_DEFINE(f32_gemm_blocked,
+                  float,
+                  float,
+                  float,
+                  F32_MR,
+                  F32_NR,
+                  1U,
+                  f32_pack_a,
+                  f32_pack_b,
+                  f32_micro_kernel)
+
+TYPED_GEMM_DEFINE(i8_gemm_blocked,
+                  int8_t,
+                  int16_t,
+                  int32_t,
+                  I8_MR,
+                  I8_NR,
+                  I8_KU,
+                  i8_pack_a,
+                  i8_pack_b,
+                  i8_micro_kernel)
+
+matrix_error_code_t
+matrix_f32_from_matrix (const matrix_t *p_src, matrix_f32_t *p_dst)
+{
+    if ((NULL == p_src) || (NULL == p_dst) || (p_src->rows != p_dst->rows)
+        || (p_src->cols != p_dst->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    for (size_t row = 0U; row < p_src->rows; ++row)
+    {
+        const double *p_in  = p_src->p_data + (row * p_src->ld);
+        float        *p_out = p_dst->p_data + (row * p_dst->ld);
+
+        for (size_t col = 0U; col < p_src->cols; ++col)
+        {
+            p_out[col] = (float)p_in[col];
+        }
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_f32_to_matrix (const matrix_f32_t *p_src, matrix_t *p_dst)
+{
+    if ((NULL == p_src) || (NULL == p_dst) || (p_src->rows != p_dst->rows)
+        || (p_src->cols != p_dst->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    for (size_t row = 0U; row < p_src->rows; ++row)
+    {
+        const float *p_in  = p_src->p_data + (row * p_src->ld);
+        double      *p_out = p_dst->p_data + (row * p_dst->ld);
+
+        for (size_t col = 0U; col < p_src->cols; ++col)
+        {
+            p_out[col] = (double)p_in[col];
+        }
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_i8_quantize (const matrix_f32_t *p_src, matrix_i8_t *p_dst)
+{
+    if ((NULL == p_src) || (NULL == p_dst) || (p_src->rows != p_dst->rows)
+        || (p_src->cols != p_dst->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    float max_abs = 0.0f;
+
+    for (size_t row = 0U; row < p_src->rows; ++row)
+    {
+        const float *p_in = p_src->p_data + (row * p_src->ld);
+
+        for (size_t col = 0U; col < p_src->cols; ++col)
+        {
+            max_abs = fmaxf(max_abs, fabsf(p_in[col]));
+        }
+    }
+
+    // An all-zero matrix quantizes to zeros with any scale
+    float scale    = (0.0f < max_abs) ? (max_abs / MATRIX_I8_MAX) : 1.0f;
+    float inv      = 1.0f / scale;
+    p_dst->scale   = scale;
+
+    for (size_t row = 0U; row < p_src->rows; ++row)
+    {
+        const float *p_in  = p_src->p_data + (row * p_src->ld);
+        int8_t      *p_out = p_dst->p_data + (row * p_dst->ld);
+
+        for (size_t col = 0U; col < p_src->cols; ++col)
+        {
+            float quant = roundf(p_in[col] * inv);
+            quant       = fminf(fmaxf(quant, -MATRIX_I8_MAX), MATRIX_I8_MAX);
+            p_out[col]  = (int8_t)quant;
+        }
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_i8_dequantize (const matrix_i8_t *p_src, matrix_f32_t *p_dst)
+{
+    if ((NULL == p_src) || (NULL == p_dst) || (p_src->rows != p_dst->rows)
+        || (p_src->cols != p_dst->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    for (size_t row = 0U; row < p_src->rows; ++row)
+    {
+        const int8_t *p_in  = p_src->p_data + (row * p_src->ld);
+        float        *p_out = p_dst->p_data + (row * p_dst->ld);
+
+        for (size_t col = 0U; col < p_src->cols; ++col)
+        {
+            p_out[col] = p_src->scale * (float)p_in[col];
+        }
+    }
+
+    return MATRIX_SUCCESS;
+}
+
+matrix_error_code_t
+matrix_f32_gemm (size_t       m,
+                 size_t       n,
+                 size_t       k,
+                 float        alpha,
+                 const float *p_a,
+                 size_t       lda,
+                 const float *p_b,
+                 size_t       ldb,
+                 float        beta,
+                 float       *p_c,
+                 size_t       ldc)
+{
+    if ((NULL == p_c) || (ldc < n) || (k > MATRIX_I8_GEMM_MAX_K)
+        || ((0U < k)
+            && ((NULL == p_a) || (NULL == p_b) || (lda < k) || (ldb < n))))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if (1.0f != beta)
+    {
+        for (size_t row = 0U; row < m; ++row)
+        {
+            float *p_row = p_c + (row * ldc);
+
+            for (size_t col = 0U; col < n; ++col)
+            {
+                p_row[col] = (0.0f == beta) ? 0.0f : beta * p_row[col];
+            }
+        }
+    }
+
+    if ((0U == m) || (0U == n) || (0U == k) || (0.0f == alpha))
+    {
+        return MATRIX_SUCCESS;
+    }
+
+    return f32_gemm_blocked(m, n, k, alpha, p_a, lda, p_b, ldb, p_c, ldc);
+}
+
+matrix_error_code_t
+matrix_f32_multiply (const matrix_f32_t *p_a,
+                     const matrix_f32_t *p_b,
+                     matrix_f32_t       *p_c)
+{
+    if ((NULL == p_a) || (NULL == p_b) || (NULL == p_c) || (p_c == p_a)
+        || (p_c == p_b) || (p_a->cols != p_b->rows) || (p_c->rows != p_a->rows)
+        || (p_c->cols != p_b->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    return matrix_f32_gemm(p_a->rows,
+                           p_b->cols,
+                           p_a->cols,
+                           1.0f,
+                           p_a->p_data,
+                           p_a->ld,
+                           p_b->p_data,
+                           p_b->ld,
+                           0.0f,
+                           p_c->p_data,
+                           p_c->ld);
+}
+
+matrix_error_code_t
+matrix_i8_gemm (size_t        m,
+                size_t        n,
+                size_t        k,
+                const int8_t *p_a,
+                size_t        lda,
+                const int8_t *p_b,
+                size_t        ldb,
+                int32_t      *p_c,
+                size_t        ldc)
+{
+    if ((NULL == p_c) || (ldc < n) || (k > MATRIX_I8_GEMM_MAX_K)
+        || ((0U < k)
+            && ((NULL == p_a) || (NULL == p_b) || (lda < k) || (ldb < n))))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    if ((0U == m) || (0U == n) || (0U == k))
+    {
+        return MATRIX_SUCCESS;
+    }
+
+    return i8_gemm_blocked(m, n, k, 1, p_a, lda, p_b, ldb, p_c, ldc);
+}
+
+matrix_error_code_t
+matrix_i8_multiply (const matrix_i8_t *p_a,
+                    const matrix_i8_t *p_b,
+                    matrix_f32_t      *p_c)
+{
+    if ((NULL == p_a) || (NULL == p_b) || (NULL == p_c)
+        || (p_a->cols != p_b->rows) || (p_c->rows != p_a->rows)
+        || (p_c->cols != p_b->cols))
+    {
+        return MATRIX_INVALID_ARGUMENT;
+    }
+
+    size_t   rows  = p_c->rows;
+    size_t   cols  = p_c->cols;
+    int32_t *p_acc = (int32_t *)calloc(rows * cols, sizeof(int32_t));
+
+    if (NULL == p_acc)
+    {
+        return MATRIX_ALLOCATION_FAILURE;
+    }
+
+    matrix_error_code_t ret = matrix_i8_gemm(rows,
+                                             cols,
+                                             p_a->cols,
+                                             p_a->p_data,
+                                             p_a->ld,
+                                             p_b->p_data,
+                                             p_b->ld,
+                                             p_acc,
+                                             cols);
+
+    if (MATRIX_SUCCESS == ret)
+    {
+        float scale = p_a->scale * p_b->scale;
+
+        for (size_t row = 0U; row < rows; ++row)
+        {
+            float *p_out = p_c->p_data + (row * p_c->ld);
+
+            for (size_t col = 0U; col < cols; ++col)
+            {
+                p_out[col] = scale * (float)p_acc[(row * cols) + col];
+            }
+        }
+    }
+
+    free(p_acc);
+    return ret;
+}
+
+static void
+f32_pack_a (size_t mc, size_t kc, const float *p_a, size_t lda, float *p_pack)
+{
+    for (size_t row = 0U; row < mc; row += F32_MR)
+    {
+        size_t mr = MIN(mc - row, (size_t)F32_MR);
+
+        for (size_t depth = 0U; depth < kc; ++depth)
+        {
+            for (size_t idx = 0U; idx < F32_MR; ++idx)
+            {
+                *p_pack++
+                    = (idx < mr) ? p_a[((row + idx) * lda) + depth] : 0.0f;
+            }
+        }
+    }
+}
+
+static void
+f32_pack_b (size_t kc, size_t nc, const float *p_b, size_t ldb, float *p_pack)
+{
+    for (size_t col = 0U; col < nc; col += F32_NR)
+    {
+        size_t nr = MIN(nc - col, (size_t)F32_NR);
+
+        for (size_t depth = 0U; depth < kc; ++depth)
+        {
+            const float *p_row = p_b + (depth * ldb) + col;
+
+            for (size_t idx = 0U; idx < F32_NR; ++idx)
+            {
+                *p_pack++ = (idx < nr) ? p_row[idx] : 0.0f;
+            }
+        }
+    }
+}
+
+static void
+f32_micro_kernel (size_t       kc,
+                  float        alpha,
+                  const float *p_a,
+                  const float *p_b,
+                  float       *p_c,
+                  size_t       ldc,
+                  size_t       mr,
+                  size_t       nr)
+{
+    float acc[F32_MR][F32_NR];
+
+#if defined(__AVX__)
+    __m256 acc_lo[F32_MR];
+    __m256 acc_hi[F32_MR];
+
+    for (size_t row = 0U; row < F32_MR; ++row)
+    {
+        acc_lo[row] = _mm256_setzero_ps();
+        acc_hi[row] = _mm256_setzero_ps();
+    }
+
+    for (size_t depth = 0U; depth < kc; ++depth)
+    {
+        __m256 b_lo = _mm256_loadu_ps(p_b);
+        __m256 b_hi = _mm256_loadu_ps(p_b + 8);
+
+        for (size_t row = 0U; row < F32_MR; ++row)
+        {
+            __m256 a_val = _mm256_broadcast_ss(p_a + row);
+#if defined(__FMA__)
+            acc_lo[row] = _mm256_fmadd_ps(a_val, b_lo, acc_lo[row]);
+            acc_hi[row] = _mm256_fmadd_ps(a_val, b_hi, acc_hi[row]);
+#else
+            acc_lo[row]
+                = _mm256_add_ps(acc_lo[row], _mm256_mul_ps(a_val, b_lo));
+            acc_hi[row]
+                = _mm256_add_ps(acc_hi[row], _mm256_mul_ps(a_val, b_hi));
+#endif
+        }
+
+        p_a += F32_MR;
+        p_b += F32_NR;
+    }
+
+    for (size_t row = 0U; row < F32_MR; ++row)
+    {
+        _mm256_storeu_ps(&acc[row][0], acc_lo[row]);
+        _mm256_storeu_ps(&acc[row][8], acc_hi[row]);
+    }
+#else
+    memset(acc, 0, sizeof(acc));
+
+    for (size_t depth = 0U; depth < kc; ++depth)
+    {
+        for (size_t row = 0U; row < F32_MR; ++row)
+        {
+            float a_val = p_a[row];
+
+            for (size_t col = 0U; col < F32_NR; ++col)
+            {
+                acc[row][col] += a_val * p_b[col];
+            }
+        }
+
+        p_a += F32_MR;
+        p_b += F32_NR;
+    }
+#endif
+
+    for (size_t row = 0U; row < mr; ++row)
+    {
+        float *p_row = p_c + (row * ldc);
+
+        for (size_t col = 0U; col < nr; ++col)
+        {
+            p_row[col] += alpha * acc[row][col];
+        }
+    }
+}
+
+static void
+i8_pack_a (size_t        mc,
+           size_t        kc,
+           const int8_t *p_a,
+           size_t        lda,
+           int16_t      *p_pack)
+{
+    // Per depth pair: row 0 (k, k + 1), row 1 (k, k + 1), ...
+    for (size_t row = 0U; row < mc; row += I8_MR)
+    {
+        size_t mr = MIN(mc - row, (size_t)I8_MR);
+
+        for (size_t depth = 0U; depth < kc; depth += I8_KU)
+        {
+            for (size_t idx = 0U; idx < I8_MR; ++idx)
+            {
+                const int8_t *p_src = p_a + ((row + idx) * lda) + depth;
+                bool          b_row = (idx < mr);
+                *p_pack++           = b_row ? p_src[0] : 0;
+                *p_pack++ = (b_row && (depth + 1U < kc)) ? p_src[1] : 0;
+            }
+        }
+    }
+}
+
+static void
+i8_pack_b (size_t        kc,
+           size_t        nc,
+           const int8_t *p_b,
+           size_t        ldb,
+           int16_t      *p_pack)
+{
+    // Per depth pair: col 0 (k, k + 1), col 1 (k, k + 1), ...
+    for (size_t col = 0U; col < nc; col += I8_NR)
+    {
+        size_t nr = MIN(nc - col, (size_t)I8_NR);
+
+        for (size_t depth = 0U; depth < kc; depth += I8_KU)
+        {
+            const int8_t *p_row  = p_b + (depth * ldb) + col;
+            bool          b_next = (depth + 1U < kc);
+
+            for (size_t idx = 0U; idx < I8_NR; ++idx)
+            {
+                bool b_col = (idx < nr);
+                *p_pack++  = b_col ? p_row[idx] : 0;
+                *p_pack++  = (b_col && b_next) ? p_row[ldb + idx] : 0;
+            }
+        }
+    }
+}
+
+static void
+i8_micro_kernel (size_t         kc,
+                 int32_t        alpha,
+                 const int16_t *p_a,
+                 const int16_t *p_b,
+                 int32_t       *p_c,
+                 size_t        ldc,
+                 size_t        mr,
+                 size_t        nr)
+{
+    int32_t acc[I8_MR][I8_NR];
+
+#if defined(__AVX2__)
+    __m256i acc_vec[I8_MR];
+
+    for (size_t row = 0U; row < I8_MR; ++row)
+    {
+        acc_vec[row] = _mm256_setzero_si256();
+    }
+
+    for (size_t depth = 0U; depth < kc; depth += I8_KU)
+    {
+        __m256i b_pairs = _mm256_loadu_si256((const __m256i *)p_b);
+
+        for (size_t row = 0U; row < I8_MR; ++row)
+        {
+            int32_t a_pair = 0;
+            memcpy(&a_pair, p_a + (row * I8_KU), sizeof(a_pair));
+            __m256i prod
+                = _mm256_madd_epi16(_mm256_set1_epi32(a_pair), b_pairs);
+            acc_vec[row] = _mm256_add_epi32(acc_vec[row], prod);
+        }
+
+        p_a += I8_MR * I8_KU;
+        p_b += I8_NR * I8_KU;
+    }
+
+    for (size_t row = 0U; row < I8_MR; ++row)
+    {
+        _mm256_storeu_si256((__m256i *)&acc[row][0], acc_vec[row]);
+    }
+#else
+    memset(acc, 0, sizeof(acc));
+
+    for (size_t depth = 0U; depth < kc; depth += I8_KU)
+    {
+        for (size_t row = 0U; row < I8_MR; ++row)
+        {
+            int32_t a_lo = p_a[row * I8_KU];
+            int32_t a_hi = p_a[(row * I8_KU) + 1U];
+
+            for (size_t col = 0U; col < I8_NR; ++col)
+            {
+                acc[row][col] += (a_lo * p_b[col * I8_KU])
+                                 + (a_hi * p_b[(col * I8_KU) + 1U]);
+            }
+        }
+
+        p_a += I8_MR * I8_KU;
+        p_b += I8_NR * I8_KU;
+    }
+#endif
+
+    for (size_t row = 0U; row < mr; ++row)
+    {
+        int32_t *p_row = p_c + (row * ldc);
+
+        for (size_t col = 0U; col < nr; ++col)
+        {
+            p_row[col] += alpha * acc[row][col];
+        }
+    }
+}
+
+/*** end of file ***/
@@ -0,0 +1,237 @@
+/**
+ * @file parallel.c
+ * @brief Minimal fork-join helper for data-parallel kernels.
+ *
+ * Kernels describe their work as a count of independent items and a
+ * function that processes a contiguous range of them. parallel_for splits
+ * the range into one chunk per thread, runs the chunks on POSIX threads and
+ * joins before returning, so callers see ordinary synchronous semantics.
+ *
+ * Threads are created per call. That costs tens of microseconds, so callers
+ * should only go parallel when each chunk carries substantially more work
+ * than that, which min_chunk expresses.
+ *
+ * @author heapbadger
+ */
+
+// CPU affinity is a GNU extension of pthreads
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "parallel.h"
+
+typedef struct
+{
+    parallel_func func;
+    void         *p_ctx;
+    size_t        begin;
+    size_t        end;
+} parallel_chunk_t;
+
+/**
+ * @brief Thread entry point that processes one chunk.
+ *
+ * @param p_arg Pointer to the parallel_chunk_t to process.
+ *
+ * @return Always NULL.
+ */
+static void *parallel_worker(void *p_arg);
+
+/**
+ * @brief Create a thread for one chunk, pinned to a CPU when pinning is on.
+ *
+ * @param p_tid Output thread id.
+ * @param p_chunk Chunk the thread will process.
+ * @param index Chunk index, which selects the CPU.
+ *
+ * @return True if the thread was started.
+ */
+static bool parallel_start(pthread_t        *p_tid,
+                           parallel_chunk_t *p_chunk,
+                           size_t            index);
+
+static size_t    g_thread_override = 0U;
+static bool      g_pin_threads     = false;
+static size_t    g_cpu_count       = 0U;
+static int       g_cpus[PARALLEL_MAX_THREADS];
+static cpu_set_t g_caller_mask;
+
+size_t
+parallel_get_threads (void)
+{
+    size_t count = g_thread_override;
+
+    if (0U == count)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        count       = (online > 0) ? (size_t)online : 1U;
+    }
+
+    return (count > PARALLEL_MAX_THREADS) ? PARALLEL_MAX_THREADS : count;
+}
+
+void
+parallel_set_threads (size_t count)
+{
+    g_thread_override = count;
+}
+
+int
+parallel_set_affinity (bool b_pin)
+{
+    pthread_t self = pthread_self();
+
+    if (b_pin == g_pin_threads)
+    {
+        return 0;
+    }
+
+    if (!b_pin)
+    {
+        g_pin_threads = false;
+        return (0
+                == pthread_setaffinity_np(
+                    self, sizeof(g_caller_mask), &g_caller_mask))
+                   ? 0
+                   : -1;
+    }
+
+    cpu_set_t mask;
+    cpu_set_t first;
+    CPU_ZERO(&mask);
+    CPU_ZERO(&first);
+
+    if (0 != pthread_getaffinity_np(self, sizeof(mask), &mask))
+    {
+        return -1;
+    }
+
+    g_cpu_count = 0U;
+
+    for (int cpu = 0;
+         (cpu < CPU_SETSIZE) && (g_cpu_count < PARALLEL_MAX_THREADS);
+         ++cpu)
+    {
+        if (CPU_ISSET(cpu, &mask))
+        {
+            g_cpus[g_cpu_count++] = cpu;
+        }
+    }
+
+    if (0U == g_cpu_count)
+    {
+        return -1;
+    }
+
+    CPU_SET(g_cpus[0], &first);
+
+    if (0 != pthread_setaffinity_np(self, sizeof(first), &first))
+    {
+        return -1;
+    }
+
+    g_caller_mask = mask;
+    g_pin_threads = true;
+    return 0;
+}
+
+void
+parallel_for (size_t        count,
+              size_t        min_chunk,
+              parallel_func func,
+              void         *p_ctx)
+{
+    if ((NULL == func) || (0U == count))
+    {
+        return;
+    }
+
+    min_chunk      = (0U == min_chunk) ? 1U : min_chunk;
+    size_t threads = parallel_get_threads();
+    size_t chunks  = count / min_chunk;
+    chunks         = (chunks < threads) ? chunks : threads;
+
+    if (chunks <= 1U)
+    {
+        func(0U, count, p_ctx);
+        return;
+    }
+
+    pthread_t        tids[PARALLEL_MAX_THREADS];
+    bool             started[PARALLEL_MAX_THREADS];
+    parallel_chunk_t work[PARALLEL_MAX_THREADS];
+    size_t           base  = count / chunks;
+    size_t           extra = count % chunks;
+    size_t           begin = 0U;
+
+    for (size_t idx = 0U; idx < chunks; ++idx)
+    {
+        size_t len      = base + ((idx < extra) ? 1U : 0U);
+        work[idx].func  = func;
+        work[idx].p_ctx = p_ctx;
+        work[idx].begin = begin;
+        work[idx].end   = begin + len;
+        begin += len;
+        started[idx] = false;
+    }
+
+    // Chunk 0 runs on the calling thread
+    for (size_t idx = 1U; idx < chunks; ++idx)
+    {
+        started[idx] = parallel_start(&tids[idx], &work[idx], idx);
+    }
+
+    for (size_t idx = 0U; idx < chunks; ++idx)
+    {
+        if (false == started[idx])
+        {
+            (void)parallel_worker(&work[idx]);
+        }
+    }
+
+    for (size_t idx = 1U; idx < chunks; ++idx)
+    {
+        if (started[idx])
+        {
+            pthread_join(tids[idx], NULL);
+        }
+    }
+}
+
+static bool
+parallel_start (pthread_t *p_tid, parallel_chunk_t *p_chunk, size_t index)
+{
+    if (!g_pin_threads)
+    {
+        return 0 == pthread_create(p_tid, NULL, parallel_worker, p_chunk);
+    }
+
+    pthread_attr_t attr;
+    cpu_set_t      cpu;
+    CPU_ZERO(&cpu);
+    CPU_SET(g_cpus[index % g_cpu_count], &cpu);
+
+    if (0 != pthread_attr_init(&attr))
+    {
+        return false;
+    }
+
+    bool b_started
+        = (0 == pthread_attr_setaffinity_np(&attr, sizeof(cpu), &cpu))
+          && (0 == pthread_create(p_tid, &attr, parallel_worker, p_chunk));
+    pthread_attr_destroy(&attr);
+    return b_started;
+}
+
+static void *
+parallel_worker (void *p_arg)
+{
+    parallel_chunk_t *p_chunk = (parallel_chunk_t *)p_arg;
+    p_chunk->func(p_chunk->begin, p_chunk->end, p_chunk->p_ctx);
+    return NULL;
+}
+
+/*** end of file ***/
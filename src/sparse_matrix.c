@@ -0,0 +1,668 @@
+/**
+ * @file sparse_matrix.c
+ * @brief Implementation of compressed sparse row/column matrices.
+ *
+ * Only the non-zero entries are stored: one value and one minor index per
+ * entry plus one offset per major slice (row for CSR, column for CSC), so
+ * memory is O(nnz + major) rather than O(rows * cols). Products walk the
+ * stored entries only and therefore also scale with nnz.
+ *
+ * CSR is the natural format for A * x because every output element is an
+ * independent dot product over one row, which makes row partitioning across
+ * threads race free. CSC is the CSR layout of the transpose and is provided
+ * for column-oriented consumers; converting between the two is a single
+ * O(nnz) counting sort.
+ *
+ * @author heapbadger
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_internal.h"
+#include "parallel.h"
+#include "sparse_matrix.h"
+
+typedef struct
+{
+    const sparse_matrix_t *p_sparse;
+    const double          *p_x;
+    double                *p_y;
+    const matrix_t        *p_b;
+    matrix_t              *p_c;
+    size_t                 parts;
+} sparse_product_ctx_t;
+
+/**
+ * @brief Allocate an empty sparse matrix with room for nnz entries.
+ *
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param nnz Number of entries to reserve.
+ * @param format Storage format.
+ *
+ * @return Pointer to the new matrix with a zeroed p_ptr, or NULL on failure.
+ */
+static sparse_matrix_t *sparse_alloc(size_t          rows,
+                                     size_t          cols,
+                                     size_t          nnz,
+                                     sparse_format_t format);
+
+/**
+ * @brief Number of major slices (rows for CSR, columns for CSC).
+ *
+ * @param p_sparse Pointer to the sparse matrix.
+ *
+ * @return Major dimension.
+ */
+static size_t sparse_major(const sparse_matrix_t *p_sparse);
+
+/**
+ * @brief Transpose compressed arrays with a counting sort.
+ *
+ * Reinterprets the compressed major/minor arrays of p_src as coordinate
+ * lists and regroups them by minor index. Minor indices of the output come
+ * out sorted because entries are visited in major order.
+ *
+ * @param p_src Pointer to the source matrix.
+ * @param p_dst Pointer to a matrix allocated with p_src->nnz entries whose
+ *              major dimension is the minor dimension of p_src.
+ */
+static void sparse_compress_transpose(const sparse_matrix_t *p_src,
+                                      sparse_matrix_t       *p_dst);
+
+/**
+ * @brief First CSR row whose entries start at or after the given share of
+ * the non-zeros.
+ *
+ * @param p_sparse Pointer to the CSR matrix.
+ * @param part Partition index.
+ * @param parts Number of partitions.
+ *
+ * @return Row index in [0, rows].
+ */
+static size_t sparse_partition_row(const sparse_matrix_t *p_sparse,
+                                   size_t                 part,
+                                   size_t                 parts);
+
+/**
+ * @brief parallel_func computing y = A * x over a range of partitions.
+ */
+static void sparse_spmv_range(size_t begin, size_t end, void *p_ctx);
+
+/**
+ * @brief parallel_func computing C = A * B over a range of partitions.
+ */
+static void sparse_spmm_range(size_t begin, size_t end, void *p_ctx);
+
+/**
+ * @brief Number of nnz-balanced partitions worth running for a product.
+ *
+ * @param p_sparse Pointer to the sparse matrix.
+ * @param work_per_nnz Floating point work per stored entry.
+ *
+ * @return Partition count (>= 1).
+ */
+static size_t sparse_partition_count(const sparse_matrix_t *p_sparse,
+                                     size_t                 work_per_nnz);
+
+sparse_matrix_t *
+sparse_from_dense (const matrix_t *p_dense, sparse_format_t format)
+{
+    if ((NULL == p_dense) || (NULL == p_dense->p_data))
+    {
+        return NULL;
+    }
+
+    size_t rows = p_dense->rows;
+    size_t cols = p_dense->cols;
+    size_t ld   = p_dense->ld;
+    size_t nnz  = 0U;
+
+    for (size_t row = 0U; row < rows; ++row)
+    {
+        for (size_t col = 0U; col < cols; ++col)
+        {
+            nnz += (0.0 != p_dense->p_data[(row * ld) + col]) ? 1U : 0U;
+        }
+    }
+
+    sparse_matrix_t *p_sparse = sparse_alloc(rows, cols, nnz, format);
+
+    if (NULL == p_sparse)
+    {
+        return NULL;
+    }
+
+    size_t major = sparse_major(p_sparse);
+    size_t minor = (SPARSE_CSR == format) ? cols : rows;
+    size_t pos   = 0U;
+
+    for (size_t outer = 0U; outer < major; ++outer)
+    {
+        for (size_t inner = 0U; inner < minor; ++inner)
+        {
+            size_t flat = (SPARSE_CSR == format) ? ((outer * ld) + inner)
+                                                 : ((inner * ld) + outer);
+            double val  = p_dense->p_data[flat];
+
+            if (0.0 != val)
+            {
+                p_sparse->p_idx[pos]    = inner;
+                p_sparse->p_values[pos] = val;
+                pos++;
+            }
+        }
+
+        p_sparse->p_ptr[outer + 1U] = pos;
+    }
+
+    return p_sparse;
+}
+
+sparse_matrix_t *
+sparse_from_triplets (size_t          rows,
+                      size_t          cols,
+                      size_t          count,
+                      const size_t   *p_row_idx,
+                      const size_t   *p_col_idx,
+                      const double   *p_values,
+                      sparse_format_t format)
+{
+    if ((0U == rows) || (0U == cols)
+        || ((0U < count)
+            && ((NULL == p_row_idx) || (NULL == p_col_idx)
+                || (NULL == p_values))))
+    {
+        return NULL;
+    }
+
+    for (size_t idx = 0U; idx < count; ++idx)
+    {
+        if ((p_row_idx[idx] >= rows) || (p_col_idx[idx] >= cols))
+        {
+            return NULL;
+        }
+    }
+
+    // Bucket by the minor index first, then transpose: the second counting
+    // sort leaves minor indices sorted within every major slice.
+    bool             b_csr   = (SPARSE_CSR == format);
+    sparse_format_t  other   = b_csr ? SPARSE_CSC : SPARSE_CSR;
+    sparse_matrix_t *p_stage = sparse_alloc(rows, cols, count, other);
+    sparse_matrix_t *p_out   = sparse_alloc(rows, cols, count, format);
+
+    if ((NULL == p_stage) || (NULL == p_out))
+    {
+        sparse_destroy(p_stage);
+        sparse_destroy(p_out);
+        return NULL;
+    }
+
+    const size_t *p_stage_major = b_csr ? p_col_idx : p_row_idx;
+    const size_t *p_stage_minor = b_csr ? p_row_idx : p_col_idx;
+    size_t        stage_slices  = sparse_major(p_stage);
+
+    for (size_t idx = 0U; idx < count; ++idx)
+    {
+        p_stage->p_ptr[p_stage_major[idx] + 1U]++;
+    }
+
+    for (size_t idx = 0U; idx < stage_slices; ++idx)
+    {
+        p_stage->p_ptr[idx + 1U] += p_stage->p_ptr[idx];
+    }
+
+    for (size_t idx = 0U; idx < count; ++idx)
+    {
+        size_t dst             = p_stage->p_ptr[p_stage_major[idx]]++;
+        p_stage->p_idx[dst]    = p_stage_minor[idx];
+        p_stage->p_values[dst] = p_values[idx];
+    }
+
+    // The fill loop advanced every offset by one slice; shift them back
+    memmove(&p_stage->p_ptr[1],
+            &p_stage->p_ptr[0],
+            stage_slices * sizeof(size_t));
+    p_stage->p_ptr[0] = 0U;
+    sparse_compress_transpose(p_stage, p_out);
+    sparse_destroy(p_stage);
+
+    // Sum duplicates, which are now adjacent
+    size_t major = sparse_major(p_out);
+    size_t pos   = 0U;
+    size_t start = 0U;
+
+    for (size_t outer = 0U; outer < major; ++outer)
+    {
+        size_t end = p_out->p_ptr[outer + 1U];
+
+        for (size_t idx = start; idx < end; ++idx)
+        {
+            if ((pos > p_out->p_ptr[outer])
+                && (p_out->p_idx[pos - 1U] == p_out->p_idx[idx]))
+            {
+                p_out->p_values[pos - 1U] += p_out->p_values[idx];
+            }
+            else
+            {
+                p_out->p_idx[pos]    = p_out->p_idx[idx];
+                p_out->p_values[pos] = p_out->p_values[idx];
+                pos++;
+            }
+        }
+
+        start                    = end;
+        p_out->p_ptr[outer + 1U] = pos;
+    }
+
+    p_out->nnz = pos;
+    return p_out;
+}
+
+void
+sparse_destroy (sparse_matrix_t *p_sparse)
+{
+    if (NULL != p_sparse)
+    {
+        free(p_sparse->p_ptr);
+        free(p_sparse->p_idx);
+        free(p_sparse->p_values);
+        free(p_sparse);
+    }
+}
+
+sparse_error_code_t
+sparse_to_dense (const sparse_matrix_t *p_sparse, matrix_t *p_dense)
+{
+    if ((NULL == p_sparse) || (NULL == p_dense)
+        || (p_sparse->rows != p_dense->rows)
+        || (p_sparse->cols != p_dense->cols))
+    {
+        return SPARSE_INVALID_ARGUMENT;
+    }
+
+    matrix_fill(p_dense, 0.0);
+    size_t major = sparse_major(p_sparse);
+
+    for (size_t outer = 0U; outer < major; ++outer)
+    {
+        for (size_t pos = p_sparse->p_ptr[outer];
+             pos < p_sparse->p_ptr[outer + 1U];
+             ++pos)
+        {
+            size_t inner = p_sparse->p_idx[pos];
+            size_t flat  = (SPARSE_CSR == p_sparse->format)
+                               ? ((outer * p_dense->ld) + inner)
+                               : ((inner * p_dense->ld) + outer);
+            p_dense->p_data[flat] = p_sparse->p_values[pos];
+        }
+    }
+
+    return SPARSE_SUCCESS;
+}
+
+sparse_error_code_t
+sparse_get (const sparse_matrix_t *p_sparse,
+            size_t                 row,
+            size_t                 col,
+            double                *p_out)
+{
+    if ((NULL == p_sparse) || (NULL == p_out))
+    {
+        return SPARSE_INVALID_ARGUMENT;
+    }
+
+    if ((row >= p_sparse->rows) || (col >= p_sparse->cols))
+    {
+        return SPARSE_OUT_OF_BOUNDS;
+    }
+
+    bool   b_csr = (SPARSE_CSR == p_sparse->format);
+    size_t outer = b_csr ? row : col;
+    size_t inner = b_csr ? col : row;
+    size_t low   = p_sparse->p_ptr[outer];
+    size_t high  = p_sparse->p_ptr[outer + 1U];
+
+    while (low < high)
+    {
+        size_t mid = low + ((high - low) / 2U);
+
+        if (p_sparse->p_idx[mid] < inner)
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    bool b_found = (low < p_sparse->p_ptr[outer + 1U])
+                   && (p_sparse->p_idx[low] == inner);
+    *p_out = b_found ? p_sparse->p_values[low] : 0.0;
+    return SPARSE_SUCCESS;
+}
+
+sparse_matrix_t *
+sparse_transpose (const sparse_matrix_t *p_sparse)
+{
+    if (NULL == p_sparse)
+    {
+        return NULL;
+    }
+
+    sparse_matrix_t *p_trans = sparse_alloc(
+        p_sparse->cols, p_sparse->rows, p_sparse->nnz, p_sparse->format);
+
+    if (NULL != p_trans)
+    {
+        sparse_compress_transpose(p_sparse, p_trans);
+    }
+
+    return p_trans;
+}
+
+sparse_matrix_t *
+sparse_convert (const sparse_matrix_t *p_sparse, sparse_format_t format)
+{
+    if (NULL == p_sparse)
+    {
+        return NULL;
+    }
+
+    sparse_matrix_t *p_out
+        = sparse_alloc(p_sparse->rows, p_sparse->cols, p_sparse->nnz, format);
+
+    if (NULL == p_out)
+    {
+        return NULL;
+    }
+
+    if (format == p_sparse->format)
+    {
+        memcpy(p_out->p_ptr,
+               p_sparse->p_ptr,
+               (sparse_major(p_sparse) + 1U) * sizeof(size_t));
+        memcpy(p_out->p_idx, p_sparse->p_idx, p_sparse->nnz * sizeof(size_t));
+        memcpy(p_out->p_values,
+               p_sparse->p_values,
+               p_sparse->nnz * sizeof(double));
+    }
+    else
+    {
+        // CSC of A has exactly the arrays of CSR of A^T
+        sparse_compress_transpose(p_sparse, p_out);
+    }
+
+    return p_out;
+}
+
+sparse_error_code_t
+sparse_spmv (const sparse_matrix_t *p_sparse, const double *p_x, double *p_y)
+{
+    if ((NULL == p_sparse) || (NULL == p_x) || (NULL == p_y))
+    {
+        return SPARSE_INVALID_ARGUMENT;
+    }
+
+    if (SPARSE_CSC == p_sparse->format)
+    {
+        memset(p_y, 0, p_sparse->rows * sizeof(double));
+
+        for (size_t col = 0U; col < p_sparse->cols; ++col)
+        {
+            double x_val = p_x[col];
+
+            for (size_t pos = p_sparse->p_ptr[col];
+                 pos < p_sparse->p_ptr[col + 1U];
+                 ++pos)
+            {
+                p_y[p_sparse->p_idx[pos]] += p_sparse->p_values[pos] * x_val;
+            }
+        }
+
+        return SPARSE_SUCCESS;
+    }
+
+    sparse_product_ctx_t ctx = { 0 };
+    ctx.p_sparse             = p_sparse;
+    ctx.p_x                  = p_x;
+    ctx.p_y                  = p_y;
+    ctx.parts                = sparse_partition_count(p_sparse, 1U);
+    parallel_for(ctx.parts, 1U, sparse_spmv_range, &ctx);
+    return SPARSE_SUCCESS;
+}
+
+sparse_error_code_t
+sparse_spmm (const sparse_matrix_t *p_sparse,
+             const matrix_t        *p_b,
+             matrix_t              *p_c)
+{
+    if ((NULL == p_sparse) || (NULL == p_b) || (NULL == p_c)
+        || (p_b->rows != p_sparse->cols) || (p_c->rows != p_sparse->rows)
+        || (p_c->cols != p_b->cols) || matrix_is_overlapping(p_b, p_c))
+    {
+        return SPARSE_INVALID_ARGUMENT;
+    }
+
+    size_t width = p_b->cols;
+
+    if (SPARSE_CSC == p_sparse->format)
+    {
+        matrix_fill(p_c, 0.0);
+
+        for (size_t col = 0U; col < p_sparse->cols; ++col)
+        {
+            const double *p_src = p_b->p_data + (col * p_b->ld);
+
+            for (size_t pos = p_sparse->p_ptr[col];
+                 pos < p_sparse->p_ptr[col + 1U];
+                 ++pos)
+            {
+                double *p_dst = p_c->p_data + (p_sparse->p_idx[pos] * p_c->ld);
+                double  val   = p_sparse->p_values[pos];
+
+                for (size_t idx = 0U; idx < width; ++idx)
+                {
+                    p_dst[idx] += val * p_src[idx];
+                }
+            }
+        }
+
+        return SPARSE_SUCCESS;
+    }
+
+    sparse_product_ctx_t ctx = { 0 };
+    ctx.p_sparse             = p_sparse;
+    ctx.p_b                  = p_b;
+    ctx.p_c                  = p_c;
+    ctx.parts                = sparse_partition_count(p_sparse, width);
+    parallel_for(ctx.parts, 1U, sparse_spmm_range, &ctx);
+    return SPARSE_SUCCESS;
+}
+
+static sparse_matrix_t *
+sparse_alloc (size_t rows, size_t cols, size_t nnz, sparse_format_t format)
+{
+    sparse_matrix_t *p_sparse
+        = (sparse_matrix_t *)calloc(1U, sizeof(sparse_matrix_t));
+
+    if (NULL == p_sparse)
+    {
+        return NULL;
+    }
+
+    p_sparse->format = format;
+    p_sparse->rows   = rows;
+    p_sparse->cols   = cols;
+    p_sparse->nnz    = nnz;
+
+    // Always allocate at least one entry so empty matrices are valid
+    size_t major       = sparse_major(p_sparse);
+    size_t slots       = (0U == nnz) ? 1U : nnz;
+    p_sparse->p_ptr    = (size_t *)calloc(major + 1U, sizeof(size_t));
+    p_sparse->p_idx    = (size_t *)malloc(slots * sizeof(size_t));
+    p_sparse->p_values = (double *)malloc(slots * sizeof(double));
+
+    if ((NULL == p_sparse->p_ptr) || (NULL == p_sparse->p_idx)
+        || (NULL == p_sparse->p_values))
+    {
+        sparse_destroy(p_sparse);
+        return NULL;
+    }
+
+    return p_sparse;
+}
+
+static size_t
+sparse_major (const sparse_matrix_t *p_sparse)
+{
+    return (SPARSE_CSR == p_sparse->format) ? p_sparse->rows : p_sparse->cols;
+}
+
+static void
+sparse_compress_transpose (const sparse_matrix_t *p_src,
+                           sparse_matrix_t       *p_dst)
+{
+    size_t src_major = sparse_major(p_src);
+    size_t dst_major = sparse_major(p_dst);
+
+    memset(p_dst->p_ptr, 0, (dst_major + 1U) * sizeof(size_t));
+
+    for (size_t pos = 0U; pos < p_src->nnz; ++pos)
+    {
+        p_dst->p_ptr[p_src->p_idx[pos] + 1U]++;
+    }
+
+    for (size_t idx = 0U; idx < dst_major; ++idx)
+    {
+        p_dst->p_ptr[idx + 1U] += p_dst->p_ptr[idx];
+    }
+
+    for (size_t outer = 0U; outer < src_major; ++outer)
+    {
+        for (size_t pos = p_src->p_ptr[outer]; pos < p_src->p_ptr[outer + 1U];
+             ++pos)
+        {
+            size_t dst           = p_dst->p_ptr[p_src->p_idx[pos]]++;
+            p_dst->p_idx[dst]    = outer;
+            p_dst->p_values[dst] = p_src->p_values[pos];
+        }
+    }
+
+    // The fill loop advanced every offset by one slice; shift them back
+    memmove(&p_dst->p_ptr[1], &p_dst->p_ptr[0], dst_major * sizeof(size_t));
+    p_dst->p_ptr[0] = 0U;
+    p_dst->nnz      = p_src->nnz;
+}
+
+static size_t
+sparse_partition_row (const sparse_matrix_t *p_sparse,
+                      size_t                 part,
+                      size_t                 parts)
+{
+    if (part >= parts)
+    {
+        return p_sparse->rows;
+    }
+
+    size_t target = (size_t)(((unsigned long long)p_sparse->nnz * part)
+                             / parts);
+    size_t low    = 0U;
+    size_t high   = p_sparse->rows;
+
+    // Lower bound of target in the row offsets
+    while (low < high)
+    {
+        size_t mid = low + ((high - low) / 2U);
+
+        if (p_sparse->p_ptr[mid] < target)
+        {
+            low = mid + 1U;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+static void
+sparse_spmv_range (size_t begin, size_t end, void *p_ctx)
+{
+    sparse_product_ctx_t  *p_prod   = (sparse_product_ctx_t *)p_ctx;
+    const sparse_matrix_t *p_sparse = p_prod->p_sparse;
+    const size_t          *p_ptr    = p_sparse->p_ptr;
+    const size_t          *p_idx    = p_sparse->p_idx;
+    const double          *p_val    = p_sparse->p_values;
+    const double          *p_x      = p_prod->p_x;
+    size_t first = sparse_partition_row(p_sparse, begin, p_prod->parts);
+    size_t last  = sparse_partition_row(p_sparse, end, p_prod->parts);
+
+    for (size_t row = first; row < last; ++row)
+    {
+        // Two independent accumulators hide the add latency of the gather
+        double sum_a = 0.0;
+        double sum_b = 0.0;
+        size_t pos   = p_ptr[row];
+        size_t stop  = p_ptr[row + 1U];
+
+        for (; pos + 1U < stop; pos += 2U)
+        {
+            sum_a += p_val[pos] * p_x[p_idx[pos]];
+            sum_b += p_val[pos + 1U] * p_x[p_idx[pos + 1U]];
+        }
+
+        if (pos < stop)
+        {
+            sum_a += p_val[pos] * p_x[p_idx[pos]];
+        }
+
+        p_prod->p_y[row] = sum_a + sum_b;
+    }
+}
+
+static void
+sparse_spmm_range (size_t begin, size_t end, void *p_ctx)
+{
+    sparse_product_ctx_t  *p_prod   = (sparse_product_ctx_t *)p_ctx;
+    const sparse_matrix_t *p_sparse = p_prod->p_sparse;
+    size_t                 width    = p_prod->p_b->cols;
+    size_t                 ldb      = p_prod->p_b->ld;
+    size_t first = sparse_partition_row(p_sparse, begin, p_prod->parts);
+    size_t last  = sparse_partition_row(p_sparse, end, p_prod->parts);
+
+    for (size_t row = first; row < last; ++row)
+    {
+        double *p_dst = p_prod->p_c->p_data + (row * p_prod->p_c->ld);
+        memset(p_dst, 0, width * sizeof(double));
+
+        for (size_t pos = p_sparse->p_ptr[row]; pos < p_sparse->p_ptr[row + 1U];
+             ++pos)
+        {
+            const double *p_src
+                = p_prod->p_b->p_data + (p_sparse->p_idx[pos] * ldb);
+            double val = p_sparse->p_values[pos];
+
+            for (size_t idx = 0U; idx < width; ++idx)
+            {
+                p_dst[idx] += val * p_src[idx];
+            }
+        }
+    }
+}
+
+static size_t
+sparse_partition_count (const sparse_matrix_t *p_sparse, size_t work_per_nnz)
+{
+    size_t work  = p_sparse->nnz * ((0U == work_per_nnz) ? 1U : work_per_nnz);
+    size_t parts = work / SPARSE_PARALLEL_MIN_NNZ;
+    size_t limit = parallel_get_threads();
+
+    parts = (parts > limit) ? limit : parts;
+    return (0U == parts) ? 1U : parts;
+}
+
+/*** end of file ***/
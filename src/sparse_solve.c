@@ -0,0 +1,1194 @@
+/**
+ * @file sparse_solve.c
+ * @brief Implementation of iterative solvers for sparse linear systems.
+ *
+ * Krylov methods only touch A through products with vectors, so a solve
+ * needs O(nnz) memory for A and a fixed number of vectors of length n,
+ * where dense LU needs O(n^2) memory and O(n^3) time. Each iteration costs
+ * one or two sparse_spmv calls plus a handful of dot products and vector
+ * updates, all of which are split across threads: SpMV by nnz-balanced row
+ * ranges, the vector operations by blocks of SPARSE_SOLVE_BLOCK elements.
+ *
+ * Every temporary vector lives in one workspace allocated before the first
+ * iteration, so the loop itself never allocates.
+ *
+ * @author heapbadger
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parallel.h"
+#include "sparse_solve.h"
+
+/**
+ * Vectors a solve needs, all of one length, plus one partial sum per block
+ * for the dot products.
+ */
+typedef struct
+{
+    size_t  size;      /**< Length of every vector. */
+    size_t  blocks;    /**< Number of SPARSE_SOLVE_BLOCK blocks. */
+    double *p_vectors; /**< count * size elements. */
+    double *p_partial; /**< One dot product partial per block. */
+} solve_work_t;
+
+/**
+ * Arguments of a block-parallel vector operation.
+ */
+typedef struct
+{
+    const solve_work_t *p_work;
+    const double       *p_x;
+    double             *p_y;
+    double              alpha;
+    double              beta;
+} solve_vector_ctx_t;
+
+/**
+ * Jacobi or ILU(0) preconditioner of a CSR matrix.
+ */
+typedef struct
+{
+    const sparse_matrix_t *p_csr;  /**< Pattern of the factors. */
+    double                *p_diag; /**< Inverse diagonal (Jacobi). */
+    double                *p_lu;   /**< L and U values, unit L (ILU(0)). */
+    size_t                *p_upos; /**< Position of each U diagonal. */
+} solve_precond_t;
+
+/**
+ * @brief Allocate a workspace of count vectors.
+ *
+ * @param p_work Workspace to fill in.
+ * @param size Length of each vector.
+ * @param count Number of vectors.
+ *
+ * @return SPARSE_SUCCESS on success, SPARSE_ALLOCATION_FAILURE on failure.
+ */
+static sparse_error_code_t solve_work_create(solve_work_t *p_work,
+                                             size_t        size,
+                                             size_t        count);
+
+/**
+ * @brief Free the memory of a workspace.
+ */
+static void solve_work_destroy(solve_work_t *p_work);
+
+/**
+ * @brief Vector idx of a workspace.
+ */
+static double *solve_vector(const solve_work_t *p_work, size_t idx);
+
+/**
+ * @brief parallel_func computing one dot product partial per block.
+ */
+static void solve_dot_range(size_t begin, size_t end, void *p_ctx);
+
+/**
+ * @brief parallel_func computing y = alpha * x + beta * y per block.
+ */
+static void solve_axpby_range(size_t begin, size_t end, void *p_ctx);
+
+/**
+ * @brief Dot product x . y, summed per block in block order.
+ */
+static double solve_dot(const solve_work_t *p_work,
+                        const double       *p_x,
+                        const double       *p_y);
+
+/**
+ * @brief Euclidean norm of x.
+ */
+static double solve_norm(const solve_work_t *p_work, const double *p_x);
+
+/**
+ * @brief y = alpha * x + beta * y. x and y may be the same vector.
+ *
+ * beta == 0 ignores the old contents of y.
+ */
+static void solve_axpby(const solve_work_t *p_work,
+                        double              alpha,
+                        const double       *p_x,
+                        double              beta,
+                        double             *p_y);
+
+/**
+ * @brief Apply the operator, y = A * x, counting the product.
+ */
+static sparse_error_code_t solve_apply(const sparse_operator_t *p_operator,
+                                       const double            *p_x,
+                                       double                  *p_y,
+                                       sparse_solve_stats_t    *p_stats);
+
+/**
+ * @brief Apply the preconditioner, z = M^-1 * r, or copy r without one.
+ */
+static sparse_error_code_t solve_precondition(
+    const sparse_operator_t *p_precond,
+    const solve_work_t      *p_work,
+    const double            *p_r,
+    double                  *p_z);
+
+/**
+ * @brief Compute r = b - A * x.
+ */
+static sparse_error_code_t solve_residual(const sparse_operator_t *p_operator,
+                                          const solve_work_t      *p_work,
+                                          const double            *p_b,
+                                          const double            *p_x,
+                                          double                  *p_r,
+                                          sparse_solve_stats_t    *p_stats);
+
+/**
+ * @brief Preconditioned conjugate gradient.
+ *
+ * The workspace holds r, p, q = A * p and z = M^-1 * r.
+ */
+static sparse_error_code_t solve_cg(const sparse_operator_t *p_operator,
+                                    const sparse_operator_t *p_precond,
+                                    const solve_work_t      *p_work,
+                                    const double            *p_b,
+                                    double                  *p_x,
+                                    double                   b_norm,
+                                    double                   tolerance,
+                                    size_t                   max_iterations,
+                                    sparse_solve_stats_t    *p_stats);
+
+/**
+ * @brief Right-preconditioned BiCGSTAB.
+ *
+ * The workspace holds r (also s), the shadow residual, p, v, t and the
+ * preconditioned p and s.
+ */
+static sparse_error_code_t solve_bicgstab(
+    const sparse_operator_t *p_operator,
+    const sparse_operator_t *p_precond,
+    const solve_work_t      *p_work,
+    const double            *p_b,
+    double                  *p_x,
+    double                   b_norm,
+    double                   tolerance,
+    size_t                   max_iterations,
+    sparse_solve_stats_t    *p_stats);
+
+/**
+ * @brief Right-preconditioned GMRES(restart) with modified Gram-Schmidt.
+ *
+ * The workspace holds the restart + 1 Krylov basis vectors followed by two
+ * scratch vectors. The Hessenberg matrix is reduced with Givens rotations
+ * as it grows, so the residual norm is known after every inner step.
+ */
+static sparse_error_code_t solve_gmres(const sparse_operator_t *p_operator,
+                                       const sparse_operator_t *p_precond,
+                                       const solve_work_t      *p_work,
+                                       const double            *p_b,
+                                       double                  *p_x,
+                                       double                   b_norm,
+                                       double                   tolerance,
+                                       size_t                   max_iterations,
+                                       size_t                   restart,
+                                       sparse_solve_stats_t    *p_stats);
+
+/**
+ * @brief Build a Jacobi or ILU(0) preconditioner of a square CSR matrix.
+ *
+ * @return SPARSE_SUCCESS on success, SPARSE_FAILURE if a diagonal entry is
+ *         missing or a pivot is zero, SPARSE_ALLOCATION_FAILURE on failure.
+ */
+static sparse_error_code_t solve_precond_create(
+    const sparse_matrix_t *p_csr,
+    sparse_precond_t       kind,
+    solve_precond_t       *p_precond);
+
+/**
+ * @brief Free the memory of a preconditioner.
+ */
+static void solve_precond_destroy(solve_precond_t *p_precond);
+
+/**
+ * @brief sparse_apply_func wrapping sparse_spmv.
+ */
+static sparse_error_code_t solve_spmv_apply(const double *p_x,
+                                            double       *p_y,
+                                            void         *p_ctx);
+
+/**
+ * @brief sparse_apply_func scaling by the inverse diagonal.
+ */
+static sparse_error_code_t solve_jacobi_apply(const double *p_x,
+                                              double       *p_y,
+                                              void         *p_ctx);
+
+/**
+ * @brief sparse_apply_func solving L * U * y = x with the ILU(0) factors.
+ */
+static sparse_error_code_t solve_ilu0_apply(const double *p_x,
+                                            double       *p_y,
+                                            void         *p_ctx);
+
+sparse_error_code_t
+sparse_solve (const sparse_matrix_t       *p_sparse,
+              const double                *p_b,
+              double                      *p_x,
+              const sparse_solve_params_t *p_params,
+              sparse_solve_stats_t        *p_stats)
+{
+    if ((NULL == p_sparse) || (p_sparse->rows != p_sparse->cols))
+    {
+        return SPARSE_INVALID_ARGUMENT;
+    }
+
+    sparse_error_code_t    status  = SPARSE_SUCCESS;
+    sparse_matrix_t       *p_owned = NULL;
+    const sparse_matrix_t *p_csr   = p_sparse;
+    solve_precond_t        precond = { 0 };
+    sparse_operator_t      op      = { 0 };
+    sparse_operator_t      inverse = { 0 };
+    sparse_precond_t       kind    = SPARSE_PRECOND_NONE;
+
+    if (NULL != p_params)
+    {
+        kind = p_params->precond;
+    }
+
+    if ((SPARSE_PRECOND_NONE != kind) && (SPARSE_PRECOND_JACOBI != kind)
+        && (SPARSE_PRECOND_ILU0 != kind))
+    {
+        return SPARSE_INVALID_ARGUMENT;
+    }
+
+    if (SPARSE_CSC == p_sparse->format)
+    {
+        p_owned = sparse_convert(p_sparse, SPARSE_CSR);
+
+        if (NULL == p_owned)
+        {
+            return SPARSE_ALLOCATION_FAILURE;
+        }
+
+        p_csr = p_owned;
+    }
+
+    op.size  = p_csr->rows;
+    op.apply = solve_spmv_apply;
+    op.p_ctx = (void *)p_csr;
+
+    if (SPARSE_PRECOND_NONE != kind)
+    {
+        status = solve_precond_create(p_csr, kind, &precond);
+
+        if (SPARSE_SUCCESS != status)
+        {
+            goto CLEANUP;
+        }
+
+        inverse.size  = p_csr->rows;
+        inverse.apply = (SPARSE_PRECOND_JACOBI == kind) ? solve_jacobi_apply
+                                                        : solve_ilu0_apply;
+        inverse.p_ctx = &precond;
+    }
+
+    status = sparse_solve_operator(&op,
+                                   (SPARSE_PRECOND_NONE == kind) ? NULL
+                                                                 : &inverse,
+                                   p_b,
+                                   p_x,
+                                   p_params,
+                                   p_stats);
+
+CLEANUP:
+    solve_precond_destroy(&precond);
+    sparse_destroy(p_owned);
+    return status;
+}
+
+sparse_error_code_t
+sparse_solve_operator (const sparse_operator_t     *p_operator,
+                       const sparse_operator_t     *p_precond,
+                       const double                *p_b,
+                       double                      *p_x,
+                       const sparse_solve_params_t *p_params,
+                       sparse_solve_stats_t        *p_stats)
+{
+    if ((NULL == p_operator) || (NULL == p_operator->apply)
+        || (0U == p_operator->size) || (NULL == p_b) || (NULL == p_x)
+        || (p_b == p_x))
+    {
+        return SPARSE_INVALID_ARGUMENT;
+    }
+
+    if ((NULL != p_precond)
+        && ((NULL == p_precond->apply)
+            || (p_precond->size != p_operator->size)))
+    {
+        return SPARSE_INVALID_ARGUMENT;
+    }
+
+    sparse_solve_params_t params = { 0 };
+    sparse_solve_stats_t  stats  = { 0 };
+    solve_work_t          work   = { 0 };
+    size_t                size   = p_operator->size;
+    size_t                count  = 0U;
+    sparse_error_code_t   status = SPARSE_SUCCESS;
+
+    if (NULL != p_params)
+    {
+        params = *p_params;
+    }
+
+    params.tolerance      = (0.0 < params.tolerance) ? params.tolerance
+                                                     : SPARSE_SOLVE_TOLERANCE;
+    params.restart        = (0U < params.restart) ? params.restart
+                                                  : SPARSE_SOLVE_RESTART;
+    params.max_iterations = (0U < params.max_iterations)
+                                ? params.max_iterations
+                                : ((SIZE_MAX / 10U < size) ? SIZE_MAX
+                                                           : size * 10U);
+
+    switch (params.method)
+    {
+        case SPARSE_SOLVE_CG:
+            count = 4U;
+            break;
+
+        case SPARSE_SOLVE_BICGSTAB:
+            count = 7U;
+            break;
+
+        case SPARSE_SOLVE_GMRES:
+            count = (SIZE_MAX - 3U < params.restart) ? SIZE_MAX
+                                                     : params.restart + 3U;
+            break;
+
+        default:
+            return SPARSE_INVALID_ARGUMENT;
+    }
+
+    status = solve_work_create(&work, size, count);
+
+    if (SPARSE_SUCCESS != status)
+    {
+        goto CLEANUP;
+    }
+
+    double b_norm = solve_norm(&work, p_b);
+
+    // A zero right-hand side has the exact solution x = 0
+    if (0.0 == b_norm)
+    {
+        memset(p_x, 0, size * sizeof(double));
+        stats.b_converged = true;
+        goto CLEANUP;
+    }
+
+    switch (params.method)
+    {
+        case SPARSE_SOLVE_CG:
+            status = solve_cg(p_operator,
+                              p_precond,
+                              &work,
+                              p_b,
+                              p_x,
+                              b_norm,
+                              params.tolerance,
+                              params.max_iterations,
+                              &stats);
+            break;
+
+        case SPARSE_SOLVE_BICGSTAB:
+            status = solve_bicgstab(p_operator,
+                                    p_precond,
+                                    &work,
+                                    p_b,
+                                    p_x,
+                                    b_norm,
+                                    params.tolerance,
+                                    params.max_iterations,
+                                    &stats);
+            break;
+
+        default:
+            status = solve_gmres(p_operator,
+                                 p_precond,
+                                 &work,
+                                 p_b,
+                                 p_x,
+                                 b_norm,
+                                 params.tolerance,
+                                 params.max_iterations,
+                                 params.restart,
+                                 &stats);
+            break;
+    }
+
+    if ((SPARSE_SUCCESS == status) && (false == stats.b_converged))
+    {
+        status = SPARSE_NOT_CONVERGED;
+    }
+
+CLEANUP:
+    solve_work_destroy(&work);
+
+    if (NULL != p_stats)
+    {
+        *p_stats = stats;
+    }
+
+    return status;
+}
+
+static sparse_error_code_t
+solve_work_create (solve_work_t *p_work, size_t size, size_t count)
+{
+    p_work->size   = size;
+    p_work->blocks = (size + SPARSE_SOLVE_BLOCK - 1U) / SPARSE_SOLVE_BLOCK;
+
+    if (count > SIZE_MAX / sizeof(double) / size)
+    {
+        return SPARSE_ALLOCATION_FAILURE;
+    }
+
+    p_work->p_vectors = malloc(count * size * sizeof(double));
+    p_work->p_partial = malloc(p_work->blocks * sizeof(double));
+
+    if ((NULL == p_work->p_vectors) || (NULL == p_work->p_partial))
+    {
+        return SPARSE_ALLOCATION_FAILURE;
+    }
+
+    return SPARSE_SUCCESS;
+}
+
+static void
+solve_work_destroy (solve_work_t *p_work)
+{
+    free(p_work->p_vectors);
+    free(p_work->p_partial);
+    p_work->p_vectors = NULL;
+    p_work->p_partial = NULL;
+}
+
+static double *
+solve_vector (const solve_work_t *p_work, size_t idx)
+{
+    return p_work->p_vectors + (idx * p_work->size);
+}
+
+static void
+solve_dot_range (size_t begin, size_t end, void *p_ctx)
+{
+    solve_vector_ctx_t *p_vec = (solve_vector_ctx_t *)p_ctx;
+    size_t              size  = p_vec->p_work->size;
+
+    for (size_t block = begin; block < end; ++block)
+    {
+        size_t first = block * SPARSE_SOLVE_BLOCK;
+        size_t last  = (size - first < SPARSE_SOLVE_BLOCK)
+                           ? size
+                           : first + SPARSE_SOLVE_BLOCK;
+        double sum_a = 0.0;
+        double sum_b = 0.0;
+        size_t idx   = first;
+
+        for (; idx + 1U < last; idx += 2U)
+        {
+            sum_a += p_vec->p_x[idx] * p_vec->p_y[idx];
+            sum_b += p_vec->p_x[idx + 1U] * p_vec->p_y[idx + 1U];
+        }
+
+        if (idx < last)
+        {
+            sum_a += p_vec->p_x[idx] * p_vec->p_y[idx];
+        }
+
+        p_vec->p_work->p_partial[block] = sum_a + sum_b;
+    }
+}
+
+static void
+solve_axpby_range (size_t begin, size_t end, void *p_ctx)
+{
+    solve_vector_ctx_t *p_vec = (solve_vector_ctx_t *)p_ctx;
+    size_t              size  = p_vec->p_work->size;
+    size_t              first = begin * SPARSE_SOLVE_BLOCK;
+    size_t              last  = (size / SPARSE_SOLVE_BLOCK < end)
+                                    ? size
+                                    : end * SPARSE_SOLVE_BLOCK;
+    double              alpha = p_vec->alpha;
+    double              beta  = p_vec->beta;
+    const double       *p_x   = p_vec->p_x;
+    double             *p_y   = p_vec->p_y;
+
+    if (0.0 == beta)
+    {
+        for (size_t idx = first; idx < last; ++idx)
+        {
+            p_y[idx] = alpha * p_x[idx];
+        }
+    }
+    else if (1.0 == beta)
+    {
+        for (size_t idx = first; idx < last; ++idx)
+        {
+            p_y[idx] += alpha * p_x[idx];
+        }
+    }
+    else
+    {
+        for (size_t idx = first; idx < last; ++idx)
+        {
+            p_y[idx] = (alpha * p_x[idx]) + (beta * p_y[idx]);
+        }
+    }
+}
+
+static double
+solve_dot (const solve_work_t *p_work, const double *p_x, const double *p_y)
+{
+    solve_vector_ctx_t ctx = { 0 };
+    ctx.p_work             = p_work;
+    ctx.p_x                = p_x;
+    ctx.p_y                = (double *)p_y;
+    parallel_for(p_work->blocks, 1U, solve_dot_range, &ctx);
+
+    double sum = 0.0;
+
+    for (size_t block = 0U; block < p_work->blocks; ++block)
+    {
+        sum += p_work->p_partial[block];
+    }
+
+    return sum;
+}
+
+static double
+solve_norm (const solve_work_t *p_work, const double *p_x)
+{
+    return sqrt(solve_dot(p_work, p_x, p_x));
+}
+
+static void
+solve_axpby (const solve_work_t *p_work,
+             double              alpha,
+             const double       *p_x,
+             double              beta,
+             double             *p_y)
+{
+    solve_vector_ctx_t ctx = { 0 };
+    ctx.p_work             = p_work;
+    ctx.p_x                = p_x;
+    ctx.p_y                = p_y;
+    ctx.alpha              = alpha;
+    ctx.beta               = beta;
+    parallel_for(p_work->blocks, 1U, solve_axpby_range, &ctx);
+}
+
+static sparse_error_code_t
+solve_apply (const sparse_operator_t *p_operator,
+             const double            *p_x,
+             double                  *p_y,
+             sparse_solve_stats_t    *p_stats)
+{
+    p_stats->matvecs += 1U;
+    return p_operator->apply(p_x, p_y, p_operator->p_ctx);
+}
+
+static sparse_error_code_t
+solve_precondition (const sparse_operator_t *p_precond,
+                    const solve_work_t      *p_work,
+                    const double            *p_r,
+                    double                  *p_z)
+{
+    if (NULL == p_precond)
+    {
+        memcpy(p_z, p_r, p_work->size * sizeof(double));
+        return SPARSE_SUCCESS;
+    }
+
+    return p_precond->apply(p_r, p_z, p_precond->p_ctx);
+}
+
+static sparse_error_code_t
+solve_residual (const sparse_operator_t *p_operator,
+                const solve_work_t      *p_work,
+                const double            *p_b,
+                const double            *p_x,
+                double                  *p_r,
+                sparse_solve_stats_t    *p_stats)
+{
+    sparse_error_code_t status = solve_apply(p_operator, p_x, p_r, p_stats);
+
+    if (SPARSE_SUCCESS == status)
+    {
+        solve_axpby(p_work, 1.0, p_b, -1.0, p_r);
+    }
+
+    return status;
+}
+
+static sparse_error_code_t
+solve_cg (const sparse_operator_t *p_operator,
+          const sparse_operator_t *p_precond,
+          const solve_work_t      *p_work,
+          const double            *p_b,
+          double                  *p_x,
+          double                   b_norm,
+          double                   tolerance,
+          size_t                   max_iterations,
+          sparse_solve_stats_t    *p_stats)
+{
+    double             *p_r    = solve_vector(p_work, 0U);
+    double             *p_p    = solve_vector(p_work, 1U);
+    double             *p_q    = solve_vector(p_work, 2U);
+    double             *p_z    = (NULL == p_precond) ? p_r
+                                                     : solve_vector(p_work, 3U);
+    sparse_error_code_t status = SPARSE_SUCCESS;
+
+    status = solve_residual(p_operator, p_work, p_b, p_x, p_r, p_stats);
+
+    if ((SPARSE_SUCCESS == status) && (NULL != p_precond))
+    {
+        status = p_precond->apply(p_r, p_z, p_precond->p_ctx);
+    }
+
+    if (SPARSE_SUCCESS != status)
+    {
+        return status;
+    }
+
+    memcpy(p_p, p_z, p_work->size * sizeof(double));
+    double rz         = solve_dot(p_work, p_r, p_z);
+    p_stats->residual = solve_norm(p_work, p_r) / b_norm;
+
+    while ((tolerance < p_stats->residual)
+           && (p_stats->iterations < max_iterations))
+    {
+        status = solve_apply(p_operator, p_p, p_q, p_stats);
+
+        if (SPARSE_SUCCESS != status)
+        {
+            return status;
+        }
+
+        // p^T A p must stay positive for an SPD operator
+        double pq = solve_dot(p_work, p_p, p_q);
+
+        if (!(0.0 < pq) || !isfinite(pq))
+        {
+            break;
+        }
+
+        double alpha = rz / pq;
+        solve_axpby(p_work, alpha, p_p, 1.0, p_x);
+        solve_axpby(p_work, -alpha, p_q, 1.0, p_r);
+        p_stats->iterations += 1U;
+        p_stats->residual = solve_norm(p_work, p_r) / b_norm;
+
+        if (tolerance >= p_stats->residual)
+        {
+            break;
+        }
+
+        if (NULL != p_precond)
+        {
+            status = p_precond->apply(p_r, p_z, p_precond->p_ctx);
+
+            if (SPARSE_SUCCESS != status)
+            {
+                return status;
+            }
+        }
+
+        double rz_next = solve_dot(p_work, p_r, p_z);
+        solve_axpby(p_work, 1.0, p_z, rz_next / rz, p_p);
+        rz = rz_next;
+    }
+
+    p_stats->b_converged = (tolerance >= p_stats->residual);
+    return SPARSE_SUCCESS;
+}
+
+static sparse_error_code_t
+solve_bicgstab (const sparse_operator_t *p_operator,
+                const sparse_operator_t *p_precond,
+                const solve_work_t      *p_work,
+                const double            *p_b,
+                double                  *p_x,
+                double                   b_norm,
+                double                   tolerance,
+                size_t                   max_iterations,
+                sparse_solve_stats_t    *p_stats)
+{
+    double             *p_r      = solve_vector(p_work, 0U);
+    double             *p_shadow = solve_vector(p_work, 1U);
+    double             *p_p      = solve_vector(p_work, 2U);
+    double             *p_v      = solve_vector(p_work, 3U);
+    double             *p_t      = solve_vector(p_work, 4U);
+    double             *p_p_hat  = solve_vector(p_work, 5U);
+    double             *p_s_hat  = solve_vector(p_work, 6U);
+    double              rho      = 1.0;
+    double              alpha    = 1.0;
+    double              omega    = 1.0;
+    sparse_error_code_t status   = SPARSE_SUCCESS;
+
+    status = solve_residual(p_operator, p_work, p_b, p_x, p_r, p_stats);
+
+    if (SPARSE_SUCCESS != status)
+    {
+        return status;
+    }
+
+    memcpy(p_shadow, p_r, p_work->size * sizeof(double));
+    p_stats->residual = solve_norm(p_work, p_r) / b_norm;
+
+    while ((tolerance < p_stats->residual)
+           && (p_stats->iterations < max_iterations))
+    {
+        double rho_next = solve_dot(p_work, p_shadow, p_r);
+
+        // The shadow residual became orthogonal to r; the method breaks
+        // down and a restart from the current x would be needed
+        if ((0.0 == rho_next) || !isfinite(rho_next))
+        {
+            break;
+        }
+
+        if (0U == p_stats->iterations)
+        {
+            memcpy(p_p, p_r, p_work->size * sizeof(double));
+        }
+        else
+        {
+            // p = r + beta * (p - omega * v)
+            solve_axpby(p_work, -omega, p_v, 1.0, p_p);
+            solve_axpby(
+                p_work, 1.0, p_r, (rho_next / rho) * (alpha / omega), p_p);
+        }
+
+        status = solve_precondition(p_precond, p_work, p_p, p_p_hat);
+
+        if (SPARSE_SUCCESS == status)
+        {
+            status = solve_apply(p_operator, p_p_hat, p_v, p_stats);
+        }
+
+        if (SPARSE_SUCCESS != status)
+        {
+            return status;
+        }
+
+        double shadow_v = solve_dot(p_work, p_shadow, p_v);
+
+        if ((0.0 == shadow_v) || !isfinite(shadow_v))
+        {
+            break;
+        }
+
+        // s = r - alpha * v overwrites r
+        alpha = rho_next / shadow_v;
+        rho   = rho_next;
+        solve_axpby(p_work, -alpha, p_v, 1.0, p_r);
+        solve_axpby(p_work, alpha, p_p_hat, 1.0, p_x);
+        p_stats->iterations += 1U;
+        p_stats->residual = solve_norm(p_work, p_r) / b_norm;
+
+        if (tolerance >= p_stats->residual)
+        {
+            break;
+        }
+
+        status = solve_precondition(p_precond, p_work, p_r, p_s_hat);
+
+        if (SPARSE_SUCCESS == status)
+        {
+            status = solve_apply(p_operator, p_s_hat, p_t, p_stats);
+        }
+
+        if (SPARSE_SUCCESS != status)
+        {
+            return status;
+        }
+
+        double tt = solve_dot(p_work, p_t, p_t);
+
+        if ((0.0 == tt) || !isfinite(tt))
+        {
+            break;
+        }
+
+        omega = solve_dot(p_work, p_t, p_r) / tt;
+        solve_axpby(p_work, omega, p_s_hat, 1.0, p_x);
+        solve_axpby(p_work, -omega, p_t, 1.0, p_r);
+        p_stats->residual = solve_norm(p_work, p_r) / b_norm;
+
+        if (0.0 == omega)
+        {
+            break;
+        }
+    }
+
+    p_stats->b_converged = (tolerance >= p_stats->residual);
+    return SPARSE_SUCCESS;
+}
+
+static sparse_error_code_t
+solve_gmres (const sparse_operator_t *p_operator,
+             const sparse_operator_t *p_precond,
+             const solve_work_t      *p_work,
+             const double            *p_b,
+             double                  *p_x,
+             double                   b_norm,
+             double                   tolerance,
+             size_t                   max_iterations,
+             size_t                   restart,
+             sparse_solve_stats_t    *p_stats)
+{
+    double             *p_u     = solve_vector(p_work, restart + 1U);
+    double             *p_w     = solve_vector(p_work, restart + 2U);
+    double             *p_hess  = NULL;
+    sparse_error_code_t status  = SPARSE_SUCCESS;
+    bool                b_stuck = false;
+
+    // (restart + 1) x restart Hessenberg matrix, column-major, then the
+    // rotation cosines and sines, the rotated right-hand side g and y
+    if (restart > (SIZE_MAX / sizeof(double) / (restart + 5U)))
+    {
+        return SPARSE_ALLOCATION_FAILURE;
+    }
+
+    p_hess = malloc((restart + 1U) * (restart + 4U) * sizeof(double));
+
+    if (NULL == p_hess)
+    {
+        return SPARSE_ALLOCATION_FAILURE;
+    }
+
+    double *p_cos = p_hess + ((restart + 1U) * restart);
+    double *p_sin = p_cos + restart;
+    double *p_g   = p_sin + restart;
+    double *p_y   = p_g + restart + 1U;
+
+    while ((p_stats->iterations < max_iterations) && (false == b_stuck))
+    {
+        double *p_v0 = solve_vector(p_work, 0U);
+        status = solve_residual(p_operator, p_work, p_b, p_x, p_v0, p_stats);
+
+        if (SPARSE_SUCCESS != status)
+        {
+            goto CLEANUP;
+        }
+
+        double beta       = solve_norm(p_work, p_v0);
+        p_stats->residual = beta / b_norm;
+
+        if (tolerance >= p_stats->residual)
+        {
+            break;
+        }
+
+        solve_axpby(p_work, 1.0 / beta, p_v0, 0.0, p_v0);
+        memset(p_g, 0, (restart + 1U) * sizeof(double));
+        p_g[0]       = beta;
+        size_t steps = 0U;
+
+        while ((steps < restart) && (p_stats->iterations < max_iterations))
+        {
+            double *p_h    = p_hess + (steps * (restart + 1U));
+            double *p_next = solve_vector(p_work, steps + 1U);
+
+            status = solve_precondition(
+                p_precond, p_work, solve_vector(p_work, steps), p_u);
+
+            if (SPARSE_SUCCESS == status)
+            {
+                status = solve_apply(p_operator, p_u, p_next, p_stats);
+            }
+
+            if (SPARSE_SUCCESS != status)
+            {
+                goto CLEANUP;
+            }
+
+            for (size_t idx = 0U; idx <= steps; ++idx)
+            {
+                const double *p_basis = solve_vector(p_work, idx);
+                p_h[idx]              = solve_dot(p_work, p_next, p_basis);
+                solve_axpby(p_work, -p_h[idx], p_basis, 1.0, p_next);
+            }
+
+            double h_next = solve_norm(p_work, p_next);
+
+            if (0.0 < h_next)
+            {
+                solve_axpby(p_work, 1.0 / h_next, p_next, 0.0, p_next);
+            }
+
+            // Apply the earlier rotations to the new column, then choose
+            // one that zeroes its subdiagonal entry
+            for (size_t idx = 0U; idx < steps; ++idx)
+            {
+                double upper  = p_h[idx];
+                double lower  = p_h[idx + 1U];
+                p_h[idx]      = (p_cos[idx] * upper) + (p_sin[idx] * lower);
+                p_h[idx + 1U] = (p_cos[idx] * lower) - (p_sin[idx] * upper);
+            }
+
+            double radius = hypot(p_h[steps], h_next);
+
+            if (!(0.0 < radius) || !isfinite(radius))
+            {
+                b_stuck = true;
+                break;
+            }
+
+            p_cos[steps]    = p_h[steps] / radius;
+            p_sin[steps]    = h_next / radius;
+            p_h[steps]      = radius;
+            p_g[steps + 1U] = -p_sin[steps] * p_g[steps];
+            p_g[steps]      = p_cos[steps] * p_g[steps];
+            steps += 1U;
+            p_stats->iterations += 1U;
+            p_stats->residual = fabs(p_g[steps]) / b_norm;
+
+            // A zero subdiagonal means the Krylov space is invariant and
+            // the current solution is exact
+            if ((tolerance >= p_stats->residual) || (0.0 == h_next))
+            {
+                break;
+            }
+        }
+
+        if (0U == steps)
+        {
+            break;
+        }
+
+        // Back substitution for y in R * y = g, then x += M^-1 * V * y
+        for (size_t row = steps; row-- > 0U;)
+        {
+            double sum = p_g[row];
+
+            for (size_t col = row + 1U; col < steps; ++col)
+            {
+                sum -= p_hess[(col * (restart + 1U)) + row] * p_y[col];
+            }
+
+            p_y[row] = sum / p_hess[(row * (restart + 1U)) + row];
+        }
+
+        solve_axpby(p_work, p_y[0], solve_vector(p_work, 0U), 0.0, p_w);
+
+        for (size_t idx = 1U; idx < steps; ++idx)
+        {
+            solve_axpby(p_work, p_y[idx], solve_vector(p_work, idx), 1.0, p_w);
+        }
+
+        status = solve_precondition(p_precond, p_work, p_w, p_u);
+
+        if (SPARSE_SUCCESS != status)
+        {
+            goto CLEANUP;
+        }
+
+        solve_axpby(p_work, 1.0, p_u, 1.0, p_x);
+
+        if (tolerance >= p_stats->residual)
+        {
+            break;
+        }
+    }
+
+    p_stats->b_converged = (tolerance >= p_stats->residual);
+
+CLEANUP:
+    free(p_hess);
+    return status;
+}
+
+static sparse_error_code_t
+solve_precond_create (const sparse_matrix_t *p_csr,
+                      sparse_precond_t       kind,
+                      solve_precond_t       *p_precond)
+{
+    size_t        size  = p_csr->rows;
+    const size_t *p_ptr = p_csr->p_ptr;
+    const size_t *p_idx = p_csr->p_idx;
+    size_t       *p_map = NULL;
+
+    p_precond->p_csr = p_csr;
+
+    if (SPARSE_PRECOND_JACOBI == kind)
+    {
+        p_precond->p_diag = malloc(size * sizeof(double));
+
+        if (NULL == p_precond->p_diag)
+        {
+            return SPARSE_ALLOCATION_FAILURE;
+        }
+
+        for (size_t row = 0U; row < size; ++row)
+        {
+            double diag = 0.0;
+
+            for (size_t pos = p_ptr[row]; pos < p_ptr[row + 1U]; ++pos)
+            {
+                diag = (row == p_idx[pos]) ? p_csr->p_values[pos] : diag;
+            }
+
+            if (0.0 == diag)
+            {
+                return SPARSE_FAILURE;
+            }
+
+            p_precond->p_diag[row] = 1.0 / diag;
+        }
+
+        return SPARSE_SUCCESS;
+    }
+
+    // ILU(0): Gaussian elimination that drops every update falling outside
+    // the pattern of A. p_map finds the position of a column in the row
+    // being eliminated, or SIZE_MAX when it is not stored.
+    p_precond->p_lu   = malloc((0U == p_csr->nnz ? 1U : p_csr->nnz)
+                             * sizeof(double));
+    p_precond->p_upos = malloc(size * sizeof(size_t));
+    p_map             = malloc(size * sizeof(size_t));
+
+    if ((NULL == p_precond->p_lu) || (NULL == p_precond->p_upos)
+        || (NULL == p_map))
+    {
+        free(p_map);
+        return SPARSE_ALLOCATION_FAILURE;
+    }
+
+    double *p_lu = p_precond->p_lu;
+    memcpy(p_lu, p_csr->p_values, p_csr->nnz * sizeof(double));
+
+    for (size_t col = 0U; col < size; ++col)
+    {
+        p_map[col] = SIZE_MAX;
+    }
+
+    sparse_error_code_t status = SPARSE_SUCCESS;
+
+    for (size_t row = 0U; (row < size) && (SPARSE_SUCCESS == status); ++row)
+    {
+        size_t diag_pos = SIZE_MAX;
+
+        for (size_t pos = p_ptr[row]; pos < p_ptr[row + 1U]; ++pos)
+        {
+            p_map[p_idx[pos]] = pos;
+            diag_pos          = (row == p_idx[pos]) ? pos : diag_pos;
+        }
+
+        // Column indices are sorted, so the L part of the row comes first
+        for (size_t pos = p_ptr[row];
+             (pos < p_ptr[row + 1U]) && (p_idx[pos] < row);
+             ++pos)
+        {
+            size_t pivot_row = p_idx[pos];
+            double factor    = p_lu[pos] / p_lu[p_precond->p_upos[pivot_row]];
+            p_lu[pos]        = factor;
+
+            for (size_t upos = p_precond->p_upos[pivot_row] + 1U;
+                 upos < p_ptr[pivot_row + 1U];
+                 ++upos)
+            {
+                size_t target = p_map[p_idx[upos]];
+
+                if (SIZE_MAX != target)
+                {
+                    p_lu[target] -= factor * p_lu[upos];
+                }
+            }
+        }
+
+        for (size_t pos = p_ptr[row]; pos < p_ptr[row + 1U]; ++pos)
+        {
+            p_map[p_idx[pos]] = SIZE_MAX;
+        }
+
+        if ((SIZE_MAX == diag_pos) || (0.0 == p_lu[diag_pos])
+            || !isfinite(p_lu[diag_pos]))
+        {
+            status = SPARSE_FAILURE;
+        }
+
+        p_precond->p_upos[row] = diag_pos;
+    }
+
+    free(p_map);
+    return status;
+}
+
+static void
+solve_precond_destroy (solve_precond_t *p_precond)
+{
+    free(p_precond->p_diag);
+    free(p_precond->p_lu);
+    free(p_precond->p_upos);
+    p_precond->p_diag = NULL;
+    p_precond->p_lu   = NULL;
+    p_precond->p_upos = NULL;
+}
+
+static sparse_error_code_t
+solve_spmv_apply (const double *p_x, double *p_y, void *p_ctx)
+{
+    return sparse_spmv((const sparse_matrix_t *)p_ctx, p_x, p_y);
+}
+
+static sparse_error_code_t
+solve_jacobi_apply (const double *p_x, double *p_y, void *p_ctx)
+{
+    const solve_precond_t *p_precond = (const solve_precond_t *)p_ctx;
+
+    for (size_t row = 0U; row < p_precond->p_csr->rows; ++row)
+    {
+        p_y[row] = p_precond->p_diag[row] * p_x[row];
+    }
+
+    return SPARSE_SUCCESS;
+}
+
+static sparse_error_code_t
+solve_ilu0_apply (const double *p_x, double *p_y, void *p_ctx)
+{
+    const solve_precond_t *p_precond = (const solve_precond_t *)p_ctx;
+    const size_t          *p_ptr     = p_precond->p_csr->p_ptr;
+    const size_t          *p_idx     = p_precond->p_csr->p_idx;
+    const size_t          *p_upos    = p_precond->p_upos;
+    const double          *p_lu      = p_precond->p_lu;
+    size_t                 size      = p_precond->p_csr->rows;
+
+    // Forward substitution with the unit lower factor
+    for (size_t row = 0U; row < size; ++row)
+    {
+        double sum = p_x[row];
+
+        for (size_t pos = p_ptr[row]; pos < p_upos[row]; ++pos)
+        {
+            sum -= p_lu[pos] * p_y[p_idx[pos]];
+        }
+
+        p_y[row] = sum;
+    }
+
+    // Back substitution with the upper factor
+    for (size_t row = size; row-- > 0U;)
+    {
+        double sum = p_y[row];
+
+        for (size_t pos = p_upos[row] + 1U; pos < p_ptr[row + 1U]; ++pos)
+        {
+            sum -= p_lu[pos] * p_y[p_idx[pos]];
+        }
+
+        p_y[row] = sum / p_lu[p_upos[row]];
+    }
+
+    return SPARSE_SUCCESS;
+}
+
+/*** end of file ***/
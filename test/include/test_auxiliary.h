@@ -10,6 +10,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include "matrix.h"
 
 /**
  * @brief Provides global error logging.
@@ -78,6 +79,32 @@ void multiply_by_five(void *data, size_t index);
  */
 bool is_name_match(const char *p_str1, const char *p_str2);
 
+/**
+ * @brief   Fill a matrix with deterministic pseudo-random values in [-1, 1).
+ *
+ * @param p_matrix  Pointer to the matrix to fill.
+ * @param seed      Seed of the linear congruential generator.
+ */
+void fill_pseudo_random(matrix_t *p_matrix, unsigned int seed);
+
+/**
+ * @brief   Fill a matrix with values that encode their position, so element
+ * (row, col) holds row * 1000 + col.
+ *
+ * @param p_matrix  Pointer to the matrix to fill.
+ */
+void fill_with_index(matrix_t *p_matrix);
+
+/**
+ * @brief   Largest absolute element-wise difference of two matrices.
+ *
+ * @param p_a  Pointer to the first matrix.
+ * @param p_b  Pointer to the second matrix, same dimensions as the first.
+ *
+ * @return  Maximum of |a(i, j) - b(i, j)| over all elements.
+ */
+double max_abs_diff(const matrix_t *p_a, const matrix_t *p_b);
+
 #endif // TEST_AUXILIARY_H
 
 /*** end of file ***/
\ No newline at end of file
@@ -0,0 +1,17 @@
+/**
+ * @file    test_matrix_conv.h
+ * @brief   Header file for `test_matrix_conv.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_MATRIX_CONV_H
+#define TEST_MATRIX_CONV_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite matrix_conv_suite(void);
+
+#endif // TEST_MATRIX_CONV_H
+
+/*** end of file ***/
@@ -0,0 +1,17 @@
+/**
+ * @file    test_matrix_expr.h
+ * @brief   Header file for `test_matrix_expr.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_MATRIX_EXPR_H
+#define TEST_MATRIX_EXPR_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite matrix_expr_suite(void);
+
+#endif // TEST_MATRIX_EXPR_H
+
+/*** end of file ***/
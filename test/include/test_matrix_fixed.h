@@ -0,0 +1,17 @@
+/**
+ * @file    test_matrix_fixed.h
+ * @brief   Header file for `test_matrix_fixed.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_MATRIX_FIXED_H
+#define TEST_MATRIX_FIXED_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite matrix_fixed_suite(void);
+
+#endif // TEST_MATRIX_FIXED_H
+
+/*** end of file ***/
@@ -0,0 +1,17 @@
+/**
+ * @file    test_matrix_io.h
+ * @brief   Header file for `test_matrix_io.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_MATRIX_IO_H
+#define TEST_MATRIX_IO_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite matrix_io_suite(void);
+
+#endif // TEST_MATRIX_IO_H
+
+/*** end of file ***/
@@ -0,0 +1,17 @@
+/**
+ * @file    test_matrix_map.h
+ * @brief   Header file for `test_matrix_map.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_MATRIX_MAP_H
+#define TEST_MATRIX_MAP_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite matrix_map_suite(void);
+
+#endif // TEST_MATRIX_MAP_H
+
+/*** end of file ***/
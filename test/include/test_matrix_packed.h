@@ -0,0 +1,17 @@
+/**
+ * @file    test_matrix_packed.h
+ * @brief   Header file for `test_matrix_packed.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_MATRIX_PACKED_H
+#define TEST_MATRIX_PACKED_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite matrix_packed_suite(void);
+
+#endif // TEST_MATRIX_PACKED_H
+
+/*** end of file ***/
@@ -0,0 +1,17 @@
+/**
+ * @file    test_matrix_reduce.h
+ * @brief   Header file for `test_matrix_reduce.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_MATRIX_REDUCE_H
+#define TEST_MATRIX_REDUCE_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite matrix_reduce_suite(void);
+
+#endif // TEST_MATRIX_REDUCE_H
+
+/*** end of file ***/
@@ -0,0 +1,17 @@
+/**
+ * @file    test_matrix_solve.h
+ * @brief   Header file for `test_matrix_solve.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_MATRIX_SOLVE_H
+#define TEST_MATRIX_SOLVE_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite matrix_solve_suite(void);
+
+#endif // TEST_MATRIX_SOLVE_H
+
+/*** end of file ***/
@@ -0,0 +1,17 @@
+/**
+ * @file    test_matrix_tiled.h
+ * @brief   Header file for `test_matrix_tiled.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_MATRIX_TILED_H
+#define TEST_MATRIX_TILED_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite matrix_tiled_suite(void);
+
+#endif // TEST_MATRIX_TILED_H
+
+/*** end of file ***/
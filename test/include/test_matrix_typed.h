@@ -0,0 +1,17 @@
+/**
+ * @file    test_matrix_typed.h
+ * @brief   Header file for `test_matrix_typed.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_MATRIX_TYPED_H
+#define TEST_MATRIX_TYPED_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite matrix_typed_suite(void);
+
+#endif // TEST_MATRIX_TYPED_H
+
+/*** end of file ***/
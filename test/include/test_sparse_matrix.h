@@ -0,0 +1,17 @@
+/**
+ * @file    test_sparse_matrix.h
+ * @brief   Header file for `test_sparse_matrix.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_SPARSE_MATRIX_H
+#define TEST_SPARSE_MATRIX_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite sparse_matrix_suite(void);
+
+#endif // TEST_SPARSE_MATRIX_H
+
+/*** end of file ***/
@@ -0,0 +1,17 @@
+/**
+ * @file    test_sparse_solve.h
+ * @brief   Header file for `test_sparse_solve.c`.
+ *
+ * @author  heapbadger
+ */
+
+#ifndef TEST_SPARSE_SOLVE_H
+#define TEST_SPARSE_SOLVE_H
+
+#include <CUnit/Basic.h>
+
+CU_pSuite sparse_solve_suite(void);
+
+#endif // TEST_SPARSE_SOLVE_H
+
+/*** end of file ***/
@@ -6,6 +6,7 @@
  */
 
 #include "test_auxiliary.h"
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -88,4 +89,55 @@ is_name_match (const char *p_str1, const char *p_str2)
     return b_name_matches && b_is_null_terminated;
 }
 
+void
+fill_pseudo_random (matrix_t *p_matrix, unsigned int seed)
+{
+    unsigned int state = seed;
+
+    for (size_t row = 0; row < p_matrix->rows; ++row)
+    {
+        for (size_t col = 0; col < p_matrix->cols; ++col)
+        {
+            state = (state * 1103515245U) + 12345U;
+            matrix_set(p_matrix,
+                       row,
+                       col,
+                       ((double)((state >> 8) % 2000U) / 1000.0) - 1.0);
+        }
+    }
+}
+
+void
+fill_with_index (matrix_t *p_matrix)
+{
+    for (size_t row = 0; row < p_matrix->rows; ++row)
+    {
+        for (size_t col = 0; col < p_matrix->cols; ++col)
+        {
+            matrix_set(p_matrix, row, col, (double)((row * 1000) + col));
+        }
+    }
+}
+
+double
+max_abs_diff (const matrix_t *p_a, const matrix_t *p_b)
+{
+    double max_err = 0.0;
+    double val_a   = 0.0;
+    double val_b   = 0.0;
+
+    for (size_t row = 0; row < p_a->rows; ++row)
+    {
+        for (size_t col = 0; col < p_a->cols; ++col)
+        {
+            matrix_get(p_a, row, col, &val_a);
+            matrix_get(p_b, row, col, &val_b);
+            double err = fabs(val_a - val_b);
+            max_err    = (err > max_err) ? err : max_err;
+        }
+    }
+
+    return max_err;
+}
+
 /*** end of file ***/
\ No newline at end of file
@@ -7,14 +7,30 @@
 
 #include "test_matrix.h"
 #include "matrix.h"
+#include "parallel.h"
 #include "test_auxiliary.h"
 #include <CUnit/Basic.h>
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 static void test_matrix_create_destroy(void);
 static void test_matrix_set_get(void);
 static void test_matrix_find_copy(void);
 static void test_matrix_arithmetic(void);
+static void test_matrix_transpose(void);
+static void test_matrix_multiply(void);
+static void test_matrix_gemm_ex(void);
+static void test_matrix_gemm_batched_strided(void);
+static void test_matrix_lu(void);
+static void test_matrix_view(void);
+static void test_matrix_gemv(void);
+static void test_matrix_aliasing(void);
+static void test_matrix_padding(void);
+static void test_matrix_resize(void);
+static void test_matrix_pow_chain(void);
+static void test_matrix_is_close(void);
 static void test_matrix_null_inputs(void);
 
 CU_pSuite
@@ -63,6 +79,101 @@ matrix_suite (void)
         goto CLEANUP;
     }
 
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_transpose", test_matrix_transpose)))
+    {
+        ERROR_LOG("Failed to add test_matrix_transpose to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_matrix_multiply", test_matrix_multiply)))
+    {
+        ERROR_LOG("Failed to add test_matrix_multiply to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_matrix_gemm_ex", test_matrix_gemm_ex)))
+    {
+        ERROR_LOG("Failed to add test_matrix_gemm_ex to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite,
+                        "test_matrix_gemm_batched_strided",
+                        test_matrix_gemm_batched_strided)))
+    {
+        ERROR_LOG("Failed to add test_matrix_gemm_batched_strided to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL == (CU_add_test(suite, "test_matrix_lu", test_matrix_lu)))
+    {
+        ERROR_LOG("Failed to add test_matrix_lu to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL == (CU_add_test(suite, "test_matrix_view", test_matrix_view)))
+    {
+        ERROR_LOG("Failed to add test_matrix_view to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL == (CU_add_test(suite, "test_matrix_gemv", test_matrix_gemv)))
+    {
+        ERROR_LOG("Failed to add test_matrix_gemv to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_matrix_aliasing", test_matrix_aliasing)))
+    {
+        ERROR_LOG("Failed to add test_matrix_aliasing to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_matrix_padding", test_matrix_padding)))
+    {
+        ERROR_LOG("Failed to add test_matrix_padding to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL == (CU_add_test(suite, "test_matrix_resize", test_matrix_resize)))
+    {
+        ERROR_LOG("Failed to add test_matrix_resize to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_matrix_pow_chain", test_matrix_pow_chain)))
+    {
+        ERROR_LOG("Failed to add test_matrix_pow_chain to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_matrix_is_close", test_matrix_is_close)))
+    {
+        ERROR_LOG("Failed to add test_matrix_is_close to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
     if (NULL
         == (CU_add_test(
             suite, "test_matrix_null_inputs", test_matrix_null_inputs)))
@@ -188,207 +299,1633 @@ test_matrix_find_copy (void)
 static void
 test_matrix_arithmetic (void)
 {
-    // // Dimensions for test matrices
-    // size_t rows = 3, cols = 3;
-
-    // // Create matrices for testing
-    // matrix_t *p_a      = matrix_create(rows, cols);
-    // matrix_t *p_b      = matrix_create(rows, cols);
-    // matrix_t *p_result = matrix_create(rows, cols);
-    // CU_ASSERT_PTR_NOT_NULL(p_a);
-    // CU_ASSERT_PTR_NOT_NULL(p_b);
-    // CU_ASSERT_PTR_NOT_NULL(p_result);
-
-    // // Initialize matrices p_a and p_b with some values
-    // for (size_t row = 0; row < rows; ++row)
-    // {
-    //     for (size_t col = 0; col < cols; ++col)
-    //     {
-    //         CU_ASSERT_EQUAL(matrix_set(p_a, row, col, (double)(row + col)),
-    //                         MATRIX_SUCCESS);
-    //         CU_ASSERT_EQUAL(matrix_set(p_b, row, col, (double)(row * col)),
-    //                         MATRIX_SUCCESS);
-    //     }
-    // }
-
-    // // Test Addition
-    // CU_ASSERT_EQUAL(matrix_add(p_a, p_b, p_result), MATRIX_SUCCESS);
-    // double val_a, val_b, val_r;
-
-    // for (size_t row = 0; row < rows; ++row)
-    // {
-    //     for (size_t col = 0; col < cols; ++col)
-    //     {
-    //         CU_ASSERT_EQUAL(matrix_get(p_a, row, col, &val_a),
-    //         MATRIX_SUCCESS); CU_ASSERT_EQUAL(matrix_get(p_b, row, col,
-    //         &val_b), MATRIX_SUCCESS); CU_ASSERT_EQUAL(matrix_get(p_result,
-    //         row, col, &val_r),
-    //                         MATRIX_SUCCESS);
-    //         CU_ASSERT_DOUBLE_EQUAL(val_r, val_a + val_b, 1e-9);
-    //     }
-    // }
-
-    // // Test Subtraction
-    // CU_ASSERT_EQUAL(matrix_subtract(p_a, p_b, p_result), MATRIX_SUCCESS);
-
-    // for (size_t row = 0; row < rows; ++row)
-    // {
-    //     for (size_t col = 0; col < cols; ++col)
-    //     {
-    //         CU_ASSERT_EQUAL(matrix_get(p_a, row, col, &val_a),
-    //         MATRIX_SUCCESS); CU_ASSERT_EQUAL(matrix_get(p_b, row, col,
-    //         &val_b), MATRIX_SUCCESS); CU_ASSERT_EQUAL(matrix_get(p_result,
-    //         row, col, &val_r),
-    //                         MATRIX_SUCCESS);
-    //         CU_ASSERT_DOUBLE_EQUAL(val_r, val_a - val_b, 1e-9);
-    //     }
-    // }
-
-    // // Test Scalar Multiplication
-    // double scalar = 2.5;
-    // CU_ASSERT_EQUAL(matrix_scalar_multiply(p_a, scalar, p_result),
-    //                 MATRIX_SUCCESS);
-
-    // for (size_t row = 0; row < rows; ++row)
-    // {
-    //     for (size_t col = 0; col < cols; ++col)
-    //     {
-    //         CU_ASSERT_EQUAL(matrix_get(p_a, row, col, &val_a),
-    //         MATRIX_SUCCESS); CU_ASSERT_EQUAL(matrix_get(p_result, row, col,
-    //         &val_r),
-    //                         MATRIX_SUCCESS);
-    //         CU_ASSERT_DOUBLE_EQUAL(val_r, val_a * scalar, 1e-9);
-    //     }
-    // }
-
-    // // Test Transpose
-    // matrix_t *p_transpose = matrix_create(cols, rows);
-    // CU_ASSERT_PTR_NOT_NULL(p_transpose);
-    // CU_ASSERT_EQUAL(matrix_transpose(p_a, p_transpose), MATRIX_SUCCESS);
-
-    // for (size_t row = 0; row < rows; ++row)
-    // {
-    //     for (size_t col = 0; col < cols; ++col)
-    //     {
-    //         CU_ASSERT_EQUAL(matrix_get(p_a, row, col, &val_a),
-    //         MATRIX_SUCCESS); CU_ASSERT_EQUAL(matrix_get(p_transpose, col,
-    //         row, &val_r),
-    //                         MATRIX_SUCCESS);
-    //         CU_ASSERT_DOUBLE_EQUAL(val_r, val_a, 1e-9);
-    //     }
-    // }
-    // matrix_destroy(p_transpose);
-
-    // // Test Multiplication
-    // // For multiplication, use 3x2 and 2x3 matrices
-    // matrix_t *p_mul_a      = matrix_create(3, 2);
-    // matrix_t *p_mul_b      = matrix_create(2, 3);
-    // matrix_t *p_mul_result = matrix_create(3, 3);
-    // CU_ASSERT_PTR_NOT_NULL(p_mul_a);
-    // CU_ASSERT_PTR_NOT_NULL(p_mul_b);
-    // CU_ASSERT_PTR_NOT_NULL(p_mul_result);
-
-    // // Initialize p_mul_a
-    // double mul_a_vals[3][2] = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
-
-    // for (size_t row = 0; row < 3; ++row)
-    // {
-    //     for (size_t col = 0; col < 2; ++col)
-    //     {
-    //         CU_ASSERT_EQUAL(matrix_set(p_mul_a, row, col,
-    //         mul_a_vals[row][col]),
-    //                         MATRIX_SUCCESS);
-    //     }
-    // }
-
-    // // Initialize p_mul_b
-    // double mul_b_vals[2][3] = { { 7, 8, 9 }, { 10, 11, 12 } };
-
-    // for (size_t row = 0; row < 2; ++row)
-    // {
-    //     for (size_t col = 0; col < 3; ++col)
-    //     {
-    //         CU_ASSERT_EQUAL(matrix_set(p_mul_b, row, col,
-    //         mul_b_vals[row][col]),
-    //                         MATRIX_SUCCESS);
-    //     }
-    // }
-
-    // // Multiply p_mul_a * p_mul_b -> p_mul_result
-    // CU_ASSERT_EQUAL(matrix_multiply(p_mul_a, p_mul_b, p_mul_result),
-    //                 MATRIX_SUCCESS);
-
-    // // Expected multiplication result
-    // double expected_mul[3][3]
-    //     = { { 27, 30, 33 }, { 61, 68, 75 }, { 95, 106, 117 } };
-
-    // for (size_t row = 0; row < 3; ++row)
-    // {
-    //     for (size_t col = 0; col < 3; ++col)
-    //     {
-    //         CU_ASSERT_EQUAL(matrix_get(p_mul_result, row, col, &val_r),
-    //                         MATRIX_SUCCESS);
-    //         CU_ASSERT_DOUBLE_EQUAL(val_r, expected_mul[row][col], 1e-9);
-    //     }
-    // }
-
-    // matrix_destroy(p_mul_a);
-    // matrix_destroy(p_mul_b);
-    // matrix_destroy(p_mul_result);
-
-    // // Test Determinant (3x3)
-    // double det = 0.0;
-    // CU_ASSERT_EQUAL(matrix_determinant(p_a, &det), MATRIX_SUCCESS);
-
-    // // Manually compute determinant of p_a (which is filled with r+c)
-    // // For matrix:
-    // // 0 1 2
-    // // 1 2 3
-    // // 2 3 4
-    // // det = 0*(2*4 - 3*3) - 1*(1*4 - 3*2) + 2*(1*3 - 2*2)
-    // // det = 0 - 1*(4 - 6) + 2*(3 - 4)
-    // // det = 0 - 1*(-2) + 2*(-1) = 2 - 2 = 0
-    // CU_ASSERT_DOUBLE_EQUAL(det, 0.0, 1e-9);
-
-    // // Test Inverse (should fail since determinant is 0)
-    // matrix_t *p_inv = matrix_create(rows, cols);
-    // CU_ASSERT_PTR_NOT_NULL(p_inv);
-    // CU_ASSERT_NOT_EQUAL(matrix_inverse(p_a, p_inv), MATRIX_SUCCESS);
-
-    // // Modify p_a to identity matrix for invertible test
-    // matrix_fill(p_a, 0.0);
-
-    // for (size_t idx = 0; idx < rows; ++idx)
-    // {
-    //     CU_ASSERT_EQUAL(matrix_set(p_a, idx, idx, 1.0), MATRIX_SUCCESS);
-    // }
-
-    // CU_ASSERT_EQUAL(matrix_inverse(p_a, p_inv), MATRIX_SUCCESS);
-    // // Inverse of identity is identity, verify
-    // for (size_t row = 0; row < rows; ++row)
-    // {
-    //     for (size_t col = 0; col < cols; ++col)
-    //     {
-    //         CU_ASSERT_EQUAL(matrix_get(p_inv, row, col, &val_r),
-    //                         MATRIX_SUCCESS);
-    //         if (row == col)
-    //         {
-    //             CU_ASSERT_DOUBLE_EQUAL(val_r, 1.0, 1e-9);
-    //         }
-    //         else
-    //         {
-    //             CU_ASSERT_DOUBLE_EQUAL(val_r, 0.0, 1e-9);
-    //         }
-    //     }
-    // }
-
-    // matrix_destroy(p_inv);
-    // matrix_destroy(p_a);
-    // matrix_destroy(p_b);
-    // matrix_destroy(p_result);
+    // Dimensions for test matrices
+    size_t rows = 3;
+    size_t cols = 3;
+
+    // Create matrices for testing
+    matrix_t *p_a      = matrix_create(rows, cols);
+    matrix_t *p_b      = matrix_create(rows, cols);
+    matrix_t *p_result = matrix_create(rows, cols);
+    CU_ASSERT_PTR_NOT_NULL(p_a);
+    CU_ASSERT_PTR_NOT_NULL(p_b);
+    CU_ASSERT_PTR_NOT_NULL(p_result);
+
+    // Initialize matrices p_a and p_b with some values
+    for (size_t row = 0; row < rows; ++row)
+    {
+        for (size_t col = 0; col < cols; ++col)
+        {
+            CU_ASSERT_EQUAL(matrix_set(p_a, row, col, (double)(row + col)),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_EQUAL(matrix_set(p_b, row, col, (double)(row * col)),
+                            MATRIX_SUCCESS);
+        }
+    }
+
+    // Test Addition
+    CU_ASSERT_EQUAL(matrix_add(p_a, p_b, p_result), MATRIX_SUCCESS);
+    double val_a = 0.0;
+    double val_b = 0.0;
+    double val_r = 0.0;
+
+    for (size_t row = 0; row < rows; ++row)
+    {
+        for (size_t col = 0; col < cols; ++col)
+        {
+            CU_ASSERT_EQUAL(matrix_get(p_a, row, col, &val_a),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_EQUAL(matrix_get(p_b, row, col, &val_b),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_EQUAL(matrix_get(p_result, row, col, &val_r),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_DOUBLE_EQUAL(val_r, val_a + val_b, 1e-9);
+        }
+    }
+
+    // Test Subtraction
+    CU_ASSERT_EQUAL(matrix_subtract(p_a, p_b, p_result), MATRIX_SUCCESS);
+
+    for (size_t row = 0; row < rows; ++row)
+    {
+        for (size_t col = 0; col < cols; ++col)
+        {
+            CU_ASSERT_EQUAL(matrix_get(p_a, row, col, &val_a),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_EQUAL(matrix_get(p_b, row, col, &val_b),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_EQUAL(matrix_get(p_result, row, col, &val_r),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_DOUBLE_EQUAL(val_r, val_a - val_b, 1e-9);
+        }
+    }
+
+    // Test Scalar Multiplication
+    double scalar = 2.5;
+    CU_ASSERT_EQUAL(matrix_scalar_multiply(p_a, scalar, p_result),
+                    MATRIX_SUCCESS);
+
+    for (size_t row = 0; row < rows; ++row)
+    {
+        for (size_t col = 0; col < cols; ++col)
+        {
+            CU_ASSERT_EQUAL(matrix_get(p_a, row, col, &val_a),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_EQUAL(matrix_get(p_result, row, col, &val_r),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_DOUBLE_EQUAL(val_r, val_a * scalar, 1e-9);
+        }
+    }
+
+    // Test Transpose
+    matrix_t *p_transpose = matrix_create(cols, rows);
+    CU_ASSERT_PTR_NOT_NULL(p_transpose);
+    CU_ASSERT_EQUAL(matrix_transpose(p_a, p_transpose), MATRIX_SUCCESS);
+
+    for (size_t row = 0; row < rows; ++row)
+    {
+        for (size_t col = 0; col < cols; ++col)
+        {
+            CU_ASSERT_EQUAL(matrix_get(p_a, row, col, &val_a),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_EQUAL(matrix_get(p_transpose, col, row, &val_r),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_DOUBLE_EQUAL(val_r, val_a, 1e-9);
+        }
+    }
+
+    matrix_destroy(p_transpose);
+
+    // Test Multiplication
+    // For multiplication, use 3x2 and 2x3 matrices
+    matrix_t *p_mul_a      = matrix_create(3, 2);
+    matrix_t *p_mul_b      = matrix_create(2, 3);
+    matrix_t *p_mul_result = matrix_create(3, 3);
+    CU_ASSERT_PTR_NOT_NULL(p_mul_a);
+    CU_ASSERT_PTR_NOT_NULL(p_mul_b);
+    CU_ASSERT_PTR_NOT_NULL(p_mul_result);
+
+    // Initialize p_mul_a
+    double mul_a_vals[3][2] = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
+
+    for (size_t row = 0; row < 3; ++row)
+    {
+        for (size_t col = 0; col < 2; ++col)
+        {
+            CU_ASSERT_EQUAL(
+                matrix_set(p_mul_a, row, col, mul_a_vals[row][col]),
+                MATRIX_SUCCESS);
+        }
+    }
+
+    // Initialize p_mul_b
+    double mul_b_vals[2][3] = { { 7, 8, 9 }, { 10, 11, 12 } };
+
+    for (size_t row = 0; row < 2; ++row)
+    {
+        for (size_t col = 0; col < 3; ++col)
+        {
+            CU_ASSERT_EQUAL(
+                matrix_set(p_mul_b, row, col, mul_b_vals[row][col]),
+                MATRIX_SUCCESS);
+        }
+    }
+
+    // Multiply p_mul_a * p_mul_b -> p_mul_result
+    CU_ASSERT_EQUAL(matrix_multiply(p_mul_a, p_mul_b, p_mul_result),
+                    MATRIX_SUCCESS);
+
+    // Expected multiplication result
+    double expected_mul[3][3]
+        = { { 27, 30, 33 }, { 61, 68, 75 }, { 95, 106, 117 } };
+
+    for (size_t row = 0; row < 3; ++row)
+    {
+        for (size_t col = 0; col < 3; ++col)
+        {
+            CU_ASSERT_EQUAL(matrix_get(p_mul_result, row, col, &val_r),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_DOUBLE_EQUAL(val_r, expected_mul[row][col], 1e-9);
+        }
+    }
+
+    matrix_destroy(p_mul_a);
+    matrix_destroy(p_mul_b);
+    matrix_destroy(p_mul_result);
+
+    // Test Determinant (3x3)
+    double det = 0.0;
+    CU_ASSERT_EQUAL(matrix_determinant(p_a, &det), MATRIX_SUCCESS);
+
+    // Manually compute determinant of p_a (which is filled with r+c)
+    // For matrix:
+    // 0 1 2
+    // 1 2 3
+    // 2 3 4
+    // det = 0*(2*4 - 3*3) - 1*(1*4 - 3*2) + 2*(1*3 - 2*2)
+    // det = 0 - 1*(4 - 6) + 2*(3 - 4)
+    // det = 0 - 1*(-2) + 2*(-1) = 2 - 2 = 0
+    CU_ASSERT_DOUBLE_EQUAL(det, 0.0, 1e-9);
+
+    // Test Inverse (should fail since determinant is 0)
+    matrix_t *p_inv = matrix_create(rows, cols);
+    CU_ASSERT_PTR_NOT_NULL(p_inv);
+    CU_ASSERT_NOT_EQUAL(matrix_inverse(p_a, p_inv), MATRIX_SUCCESS);
+
+    // Modify p_a to identity matrix for invertible test
+    matrix_fill(p_a, 0.0);
+
+    for (size_t idx = 0; idx < rows; ++idx)
+    {
+        CU_ASSERT_EQUAL(matrix_set(p_a, idx, idx, 1.0), MATRIX_SUCCESS);
+    }
+
+    CU_ASSERT_EQUAL(matrix_inverse(p_a, p_inv), MATRIX_SUCCESS);
+
+    // Inverse of identity is identity, verify
+    for (size_t row = 0; row < rows; ++row)
+    {
+        for (size_t col = 0; col < cols; ++col)
+        {
+            CU_ASSERT_EQUAL(matrix_get(p_inv, row, col, &val_r),
+                            MATRIX_SUCCESS);
+
+            if (row == col)
+            {
+                CU_ASSERT_DOUBLE_EQUAL(val_r, 1.0, 1e-9);
+            }
+            else
+            {
+                CU_ASSERT_DOUBLE_EQUAL(val_r, 0.0, 1e-9);
+            }
+        }
+    }
+
+    matrix_destroy(p_inv);
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    matrix_destroy(p_result);
+    return;
+}
+
+/**
+ * @brief   Check that p_trans holds the transpose of an index-filled matrix.
+ */
+static bool
+is_index_transpose (const matrix_t *p_trans)
+{
+    double val = 0.0;
+
+    for (size_t row = 0; row < p_trans->rows; ++row)
+    {
+        for (size_t col = 0; col < p_trans->cols; ++col)
+        {
+            matrix_get(p_trans, row, col, &val);
+
+            if (val != (double)((col * 1000) + row))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void
+test_matrix_transpose (void)
+{
+    // Shapes covering single tiles, ragged edges and recursive splits
+    size_t shapes[][2] = { { 1, 1 },   { 3, 5 },   { 4, 4 },
+                           { 8, 12 },  { 33, 7 },  { 70, 45 },
+                           { 64, 64 }, { 130, 3 } };
+
+    for (size_t idx = 0; idx < sizeof(shapes) / sizeof(shapes[0]); ++idx)
+    {
+        matrix_t *p_src = matrix_create(shapes[idx][0], shapes[idx][1]);
+        matrix_t *p_dst = matrix_create(shapes[idx][1], shapes[idx][0]);
+        CU_ASSERT_PTR_NOT_NULL(p_src);
+        CU_ASSERT_PTR_NOT_NULL(p_dst);
+        fill_with_index(p_src);
+
+        CU_ASSERT_EQUAL(matrix_transpose(p_src, p_dst), MATRIX_SUCCESS);
+        CU_ASSERT_TRUE(is_index_transpose(p_dst));
+
+        // In place: square tiles or cycle following, dims swap
+        CU_ASSERT_EQUAL(matrix_transpose_inplace(p_src), MATRIX_SUCCESS);
+        CU_ASSERT_EQUAL(p_src->rows, shapes[idx][1]);
+        CU_ASSERT_EQUAL(p_src->cols, shapes[idx][0]);
+        CU_ASSERT_TRUE(matrix_is_equal(p_src, p_dst));
+
+        matrix_destroy(p_src);
+        matrix_destroy(p_dst);
+    }
+
+    // Square odd-sized matrix transposed onto itself
+    matrix_t *p_square = matrix_create(67, 67);
+    fill_with_index(p_square);
+    CU_ASSERT_EQUAL(matrix_transpose(p_square, p_square), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(is_index_transpose(p_square));
+    matrix_destroy(p_square);
+
+    // Result dimensions must be swapped
+    matrix_t *p_a = matrix_create(2, 3);
+    matrix_t *p_b = matrix_create(2, 3);
+    CU_ASSERT_EQUAL(matrix_transpose(p_a, p_b), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_transpose(NULL, p_b), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_transpose_inplace(NULL), MATRIX_INVALID_ARGUMENT);
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    return;
+}
+
+/**
+ * @brief   Largest absolute difference between A * B and p_result.
+ */
+static double
+max_product_error (const matrix_t *p_a,
+                   const matrix_t *p_b,
+                   const matrix_t *p_result)
+{
+    double max_err = 0.0;
+    double val_a   = 0.0;
+    double val_b   = 0.0;
+    double val_r   = 0.0;
+
+    for (size_t row = 0; row < p_a->rows; ++row)
+    {
+        for (size_t col = 0; col < p_b->cols; ++col)
+        {
+            double expected = 0.0;
+
+            for (size_t idx = 0; idx < p_a->cols; ++idx)
+            {
+                matrix_get(p_a, row, idx, &val_a);
+                matrix_get(p_b, idx, col, &val_b);
+                expected += val_a * val_b;
+            }
+
+            matrix_get(p_result, row, col, &val_r);
+            double err = fabs(expected - val_r);
+            max_err    = (err > max_err) ? err : max_err;
+        }
+    }
+
+    return max_err;
+}
+
+static void
+test_matrix_multiply (void)
+{
+    // Shapes covering micro-kernel edges and every cache blocking loop
+    size_t shapes[][3] = { { 1, 1, 1 },   { 3, 2, 3 },   { 5, 7, 9 },
+                           { 33, 17, 65 }, { 130, 300, 50 } };
+
+    for (size_t idx = 0; idx < sizeof(shapes) / sizeof(shapes[0]); ++idx)
+    {
+        matrix_t *p_a = matrix_create(shapes[idx][0], shapes[idx][1]);
+        matrix_t *p_b = matrix_create(shapes[idx][1], shapes[idx][2]);
+        matrix_t *p_c = matrix_create(shapes[idx][0], shapes[idx][2]);
+        fill_pseudo_random(p_a, 1U + idx);
+        fill_pseudo_random(p_b, 100U + idx);
+        matrix_fill(p_c, 42.0);
+
+        CU_ASSERT_EQUAL(matrix_multiply(p_a, p_b, p_c), MATRIX_SUCCESS);
+        CU_ASSERT_DOUBLE_EQUAL(max_product_error(p_a, p_b, p_c), 0.0, 1e-9);
+
+        matrix_destroy(p_a);
+        matrix_destroy(p_b);
+        matrix_destroy(p_c);
+    }
+
+    // Known product
+    double    vals_a[3][2] = { { 1, 2 }, { 3, 4 }, { 5, 6 } };
+    double    vals_b[2][3] = { { 7, 8, 9 }, { 10, 11, 12 } };
+    double    expected[3][3]
+        = { { 27, 30, 33 }, { 61, 68, 75 }, { 95, 106, 117 } };
+    matrix_t *p_a = matrix_create(3, 2);
+    matrix_t *p_b = matrix_create(2, 3);
+    matrix_t *p_c = matrix_create(3, 3);
+
+    for (size_t row = 0; row < 3; ++row)
+    {
+        for (size_t col = 0; col < 2; ++col)
+        {
+            matrix_set(p_a, row, col, vals_a[row][col]);
+            matrix_set(p_b, col, row, vals_b[col][row]);
+        }
+    }
+
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_b, p_c), MATRIX_SUCCESS);
+    double val = 0.0;
+
+    for (size_t row = 0; row < 3; ++row)
+    {
+        for (size_t col = 0; col < 3; ++col)
+        {
+            CU_ASSERT_EQUAL(matrix_get(p_c, row, col, &val), MATRIX_SUCCESS);
+            CU_ASSERT_DOUBLE_EQUAL(val, expected[row][col], 1e-12);
+        }
+    }
+
+    // Mismatched inner dimensions
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_a, p_c), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_multiply(NULL, p_b, p_c), MATRIX_INVALID_ARGUMENT);
+
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    matrix_destroy(p_c);
     return;
 }
 
+static void
+test_matrix_gemm_ex (void)
+{
+    // Inner dimensions past MATRIX_GEMM_KC and MATRIX_GEMM_MC, with edges
+    size_t shapes[][3] = { { 5, 7, 9 }, { 37, 29, 41 }, { 140, 300, 21 } };
+
+    for (size_t idx = 0; idx < sizeof(shapes) / sizeof(shapes[0]); ++idx)
+    {
+        size_t    m     = shapes[idx][0];
+        size_t    k     = shapes[idx][1];
+        size_t    n     = shapes[idx][2];
+        matrix_t *p_a   = matrix_create(m, k);
+        matrix_t *p_b   = matrix_create(k, n);
+        matrix_t *p_at  = matrix_create(k, m);
+        matrix_t *p_bt  = matrix_create(n, k);
+        matrix_t *p_ref = matrix_create(m, n);
+        matrix_t *p_c   = matrix_create(m, n);
+        matrix_t *p_ct  = matrix_create(n, m);
+        fill_pseudo_random(p_a, 3U + idx);
+        fill_pseudo_random(p_b, 30U + idx);
+        matrix_transpose(p_a, p_at);
+        matrix_transpose(p_b, p_bt);
+        matrix_multiply(p_a, p_b, p_ref);
+
+        for (int op = 0; op < 4; ++op)
+        {
+            matrix_op_t     op_a  = (matrix_op_t)(op & 1);
+            matrix_op_t     op_b  = (matrix_op_t)(op >> 1);
+            const matrix_t *p_lhs = (op & 1) ? p_at : p_a;
+            const matrix_t *p_rhs = (op >> 1) ? p_bt : p_b;
+
+            CU_ASSERT_EQUAL(matrix_multiply_ex(p_lhs, op_a, p_rhs, op_b, p_c),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_TRUE(matrix_is_close(p_c, p_ref, 1e-12, 1e-12));
+
+            // alpha and beta: C = 2 * op(A) * op(B) - C = op(A) * op(B)
+            CU_ASSERT_EQUAL(matrix_gemm_ex(MATRIX_LAYOUT_ROW_MAJOR,
+                                           op_a,
+                                           op_b,
+                                           m,
+                                           n,
+                                           k,
+                                           2.0,
+                                           p_lhs->p_data,
+                                           p_lhs->ld,
+                                           p_rhs->p_data,
+                                           p_rhs->ld,
+                                           -1.0,
+                                           p_c->p_data,
+                                           p_c->ld),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_TRUE(matrix_is_close(p_c, p_ref, 1e-12, 1e-12));
+
+            // The row-major buffer of X^T is the column-major buffer of X,
+            // so the transposed operands give C^T in column-major order
+            CU_ASSERT_EQUAL(matrix_gemm_ex(MATRIX_LAYOUT_COL_MAJOR,
+                                           op_a,
+                                           op_b,
+                                           m,
+                                           n,
+                                           k,
+                                           1.0,
+                                           ((op & 1) ? p_a : p_at)->p_data,
+                                           ((op & 1) ? p_a : p_at)->ld,
+                                           ((op >> 1) ? p_b : p_bt)->p_data,
+                                           ((op >> 1) ? p_b : p_bt)->ld,
+                                           0.0,
+                                           p_ct->p_data,
+                                           p_ct->ld),
+                            MATRIX_SUCCESS);
+            matrix_transpose(p_ct, p_c);
+            CU_ASSERT_TRUE(matrix_is_close(p_c, p_ref, 1e-12, 1e-12));
+        }
+
+        matrix_destroy(p_a);
+        matrix_destroy(p_b);
+        matrix_destroy(p_at);
+        matrix_destroy(p_bt);
+        matrix_destroy(p_ref);
+        matrix_destroy(p_c);
+        matrix_destroy(p_ct);
+    }
+
+    // A^T * A in place of A goes through workspace
+    matrix_t *p_a   = matrix_create(24, 24);
+    matrix_t *p_at  = matrix_create(24, 24);
+    matrix_t *p_ref = matrix_create(24, 24);
+    fill_pseudo_random(p_a, 77U);
+    matrix_transpose(p_a, p_at);
+    matrix_multiply(p_at, p_a, p_ref);
+    CU_ASSERT_EQUAL(
+        matrix_multiply_ex(p_a, MATRIX_OP_TRANSPOSE, p_a, MATRIX_OP_NONE, p_a),
+        MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_close(p_a, p_ref, 1e-12, 1e-12));
+
+    // Shapes, leading dimensions and flags are checked against the ops
+    matrix_t *p_wide = matrix_create(3, 5);
+    matrix_t *p_c    = matrix_create(5, 5);
+    CU_ASSERT_EQUAL(matrix_multiply_ex(p_wide,
+                                       MATRIX_OP_TRANSPOSE,
+                                       p_wide,
+                                       MATRIX_OP_NONE,
+                                       p_c),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(
+        matrix_multiply_ex(p_wide, MATRIX_OP_NONE, p_wide, MATRIX_OP_NONE, p_c),
+        MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_multiply_ex(p_wide,
+                                       MATRIX_OP_TRANSPOSE,
+                                       p_wide,
+                                       MATRIX_OP_TRANSPOSE,
+                                       p_c),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(
+        matrix_multiply_ex(p_wide, (matrix_op_t)5, p_wide, MATRIX_OP_NONE, p_c),
+        MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_gemm_ex(MATRIX_LAYOUT_ROW_MAJOR,
+                                   MATRIX_OP_TRANSPOSE,
+                                   MATRIX_OP_NONE,
+                                   5,
+                                   5,
+                                   3,
+                                   1.0,
+                                   p_wide->p_data,
+                                   4,
+                                   p_wide->p_data,
+                                   5,
+                                   0.0,
+                                   p_c->p_data,
+                                   5),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_gemm_ex((matrix_layout_t)2,
+                                   MATRIX_OP_NONE,
+                                   MATRIX_OP_NONE,
+                                   1,
+                                   1,
+                                   1,
+                                   1.0,
+                                   p_wide->p_data,
+                                   1,
+                                   p_wide->p_data,
+                                   1,
+                                   0.0,
+                                   p_c->p_data,
+                                   1),
+                    MATRIX_INVALID_ARGUMENT);
+
+    matrix_destroy(p_a);
+    matrix_destroy(p_at);
+    matrix_destroy(p_ref);
+    matrix_destroy(p_wide);
+    matrix_destroy(p_c);
+}
+
+static void
+test_matrix_gemm_batched_strided (void)
+{
+    // Many small products across threads, and few tall ones split into row
+    // bands; every product must match a lone matrix_gemm_ex bit for bit
+    size_t shapes[][4] = { { 64, 24, 20, 28 }, { 3, 300, 19, 33 } };
+
+    parallel_set_threads(4);
+
+    for (size_t idx = 0; idx < sizeof(shapes) / sizeof(shapes[0]); ++idx)
+    {
+        size_t batch = shapes[idx][0];
+        size_t m     = shapes[idx][1];
+        size_t n     = shapes[idx][2];
+        size_t k     = shapes[idx][3];
+
+        // Each operand sits in a padded dim x dim block of one buffer, which
+        // fits it in either layout and with either op
+        size_t    dim   = (m > n) ? m : n;
+        dim             = (dim > k) ? dim : k;
+        matrix_t *p_a   = matrix_create(batch * dim, dim + 3U);
+        matrix_t *p_b   = matrix_create(batch * dim, dim + 3U);
+        matrix_t *p_c   = matrix_create(batch * dim, dim + 3U);
+        matrix_t *p_ref = matrix_create(batch * dim, dim + 3U);
+        fill_pseudo_random(p_a, 5U + idx);
+        fill_pseudo_random(p_b, 50U + idx);
+        fill_pseudo_random(p_c, 500U + idx);
+        matrix_copy_into(p_ref, p_c);
+
+        for (int op = 0; op < 4; ++op)
+        {
+            matrix_op_t     op_a   = (matrix_op_t)(op & 1);
+            matrix_op_t     op_b   = (matrix_op_t)(op >> 1);
+            matrix_layout_t layout = (matrix_layout_t)((op >> 1) ^ (op & 1));
+
+            // Odd ops share one B across the batch
+            size_t stride   = dim * p_a->ld;
+            size_t stride_b = (op & 1) ? 0U : stride;
+
+            for (size_t item = 0U; item < batch; ++item)
+            {
+                CU_ASSERT_EQUAL(matrix_gemm_ex(layout,
+                                               op_a,
+                                               op_b,
+                                               m,
+                                               n,
+                                               k,
+                                               0.5,
+                                               p_a->p_data + (item * stride),
+                                               p_a->ld,
+                                               p_b->p_data + (item * stride_b),
+                                               p_b->ld,
+                                               -2.0,
+                                               p_ref->p_data + (item * stride),
+                                               p_ref->ld),
+                                MATRIX_SUCCESS);
+            }
+
+            CU_ASSERT_EQUAL(matrix_gemm_batched_strided(layout,
+                                                        op_a,
+                                                        op_b,
+                                                        m,
+                                                        n,
+                                                        k,
+                                                        0.5,
+                                                        p_a->p_data,
+                                                        p_a->ld,
+                                                        stride,
+                                                        p_b->p_data,
+                                                        p_b->ld,
+                                                        stride_b,
+                                                        -2.0,
+                                                        p_c->p_data,
+                                                        p_c->ld,
+                                                        stride,
+                                                        batch),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_TRUE(matrix_is_equal(p_c, p_ref));
+        }
+
+        matrix_destroy(p_a);
+        matrix_destroy(p_b);
+        matrix_destroy(p_c);
+        matrix_destroy(p_ref);
+    }
+
+    parallel_set_threads(0);
+
+    // Overlapping outputs and bad flags are rejected; no products is a no-op
+    double data[16] = { 0 };
+    CU_ASSERT_EQUAL(matrix_gemm_batched_strided(MATRIX_LAYOUT_ROW_MAJOR,
+                                                MATRIX_OP_NONE,
+                                                MATRIX_OP_NONE,
+                                                2,
+                                                2,
+                                                2,
+                                                1.0,
+                                                data,
+                                                2,
+                                                4,
+                                                data,
+                                                2,
+                                                4,
+                                                0.0,
+                                                data + 8,
+                                                2,
+                                                3,
+                                                2),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_gemm_batched_strided(MATRIX_LAYOUT_ROW_MAJOR,
+                                                (matrix_op_t)2,
+                                                MATRIX_OP_NONE,
+                                                2,
+                                                2,
+                                                2,
+                                                1.0,
+                                                data,
+                                                2,
+                                                4,
+                                                data,
+                                                2,
+                                                4,
+                                                0.0,
+                                                data + 8,
+                                                2,
+                                                4,
+                                                2),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_gemm_batched_strided(MATRIX_LAYOUT_ROW_MAJOR,
+                                                MATRIX_OP_NONE,
+                                                MATRIX_OP_NONE,
+                                                2,
+                                                2,
+                                                2,
+                                                1.0,
+                                                NULL,
+                                                2,
+                                                4,
+                                                NULL,
+                                                2,
+                                                4,
+                                                0.0,
+                                                NULL,
+                                                2,
+                                                4,
+                                                0),
+                    MATRIX_SUCCESS);
+}
+
+static void
+test_matrix_lu (void)
+{
+    // Singular matrix filled with row + col
+    matrix_t *p_sing = matrix_create(3, 3);
+    matrix_t *p_inv  = matrix_create(3, 3);
+    double    det    = 1.0;
+
+    for (size_t row = 0; row < 3; ++row)
+    {
+        for (size_t col = 0; col < 3; ++col)
+        {
+            matrix_set(p_sing, row, col, (double)(row + col));
+        }
+    }
+
+    CU_ASSERT_EQUAL(matrix_determinant(p_sing, &det), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(det, 0.0, 1e-12);
+    CU_ASSERT_EQUAL(matrix_inverse(p_sing, p_inv), MATRIX_SINGULAR);
+
+    // Known determinant with a required pivot
+    double vals[3][3] = { { 0, 2, 1 }, { 1, 1, 0 }, { 3, 0, 4 } };
+
+    for (size_t row = 0; row < 3; ++row)
+    {
+        for (size_t col = 0; col < 3; ++col)
+        {
+            matrix_set(p_sing, row, col, vals[row][col]);
+        }
+    }
+
+    CU_ASSERT_EQUAL(matrix_determinant(p_sing, &det), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(det, -11.0, 1e-12);
+    matrix_destroy(p_sing);
+    matrix_destroy(p_inv);
+
+    // Larger than one LU panel so the GEMM trailing update is exercised
+    size_t    n       = 150;
+    matrix_t *p_a     = matrix_create(n, n);
+    matrix_t *p_lu    = matrix_create(n, n);
+    matrix_t *p_prod  = matrix_create(n, n);
+    size_t   *p_pivot = calloc(n, sizeof(size_t));
+    p_inv             = matrix_create(n, n);
+    fill_pseudo_random(p_a, 7U);
+
+    CU_ASSERT_EQUAL(matrix_inverse(p_a, p_inv), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_inv, p_prod), MATRIX_SUCCESS);
+
+    double max_err = 0.0;
+    double val     = 0.0;
+
+    for (size_t row = 0; row < n; ++row)
+    {
+        for (size_t col = 0; col < n; ++col)
+        {
+            matrix_get(p_prod, row, col, &val);
+            double err = fabs(val - ((row == col) ? 1.0 : 0.0));
+            max_err    = (err > max_err) ? err : max_err;
+        }
+    }
+
+    CU_ASSERT_DOUBLE_EQUAL(max_err, 0.0, 1e-8);
+
+    // Reuse one factorization for several right-hand sides
+    matrix_t *p_x  = matrix_create(n, 3);
+    matrix_t *p_b  = matrix_create(n, 3);
+    int       sign = 0;
+    fill_pseudo_random(p_x, 11U);
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_x, p_b), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_lu(p_a, p_lu, p_pivot, &sign), MATRIX_SUCCESS);
+    CU_ASSERT(1 == abs(sign));
+    CU_ASSERT_EQUAL(matrix_lu_solve(p_lu, p_pivot, p_b, p_b), MATRIX_SUCCESS);
+
+    max_err = 0.0;
+
+    for (size_t row = 0; row < n; ++row)
+    {
+        for (size_t col = 0; col < 3; ++col)
+        {
+            double expected = 0.0;
+            matrix_get(p_x, row, col, &expected);
+            matrix_get(p_b, row, col, &val);
+            double err = fabs(val - expected);
+            max_err    = (err > max_err) ? err : max_err;
+        }
+    }
+
+    CU_ASSERT_DOUBLE_EQUAL(max_err, 0.0, 1e-8);
+
+    // Determinant overflows a double, the log-determinant does not
+    matrix_fill(p_a, 0.0);
+
+    for (size_t idx = 0; idx < n; ++idx)
+    {
+        matrix_set(p_a, idx, idx, (0 == idx) ? -1e10 : 1e10);
+    }
+
+    double log_abs = 0.0;
+    CU_ASSERT_EQUAL(matrix_log_determinant(p_a, &log_abs, &sign),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(log_abs, (double)n * log(1e10), 1e-6);
+    CU_ASSERT_EQUAL(sign, -1);
+
+    // Non-square input
+    matrix_t *p_rect = matrix_create(2, 3);
+    CU_ASSERT_EQUAL(matrix_determinant(p_rect, &det), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_lu(p_rect, p_rect, p_pivot, NULL),
+                    MATRIX_INVALID_ARGUMENT);
+
+    matrix_destroy(p_rect);
+    matrix_destroy(p_a);
+    matrix_destroy(p_lu);
+    matrix_destroy(p_prod);
+    matrix_destroy(p_inv);
+    matrix_destroy(p_x);
+    matrix_destroy(p_b);
+    free(p_pivot);
+    return;
+}
+
+static void
+test_matrix_view (void)
+{
+    matrix_t *p_parent = matrix_create(10, 12);
+    matrix_t  view     = { 0 };
+    matrix_t  inner    = { 0 };
+    double    val      = 0.0;
+    size_t    row      = 0;
+    size_t    col      = 0;
+    fill_with_index(p_parent);
+
+    // Block view shares storage with the parent
+    CU_ASSERT_EQUAL(matrix_view(p_parent, 2, 3, 4, 5, &view), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(view.rows, 4);
+    CU_ASSERT_EQUAL(view.cols, 5);
+    CU_ASSERT_EQUAL(view.ld, p_parent->ld);
+    CU_ASSERT_TRUE(view.b_view);
+    CU_ASSERT_EQUAL(matrix_get(&view, 1, 2, &val), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(val, 3005.0);
+    CU_ASSERT_EQUAL(matrix_get(&view, 4, 0, &val), MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_set(&view, 0, 0, -1.0), MATRIX_SUCCESS);
+    matrix_get(p_parent, 2, 3, &val);
+    CU_ASSERT_EQUAL(val, -1.0);
+    CU_ASSERT_EQUAL(matrix_find(&view, 5007.0, &row, &col), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(row, 3);
+    CU_ASSERT_EQUAL(col, 4);
+    CU_ASSERT_EQUAL(matrix_find(&view, 5008.0, &row, &col), MATRIX_NOT_FOUND);
+
+    // Views of views, rows, columns and strided rows
+    CU_ASSERT_EQUAL(matrix_view(&view, 1, 1, 2, 2, &inner), MATRIX_SUCCESS);
+    matrix_get(&inner, 1, 1, &val);
+    CU_ASSERT_EQUAL(val, 4005.0);
+    CU_ASSERT_EQUAL(matrix_row_view(p_parent, 7, &inner), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(inner.cols, 12);
+    matrix_get(&inner, 0, 11, &val);
+    CU_ASSERT_EQUAL(val, 7011.0);
+    CU_ASSERT_EQUAL(matrix_column_view(p_parent, 9, &inner), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(inner.rows, 10);
+    matrix_get(&inner, 8, 0, &val);
+    CU_ASSERT_EQUAL(val, 8009.0);
+    CU_ASSERT_EQUAL(matrix_view_strided(p_parent, 1, 0, 3, 2, 4, &inner),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(inner.ld, 4 * p_parent->ld);
+    matrix_get(&inner, 2, 1, &val);
+    CU_ASSERT_EQUAL(val, 9001.0);
+    CU_ASSERT_EQUAL(matrix_view_strided(p_parent, 1, 0, 4, 2, 3, &inner),
+                    MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_view(p_parent, 8, 0, 3, 1, &inner),
+                    MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_view(p_parent, 0, 10, 1, 3, &inner),
+                    MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_view(p_parent, 0, 0, 0, 3, &inner),
+                    MATRIX_INVALID_ARGUMENT);
+
+    // Filling a view leaves the surrounding elements untouched
+    CU_ASSERT_EQUAL(matrix_view(p_parent, 2, 3, 4, 5, &view), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_fill(&view, 0.5), MATRIX_SUCCESS);
+    matrix_get(p_parent, 2, 2, &val);
+    CU_ASSERT_EQUAL(val, 2002.0);
+    matrix_get(p_parent, 5, 7, &val);
+    CU_ASSERT_EQUAL(val, 0.5);
+    matrix_get(p_parent, 6, 3, &val);
+    CU_ASSERT_EQUAL(val, 6003.0);
+
+    // Clones of views are packed, owning matrices
+    matrix_t *p_clone = matrix_clone(&view);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_clone);
+    CU_ASSERT_EQUAL(p_clone->ld, 5);
+    CU_ASSERT_FALSE(p_clone->b_view);
+    CU_ASSERT_TRUE(matrix_is_equal(p_clone, &view));
+    matrix_destroy(p_clone);
+    matrix_destroy(&view);
+
+    // Kernels on views: C[1:, 2:] = A[3:, 1:] * B^T[:, 4:]
+    matrix_t *p_a   = matrix_create(40, 35);
+    matrix_t *p_b   = matrix_create(30, 50);
+    matrix_t *p_c   = matrix_create(30, 31);
+    matrix_t  a_blk = { 0 };
+    matrix_t  b_blk = { 0 };
+    matrix_t  c_blk = { 0 };
+    fill_pseudo_random(p_a, 41U);
+    fill_pseudo_random(p_b, 43U);
+    matrix_fill(p_c, 7.0);
+    matrix_view(p_a, 3, 1, 29, 30, &a_blk);
+    matrix_view(p_b, 0, 4, 30, 29, &b_blk);
+    matrix_view(p_c, 1, 2, 29, 29, &c_blk);
+    CU_ASSERT_EQUAL(matrix_multiply(&a_blk, &b_blk, &c_blk), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(
+        max_product_error(&a_blk, &b_blk, &c_blk), 0.0, 1e-12);
+    matrix_get(p_c, 0, 5, &val);
+    CU_ASSERT_EQUAL(val, 7.0);
+    matrix_get(p_c, 5, 1, &val);
+    CU_ASSERT_EQUAL(val, 7.0);
+
+    // Element-wise kernels and transpose between views
+    matrix_t *p_sum = matrix_create(29, 29);
+    CU_ASSERT_EQUAL(matrix_add(&a_blk, &b_blk, &c_blk),
+                    MATRIX_INVALID_ARGUMENT);
+    fill_with_index(p_a);
+    fill_with_index(p_b);
+    matrix_view(p_a, 3, 1, 29, 29, &a_blk);
+    matrix_view(p_b, 1, 4, 29, 29, &b_blk);
+    CU_ASSERT_EQUAL(matrix_add(&a_blk, &b_blk, p_sum), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_subtract(p_sum, &b_blk, &c_blk), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_scalar_multiply(&c_blk, -1.0, &c_blk),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_add(&c_blk, &a_blk, p_sum), MATRIX_SUCCESS);
+    matrix_t *p_zero = matrix_create(29, 29);
+    CU_ASSERT_TRUE(matrix_is_equal(p_sum, p_zero));
+
+    matrix_view(p_a, 3, 1, 20, 29, &a_blk);
+    matrix_view(p_b, 1, 3, 29, 20, &b_blk);
+    CU_ASSERT_EQUAL(matrix_transpose(&a_blk, &b_blk), MATRIX_SUCCESS);
+    matrix_get(&b_blk, 28, 19, &val);
+    CU_ASSERT_EQUAL(val, 22029.0);
+    CU_ASSERT_EQUAL(matrix_transpose_inplace(&a_blk), MATRIX_INVALID_ARGUMENT);
+    matrix_view(p_a, 3, 1, 20, 20, &a_blk);
+    CU_ASSERT_EQUAL(matrix_transpose_inplace(&a_blk), MATRIX_SUCCESS);
+    matrix_get(p_a, 3, 2, &val);
+    CU_ASSERT_EQUAL(val, 4001.0);
+
+    // Factorizations accept views too
+    matrix_t *p_x   = matrix_create(20, 3);
+    matrix_t  x_blk = { 0 };
+    double    det   = 0.0;
+    double    ref   = 0.0;
+    fill_pseudo_random(p_a, 47U);
+    matrix_view(p_a, 5, 6, 20, 20, &a_blk);
+    p_clone = matrix_clone(&a_blk);
+    CU_ASSERT_EQUAL(matrix_determinant(&a_blk, &det), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_determinant(p_clone, &ref), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(det, ref);
+    matrix_view(p_c, 2, 4, 20, 20, &c_blk);
+    CU_ASSERT_EQUAL(matrix_inverse(&a_blk, &c_blk), MATRIX_SUCCESS);
+    matrix_view(p_b, 0, 0, 20, 3, &b_blk);
+    matrix_view(p_b, 5, 10, 20, 3, &x_blk);
+    fill_pseudo_random(p_x, 53U);
+    CU_ASSERT_EQUAL(matrix_multiply(&a_blk, p_x, &b_blk), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_multiply(&c_blk, &b_blk, &x_blk), MATRIX_SUCCESS);
+
+    for (row = 0; row < 20; ++row)
+    {
+        for (col = 0; col < 3; ++col)
+        {
+            matrix_get(&x_blk, row, col, &val);
+            matrix_get(p_x, row, col, &ref);
+            CU_ASSERT_DOUBLE_EQUAL(val, ref, 1e-9);
+        }
+    }
+
+    matrix_destroy(p_x);
+    matrix_destroy(p_zero);
+    matrix_destroy(p_sum);
+    matrix_destroy(p_clone);
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    matrix_destroy(p_c);
+    matrix_destroy(p_parent);
+    return;
+}
+
+static void
+test_matrix_gemv (void)
+{
+    // 301 x 517 is large enough to split into row bands on four threads
+    const size_t m       = 301;
+    const size_t n       = 517;
+    const size_t count   = 7;
+    matrix_t    *p_a     = matrix_create(m, n);
+    matrix_t    *p_at    = matrix_create(n, m);
+    matrix_t    *p_x     = matrix_create(n, 1);
+    matrix_t    *p_xt    = matrix_create(m, 1);
+    matrix_t    *p_y     = matrix_create(m, 1);
+    matrix_t    *p_yt    = matrix_create(n, 1);
+    matrix_t    *p_ref   = matrix_create(m, 1);
+    matrix_t    *p_reft  = matrix_create(n, 1);
+    matrix_t    *p_batch = matrix_create(count, n);
+    matrix_t    *p_out   = matrix_create(count, m);
+    matrix_t    *p_bref  = matrix_create(count, m);
+    fill_pseudo_random(p_a, 51U);
+    fill_pseudo_random(p_x, 52U);
+    fill_pseudo_random(p_xt, 53U);
+    fill_pseudo_random(p_batch, 54U);
+    fill_pseudo_random(p_out, 55U);
+    matrix_transpose(p_a, p_at);
+
+    for (size_t threads = 1U; threads <= 4U; threads += 3U)
+    {
+        parallel_set_threads(threads);
+
+        // y = 2 * A * x - y
+        matrix_fill(p_y, 1.5);
+        matrix_multiply(p_a, p_x, p_ref);
+        matrix_scalar_multiply(p_ref, 2.0, p_ref);
+        CU_ASSERT_EQUAL(
+            matrix_gemv(p_a, 2.0, p_x->p_data, -1.0, p_y->p_data),
+            MATRIX_SUCCESS);
+
+        for (size_t row = 0; row < m; ++row)
+        {
+            CU_ASSERT_DOUBLE_EQUAL(
+                p_y->p_data[row], p_ref->p_data[row] - 1.5, 1e-10);
+        }
+
+        // y = A^T * x, stale contents ignored when beta is 0
+        matrix_fill(p_yt, 99.0);
+        matrix_multiply(p_at, p_xt, p_reft);
+        CU_ASSERT_EQUAL(
+            matrix_gemv_transposed(p_a, 1.0, p_xt->p_data, 0.0, p_yt->p_data),
+            MATRIX_SUCCESS);
+
+        for (size_t col = 0; col < n; ++col)
+        {
+            CU_ASSERT_DOUBLE_EQUAL(
+                p_yt->p_data[col], p_reft->p_data[col], 1e-10);
+        }
+
+        // Y = X * A^T + Y for a batch that is not a multiple of four
+        matrix_multiply(p_batch, p_at, p_bref);
+        matrix_add(p_bref, p_out, p_bref);
+        CU_ASSERT_EQUAL(matrix_gemv_batched(p_a, 1.0, p_batch, 1.0, p_out),
+                        MATRIX_SUCCESS);
+
+        for (size_t vec = 0; vec < count; ++vec)
+        {
+            for (size_t row = 0; row < m; ++row)
+            {
+                double value    = 0.0;
+                double expected = 0.0;
+                matrix_get(p_out, vec, row, &value);
+                matrix_get(p_bref, vec, row, &expected);
+                CU_ASSERT_DOUBLE_EQUAL(value, expected, 1e-10);
+            }
+        }
+    }
+
+    // Pinned worker threads compute the same bands
+    CU_ASSERT_EQUAL(parallel_set_affinity(true), 0);
+    matrix_multiply(p_a, p_x, p_ref);
+    CU_ASSERT_EQUAL(matrix_gemv(p_a, 1.0, p_x->p_data, 0.0, p_y->p_data),
+                    MATRIX_SUCCESS);
+
+    for (size_t row = 0; row < m; ++row)
+    {
+        CU_ASSERT_DOUBLE_EQUAL(p_y->p_data[row], p_ref->p_data[row], 1e-10);
+    }
+
+    CU_ASSERT_EQUAL(parallel_set_affinity(false), 0);
+    parallel_set_threads(0);
+
+    // Views of A and of the batch use their leading dimensions
+    matrix_t a_blk = { 0 };
+    matrix_t x_blk = { 0 };
+    matrix_t y_blk = { 0 };
+    matrix_view(p_a, 3, 5, 9, 11, &a_blk);
+    matrix_view(p_batch, 1, 2, 5, 11, &x_blk);
+    matrix_view(p_out, 0, 0, 5, 9, &y_blk);
+    matrix_t *p_blk  = matrix_clone(&a_blk);
+    matrix_t *p_blkt = matrix_create(11, 9);
+    matrix_t *p_sref = matrix_create(5, 9);
+    matrix_transpose(p_blk, p_blkt);
+    matrix_multiply(&x_blk, p_blkt, p_sref);
+    CU_ASSERT_EQUAL(matrix_gemv_batched(&a_blk, 1.0, &x_blk, 0.0, &y_blk),
+                    MATRIX_SUCCESS);
+
+    for (size_t vec = 0; vec < 5; ++vec)
+    {
+        for (size_t row = 0; row < 9; ++row)
+        {
+            double got = 0.0;
+            double exp = 0.0;
+            matrix_get(&y_blk, vec, row, &got);
+            matrix_get(p_sref, vec, row, &exp);
+            CU_ASSERT_DOUBLE_EQUAL(got, exp, 1e-12);
+        }
+    }
+
+    CU_ASSERT_EQUAL(matrix_gemv(NULL, 1.0, p_x->p_data, 0.0, p_y->p_data),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_gemv_transposed(p_a, 1.0, NULL, 0.0, p_y->p_data),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_gemv_batched(p_a, 1.0, p_batch, 0.0, p_batch),
+                    MATRIX_INVALID_ARGUMENT);
+
+    matrix_destroy(p_a);
+    matrix_destroy(p_at);
+    matrix_destroy(p_x);
+    matrix_destroy(p_xt);
+    matrix_destroy(p_y);
+    matrix_destroy(p_yt);
+    matrix_destroy(p_ref);
+    matrix_destroy(p_reft);
+    matrix_destroy(p_batch);
+    matrix_destroy(p_out);
+    matrix_destroy(p_bref);
+    matrix_destroy(p_blk);
+    matrix_destroy(p_blkt);
+    matrix_destroy(p_sref);
+    return;
+}
+
+static void
+test_matrix_aliasing (void)
+{
+    matrix_t *p_a   = matrix_create(6, 6);
+    matrix_t *p_b   = matrix_create(6, 6);
+    matrix_t *p_ref = matrix_create(6, 6);
+    fill_pseudo_random(p_a, 61U);
+    fill_pseudo_random(p_b, 62U);
+
+    // A += B, B = A - B and A *= s run in place
+    matrix_add(p_a, p_b, p_ref);
+    CU_ASSERT_EQUAL(matrix_add(p_a, p_b, p_a), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(p_a, p_ref));
+    matrix_subtract(p_a, p_b, p_ref);
+    CU_ASSERT_EQUAL(matrix_subtract(p_a, p_b, p_b), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(p_b, p_ref));
+    matrix_scalar_multiply(p_a, -3.0, p_ref);
+    CU_ASSERT_EQUAL(matrix_scalar_multiply(p_a, -3.0, p_a), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(p_a, p_ref));
+
+    // A = A * B and A = A * A go through workspace
+    matrix_multiply(p_a, p_b, p_ref);
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_b, p_a), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(p_a, p_ref));
+    matrix_multiply(p_b, p_b, p_ref);
+    CU_ASSERT_EQUAL(matrix_multiply(p_b, p_b, p_b), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(p_b, p_ref));
+
+    // Shifted views of one buffer: rows 0..4 = rows 1..5 + rows 0..4
+    matrix_t upper = { 0 };
+    matrix_t lower = { 0 };
+    matrix_view(p_a, 0, 0, 5, 6, &upper);
+    matrix_view(p_a, 1, 0, 5, 6, &lower);
+    matrix_t *p_lower = matrix_clone(&lower);
+    matrix_t *p_sum   = matrix_create(5, 6);
+    matrix_add(p_lower, &upper, p_sum);
+    CU_ASSERT_EQUAL(matrix_add(&lower, &upper, &upper), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(&upper, p_sum));
+
+    // A = A^T on a non-square matrix swaps its dimensions
+    matrix_t *p_rect  = matrix_create(3, 7);
+    matrix_t *p_rectt = matrix_create(7, 3);
+    fill_pseudo_random(p_rect, 63U);
+    matrix_transpose(p_rect, p_rectt);
+    CU_ASSERT_EQUAL(matrix_transpose(p_rect, p_rect), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(p_rect->rows, 7);
+    CU_ASSERT_EQUAL(p_rect->cols, 3);
+    CU_ASSERT_EQUAL(p_rect->ld, 3);
+    CU_ASSERT_TRUE(matrix_is_equal(p_rect, p_rectt));
+
+    // Transposing a block onto an overlapping block of the same buffer
+    matrix_t  src   = { 0 };
+    matrix_t  dst   = { 0 };
+    matrix_t *p_big = matrix_create(10, 10);
+    fill_pseudo_random(p_big, 64U);
+    matrix_view(p_big, 0, 0, 4, 6, &src);
+    matrix_view(p_big, 2, 1, 6, 4, &dst);
+    matrix_t *p_src  = matrix_clone(&src);
+    matrix_t *p_srct = matrix_create(6, 4);
+    matrix_transpose(p_src, p_srct);
+    CU_ASSERT_EQUAL(matrix_transpose(&src, &dst), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(&dst, p_srct));
+
+    // A view cannot change shape
+    CU_ASSERT_EQUAL(matrix_transpose(&src, &src), MATRIX_INVALID_ARGUMENT);
+
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    matrix_destroy(p_ref);
+    matrix_destroy(p_lower);
+    matrix_destroy(p_sum);
+    matrix_destroy(p_rect);
+    matrix_destroy(p_rectt);
+    matrix_destroy(p_big);
+    matrix_destroy(p_src);
+    matrix_destroy(p_srct);
+    return;
+}
+
+static void
+test_matrix_padding (void)
+{
+    // Rows narrower than a cache line stay packed, wider ones are rounded up
+    // to whole lines and strides that are a multiple of 512 bytes get one more
+    CU_ASSERT_EQUAL(matrix_padded_ld(5), 5);
+    CU_ASSERT_EQUAL(matrix_padded_ld(8), 8);
+    CU_ASSERT_EQUAL(matrix_padded_ld(100), 104);
+    CU_ASSERT_EQUAL(matrix_padded_ld(64), 72);
+    CU_ASSERT_EQUAL(matrix_padded_ld(1024), 1032);
+
+    matrix_t *p_wide = matrix_create(3, 512);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_wide);
+    CU_ASSERT_EQUAL(p_wide->ld, 520);
+
+    for (size_t row = 0; row < p_wide->rows; ++row)
+    {
+        uintptr_t start = (uintptr_t)(p_wide->p_data + (row * p_wide->ld));
+        CU_ASSERT_EQUAL(start % MATRIX_ALIGNMENT, 0);
+    }
+
+    // Clone, compare and element access all go through ld
+    matrix_t *p_a = matrix_create(9, 100);
+    fill_pseudo_random(p_a, 71U);
+    matrix_t *p_clone = matrix_clone(p_a);
+    CU_ASSERT_EQUAL(p_clone->ld, 104);
+    CU_ASSERT_TRUE(matrix_is_equal(p_a, p_clone));
+    matrix_set(p_clone, 8, 99, 5.0);
+    CU_ASSERT_FALSE(matrix_is_equal(p_a, p_clone));
+
+    // In-place transposes re-pad only when the padded shape fits in the
+    // buffer's capacity, and pack otherwise
+    matrix_t *p_at = matrix_create(100, 9);
+    matrix_transpose(p_a, p_at);
+    matrix_destroy(p_clone);
+    p_clone = matrix_clone(p_a);
+    CU_ASSERT_EQUAL(matrix_transpose_inplace(p_clone), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(p_clone->ld, 9);
+    CU_ASSERT_TRUE(matrix_is_equal(p_clone, p_at));
+    CU_ASSERT_EQUAL(matrix_transpose_inplace(p_clone), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(p_clone->ld, 104);
+    CU_ASSERT_TRUE(matrix_is_equal(p_clone, p_a));
+    CU_ASSERT_EQUAL(matrix_transpose(p_at, p_at), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(p_at->ld, 104);
+    CU_ASSERT_TRUE(matrix_is_equal(p_at, p_a));
+
+    matrix_destroy(p_wide);
+    matrix_destroy(p_a);
+    matrix_destroy(p_clone);
+    matrix_destroy(p_at);
+}
+
+/**
+ * @brief   Test copying into, reshaping and resizing existing matrices.
+ */
+static void
+test_matrix_resize (void)
+{
+    matrix_t *p_src     = matrix_create(6, 20);
+    matrix_t *p_dst     = matrix_create(2, 2);
+    matrix_t  view      = { 0 };
+    double   *p_storage = NULL;
+    double    value     = 0.0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_src);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_dst);
+    fill_pseudo_random(p_src, 41U);
+
+    // A small destination grows once, after which any shape that fits is
+    // served from the same buffer
+    CU_ASSERT_EQUAL(matrix_copy_into(p_dst, p_src), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(p_dst, p_src));
+    CU_ASSERT_EQUAL(p_dst->ld, 24);
+    CU_ASSERT(p_dst->capacity >= 6 * 24);
+    p_storage = p_dst->p_data;
+
+    CU_ASSERT_EQUAL(matrix_view(p_src, 1, 2, 3, 4, &view), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_copy_into(p_dst, &view), MATRIX_SUCCESS);
+    CU_ASSERT_PTR_EQUAL(p_dst->p_data, p_storage);
+    CU_ASSERT_EQUAL(p_dst->rows, 3);
+    CU_ASSERT_EQUAL(p_dst->cols, 4);
+    CU_ASSERT_TRUE(matrix_is_equal(p_dst, &view));
+
+    // Views cannot change shape, and overlapping copies are rejected
+    CU_ASSERT_EQUAL(matrix_copy_into(&view, p_src), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_copy_into(p_src, &view), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_copy_into(&view, p_dst), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_copy_into(p_dst, p_dst), MATRIX_SUCCESS);
+
+    // Resizing keeps the common block, zero-fills the rest and only
+    // reallocates past the capacity
+    CU_ASSERT_EQUAL(matrix_copy_into(p_dst, p_src), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_resize(p_dst, 4, 26), MATRIX_SUCCESS);
+    CU_ASSERT_PTR_EQUAL(p_dst->p_data, p_storage);
+    CU_ASSERT_EQUAL(p_dst->ld, 32);
+
+    for (size_t row = 0; row < 4; ++row)
+    {
+        for (size_t col = 0; col < 26; ++col)
+        {
+            double expected = 0.0;
+
+            if (col < 20)
+            {
+                matrix_get(p_src, row, col, &expected);
+            }
+
+            matrix_get(p_dst, row, col, &value);
+            CU_ASSERT_EQUAL(value, expected);
+        }
+    }
+
+    CU_ASSERT_EQUAL(matrix_resize(p_dst, 2, 3), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_resize(p_dst, 3, 3), MATRIX_SUCCESS);
+    CU_ASSERT_PTR_EQUAL(p_dst->p_data, p_storage);
+    matrix_get(p_dst, 1, 2, &value);
+    CU_ASSERT_EQUAL(value, p_src->p_data[p_src->ld + 2]);
+    matrix_get(p_dst, 2, 0, &value);
+    CU_ASSERT_EQUAL(value, 0.0);
+
+    CU_ASSERT_EQUAL(matrix_resize(p_dst, 40, 40), MATRIX_SUCCESS);
+    CU_ASSERT(p_dst->capacity >= 40 * 40);
+    matrix_get(p_dst, 1, 2, &value);
+    CU_ASSERT_EQUAL(value, p_src->p_data[p_src->ld + 2]);
+    CU_ASSERT_EQUAL(matrix_resize(&view, 2, 2), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_resize(p_dst, 0, 2), MATRIX_INVALID_ARGUMENT);
+
+    // Reshape keeps row-major order; padded rows are moved to the new stride
+    CU_ASSERT_EQUAL(matrix_copy_into(p_dst, p_src), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_reshape(p_dst, 10, 12), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(p_dst->ld, 16);
+
+    for (size_t idx = 0; idx < 120; ++idx)
+    {
+        double expected = 0.0;
+
+        matrix_get(p_src, idx / 20, idx % 20, &expected);
+        matrix_get(p_dst, idx / 12, idx % 12, &value);
+        CU_ASSERT_EQUAL(value, expected);
+    }
+
+    CU_ASSERT_EQUAL(matrix_reshape(p_dst, 7, 17), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_reshape(&view, 4, 3), MATRIX_INVALID_ARGUMENT);
+
+    // Packed rows are reinterpreted without touching the data
+    matrix_t *p_small = matrix_create(4, 6);
+    fill_pseudo_random(p_small, 43U);
+    p_storage = p_small->p_data;
+    value     = p_small->p_data[13];
+    CU_ASSERT_EQUAL(matrix_reshape(p_small, 3, 8), MATRIX_SUCCESS);
+    CU_ASSERT_PTR_EQUAL(p_small->p_data, p_storage);
+    CU_ASSERT_EQUAL(p_small->ld, 8);
+    CU_ASSERT_EQUAL(p_small->p_data[13], value);
+    CU_ASSERT_EQUAL(matrix_row_view(p_src, 2, &view), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_reshape(&view, 4, 5), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(view.ld, 5);
+
+    matrix_destroy(p_small);
+    matrix_destroy(p_src);
+    matrix_destroy(p_dst);
+}
+
+/**
+ * @brief   Test integer matrix powers and matrix chain products.
+ */
+static void
+test_matrix_pow_chain (void)
+{
+    // Fibonacci: [[1, 1], [1, 0]]^k = [[F(k+1), F(k)], [F(k), F(k-1)]]
+    matrix_t *p_fib    = matrix_create(2, 2);
+    matrix_t *p_result = matrix_create(2, 2);
+    double    value    = 0.0;
+
+    matrix_fill(p_fib, 1.0);
+    matrix_set(p_fib, 1, 1, 0.0);
+
+    for (size_t k = 0; k <= 20; ++k)
+    {
+        double f_prev = 1.0; // F(k - 1), with F(-1) = 1
+        double f_k    = 0.0;
+
+        for (size_t idx = 0; idx < k; ++idx)
+        {
+            double next = f_prev + f_k;
+            f_prev      = f_k;
+            f_k         = next;
+        }
+
+        CU_ASSERT_EQUAL(matrix_pow(p_fib, k, p_result), MATRIX_SUCCESS);
+        matrix_get(p_result, 0, 1, &value);
+        CU_ASSERT_EQUAL(value, f_k);
+        matrix_get(p_result, 1, 1, &value);
+        CU_ASSERT_EQUAL(value, f_prev);
+    }
+
+    // Larger powers against repeated multiplication, in place as well
+    matrix_t *p_a        = matrix_create(20, 20);
+    matrix_t *p_expected = matrix_create(20, 20);
+    matrix_t *p_pow      = matrix_create(20, 20);
+
+    fill_pseudo_random(p_a, 31U);
+    matrix_scalar_multiply(p_a, 0.2, p_a);
+    matrix_copy_into(p_expected, p_a);
+
+    for (size_t k = 2; k <= 13; ++k)
+    {
+        CU_ASSERT_EQUAL(matrix_multiply(p_expected, p_a, p_expected),
+                        MATRIX_SUCCESS);
+    }
+
+    CU_ASSERT_EQUAL(matrix_pow(p_a, 13, p_pow), MATRIX_SUCCESS);
+
+    for (size_t idx = 0; idx < 400; ++idx)
+    {
+        double expected = 0.0;
+
+        matrix_get(p_expected, idx / 20, idx % 20, &expected);
+        matrix_get(p_pow, idx / 20, idx % 20, &value);
+        CU_ASSERT_DOUBLE_EQUAL(value, expected, 1e-12);
+    }
+
+    CU_ASSERT_EQUAL(matrix_pow(p_a, 13, p_a), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(p_a, p_pow));
+
+    // Chain products match left-to-right multiplication whatever order the
+    // planner picks
+    matrix_t *p_m[5]   = { matrix_create(10, 30),
+                           matrix_create(30, 5),
+                           matrix_create(5, 60),
+                           matrix_create(60, 2),
+                           matrix_create(2, 40) };
+    matrix_t *p_tmp    = NULL;
+    matrix_t *p_chain  = matrix_create(10, 40);
+    matrix_t *p_serial = NULL;
+
+    for (size_t idx = 0; idx < 5; ++idx)
+    {
+        CU_ASSERT_PTR_NOT_NULL_FATAL(p_m[idx]);
+        fill_pseudo_random(p_m[idx], 50U + (unsigned int)idx);
+    }
+
+    p_serial = matrix_clone(p_m[0]);
+
+    for (size_t idx = 1; idx < 5; ++idx)
+    {
+        p_tmp = matrix_create(p_serial->rows, p_m[idx]->cols);
+        CU_ASSERT_EQUAL(matrix_multiply(p_serial, p_m[idx], p_tmp),
+                        MATRIX_SUCCESS);
+        matrix_destroy(p_serial);
+        p_serial = p_tmp;
+    }
+
+    CU_ASSERT_EQUAL(
+        matrix_chain_multiply((const matrix_t *const *)p_m, 5, p_chain),
+        MATRIX_SUCCESS);
+
+    for (size_t idx = 0; idx < 400; ++idx)
+    {
+        double expected = 0.0;
+
+        matrix_get(p_serial, idx / 40, idx % 40, &expected);
+        matrix_get(p_chain, idx / 40, idx % 40, &value);
+        CU_ASSERT_DOUBLE_EQUAL(value, expected, 1e-10);
+    }
+
+    // Sub-chains, a single matrix, an output aliasing an input and
+    // mismatched shapes
+    CU_ASSERT_EQUAL(
+        matrix_chain_multiply((const matrix_t *const *)p_m, 2, p_chain),
+        MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(
+        matrix_chain_multiply((const matrix_t *const *)&p_m[2], 1, p_m[2]),
+        MATRIX_SUCCESS);
+
+    // A single matrix into a view that partially overlaps it
+    matrix_t *p_grid = matrix_create(6, 6);
+    matrix_t  src    = { 0 };
+    matrix_t  dst    = { 0 };
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_grid);
+    fill_pseudo_random(p_grid, 77U);
+    CU_ASSERT_EQUAL(matrix_view(p_grid, 0, 0, 4, 4, &src), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_view(p_grid, 1, 1, 4, 4, &dst), MATRIX_SUCCESS);
+    matrix_t       *p_copy   = matrix_clone(&src);
+    const matrix_t *p_single = &src;
+    CU_ASSERT_EQUAL(matrix_chain_multiply(&p_single, 1, &dst),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(max_abs_diff(&dst, p_copy), 0.0);
+    matrix_destroy(p_copy);
+    matrix_destroy(p_grid);
+
+    const matrix_t *p_square[3] = { p_pow, p_pow, p_pow };
+    CU_ASSERT_EQUAL(matrix_chain_multiply(p_square, 3, p_pow),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_pow(p_a, 3, p_a), MATRIX_SUCCESS);
+
+    for (size_t idx = 0; idx < 400; ++idx)
+    {
+        double expected = 0.0;
+
+        matrix_get(p_a, idx / 20, idx % 20, &expected);
+        matrix_get(p_pow, idx / 20, idx % 20, &value);
+        CU_ASSERT_DOUBLE_EQUAL(value, expected, 1e-12);
+    }
+
+    CU_ASSERT_EQUAL(matrix_chain_multiply(p_square, 0, p_pow),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_pow(p_m[0], 2, p_chain), MATRIX_INVALID_ARGUMENT);
+
+    for (size_t idx = 0; idx < 5; ++idx)
+    {
+        matrix_destroy(p_m[idx]);
+    }
+
+    matrix_destroy(p_fib);
+    matrix_destroy(p_result);
+    matrix_destroy(p_a);
+    matrix_destroy(p_expected);
+    matrix_destroy(p_pow);
+    matrix_destroy(p_chain);
+    matrix_destroy(p_serial);
+}
+
+static void
+test_matrix_is_close (void)
+{
+    // Views with 13 columns cover full vector steps and a scalar tail
+    matrix_t *p_a  = matrix_create(5, 20);
+    matrix_t *p_b  = matrix_create(5, 20);
+    matrix_t  va   = { 0 };
+    matrix_t  vb   = { 0 };
+    size_t    row  = 0U;
+    size_t    col  = 0U;
+    double    base = 0.0;
+
+    for (size_t idx = 0U; idx < 5U * 20U; ++idx)
+    {
+        base = 1.0 + ((double)idx * 0.37);
+        matrix_set(p_a, idx / 20U, idx % 20U, base);
+        matrix_set(p_b, idx / 20U, idx % 20U, base);
+    }
+
+    CU_ASSERT_EQUAL(matrix_view(p_a, 1, 2, 4, 13, &va), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_view(p_b, 1, 2, 4, 13, &vb), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(&va, &vb));
+    CU_ASSERT_TRUE(matrix_is_close(&va, &vb, 0.0, 0.0));
+    CU_ASSERT_TRUE(matrix_is_close_ulps(&va, &vb, 0U));
+
+    // A difference at every position is found, inside and around the view
+    for (size_t pos = 0U; pos < 4U * 13U; ++pos)
+    {
+        double *p_val = vb.p_data + ((pos / 13U) * vb.ld) + (pos % 13U);
+        double  saved = *p_val;
+        double  up    = nextafter(saved, INFINITY);
+
+        *p_val = up;
+        CU_ASSERT_FALSE(matrix_is_equal(&va, &vb));
+        CU_ASSERT_TRUE(matrix_is_close_ulps(&va, &vb, 1U));
+        CU_ASSERT_FALSE(matrix_is_close_ulps(&va, &vb, 0U));
+        CU_ASSERT_TRUE(matrix_is_close(&va, &vb, 1e-15, 0.0));
+        *p_val = saved + 1e-3;
+        CU_ASSERT_FALSE(matrix_is_close(&va, &vb, 1e-6, 1e-6));
+        CU_ASSERT_TRUE(matrix_is_close(&va, &vb, 0.0, 1.1e-3));
+        CU_ASSERT_TRUE(matrix_is_close(&vb, &va, 1e-3, 0.0));
+        CU_ASSERT_EQUAL(matrix_find(&vb, saved + 1e-3, &row, &col),
+                        MATRIX_SUCCESS);
+        CU_ASSERT_EQUAL(row * 13U + col, pos);
+        CU_ASSERT_EQUAL(
+            matrix_find_close(&vb, saved + 2e-3, 0.0, 1.5e-3, &row, &col),
+            MATRIX_SUCCESS);
+        CU_ASSERT_EQUAL(row * 13U + col, pos);
+        *p_val = NAN;
+        CU_ASSERT_FALSE(matrix_is_close(&va, &vb, 1.0, 1.0));
+        CU_ASSERT_FALSE(matrix_is_close_ulps(&va, &vb, UINT64_MAX));
+        *p_val = saved;
+    }
+
+    p_b->p_data[0] = 1e9;
+    CU_ASSERT_TRUE(matrix_is_close(&va, &vb, 0.0, 0.0));
+    CU_ASSERT_FALSE(matrix_is_equal(p_a, p_b));
+
+    // Tolerances: first match wins, none found, invalid tolerances
+    CU_ASSERT_EQUAL(matrix_find_close(&va, 9.6, 0.0, 0.2, &row, &col),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(row, 0U);
+    CU_ASSERT_EQUAL(col, 1U);
+    CU_ASSERT_EQUAL(matrix_find_close(&va, -1.0, 0.1, 0.1, &row, &col),
+                    MATRIX_NOT_FOUND);
+    CU_ASSERT_EQUAL(matrix_find_close(&va, 4.0, -1.0, 0.5, &row, &col),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_find_close(&va, 4.0, 0.0, NAN, &row, &col),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_find_close(NULL, 4.0, 0.0, 0.5, &row, &col),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_FALSE(matrix_is_close(&va, &vb, -1e-9, 0.0));
+    CU_ASSERT_FALSE(matrix_is_close(&va, &vb, 0.0, NAN));
+    CU_ASSERT_FALSE(matrix_is_close(&va, p_b, 1.0, 1.0));
+    CU_ASSERT_FALSE(matrix_is_close_ulps(&va, NULL, 0U));
+    CU_ASSERT_TRUE(matrix_is_close(NULL, NULL, 0.0, 0.0));
+
+    // Special values in a vector step and in the tail
+    double lhs[6] = { 0.0, INFINITY, -INFINITY, DBL_MAX, 1e300, 5e-324 };
+    double rhs[6]
+        = { -0.0, INFINITY, -INFINITY, INFINITY, INFINITY, -5e-324 };
+    matrix_t *p_lhs = matrix_create(2, 6);
+    matrix_t *p_rhs = matrix_create(2, 6);
+
+    for (size_t idx = 0U; idx < 12U; ++idx)
+    {
+        matrix_set(p_lhs, idx / 6U, idx % 6U, lhs[idx % 6U]);
+        matrix_set(p_rhs, idx / 6U, idx % 6U, lhs[idx % 6U]);
+    }
+
+    CU_ASSERT_TRUE(matrix_is_equal(p_lhs, p_rhs));
+
+    for (size_t idx = 0U; idx < 12U; ++idx)
+    {
+        matrix_set(p_rhs, idx / 6U, idx % 6U, rhs[idx % 6U]);
+    }
+
+    // An infinity is never within a finite or relative bound of a number
+    CU_ASSERT_FALSE(matrix_is_close(p_lhs, p_rhs, 1.0, 1e300));
+    CU_ASSERT_FALSE(matrix_is_close_ulps(p_lhs, p_rhs, 1U));
+
+    // DBL_MAX is 1 ulp from infinity, the subnormals 2 ulps apart
+    matrix_set(p_rhs, 0, 4, 1e300);
+    matrix_set(p_rhs, 1, 4, 1e300);
+    CU_ASSERT_TRUE(matrix_is_close_ulps(p_lhs, p_rhs, 2U));
+    CU_ASSERT_FALSE(matrix_is_close_ulps(p_lhs, p_rhs, 1U));
+    matrix_set(p_rhs, 0, 5, 5e-324);
+    matrix_set(p_rhs, 1, 5, 5e-324);
+    CU_ASSERT_TRUE(matrix_is_close_ulps(p_lhs, p_rhs, 1U));
+    CU_ASSERT_FALSE(matrix_is_close(p_lhs, p_rhs, 1.0, 1.0));
+    CU_ASSERT_EQUAL(matrix_find_close(p_rhs, INFINITY, 1.0, 1.0, &row, &col),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(col, 1U);
+    CU_ASSERT_EQUAL(matrix_find(p_rhs, -0.0, &row, &col), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(col, 0U);
+    CU_ASSERT_EQUAL(matrix_find(p_rhs, NAN, &row, &col), MATRIX_NOT_FOUND);
+
+    matrix_destroy(p_lhs);
+    matrix_destroy(p_rhs);
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+}
+
 static void
 test_matrix_null_inputs (void)
 {
@@ -0,0 +1,323 @@
+/**
+ * @file    test_matrix_conv.c
+ * @brief   Test suite for 2D convolution.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_matrix_conv.h"
+#include "matrix_conv.h"
+#include "parallel.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+static void test_matrix_conv_size(void);
+static void test_matrix_conv_paths(void);
+static void test_matrix_conv_invalid(void);
+
+CU_pSuite
+matrix_conv_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("matrix-conv-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add matrix-conv-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_matrix_conv_size", test_matrix_conv_size)))
+    {
+        ERROR_LOG("Failed to add test_matrix_conv_size to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_conv_paths", test_matrix_conv_paths)))
+    {
+        ERROR_LOG("Failed to add test_matrix_conv_paths to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_conv_invalid", test_matrix_conv_invalid)))
+    {
+        ERROR_LOG("Failed to add test_matrix_conv_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+/**
+ * @brief   Textbook convolution, one output element at a time.
+ */
+static void
+conv_reference (const matrix_t             *p_input,
+                const matrix_t             *p_kernels,
+                const matrix_conv_params_t *p_params,
+                size_t                      out_rows,
+                size_t                      out_cols,
+                matrix_t                   *p_output)
+{
+    for (size_t kernel = 0; kernel < p_kernels->rows; ++kernel)
+    {
+        for (size_t pixel = 0; pixel < out_rows * out_cols; ++pixel)
+        {
+            double sum = 0.0;
+
+            for (size_t tap = 0; tap < p_kernels->cols; ++tap)
+            {
+                long row = (long)(((pixel / out_cols) * p_params->stride_rows)
+                                  + (tap / p_params->kernel_cols))
+                           - (long)p_params->pad_rows;
+                long col = (long)(((pixel % out_cols) * p_params->stride_cols)
+                                  + (tap % p_params->kernel_cols))
+                           - (long)p_params->pad_cols;
+                double value = 0.0;
+
+                if ((row >= 0) && (col >= 0))
+                {
+                    (void)matrix_get(
+                        p_input, (size_t)row, (size_t)col, &value);
+                }
+
+                sum += p_kernels->p_data[(kernel * p_kernels->ld) + tap]
+                       * value;
+            }
+
+            p_output->p_data[(kernel * p_output->ld) + pixel] = sum;
+        }
+    }
+}
+
+/**
+ * @brief   Run every applicable algorithm for one shape against the
+ *          reference.
+ */
+static void
+check_conv (const matrix_t       *p_input,
+            size_t                kernels,
+            matrix_conv_params_t  params)
+{
+    size_t    taps      = params.kernel_rows * params.kernel_cols;
+    size_t    out_rows  = 0;
+    size_t    out_cols  = 0;
+    matrix_t *p_kernels = matrix_create(kernels, taps);
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_kernels);
+    CU_ASSERT_EQUAL_FATAL(
+        matrix_conv2d_size(
+            p_input->rows, p_input->cols, &params, &out_rows, &out_cols),
+        MATRIX_SUCCESS);
+    fill_pseudo_random(p_kernels, (unsigned int)(kernels + taps));
+
+    matrix_t *p_ref = matrix_create(kernels, out_rows * out_cols);
+    matrix_t *p_out = matrix_create(kernels, out_rows * out_cols);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_ref);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_out);
+    conv_reference(p_input, p_kernels, &params, out_rows, out_cols, p_ref);
+
+    matrix_conv_algorithm_t algorithms[] = {
+        MATRIX_CONV_AUTO,
+        MATRIX_CONV_IM2COL,
+        MATRIX_CONV_DIRECT,
+    };
+
+    for (size_t idx = 0; idx < 3; ++idx)
+    {
+        params.algorithm = algorithms[idx];
+
+        if ((MATRIX_CONV_DIRECT == algorithms[idx]) && (9 != taps))
+        {
+            CU_ASSERT_EQUAL(matrix_conv2d(p_input, p_kernels, &params, p_out),
+                            MATRIX_INVALID_ARGUMENT);
+            continue;
+        }
+
+        for (size_t row = 0; row < kernels; ++row)
+        {
+            for (size_t col = 0; col < p_out->cols; ++col)
+            {
+                p_out->p_data[(row * p_out->ld) + col] = NAN;
+            }
+        }
+
+        CU_ASSERT_EQUAL(matrix_conv2d(p_input, p_kernels, &params, p_out),
+                        MATRIX_SUCCESS);
+        CU_ASSERT(max_abs_diff(p_out, p_ref) < 1e-12);
+    }
+
+    matrix_destroy(p_kernels);
+    matrix_destroy(p_ref);
+    matrix_destroy(p_out);
+}
+
+static void
+test_matrix_conv_size (void)
+{
+    matrix_conv_params_t params   = { .kernel_rows = 3,
+                                      .kernel_cols = 5,
+                                      .stride_rows = 1,
+                                      .stride_cols = 2 };
+    size_t               out_rows = 0;
+    size_t               out_cols = 0;
+
+    CU_ASSERT_EQUAL(matrix_conv2d_size(10, 11, &params, &out_rows, &out_cols),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(out_rows, 8);
+    CU_ASSERT_EQUAL(out_cols, 4);
+
+    // "Same" padding keeps the size at stride 1 and halves it at stride 2
+    params.pad_rows = 1;
+    params.pad_cols = 2;
+    CU_ASSERT_EQUAL(matrix_conv2d_size(10, 11, &params, &out_rows, &out_cols),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(out_rows, 10);
+    CU_ASSERT_EQUAL(out_cols, 6);
+
+    // Padding alone can make room for the kernel
+    CU_ASSERT_EQUAL(matrix_conv2d_size(1, 1, &params, &out_rows, &out_cols),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(out_rows, 1);
+    CU_ASSERT_EQUAL(out_cols, 1);
+
+    params.pad_cols = 1;
+    CU_ASSERT_EQUAL(matrix_conv2d_size(4, 2, &params, &out_rows, &out_cols),
+                    MATRIX_INVALID_ARGUMENT);
+    params.stride_rows = 0;
+    CU_ASSERT_EQUAL(matrix_conv2d_size(10, 11, &params, &out_rows, &out_cols),
+                    MATRIX_INVALID_ARGUMENT);
+}
+
+static void
+test_matrix_conv_paths (void)
+{
+    matrix_t            *p_image = matrix_create(61, 83);
+    matrix_t             view    = { 0 };
+    matrix_conv_params_t same    = { .kernel_rows = 3,
+                                     .kernel_cols = 3,
+                                     .stride_rows = 1,
+                                     .stride_cols = 1,
+                                     .pad_rows    = 1,
+                                     .pad_cols    = 1 };
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_image);
+    fill_pseudo_random(p_image, 17U);
+
+    // 3x3 kernels, both paths, with and without padding and stride
+    check_conv(p_image, 3, same);
+    same.pad_rows = 0;
+    same.pad_cols = 0;
+    check_conv(p_image, 1, same);
+    same.stride_rows = 2;
+    same.stride_cols = 3;
+    same.pad_cols    = 2;
+    check_conv(p_image, 4, same);
+
+    // Narrower than a vector after padding, so every pixel is an edge
+    CU_ASSERT_EQUAL(matrix_view(p_image, 5, 7, 20, 2, &view), MATRIX_SUCCESS);
+    same.stride_rows = 1;
+    same.stride_cols = 1;
+    same.pad_cols    = 1;
+    check_conv(&view, 2, same);
+
+    // Rectangular kernel, strided view input, several im2col panels
+    matrix_conv_params_t wide = { .kernel_rows = 5,
+                                  .kernel_cols = 4,
+                                  .stride_rows = 2,
+                                  .stride_cols = 1,
+                                  .pad_rows    = 2,
+                                  .pad_cols    = 1 };
+    CU_ASSERT_EQUAL(matrix_view(p_image, 3, 4, 50, 70, &view),
+                    MATRIX_SUCCESS);
+    check_conv(&view, 5, wide);
+
+    // Split across threads, and enough kernels that AUTO picks im2col
+    matrix_t *p_big = matrix_create(300, 257);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_big);
+    fill_pseudo_random(p_big, 19U);
+    same.pad_rows = 1;
+    parallel_set_threads(3);
+    check_conv(p_big, 2, same);
+    CU_ASSERT_EQUAL(matrix_view(p_image, 0, 0, 16, 24, &view),
+                    MATRIX_SUCCESS);
+    check_conv(&view, MATRIX_CONV_DIRECT_MAX_KERNELS + 2, same);
+    parallel_set_threads(0);
+
+    matrix_destroy(p_image);
+    matrix_destroy(p_big);
+}
+
+static void
+test_matrix_conv_invalid (void)
+{
+    matrix_t            *p_image   = matrix_create(8, 8);
+    matrix_t            *p_kernels = matrix_create(2, 9);
+    matrix_t            *p_out     = matrix_create(2, 36);
+    matrix_t             view      = { 0 };
+    matrix_conv_params_t params    = { .kernel_rows = 3,
+                                       .kernel_cols = 3,
+                                       .stride_rows = 1,
+                                       .stride_cols = 1 };
+
+    CU_ASSERT_EQUAL(matrix_conv2d(p_image, p_kernels, &params, p_out),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_conv2d(NULL, p_kernels, &params, p_out),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_conv2d(p_image, p_kernels, NULL, p_out),
+                    MATRIX_INVALID_ARGUMENT);
+
+    // Output not matching the kernel count or the map size
+    params.pad_rows = 1;
+    CU_ASSERT_EQUAL(matrix_conv2d(p_image, p_kernels, &params, p_out),
+                    MATRIX_INVALID_ARGUMENT);
+    params.pad_rows = 0;
+    CU_ASSERT_EQUAL(matrix_conv2d(p_image, p_out, &params, p_out),
+                    MATRIX_INVALID_ARGUMENT);
+
+    // Kernel width not matching the shape, and direct path for 2x2
+    params.kernel_rows = 2;
+    params.kernel_cols = 2;
+    CU_ASSERT_EQUAL(matrix_conv2d(p_image, p_kernels, &params, p_out),
+                    MATRIX_INVALID_ARGUMENT);
+    matrix_view(p_kernels, 0, 0, 2, 4, &view);
+    params.algorithm = MATRIX_CONV_DIRECT;
+    CU_ASSERT_EQUAL(matrix_conv2d(p_image, &view, &params, p_out),
+                    MATRIX_INVALID_ARGUMENT);
+
+    // Output written over the kernels
+    matrix_t *p_small  = matrix_create(2, 2);
+    matrix_t  kernel   = { 0 };
+    params.kernel_rows = 1;
+    params.kernel_cols = 1;
+    params.algorithm   = MATRIX_CONV_AUTO;
+    matrix_view(p_kernels, 0, 0, 2, 1, &kernel);
+    matrix_view(p_kernels, 0, 0, 2, 4, &view);
+    CU_ASSERT_EQUAL(matrix_conv2d(p_small, &kernel, &params, &view),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_conv2d(p_small, &kernel, &params, p_small),
+                    MATRIX_INVALID_ARGUMENT);
+
+    matrix_destroy(p_image);
+    matrix_destroy(p_kernels);
+    matrix_destroy(p_out);
+    matrix_destroy(p_small);
+}
+
+/*** end of file ***/
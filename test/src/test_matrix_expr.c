@@ -0,0 +1,257 @@
+/**
+ * @file    test_matrix_expr.c
+ * @brief   Test suite for fused matrix expressions.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_matrix_expr.h"
+#include "matrix_expr.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+static void test_matrix_expr_gemm_update(void);
+static void test_matrix_expr_nested(void);
+static void test_matrix_expr_aliasing(void);
+static void test_matrix_expr_invalid(void);
+
+CU_pSuite
+matrix_expr_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("matrix-expr-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add matrix-expr-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite,
+                        "test_matrix_expr_gemm_update",
+                        test_matrix_expr_gemm_update)))
+    {
+        ERROR_LOG("Failed to add test_matrix_expr_gemm_update to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_expr_nested", test_matrix_expr_nested)))
+    {
+        ERROR_LOG("Failed to add test_matrix_expr_nested to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_expr_aliasing", test_matrix_expr_aliasing)))
+    {
+        ERROR_LOG("Failed to add test_matrix_expr_aliasing to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_expr_invalid", test_matrix_expr_invalid)))
+    {
+        ERROR_LOG("Failed to add test_matrix_expr_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+static void
+test_matrix_expr_gemm_update (void)
+{
+    // C = 2 * A * B + 0.5 * C + D, evaluated into C itself
+    matrix_t *p_a   = matrix_create(37, 29);
+    matrix_t *p_b   = matrix_create(29, 600);
+    matrix_t *p_c   = matrix_create(37, 600);
+    matrix_t *p_d   = matrix_create(37, 600);
+    matrix_t *p_ab  = matrix_create(37, 600);
+    matrix_t *p_ref = matrix_create(37, 600);
+    fill_pseudo_random(p_a, 1U);
+    fill_pseudo_random(p_b, 2U);
+    fill_pseudo_random(p_c, 3U);
+    fill_pseudo_random(p_d, 4U);
+
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_b, p_ab), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_scalar_multiply(p_ab, 2.0, p_ab), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_scalar_multiply(p_c, 0.5, p_ref), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_add(p_ref, p_ab, p_ref), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_add(p_ref, p_d, p_ref), MATRIX_SUCCESS);
+
+    matrix_expr_t *p_expr = matrix_expr_add(
+        matrix_expr_add(
+            matrix_expr_scale(2.0,
+                              matrix_expr_multiply(matrix_expr_leaf(p_a),
+                                                   matrix_expr_leaf(p_b))),
+            matrix_expr_scale(0.5, matrix_expr_leaf(p_c))),
+        matrix_expr_leaf(p_d));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_expr);
+    CU_ASSERT_EQUAL(p_expr->rows, 37);
+    CU_ASSERT_EQUAL(p_expr->cols, 600);
+    CU_ASSERT_EQUAL(matrix_expr_evaluate(p_expr, p_c), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_c, p_ref), 0.0, 1e-12);
+    matrix_expr_destroy(p_expr);
+
+    // Pure product into a fresh matrix overwrites stale contents
+    matrix_fill(p_c, 99.0);
+    p_expr = matrix_expr_multiply(matrix_expr_leaf(p_a), matrix_expr_leaf(p_b));
+    CU_ASSERT_EQUAL(matrix_expr_evaluate(p_expr, p_c), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_scalar_multiply(p_ab, 0.5, p_ab), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_c, p_ab), 0.0, 1e-12);
+    matrix_expr_destroy(p_expr);
+
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    matrix_destroy(p_c);
+    matrix_destroy(p_d);
+    matrix_destroy(p_ab);
+    matrix_destroy(p_ref);
+    return;
+}
+
+static void
+test_matrix_expr_nested (void)
+{
+    // R = 3 * (A + B) * (C - D) - A * (2 * C) on views
+    matrix_t *p_big  = matrix_create(40, 40);
+    matrix_t *p_out  = matrix_create(20, 20);
+    matrix_t *p_sum  = matrix_create(20, 20);
+    matrix_t *p_diff = matrix_create(20, 20);
+    matrix_t *p_ref  = matrix_create(20, 20);
+    matrix_t *p_tmp  = matrix_create(20, 20);
+    matrix_t  a_blk  = { 0 };
+    matrix_t  b_blk  = { 0 };
+    matrix_t  c_blk  = { 0 };
+    matrix_t  d_blk  = { 0 };
+    fill_pseudo_random(p_big, 9U);
+    matrix_view(p_big, 0, 0, 20, 20, &a_blk);
+    matrix_view(p_big, 0, 20, 20, 20, &b_blk);
+    matrix_view(p_big, 20, 0, 20, 20, &c_blk);
+    matrix_view(p_big, 20, 20, 20, 20, &d_blk);
+
+    matrix_add(&a_blk, &b_blk, p_sum);
+    matrix_subtract(&c_blk, &d_blk, p_diff);
+    matrix_multiply(p_sum, p_diff, p_ref);
+    matrix_scalar_multiply(p_ref, 3.0, p_ref);
+    matrix_multiply(&a_blk, &c_blk, p_tmp);
+    matrix_scalar_multiply(p_tmp, 2.0, p_tmp);
+    matrix_subtract(p_ref, p_tmp, p_ref);
+
+    matrix_expr_t *p_expr = matrix_expr_subtract(
+        matrix_expr_scale(
+            3.0,
+            matrix_expr_multiply(
+                matrix_expr_add(matrix_expr_leaf(&a_blk),
+                                matrix_expr_leaf(&b_blk)),
+                matrix_expr_subtract(matrix_expr_leaf(&c_blk),
+                                     matrix_expr_leaf(&d_blk)))),
+        matrix_expr_multiply(
+            matrix_expr_leaf(&a_blk),
+            matrix_expr_scale(2.0, matrix_expr_leaf(&c_blk))));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_expr);
+    CU_ASSERT_EQUAL(matrix_expr_evaluate(p_expr, p_out), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_out, p_ref), 0.0, 1e-12);
+    matrix_expr_destroy(p_expr);
+
+    matrix_destroy(p_big);
+    matrix_destroy(p_out);
+    matrix_destroy(p_sum);
+    matrix_destroy(p_diff);
+    matrix_destroy(p_ref);
+    matrix_destroy(p_tmp);
+    return;
+}
+
+static void
+test_matrix_expr_aliasing (void)
+{
+    // A = A * B + A reads A inside the product
+    matrix_t *p_a   = matrix_create(30, 30);
+    matrix_t *p_b   = matrix_create(30, 30);
+    matrix_t *p_ref = matrix_create(30, 30);
+    fill_pseudo_random(p_a, 11U);
+    fill_pseudo_random(p_b, 12U);
+    matrix_multiply(p_a, p_b, p_ref);
+    matrix_add(p_ref, p_a, p_ref);
+
+    matrix_expr_t *p_expr = matrix_expr_add(
+        matrix_expr_multiply(matrix_expr_leaf(p_a), matrix_expr_leaf(p_b)),
+        matrix_expr_leaf(p_a));
+    CU_ASSERT_EQUAL(matrix_expr_evaluate(p_expr, p_a), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_a, p_ref), 0.0, 1e-12);
+    matrix_expr_destroy(p_expr);
+
+    // Shifted view of the output: out[0:29, :] = out[1:30, :] + out[0:29, :]
+    matrix_t upper = { 0 };
+    matrix_t lower = { 0 };
+    matrix_view(p_a, 0, 0, 29, 30, &upper);
+    matrix_view(p_a, 1, 0, 29, 30, &lower);
+    matrix_t *p_lower = matrix_clone(&lower);
+    matrix_t *p_sum   = matrix_create(29, 30);
+    matrix_add(p_lower, &upper, p_sum);
+    p_expr
+        = matrix_expr_add(matrix_expr_leaf(&lower), matrix_expr_leaf(&upper));
+    CU_ASSERT_EQUAL(matrix_expr_evaluate(p_expr, &upper), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(&upper, p_sum));
+    matrix_expr_destroy(p_expr);
+
+    matrix_destroy(p_lower);
+    matrix_destroy(p_sum);
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    matrix_destroy(p_ref);
+    return;
+}
+
+static void
+test_matrix_expr_invalid (void)
+{
+    matrix_t *p_a = matrix_create(3, 4);
+    matrix_t *p_b = matrix_create(3, 4);
+    matrix_t *p_c = matrix_create(4, 4);
+
+    // Size mismatches fail at build time and free the operands
+    CU_ASSERT_PTR_NULL(
+        matrix_expr_add(matrix_expr_leaf(p_a), matrix_expr_leaf(p_c)));
+    CU_ASSERT_PTR_NULL(
+        matrix_expr_multiply(matrix_expr_leaf(p_a), matrix_expr_leaf(p_b)));
+    CU_ASSERT_PTR_NULL(matrix_expr_add(NULL, matrix_expr_leaf(p_a)));
+    CU_ASSERT_PTR_NULL(matrix_expr_scale(2.0, NULL));
+    CU_ASSERT_PTR_NULL(matrix_expr_leaf(NULL));
+
+    // Result of the wrong size
+    matrix_expr_t *p_expr
+        = matrix_expr_multiply(matrix_expr_leaf(p_a), matrix_expr_leaf(p_c));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_expr);
+    CU_ASSERT_EQUAL(matrix_expr_evaluate(p_expr, p_c),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_expr_evaluate(p_expr, p_b), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_expr_evaluate(NULL, p_b), MATRIX_INVALID_ARGUMENT);
+    matrix_expr_destroy(p_expr);
+    matrix_expr_destroy(NULL);
+
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    matrix_destroy(p_c);
+    return;
+}
+
+/*** end of file ***/
@@ -0,0 +1,327 @@
+/**
+ * @file    test_matrix_fixed.c
+ * @brief   Test suite for fixed-size matrices.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_matrix_fixed.h"
+#include "matrix_fixed.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+#define BATCH_COUNT 13
+#define BATCH_PACKS                                                          \
+    ((BATCH_COUNT + MATRIX_FIXED_LANES - 1) / MATRIX_FIXED_LANES)
+
+static void test_matrix_fixed_scalar(void);
+static void test_matrix_fixed_batch(void);
+static void test_matrix_fixed_invalid(void);
+
+CU_pSuite
+matrix_fixed_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("matrix-fixed-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add matrix-fixed-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_fixed_scalar", test_matrix_fixed_scalar)))
+    {
+        ERROR_LOG("Failed to add test_matrix_fixed_scalar to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_fixed_batch", test_matrix_fixed_batch)))
+    {
+        ERROR_LOG("Failed to add test_matrix_fixed_batch to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_fixed_invalid", test_matrix_fixed_invalid)))
+    {
+        ERROR_LOG("Failed to add test_matrix_fixed_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+/**
+ * @brief   Fill values with deterministic pseudo-random numbers in [-1, 1).
+ */
+static void
+fill_values_pseudo_random (double *p_values, size_t count, unsigned int seed)
+{
+    matrix_t row = { .rows   = 1U,
+                     .cols   = count,
+                     .ld     = count,
+                     .b_view = true,
+                     .p_data = p_values };
+    fill_pseudo_random(&row, seed);
+}
+
+/**
+ * @brief   Largest absolute difference between two arrays.
+ */
+static double
+max_values_abs_diff (const double *p_a, const double *p_b, size_t count)
+{
+    double max_diff = 0.0;
+
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        double diff = fabs(p_a[idx] - p_b[idx]);
+        max_diff    = (diff > max_diff) ? diff : max_diff;
+    }
+
+    return max_diff;
+}
+
+static void
+test_matrix_fixed_scalar (void)
+{
+    // | 1 2 |   | 5 6 |   | 19 22 |
+    // | 3 4 | * | 7 8 | = | 43 50 |
+    matrix2_t a2       = { { 1.0, 2.0, 3.0, 4.0 } };
+    matrix2_t b2       = { { 5.0, 6.0, 7.0, 8.0 } };
+    matrix2_t c2       = { { 0.0 } };
+    double    det      = 0.0;
+    double    expected = 0.0;
+
+    CU_ASSERT_EQUAL(matrix2_multiply(&a2, &b2, &c2), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(c2.m[0], 19.0);
+    CU_ASSERT_EQUAL(c2.m[1], 22.0);
+    CU_ASSERT_EQUAL(c2.m[2], 43.0);
+    CU_ASSERT_EQUAL(c2.m[3], 50.0);
+    CU_ASSERT_EQUAL(matrix2_determinant(&a2, &det), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(det, -2.0);
+    CU_ASSERT_EQUAL(matrix2_inverse(&a2, &c2), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(c2.m[0], -2.0, 1e-15);
+    CU_ASSERT_DOUBLE_EQUAL(c2.m[1], 1.0, 1e-15);
+    CU_ASSERT_DOUBLE_EQUAL(c2.m[2], 1.5, 1e-15);
+    CU_ASSERT_DOUBLE_EQUAL(c2.m[3], -0.5, 1e-15);
+
+    // | 2 0 1 |
+    // | 1 3 2 |  det = 2 * (6 - 2) - 0 * (2 - 2) + 1 * (1 - 3) = 6
+    // | 1 1 2 |
+    matrix3_t a3 = { { 2.0, 0.0, 1.0, 1.0, 3.0, 2.0, 1.0, 1.0, 2.0 } };
+    matrix3_t i3 = { { 0.0 } };
+    matrix3_t p3 = { { 0.0 } };
+
+    CU_ASSERT_EQUAL(matrix3_determinant(&a3, &det), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(det, 6.0);
+    CU_ASSERT_EQUAL(matrix3_inverse(&a3, &i3), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix3_multiply(&a3, &i3, &p3), MATRIX_SUCCESS);
+
+    for (size_t e = 0; e < 9; ++e)
+    {
+        CU_ASSERT_DOUBLE_EQUAL(p3.m[e], (0 == (e % 4)) ? 1.0 : 0.0, 1e-14);
+    }
+
+    // 4x4 against the general matrix_t path
+    matrix4_t a4       = { { 0.0 } };
+    matrix4_t b4       = { { 0.0 } };
+    matrix4_t c4       = { { 0.0 } };
+    matrix_t *p_a      = matrix_create(4, 4);
+    matrix_t *p_b      = matrix_create(4, 4);
+    matrix_t *p_result = matrix_create(4, 4);
+
+    fill_values_pseudo_random(a4.m, 16, 7U);
+    fill_values_pseudo_random(b4.m, 16, 11U);
+
+    for (size_t e = 0; e < 16; ++e)
+    {
+        matrix_set(p_a, e / 4, e % 4, a4.m[e]);
+        matrix_set(p_b, e / 4, e % 4, b4.m[e]);
+    }
+
+    CU_ASSERT_EQUAL(matrix4_multiply(&a4, &b4, &c4), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_b, p_result), MATRIX_SUCCESS);
+    CU_ASSERT(max_values_abs_diff(c4.m, p_result->p_data, 16) < 1e-14);
+
+    CU_ASSERT_EQUAL(matrix4_determinant(&a4, &det), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_determinant(p_a, &expected), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(det, expected, 1e-13);
+
+    CU_ASSERT_EQUAL(matrix4_inverse(&a4, &c4), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_inverse(p_a, p_result), MATRIX_SUCCESS);
+    CU_ASSERT(max_values_abs_diff(c4.m, p_result->p_data, 16) < 1e-11);
+
+    // Outputs may alias inputs
+    c4 = a4;
+    CU_ASSERT_EQUAL(matrix4_multiply(&c4, &b4, &c4), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_b, p_result), MATRIX_SUCCESS);
+    CU_ASSERT(max_values_abs_diff(c4.m, p_result->p_data, 16) < 1e-14);
+    c4 = a4;
+    CU_ASSERT_EQUAL(matrix4_inverse(&c4, &c4), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_inverse(p_a, p_result), MATRIX_SUCCESS);
+    CU_ASSERT(max_values_abs_diff(c4.m, p_result->p_data, 16) < 1e-11);
+
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    matrix_destroy(p_result);
+}
+
+static void
+test_matrix_fixed_batch (void)
+{
+    matrix4_t          a[BATCH_COUNT];
+    matrix4_t          b[BATCH_COUNT];
+    matrix4_t          out[BATCH_COUNT];
+    matrix4_t          expected      = { { 0.0 } };
+    double             det[BATCH_PACKS * MATRIX_FIXED_LANES];
+    double             expected_det  = 0.0;
+    matrix4_pack_t    *p_a           = calloc(BATCH_PACKS, sizeof(*p_a));
+    matrix4_pack_t    *p_b           = calloc(BATCH_PACKS, sizeof(*p_b));
+    matrix4_pack_t    *p_c           = calloc(BATCH_PACKS, sizeof(*p_c));
+    size_t             last_lane     = BATCH_COUNT % MATRIX_FIXED_LANES;
+
+    for (size_t idx = 0; idx < BATCH_COUNT; ++idx)
+    {
+        fill_values_pseudo_random(a[idx].m, 16, 3U + (unsigned int)idx);
+        fill_values_pseudo_random(b[idx].m, 16, 101U + (unsigned int)idx);
+    }
+
+    CU_ASSERT_EQUAL(matrix4_pack(a, BATCH_COUNT, p_a), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix4_pack(b, BATCH_COUNT, p_b), MATRIX_SUCCESS);
+
+    // Lanes past the end of the batch are padded with the identity
+    CU_ASSERT_EQUAL(p_a[BATCH_PACKS - 1].m[0][last_lane], 1.0);
+    CU_ASSERT_EQUAL(p_a[BATCH_PACKS - 1].m[1][last_lane], 0.0);
+    CU_ASSERT_EQUAL(p_a[BATCH_PACKS - 1].m[15][last_lane], 1.0);
+
+    CU_ASSERT_EQUAL(matrix4_multiply_batch(p_a, p_b, p_c, BATCH_PACKS),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix4_unpack(p_c, BATCH_COUNT, out), MATRIX_SUCCESS);
+
+    for (size_t idx = 0; idx < BATCH_COUNT; ++idx)
+    {
+        matrix4_multiply(&a[idx], &b[idx], &expected);
+        CU_ASSERT(max_values_abs_diff(out[idx].m, expected.m, 16) < 1e-15);
+    }
+
+    CU_ASSERT_EQUAL(matrix4_determinant_batch(p_a, det, BATCH_PACKS),
+                    MATRIX_SUCCESS);
+
+    for (size_t idx = 0; idx < BATCH_COUNT; ++idx)
+    {
+        matrix4_determinant(&a[idx], &expected_det);
+        CU_ASSERT_DOUBLE_EQUAL(det[idx], expected_det, 1e-15);
+    }
+
+    CU_ASSERT_EQUAL(det[BATCH_COUNT], 1.0);
+
+    // In place over the whole batch, padding lanes included
+    CU_ASSERT_EQUAL(matrix4_inverse_batch(p_a, p_a, BATCH_PACKS),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix4_unpack(p_a, BATCH_COUNT, out), MATRIX_SUCCESS);
+
+    for (size_t idx = 0; idx < BATCH_COUNT; ++idx)
+    {
+        matrix4_inverse(&a[idx], &expected);
+        CU_ASSERT(max_values_abs_diff(out[idx].m, expected.m, 16) < 1e-12);
+    }
+
+    // The smaller orders share the templates; one round trip each
+    matrix2_t      a2[BATCH_COUNT];
+    matrix2_t      out2[BATCH_COUNT];
+    matrix2_t      expected2 = { { 0.0 } };
+    matrix2_pack_t p2[BATCH_PACKS];
+    matrix3_t      a3[BATCH_COUNT];
+    matrix3_t      out3[BATCH_COUNT];
+    matrix3_t      expected3 = { { 0.0 } };
+    matrix3_pack_t p3[BATCH_PACKS];
+
+    for (size_t idx = 0; idx < BATCH_COUNT; ++idx)
+    {
+        fill_values_pseudo_random(a2[idx].m, 4, 17U + (unsigned int)idx);
+        fill_values_pseudo_random(a3[idx].m, 9, 29U + (unsigned int)idx);
+    }
+
+    matrix2_pack(a2, BATCH_COUNT, p2);
+    CU_ASSERT_EQUAL(matrix2_multiply_batch(p2, p2, p2, BATCH_PACKS),
+                    MATRIX_SUCCESS);
+    matrix2_unpack(p2, BATCH_COUNT, out2);
+    matrix3_pack(a3, BATCH_COUNT, p3);
+    CU_ASSERT_EQUAL(matrix3_inverse_batch(p3, p3, BATCH_PACKS),
+                    MATRIX_SUCCESS);
+    matrix3_unpack(p3, BATCH_COUNT, out3);
+
+    for (size_t idx = 0; idx < BATCH_COUNT; ++idx)
+    {
+        matrix2_multiply(&a2[idx], &a2[idx], &expected2);
+        CU_ASSERT(max_values_abs_diff(out2[idx].m, expected2.m, 4) < 1e-15);
+        matrix3_inverse(&a3[idx], &expected3);
+        CU_ASSERT(max_values_abs_diff(out3[idx].m, expected3.m, 9) < 1e-12);
+    }
+
+    free(p_a);
+    free(p_b);
+    free(p_c);
+}
+
+static void
+test_matrix_fixed_invalid (void)
+{
+    matrix3_t      singular = { { 1.0, 2.0, 3.0, 2.0, 4.0, 6.0, 0.0, 1.0,
+                                  1.0 } };
+    matrix3_t      inv      = { { 0.0 } };
+    matrix3_t      batch[2] = { { { 0.0 } } };
+    matrix3_pack_t pack     = { { { 0.0 } } };
+    double         det      = 1.0;
+
+    CU_ASSERT_EQUAL(matrix3_determinant(&singular, &det), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(det, 0.0);
+    CU_ASSERT_EQUAL(matrix3_inverse(&singular, &inv), MATRIX_SINGULAR);
+    CU_ASSERT_EQUAL(inv.m[0], 0.0);
+
+    // One singular matrix among invertible ones flags the whole batch
+    batch[0] = singular;
+    batch[1] = (matrix3_t) { { 1.0, 0.0, 0.0, 0.0, 2.0, 0.0, 0.0, 0.0, 4.0 } };
+    matrix3_pack(batch, 2, &pack);
+    CU_ASSERT_EQUAL(matrix3_inverse_batch(&pack, &pack, 1), MATRIX_SINGULAR);
+    matrix3_unpack(&pack, 2, batch);
+    CU_ASSERT_EQUAL(batch[1].m[4], 0.5);
+    CU_ASSERT_EQUAL(batch[1].m[8], 0.25);
+
+    CU_ASSERT_EQUAL(matrix3_multiply(NULL, &inv, &inv),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix3_determinant(&inv, NULL), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix3_inverse(&inv, NULL), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix3_pack(NULL, 1, &pack), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix3_unpack(&pack, 1, NULL), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix3_multiply_batch(&pack, NULL, &pack, 1),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix3_determinant_batch(&pack, NULL, 1),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix3_inverse_batch(NULL, &pack, 1),
+                    MATRIX_INVALID_ARGUMENT);
+
+    // An empty batch is a no-op
+    CU_ASSERT_EQUAL(matrix3_multiply_batch(NULL, NULL, NULL, 0),
+                    MATRIX_SUCCESS);
+}
+
+/*** end of file ***/
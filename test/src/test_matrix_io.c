@@ -0,0 +1,367 @@
+/**
+ * @file    test_matrix_io.c
+ * @brief   Test suite for binary matrix files.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_matrix_io.h"
+#include "matrix_io.h"
+#include "parallel.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void test_matrix_io_round_trip(void);
+static void test_matrix_io_mmap(void);
+static void test_matrix_io_invalid(void);
+static void test_matrix_io_csv(void);
+static void test_matrix_io_csv_invalid(void);
+
+CU_pSuite
+matrix_io_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("matrix-io-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add matrix-io-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_io_round_trip", test_matrix_io_round_trip)))
+    {
+        ERROR_LOG("Failed to add test_matrix_io_round_trip to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_matrix_io_mmap", test_matrix_io_mmap)))
+    {
+        ERROR_LOG("Failed to add test_matrix_io_mmap to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_io_invalid", test_matrix_io_invalid)))
+    {
+        ERROR_LOG("Failed to add test_matrix_io_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_matrix_io_csv", test_matrix_io_csv)))
+    {
+        ERROR_LOG("Failed to add test_matrix_io_csv to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_io_csv_invalid", test_matrix_io_csv_invalid)))
+    {
+        ERROR_LOG("Failed to add test_matrix_io_csv_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+/**
+ * @brief   Create an empty temporary file and store its path.
+ */
+static void
+make_temp_path (char *p_path, size_t size)
+{
+    snprintf(p_path, size, "/tmp/test_matrix_io_XXXXXX");
+    int fd = mkstemp(p_path);
+    CU_ASSERT_FATAL(0 <= fd);
+    close(fd);
+}
+
+/**
+ * @brief   Replace the contents of a file with a string.
+ */
+static void
+write_text (const char *p_path, const char *p_text)
+{
+    FILE *p_file = fopen(p_path, "wb");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_file);
+    CU_ASSERT_EQUAL(fwrite(p_text, 1, strlen(p_text), p_file),
+                    strlen(p_text));
+    fclose(p_file);
+}
+
+static void
+test_matrix_io_round_trip (void)
+{
+    char      path[64];
+    matrix_t *p_big    = matrix_create(20, 30);
+    matrix_t *p_loaded = NULL;
+    matrix_t  blk      = { 0 };
+    make_temp_path(path, sizeof(path));
+    fill_with_index(p_big);
+
+    CU_ASSERT_EQUAL(matrix_save(p_big, path), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_load(path, &p_loaded), MATRIX_SUCCESS);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_loaded);
+    CU_ASSERT_TRUE(matrix_is_equal(p_big, p_loaded));
+    matrix_destroy(p_loaded);
+
+    // A view is saved as its visible block
+    matrix_view(p_big, 3, 4, 7, 9, &blk);
+    CU_ASSERT_EQUAL(matrix_save(&blk, path), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_load(path, &p_loaded), MATRIX_SUCCESS);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_loaded);
+    CU_ASSERT_EQUAL(p_loaded->rows, 7);
+    CU_ASSERT_EQUAL(p_loaded->cols, 9);
+    CU_ASSERT_TRUE(matrix_is_equal(&blk, p_loaded));
+    matrix_destroy(p_loaded);
+
+    matrix_destroy(p_big);
+    remove(path);
+    return;
+}
+
+static void
+test_matrix_io_mmap (void)
+{
+    char             path[64];
+    matrix_t        *p_matrix = matrix_create(33, 17);
+    matrix_mapping_t mapping  = { 0 };
+    double           value    = 0.0;
+    make_temp_path(path, sizeof(path));
+    fill_with_index(p_matrix);
+    CU_ASSERT_EQUAL(matrix_save(p_matrix, path), MATRIX_SUCCESS);
+
+    // Read-only mappings alias the file payload directly
+    CU_ASSERT_EQUAL(matrix_load_mmap(path, MATRIX_MAP_READ_ONLY, &mapping),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(mapping.matrix.b_view);
+    CU_ASSERT_EQUAL((uintptr_t)mapping.matrix.p_data % MATRIX_IO_ALIGNMENT,
+                    0);
+    CU_ASSERT_TRUE(matrix_is_equal(&mapping.matrix, p_matrix));
+    matrix_destroy(&mapping.matrix);
+    matrix_unmap(&mapping);
+    CU_ASSERT_PTR_NULL(mapping.p_map);
+
+    // Copy-on-write mappings are writable but leave the file untouched
+    CU_ASSERT_EQUAL(
+        matrix_load_mmap(path, MATRIX_MAP_COPY_ON_WRITE, &mapping),
+        MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_set(&mapping.matrix, 32, 16, -1.0), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_scalar_multiply(&mapping.matrix, 2.0,
+                                           &mapping.matrix),
+                    MATRIX_SUCCESS);
+    matrix_get(&mapping.matrix, 32, 16, &value);
+    CU_ASSERT_EQUAL(value, -2.0);
+    matrix_unmap(&mapping);
+
+    CU_ASSERT_EQUAL(matrix_load_mmap(path, MATRIX_MAP_READ_ONLY, &mapping),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(&mapping.matrix, p_matrix));
+    matrix_unmap(&mapping);
+    matrix_unmap(NULL);
+
+    matrix_destroy(p_matrix);
+    remove(path);
+    return;
+}
+
+static void
+test_matrix_io_invalid (void)
+{
+    char                 path[64];
+    matrix_t            *p_matrix = matrix_create(4, 4);
+    matrix_t            *p_loaded = NULL;
+    matrix_mapping_t     mapping  = { 0 };
+    matrix_file_header_t header   = { 0 };
+    make_temp_path(path, sizeof(path));
+
+    // Empty file
+    CU_ASSERT_EQUAL(matrix_load(path, &p_loaded), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_load_mmap(path, MATRIX_MAP_READ_ONLY, &mapping),
+                    MATRIX_INVALID_ARGUMENT);
+
+    // Truncated payload and corrupted signature
+    CU_ASSERT_EQUAL(matrix_save(p_matrix, path), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(truncate(path, 64 + (15 * sizeof(double))), 0);
+    CU_ASSERT_EQUAL(matrix_load(path, &p_loaded), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_load_mmap(path, MATRIX_MAP_READ_ONLY, &mapping),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_PTR_NULL(mapping.p_map);
+
+    CU_ASSERT_EQUAL(matrix_save(p_matrix, path), MATRIX_SUCCESS);
+    FILE *p_file = fopen(path, "r+b");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_file);
+    CU_ASSERT_EQUAL(fread(&header, sizeof(header), 1, p_file), 1);
+    header.magic[0] = 'X';
+    rewind(p_file);
+    CU_ASSERT_EQUAL(fwrite(&header, sizeof(header), 1, p_file), 1);
+    fclose(p_file);
+    CU_ASSERT_EQUAL(matrix_load(path, &p_loaded), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_PTR_NULL(p_loaded);
+
+    CU_ASSERT_EQUAL(matrix_save(NULL, path), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_load(NULL, &p_loaded), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_load("/nonexistent/matrix.bin", &p_loaded),
+                    MATRIX_FAILURE);
+    CU_ASSERT_EQUAL(matrix_load_mmap(path, (matrix_map_mode_t)7, &mapping),
+                    MATRIX_INVALID_ARGUMENT);
+
+    matrix_destroy(p_matrix);
+    remove(path);
+    return;
+}
+
+static void
+test_matrix_io_csv (void)
+{
+    char      path[64];
+    matrix_t *p_loaded = NULL;
+    double    value    = 0.0;
+    make_temp_path(path, sizeof(path));
+
+    // Spacing, CRLF, blank lines, signs, exponents, and a mantissa too long
+    // for the fast path; no newline after the last row
+    write_text(path,
+               "1,2.5,-3e2\n"
+               " 4 , 0.125,\t1E-3\r\n"
+               "\n"
+               "-0.0,+7,12345678901234567890123\n"
+               "  \r\n"
+               "1e300,inf,.5");
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 0, 0, &p_loaded), MATRIX_SUCCESS);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_loaded);
+    CU_ASSERT_EQUAL(p_loaded->rows, 4);
+    CU_ASSERT_EQUAL(p_loaded->cols, 3);
+    matrix_get(p_loaded, 0, 2, &value);
+    CU_ASSERT_EQUAL(value, -300.0);
+    matrix_get(p_loaded, 1, 1, &value);
+    CU_ASSERT_EQUAL(value, 0.125);
+    matrix_get(p_loaded, 1, 2, &value);
+    CU_ASSERT_EQUAL(value, 1e-3);
+    matrix_get(p_loaded, 2, 0, &value);
+    CU_ASSERT_TRUE(signbit(value));
+    matrix_get(p_loaded, 2, 2, &value);
+    CU_ASSERT_EQUAL(value, 12345678901234567890123.0);
+    matrix_get(p_loaded, 3, 0, &value);
+    CU_ASSERT_EQUAL(value, 1e300);
+    matrix_get(p_loaded, 3, 1, &value);
+    CU_ASSERT_TRUE(isinf(value));
+    matrix_get(p_loaded, 3, 2, &value);
+    CU_ASSERT_EQUAL(value, 0.5);
+    matrix_destroy(p_loaded);
+
+    // Several chunks parsed across threads, in shortest-exact, fixed and
+    // 15-digit forms, must agree bit for bit with strtod
+    FILE        *p_file = fopen(path, "wb");
+    matrix_t    *p_ref  = matrix_create(30000, 7);
+    unsigned int state  = 29U;
+    char         text[64];
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_file);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_ref);
+
+    for (size_t row = 0; row < 30000; ++row)
+    {
+        for (size_t col = 0; col < 7; ++col)
+        {
+            state = (state * 1103515245U) + 12345U;
+            double      raw = ((double)(state >> 4) / 268435456.0) - 0.5;
+            double      x = raw * pow(10.0, (double)((int)(row % 61) - 30));
+            const char *p_format = (0 == (col % 3))   ? "%.17g"
+                                   : (1 == (col % 3)) ? "%.6f"
+                                                      : "%.15g";
+            snprintf(text, sizeof(text), p_format, x);
+            p_ref->p_data[(row * p_ref->ld) + col] = strtod(text, NULL);
+            fprintf(p_file, (6 == col) ? "%s\n" : "%s,", text);
+        }
+    }
+
+    fclose(p_file);
+    parallel_set_threads(4);
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 30000, 7, &p_loaded),
+                    MATRIX_SUCCESS);
+    parallel_set_threads(0);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_loaded);
+    CU_ASSERT_TRUE(matrix_is_equal(p_loaded, p_ref));
+    matrix_destroy(p_loaded);
+
+    matrix_destroy(p_ref);
+    remove(path);
+    return;
+}
+
+static void
+test_matrix_io_csv_invalid (void)
+{
+    char      path[64];
+    matrix_t *p_loaded = NULL;
+    make_temp_path(path, sizeof(path));
+
+    // Empty and blank files
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 0, 0, &p_loaded),
+                    MATRIX_INVALID_ARGUMENT);
+    write_text(path, "\n \r\n\n");
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 0, 0, &p_loaded),
+                    MATRIX_INVALID_ARGUMENT);
+
+    // Ragged rows, bad fields, trailing comma
+    write_text(path, "1,2\n3\n");
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 0, 0, &p_loaded),
+                    MATRIX_INVALID_ARGUMENT);
+    write_text(path, "1,2\n3,4,5\n");
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 0, 0, &p_loaded),
+                    MATRIX_INVALID_ARGUMENT);
+    write_text(path, "1,abc\n");
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 0, 0, &p_loaded),
+                    MATRIX_INVALID_ARGUMENT);
+    write_text(path, "1,2e\n");
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 0, 0, &p_loaded),
+                    MATRIX_INVALID_ARGUMENT);
+    write_text(path, "1,2,\n");
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 0, 0, &p_loaded),
+                    MATRIX_INVALID_ARGUMENT);
+    write_text(path, "1 2,3\n");
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 0, 0, &p_loaded),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_PTR_NULL(p_loaded);
+
+    // Hints must match the file
+    write_text(path, "1,2\n3,4\n");
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 3, 0, &p_loaded),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 0, 3, &p_loaded),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_load_csv(path, 2, 2, &p_loaded), MATRIX_SUCCESS);
+    matrix_destroy(p_loaded);
+
+    CU_ASSERT_EQUAL(matrix_load_csv(NULL, 0, 0, &p_loaded),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_load_csv("/nonexistent/matrix.csv", 0, 0, &p_loaded),
+                    MATRIX_FAILURE);
+
+    remove(path);
+    return;
+}
+
+/*** end of file ***/
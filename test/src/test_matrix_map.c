@@ -0,0 +1,284 @@
+/**
+ * @file    test_matrix_map.c
+ * @brief   Test suite for element-wise maps.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_matrix_map.h"
+#include "matrix_map.h"
+#include "parallel.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+typedef struct
+{
+    double lower;
+    double upper;
+    size_t calls;
+    size_t longest;
+} clamp_ctx_t;
+
+static void test_matrix_map_unary(void);
+static void test_matrix_map_binary(void);
+static void test_matrix_map_invalid(void);
+
+CU_pSuite
+matrix_map_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("matrix-map-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add matrix-map-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_map_unary", test_matrix_map_unary)))
+    {
+        ERROR_LOG("Failed to add test_matrix_map_unary to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_map_binary", test_matrix_map_binary)))
+    {
+        ERROR_LOG("Failed to add test_matrix_map_binary to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_map_invalid", test_matrix_map_invalid)))
+    {
+        ERROR_LOG("Failed to add test_matrix_map_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+/**
+ * @brief   Clamp kernel that also records how it was called. Not thread
+ *          safe; used by the serial tests only.
+ */
+static void
+clamp_counting (const double *p_in, double *p_out, size_t count, void *p_ctx)
+{
+    clamp_ctx_t *p_clamp = (clamp_ctx_t *)p_ctx;
+
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        p_out[idx] = fmin(fmax(p_in[idx], p_clamp->lower), p_clamp->upper);
+    }
+
+    p_clamp->calls += 1;
+    p_clamp->longest = (count > p_clamp->longest) ? count : p_clamp->longest;
+}
+
+/**
+ * @brief   Stateless kernel, out = 2 * in + 1.
+ */
+static void
+affine (const double *p_in, double *p_out, size_t count, void *p_ctx)
+{
+    (void)p_ctx;
+
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        p_out[idx] = (2.0 * p_in[idx]) + 1.0;
+    }
+}
+
+/**
+ * @brief   Binary kernel, out = a + scale * b.
+ */
+static void
+axpy (const double *p_a,
+      const double *p_b,
+      double       *p_out,
+      size_t        count,
+      void         *p_ctx)
+{
+    double scale = *(const double *)p_ctx;
+
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        p_out[idx] = p_a[idx] + (scale * p_b[idx]);
+    }
+}
+
+static void
+test_matrix_map_unary (void)
+{
+    matrix_t   *p_src = matrix_create(7, 3001);
+    matrix_t   *p_dst = matrix_create(7, 3001);
+    matrix_t    view  = { 0 };
+    clamp_ctx_t clamp = { .lower = -0.5, .upper = 0.75 };
+    double      value = 0.0;
+    double      in    = 0.0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_src);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_dst);
+    fill_pseudo_random(p_src, 3U);
+
+    // Padded rows: each row is cut into segments of at most
+    // MATRIX_MAP_SEGMENT elements
+    CU_ASSERT_EQUAL(matrix_map(p_src, p_dst, clamp_counting, &clamp),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(clamp.calls, 7 * 2);
+    CU_ASSERT_EQUAL(clamp.longest, MATRIX_MAP_SEGMENT);
+
+    for (size_t row = 0; row < 7; ++row)
+    {
+        for (size_t col = 0; col < 3001; col += 7)
+        {
+            matrix_get(p_src, row, col, &in);
+            matrix_get(p_dst, row, col, &value);
+            CU_ASSERT_EQUAL(value, fmin(fmax(in, -0.5), 0.75));
+        }
+    }
+
+    // Packed rows are treated as one flat run
+    matrix_t *p_packed = matrix_create(500, 6);
+    clamp.calls        = 0;
+    fill_pseudo_random(p_packed, 5U);
+    CU_ASSERT_EQUAL(matrix_map(p_packed, p_packed, clamp_counting, &clamp),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(clamp.calls, (3000 + MATRIX_MAP_SEGMENT - 1)
+                                     / MATRIX_MAP_SEGMENT);
+
+    for (size_t idx = 0; idx < 3000; ++idx)
+    {
+        CU_ASSERT(p_packed->p_data[idx] >= -0.5);
+        CU_ASSERT(p_packed->p_data[idx] <= 0.75);
+    }
+
+    // In place through a view leaves the rest of the matrix alone
+    matrix_copy_into(p_dst, p_src);
+    CU_ASSERT_EQUAL(matrix_view(p_dst, 2, 10, 3, 40, &view), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_map(&view, &view, affine, NULL), MATRIX_SUCCESS);
+    matrix_get(p_src, 3, 20, &in);
+    matrix_get(p_dst, 3, 20, &value);
+    CU_ASSERT_EQUAL(value, (2.0 * in) + 1.0);
+    matrix_get(p_src, 3, 50, &in);
+    matrix_get(p_dst, 3, 50, &value);
+    CU_ASSERT_EQUAL(value, in);
+
+    // The parallel variant gives the same result
+    matrix_t *p_big = matrix_create(300, 1000);
+    matrix_t *p_out = matrix_create(300, 1000);
+    fill_pseudo_random(p_big, 7U);
+    parallel_set_threads(4);
+    CU_ASSERT_EQUAL(matrix_map_parallel(p_big, p_out, affine, NULL),
+                    MATRIX_SUCCESS);
+    parallel_set_threads(0);
+
+    for (size_t row = 0; row < 300; ++row)
+    {
+        for (size_t col = 0; col < 1000; col += 13)
+        {
+            matrix_get(p_big, row, col, &in);
+            matrix_get(p_out, row, col, &value);
+            CU_ASSERT_EQUAL(value, (2.0 * in) + 1.0);
+        }
+    }
+
+    matrix_destroy(p_src);
+    matrix_destroy(p_dst);
+    matrix_destroy(p_packed);
+    matrix_destroy(p_big);
+    matrix_destroy(p_out);
+}
+
+static void
+test_matrix_map_binary (void)
+{
+    matrix_t *p_a   = matrix_create(300, 700);
+    matrix_t *p_b   = matrix_create(300, 700);
+    matrix_t *p_out = matrix_create(300, 700);
+    double    scale = -3.0;
+    double    a     = 0.0;
+    double    b     = 0.0;
+    double    value = 0.0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_a);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_b);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_out);
+    fill_pseudo_random(p_a, 11U);
+    fill_pseudo_random(p_b, 13U);
+
+    CU_ASSERT_EQUAL(matrix_zip_map(p_a, p_b, p_out, axpy, &scale),
+                    MATRIX_SUCCESS);
+
+    for (size_t row = 0; row < 300; row += 7)
+    {
+        for (size_t col = 0; col < 700; ++col)
+        {
+            matrix_get(p_a, row, col, &a);
+            matrix_get(p_b, row, col, &b);
+            matrix_get(p_out, row, col, &value);
+            CU_ASSERT_EQUAL(value, a + (scale * b));
+        }
+    }
+
+    // Output aliasing an input, split across threads
+    parallel_set_threads(3);
+    CU_ASSERT_EQUAL(matrix_zip_map_parallel(p_a, p_b, p_a, axpy, &scale),
+                    MATRIX_SUCCESS);
+    parallel_set_threads(0);
+    CU_ASSERT_TRUE(matrix_is_equal(p_a, p_out));
+
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    matrix_destroy(p_out);
+}
+
+static void
+test_matrix_map_invalid (void)
+{
+    matrix_t *p_a    = matrix_create(4, 4);
+    matrix_t *p_b    = matrix_create(4, 5);
+    matrix_t  top    = { 0 };
+    matrix_t  bottom = { 0 };
+    double    scale  = 1.0;
+
+    CU_ASSERT_EQUAL(matrix_map(NULL, p_a, affine, NULL),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_map(p_a, p_a, NULL, NULL),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_map(p_a, p_b, affine, NULL),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_zip_map(p_a, NULL, p_a, axpy, &scale),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_zip_map_parallel(p_a, p_b, p_a, axpy, &scale),
+                    MATRIX_INVALID_ARGUMENT);
+
+    // Overlapping other than element for element is rejected
+    matrix_view(p_a, 0, 0, 3, 4, &top);
+    matrix_view(p_a, 1, 0, 3, 4, &bottom);
+    CU_ASSERT_EQUAL(matrix_map(&top, &bottom, affine, NULL),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_zip_map(&top, &top, &bottom, axpy, &scale),
+                    MATRIX_INVALID_ARGUMENT);
+
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+}
+
+/*** end of file ***/
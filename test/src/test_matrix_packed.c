@@ -0,0 +1,424 @@
+/**
+ * @file    test_matrix_packed.c
+ * @brief   Test suite for packed and banded matrix storage.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_matrix_packed.h"
+#include "matrix_packed.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define PACKED_ORDER 7
+#define BAND_ORDER   200
+#define BAND_KL      3
+#define BAND_KU      2
+#define BAND_NRHS    3
+
+static void test_matrix_packed_storage(void);
+static void test_matrix_packed_band(void);
+static void test_matrix_packed_band_solve(void);
+static void test_matrix_packed_invalid(void);
+
+CU_pSuite
+matrix_packed_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("matrix-packed-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add matrix-packed-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_packed_storage", test_matrix_packed_storage)))
+    {
+        ERROR_LOG("Failed to add test_matrix_packed_storage to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_packed_band", test_matrix_packed_band)))
+    {
+        ERROR_LOG("Failed to add test_matrix_packed_band to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite,
+                        "test_matrix_packed_band_solve",
+                        test_matrix_packed_band_solve)))
+    {
+        ERROR_LOG("Failed to add test_matrix_packed_band_solve to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_packed_invalid", test_matrix_packed_invalid)))
+    {
+        ERROR_LOG("Failed to add test_matrix_packed_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+/**
+ * @brief   y = A * x for a dense matrix, the reference for the gemv tests.
+ */
+static void
+dense_gemv (const matrix_t *p_a, const double *p_x, double *p_y)
+{
+    for (size_t row = 0; row < p_a->rows; ++row)
+    {
+        p_y[row] = 0.0;
+
+        for (size_t col = 0; col < p_a->cols; ++col)
+        {
+            p_y[row] += p_a->p_data[(row * p_a->ld) + col] * p_x[col];
+        }
+    }
+}
+
+static void
+test_matrix_packed_storage (void)
+{
+    matrix_t *p_dense    = matrix_create(PACKED_ORDER, PACKED_ORDER);
+    matrix_t *p_expected = matrix_create(PACKED_ORDER, PACKED_ORDER);
+    matrix_t *p_result   = matrix_create(PACKED_ORDER, PACKED_ORDER);
+    double    x[PACKED_ORDER];
+    double    y[PACKED_ORDER];
+    double    y_ref[PACKED_ORDER];
+    double    value = 0.0;
+
+    fill_pseudo_random(p_dense, 3U);
+
+    for (size_t idx = 0; idx < PACKED_ORDER; ++idx)
+    {
+        x[idx] = (double)idx - 2.5;
+    }
+
+    for (int kind = 0; kind < 2; ++kind)
+    {
+        for (int uplo = 0; uplo < 2; ++uplo)
+        {
+            matrix_packed_t *p_packed = matrix_packed_from_dense(
+                p_dense, (matrix_packed_kind_t)kind, (matrix_uplo_t)uplo);
+
+            CU_ASSERT_PTR_NOT_NULL_FATAL(p_packed);
+
+            // Build the dense matrix the packed one stands for
+            for (size_t row = 0; row < PACKED_ORDER; ++row)
+            {
+                for (size_t col = 0; col < PACKED_ORDER; ++col)
+                {
+                    bool   b_stored = (MATRIX_UPPER == uplo) ? (col >= row)
+                                                             : (col <= row);
+                    double src      = 0.0;
+
+                    matrix_get(p_dense, row, col, &src);
+
+                    if (!b_stored)
+                    {
+                        src = 0.0;
+
+                        if (MATRIX_PACKED_SYMMETRIC == kind)
+                        {
+                            matrix_get(p_dense, col, row, &src);
+                        }
+                    }
+
+                    matrix_set(p_expected, row, col, src);
+                    CU_ASSERT_EQUAL(
+                        matrix_packed_get(p_packed, row, col, &value),
+                        MATRIX_SUCCESS);
+                    CU_ASSERT_EQUAL(value, src);
+                }
+            }
+
+            CU_ASSERT_EQUAL(matrix_packed_to_dense(p_packed, p_result),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_EQUAL(max_abs_diff(p_result, p_expected), 0.0);
+
+            // y = 2 * A * x - 1 * y
+            dense_gemv(p_expected, x, y_ref);
+
+            for (size_t idx = 0; idx < PACKED_ORDER; ++idx)
+            {
+                y[idx]     = 1.0;
+                y_ref[idx] = (2.0 * y_ref[idx]) - 1.0;
+            }
+
+            CU_ASSERT_EQUAL(matrix_packed_gemv(p_packed, 2.0, x, -1.0, y),
+                            MATRIX_SUCCESS);
+
+            for (size_t idx = 0; idx < PACKED_ORDER; ++idx)
+            {
+                CU_ASSERT_DOUBLE_EQUAL(y[idx], y_ref[idx], 1e-13);
+            }
+
+            // Setting across the diagonal mirrors or is rejected
+            size_t row = (MATRIX_UPPER == uplo) ? 5 : 1;
+            size_t col = (MATRIX_UPPER == uplo) ? 1 : 5;
+
+            if (MATRIX_PACKED_SYMMETRIC == kind)
+            {
+                CU_ASSERT_EQUAL(matrix_packed_set(p_packed, row, col, 9.0),
+                                MATRIX_SUCCESS);
+                CU_ASSERT_EQUAL(matrix_packed_get(p_packed, col, row, &value),
+                                MATRIX_SUCCESS);
+                CU_ASSERT_EQUAL(value, 9.0);
+            }
+            else
+            {
+                CU_ASSERT_EQUAL(matrix_packed_set(p_packed, row, col, 9.0),
+                                MATRIX_OUT_OF_BOUNDS);
+                CU_ASSERT_EQUAL(matrix_packed_set(p_packed, col, row, 9.0),
+                                MATRIX_SUCCESS);
+            }
+
+            matrix_packed_destroy(p_packed);
+        }
+    }
+
+    // Upper rows are stored back to back: row 1 starts after the n
+    // elements of row 0
+    matrix_packed_t *p_packed = matrix_packed_create(
+        MATRIX_PACKED_TRIANGULAR, MATRIX_UPPER, PACKED_ORDER);
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_packed);
+    CU_ASSERT_EQUAL(matrix_packed_set(p_packed, 1, 1, 4.0), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(p_packed->p_data[PACKED_ORDER], 4.0);
+    CU_ASSERT_EQUAL(
+        matrix_packed_set(p_packed, PACKED_ORDER - 1, PACKED_ORDER - 1, 5.0),
+        MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(
+        p_packed->p_data[((PACKED_ORDER * (PACKED_ORDER + 1)) / 2) - 1], 5.0);
+    matrix_packed_destroy(p_packed);
+
+    matrix_destroy(p_dense);
+    matrix_destroy(p_expected);
+    matrix_destroy(p_result);
+}
+
+static void
+test_matrix_packed_band (void)
+{
+    const size_t   n          = 9;
+    matrix_t      *p_dense    = matrix_create(n, n);
+    matrix_t      *p_expected = matrix_create(n, n);
+    matrix_t      *p_result   = matrix_create(n, n);
+    matrix_band_t *p_band     = NULL;
+    double         x[9];
+    double         y[9];
+    double         y_ref[9];
+    double         value = 0.0;
+
+    fill_pseudo_random(p_dense, 5U);
+    p_band = matrix_band_from_dense(p_dense, 2, 1);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_band);
+    CU_ASSERT_EQUAL(p_band->ld, 6);
+
+    for (size_t row = 0; row < n; ++row)
+    {
+        x[row] = 1.0 / (double)(row + 1);
+
+        for (size_t col = 0; col < n; ++col)
+        {
+            double src = 0.0;
+
+            if ((col + 2 >= row) && (col <= row + 1))
+            {
+                matrix_get(p_dense, row, col, &src);
+            }
+
+            matrix_set(p_expected, row, col, src);
+            CU_ASSERT_EQUAL(matrix_band_get(p_band, row, col, &value),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_EQUAL(value, src);
+        }
+    }
+
+    CU_ASSERT_EQUAL(matrix_band_to_dense(p_band, p_result), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(max_abs_diff(p_result, p_expected), 0.0);
+
+    dense_gemv(p_expected, x, y_ref);
+    CU_ASSERT_EQUAL(matrix_band_gemv(p_band, 1.0, x, 0.0, y), MATRIX_SUCCESS);
+
+    for (size_t idx = 0; idx < n; ++idx)
+    {
+        CU_ASSERT_DOUBLE_EQUAL(y[idx], y_ref[idx], 1e-14);
+    }
+
+    CU_ASSERT_EQUAL(matrix_band_set(p_band, 4, 2, 7.0), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_band_get(p_band, 4, 2, &value), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(value, 7.0);
+    CU_ASSERT_EQUAL(matrix_band_set(p_band, 4, 6, 7.0), MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_band_set(p_band, 4, 1, 7.0), MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_band_set(p_band, n, 0, 7.0), MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_band_get(p_band, 0, n - 1, &value),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(value, 0.0);
+
+    matrix_band_destroy(p_band);
+    matrix_destroy(p_dense);
+    matrix_destroy(p_expected);
+    matrix_destroy(p_result);
+}
+
+static void
+test_matrix_packed_band_solve (void)
+{
+    matrix_t      *p_dense  = matrix_create(BAND_ORDER, BAND_ORDER);
+    matrix_t      *p_b      = matrix_create(BAND_ORDER, BAND_NRHS);
+    matrix_t      *p_x      = matrix_create(BAND_ORDER, BAND_NRHS);
+    matrix_t      *p_ref    = matrix_create(BAND_ORDER, BAND_NRHS);
+    matrix_t      *p_lu     = matrix_create(BAND_ORDER, BAND_ORDER);
+    size_t        *p_pivots = calloc(BAND_ORDER, sizeof(size_t));
+    matrix_band_t *p_band   = NULL;
+    size_t         swaps    = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_pivots);
+
+    // Random band without a dominant diagonal, so rows get swapped and
+    // the fill-in columns are exercised
+    fill_pseudo_random(p_dense, 17U);
+    fill_pseudo_random(p_b, 19U);
+    p_band = matrix_band_from_dense(p_dense, BAND_KL, BAND_KU);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_band);
+    CU_ASSERT_EQUAL(matrix_band_to_dense(p_band, p_dense), MATRIX_SUCCESS);
+
+    CU_ASSERT_EQUAL(matrix_lu(p_dense, p_lu, p_pivots, NULL),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_lu_solve(p_lu, p_pivots, p_b, p_ref),
+                    MATRIX_SUCCESS);
+
+    CU_ASSERT_EQUAL(matrix_band_solve(p_band, p_b, p_x), MATRIX_SUCCESS);
+    CU_ASSERT(max_abs_diff(p_x, p_ref) < 1e-9);
+
+    // In-place factorization, solving over the right-hand side
+    CU_ASSERT_EQUAL(matrix_band_lu(p_band, p_pivots), MATRIX_SUCCESS);
+
+    for (size_t idx = 0; idx < BAND_ORDER; ++idx)
+    {
+        CU_ASSERT(p_pivots[idx] >= idx);
+        CU_ASSERT(p_pivots[idx] <= idx + BAND_KL);
+        swaps += (p_pivots[idx] != idx) ? 1 : 0;
+    }
+
+    CU_ASSERT(swaps > 0);
+    CU_ASSERT_EQUAL(matrix_band_lu_solve(p_band, p_pivots, p_b, p_b),
+                    MATRIX_SUCCESS);
+    CU_ASSERT(max_abs_diff(p_b, p_ref) < 1e-9);
+
+    // X may share B's storage exactly, but not shifted by a row
+    matrix_t *p_grid = matrix_create(BAND_ORDER + 1, BAND_NRHS);
+    matrix_t  b_view = { 0 };
+    matrix_t  x_view = { 0 };
+    CU_ASSERT_EQUAL(matrix_view(p_grid, 0, 0, BAND_ORDER, BAND_NRHS, &b_view),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_view(p_grid, 1, 0, BAND_ORDER, BAND_NRHS, &x_view),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(
+        matrix_band_lu_solve(p_band, p_pivots, &b_view, &x_view),
+        MATRIX_INVALID_ARGUMENT);
+    matrix_destroy(p_grid);
+    matrix_band_destroy(p_band);
+
+    // A zero column is reported but the factorization still completes
+    matrix_t *p_small = matrix_create(4, 1);
+
+    p_band = matrix_band_create(4, 1, 1);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_band);
+    matrix_band_set(p_band, 0, 0, 1.0);
+    matrix_band_set(p_band, 2, 2, 1.0);
+    matrix_band_set(p_band, 3, 3, 1.0);
+    CU_ASSERT_EQUAL(matrix_band_solve(p_band, p_small, p_small),
+                    MATRIX_SINGULAR);
+    CU_ASSERT_EQUAL(matrix_band_lu(p_band, p_pivots), MATRIX_SINGULAR);
+    matrix_destroy(p_small);
+
+    matrix_band_destroy(p_band);
+    free(p_pivots);
+    matrix_destroy(p_dense);
+    matrix_destroy(p_b);
+    matrix_destroy(p_x);
+    matrix_destroy(p_ref);
+    matrix_destroy(p_lu);
+}
+
+static void
+test_matrix_packed_invalid (void)
+{
+    matrix_t        *p_rect   = matrix_create(3, 4);
+    matrix_t        *p_square = matrix_create(4, 4);
+    matrix_packed_t *p_packed = NULL;
+    matrix_band_t   *p_band   = NULL;
+    size_t           pivots[4];
+    double           value    = 0.0;
+
+    CU_ASSERT_PTR_NULL(
+        matrix_packed_create(MATRIX_PACKED_SYMMETRIC, MATRIX_UPPER, 0));
+    CU_ASSERT_PTR_NULL(matrix_packed_create(
+        MATRIX_PACKED_SYMMETRIC, MATRIX_UPPER, SIZE_MAX));
+    CU_ASSERT_PTR_NULL(matrix_packed_from_dense(
+        p_rect, MATRIX_PACKED_SYMMETRIC, MATRIX_UPPER));
+    CU_ASSERT_PTR_NULL(
+        matrix_packed_from_dense(NULL, MATRIX_PACKED_SYMMETRIC, MATRIX_LOWER));
+    CU_ASSERT_PTR_NULL(matrix_band_create(0, 0, 0));
+    CU_ASSERT_PTR_NULL(matrix_band_create(4, 4, 0));
+    CU_ASSERT_PTR_NULL(matrix_band_create(4, 0, 4));
+    CU_ASSERT_PTR_NULL(matrix_band_from_dense(p_rect, 1, 1));
+
+    p_packed = matrix_packed_create(
+        MATRIX_PACKED_TRIANGULAR, MATRIX_LOWER, 3);
+    p_band   = matrix_band_create(3, 1, 0);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_packed);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_band);
+
+    CU_ASSERT_EQUAL(matrix_packed_get(p_packed, 3, 0, &value),
+                    MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_packed_get(p_packed, 0, 0, NULL),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_packed_to_dense(p_packed, p_square),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_packed_gemv(p_packed, 1.0, NULL, 0.0, &value),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_band_to_dense(p_band, p_square),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_band_get(p_band, 0, 3, &value),
+                    MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_band_gemv(NULL, 1.0, &value, 0.0, &value),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_band_lu(p_band, NULL), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_band_lu_solve(p_band, pivots, p_square, p_square),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_band_solve(p_band, p_square, p_square),
+                    MATRIX_INVALID_ARGUMENT);
+
+    matrix_packed_destroy(p_packed);
+    matrix_band_destroy(p_band);
+    matrix_destroy(p_rect);
+    matrix_destroy(p_square);
+}
+
+/*** end of file ***/
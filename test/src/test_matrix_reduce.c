@@ -0,0 +1,246 @@
+/**
+ * @file    test_matrix_reduce.c
+ * @brief   Test suite for matrix reductions.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_matrix_reduce.h"
+#include "matrix_reduce.h"
+#include "parallel.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+static void test_matrix_reduce_basic(void);
+static void test_matrix_reduce_large(void);
+static void test_matrix_reduce_invalid(void);
+
+CU_pSuite
+matrix_reduce_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("matrix-reduce-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add matrix-reduce-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_reduce_basic", test_matrix_reduce_basic)))
+    {
+        ERROR_LOG("Failed to add test_matrix_reduce_basic to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_reduce_large", test_matrix_reduce_large)))
+    {
+        ERROR_LOG("Failed to add test_matrix_reduce_large to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_reduce_invalid", test_matrix_reduce_invalid)))
+    {
+        ERROR_LOG("Failed to add test_matrix_reduce_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+static void
+test_matrix_reduce_basic (void)
+{
+    // | 1  -4   2 |
+    // | 3   0  -4 |
+    const double values[2][3] = { { 1.0, -4.0, 2.0 }, { 3.0, 0.0, -4.0 } };
+    matrix_t    *p_matrix     = matrix_create(2, 3);
+    double       out[3]       = { 0.0 };
+    size_t       pos[3]       = { 0 };
+    size_t       row          = 0;
+    size_t       col          = 0;
+
+    for (size_t r = 0; r < 2; ++r)
+    {
+        for (size_t c = 0; c < 3; ++c)
+        {
+            matrix_set(p_matrix, r, c, values[r][c]);
+        }
+    }
+
+    matrix_reduce(p_matrix, MATRIX_REDUCE_SUM, MATRIX_AXIS_ALL, out);
+    CU_ASSERT_DOUBLE_EQUAL(out[0], -2.0, 1e-15);
+    matrix_reduce(p_matrix, MATRIX_REDUCE_MEAN, MATRIX_AXIS_ALL, out);
+    CU_ASSERT_DOUBLE_EQUAL(out[0], -2.0 / 6.0, 1e-15);
+    matrix_reduce(p_matrix, MATRIX_REDUCE_NORM_L2, MATRIX_AXIS_ALL, out);
+    CU_ASSERT_DOUBLE_EQUAL(out[0], sqrt(46.0), 1e-14);
+    matrix_reduce(p_matrix, MATRIX_REDUCE_NORM_INF, MATRIX_AXIS_ALL, out);
+    CU_ASSERT_EQUAL(out[0], 4.0);
+
+    // Ties go to the first element in row-major order
+    CU_ASSERT_EQUAL(matrix_argmin(p_matrix, &row, &col), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(row, 0);
+    CU_ASSERT_EQUAL(col, 1);
+    CU_ASSERT_EQUAL(matrix_argmax(p_matrix, &row, &col), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(row, 1);
+    CU_ASSERT_EQUAL(col, 0);
+
+    matrix_reduce(p_matrix, MATRIX_REDUCE_MAX, MATRIX_AXIS_ROWS, out);
+    CU_ASSERT_EQUAL(out[0], 2.0);
+    CU_ASSERT_EQUAL(out[1], 3.0);
+    matrix_reduce(p_matrix, MATRIX_REDUCE_NORM_L1, MATRIX_AXIS_COLS, out);
+    CU_ASSERT_EQUAL(out[0], 4.0);
+    CU_ASSERT_EQUAL(out[1], 4.0);
+    CU_ASSERT_EQUAL(out[2], 6.0);
+    matrix_reduce(p_matrix, MATRIX_REDUCE_MIN, MATRIX_AXIS_COLS, out);
+    CU_ASSERT_EQUAL(out[0], 1.0);
+    CU_ASSERT_EQUAL(out[1], -4.0);
+    CU_ASSERT_EQUAL(out[2], -4.0);
+
+    matrix_reduce_index(p_matrix, MATRIX_REDUCE_MIN, MATRIX_AXIS_ROWS, pos);
+    CU_ASSERT_EQUAL(pos[0], 1);
+    CU_ASSERT_EQUAL(pos[1], 2);
+    matrix_reduce_index(
+        p_matrix, MATRIX_REDUCE_NORM_INF, MATRIX_AXIS_COLS, pos);
+    CU_ASSERT_EQUAL(pos[0], 1);
+    CU_ASSERT_EQUAL(pos[1], 0);
+    CU_ASSERT_EQUAL(pos[2], 1);
+
+    matrix_norm(p_matrix, MATRIX_NORM_ONE, out);
+    CU_ASSERT_EQUAL(out[0], 6.0);
+    matrix_norm(p_matrix, MATRIX_NORM_INF, out);
+    CU_ASSERT_EQUAL(out[0], 7.0);
+    matrix_norm(p_matrix, MATRIX_NORM_FROBENIUS, out);
+    CU_ASSERT_DOUBLE_EQUAL(out[0], sqrt(46.0), 1e-14);
+
+    matrix_destroy(p_matrix);
+    return;
+}
+
+static void
+test_matrix_reduce_large (void)
+{
+    // Rows longer than one segment, views, and four threads
+    const size_t rows   = 70;
+    const size_t cols   = 9001;
+    matrix_t    *p_big  = matrix_create(rows + 2, cols + 3);
+    matrix_t     blk    = { 0 };
+    double      *p_row  = calloc(rows, sizeof(double));
+    double      *p_col  = calloc(cols, sizeof(double));
+    size_t      *p_pos  = calloc(cols, sizeof(size_t));
+    long double  total  = 0.0L;
+    double       result = 0.0;
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_row);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_col);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_pos);
+    fill_pseudo_random(p_big, 71U);
+    matrix_view(p_big, 1, 2, rows, cols, &blk);
+    matrix_set(&blk, 37, 8000, 5.0);
+    matrix_set(&blk, 38, 8000, 5.0);
+    matrix_set(&blk, 3, 4100, -7.0);
+    parallel_set_threads(4);
+
+    CU_ASSERT_EQUAL(
+        matrix_reduce(&blk, MATRIX_REDUCE_SUM, MATRIX_AXIS_ROWS, p_row),
+        MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(
+        matrix_reduce(&blk, MATRIX_REDUCE_SUM, MATRIX_AXIS_COLS, p_col),
+        MATRIX_SUCCESS);
+
+    for (size_t row = 0; row < rows; ++row)
+    {
+        long double sum = 0.0L;
+
+        for (size_t col = 0; col < cols; ++col)
+        {
+            sum += blk.p_data[(row * blk.ld) + col];
+        }
+
+        CU_ASSERT_DOUBLE_EQUAL(p_row[row], (double)sum, 1e-11);
+        total += sum;
+    }
+
+    for (size_t col = 0; col < cols; ++col)
+    {
+        long double sum = 0.0L;
+
+        for (size_t row = 0; row < rows; ++row)
+        {
+            sum += blk.p_data[(row * blk.ld) + col];
+        }
+
+        CU_ASSERT_DOUBLE_EQUAL(p_col[col], (double)sum, 1e-12);
+    }
+
+    matrix_reduce(&blk, MATRIX_REDUCE_SUM, MATRIX_AXIS_ALL, &result);
+    CU_ASSERT_DOUBLE_EQUAL(result, (double)total, 1e-9);
+
+    size_t row = 0;
+    size_t col = 0;
+    matrix_argmax(&blk, &row, &col);
+    CU_ASSERT_EQUAL(row, 37);
+    CU_ASSERT_EQUAL(col, 8000);
+    matrix_argmin(&blk, &row, &col);
+    CU_ASSERT_EQUAL(row, 3);
+    CU_ASSERT_EQUAL(col, 4100);
+    matrix_reduce_index(&blk, MATRIX_REDUCE_MAX, MATRIX_AXIS_COLS, p_pos);
+    CU_ASSERT_EQUAL(p_pos[8000], 37);
+    matrix_reduce(&blk, MATRIX_REDUCE_NORM_INF, MATRIX_AXIS_ALL, &result);
+    CU_ASSERT_EQUAL(result, 7.0);
+
+    parallel_set_threads(0);
+    free(p_row);
+    free(p_col);
+    free(p_pos);
+    matrix_destroy(p_big);
+    return;
+}
+
+static void
+test_matrix_reduce_invalid (void)
+{
+    matrix_t *p_matrix = matrix_create(2, 2);
+    double    value    = 0.0;
+    size_t    pos      = 0;
+
+    CU_ASSERT_EQUAL(
+        matrix_reduce(NULL, MATRIX_REDUCE_SUM, MATRIX_AXIS_ALL, &value),
+        MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_reduce(p_matrix,
+                                  (matrix_reduce_op_t)42,
+                                  MATRIX_AXIS_ALL,
+                                  &value),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(
+        matrix_reduce(p_matrix, MATRIX_REDUCE_SUM, (matrix_axis_t)9, &value),
+        MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(
+        matrix_reduce_index(p_matrix, MATRIX_REDUCE_SUM, MATRIX_AXIS_ALL, &pos),
+        MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_argmax(p_matrix, NULL, &pos),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_norm(p_matrix, (matrix_norm_t)5, &value),
+                    MATRIX_INVALID_ARGUMENT);
+
+    matrix_destroy(p_matrix);
+    return;
+}
+
+/*** end of file ***/
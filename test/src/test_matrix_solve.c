@@ -0,0 +1,267 @@
+/**
+ * @file    test_matrix_solve.c
+ * @brief   Test suite for matrix solvers.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_matrix_solve.h"
+#include "matrix_solve.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+static void test_matrix_solve_cholesky(void);
+static void test_matrix_solve_lu(void);
+static void test_matrix_solve_qr(void);
+static void test_matrix_solve_invalid(void);
+
+CU_pSuite
+matrix_solve_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("matrix-solve-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add matrix-solve-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite,
+                        "test_matrix_solve_cholesky",
+                        test_matrix_solve_cholesky)))
+    {
+        ERROR_LOG("Failed to add test_matrix_solve_cholesky to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_matrix_solve_lu", test_matrix_solve_lu)))
+    {
+        ERROR_LOG("Failed to add test_matrix_solve_lu to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_matrix_solve_qr", test_matrix_solve_qr)))
+    {
+        ERROR_LOG("Failed to add test_matrix_solve_qr to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_solve_invalid", test_matrix_solve_invalid)))
+    {
+        ERROR_LOG("Failed to add test_matrix_solve_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+static void
+test_matrix_solve_cholesky (void)
+{
+    // A = M * M^T + n * I is symmetric positive definite
+    size_t    n     = 100;
+    matrix_t *p_m   = matrix_create(n, n);
+    matrix_t *p_mt  = matrix_create(n, n);
+    matrix_t *p_a   = matrix_create(n, n);
+    matrix_t *p_x   = matrix_create(n, 4);
+    matrix_t *p_b   = matrix_create(n, 4);
+    matrix_t *p_sol = matrix_create(n, 4);
+    double    val   = 0.0;
+    fill_pseudo_random(p_m, 3U);
+    fill_pseudo_random(p_x, 5U);
+    CU_ASSERT_EQUAL(matrix_transpose(p_m, p_mt), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_multiply(p_m, p_mt, p_a), MATRIX_SUCCESS);
+
+    for (size_t idx = 0; idx < n; ++idx)
+    {
+        matrix_get(p_a, idx, idx, &val);
+        matrix_set(p_a, idx, idx, val + (double)n);
+    }
+
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_x, p_b), MATRIX_SUCCESS);
+
+    // Automatic selection picks Cholesky for an SPD matrix
+    matrix_factor_t *p_factor = NULL;
+    CU_ASSERT_EQUAL(matrix_factorize(p_a, MATRIX_SOLVE_AUTO, &p_factor),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_PTR_NOT_NULL(p_factor);
+    CU_ASSERT_EQUAL(p_factor->method, MATRIX_SOLVE_CHOLESKY);
+    CU_ASSERT_EQUAL(matrix_factor_solve(p_factor, p_b, p_sol), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_sol, p_x), 0.0, 1e-9);
+    matrix_factor_destroy(p_factor);
+
+    CU_ASSERT_EQUAL(matrix_solve(p_a, p_b, p_b), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_b, p_x), 0.0, 1e-9);
+
+    // Symmetric but indefinite: explicit Cholesky fails, auto falls back
+    matrix_set(p_a, 0, 0, -1000.0);
+    CU_ASSERT_EQUAL(matrix_factorize(p_a, MATRIX_SOLVE_CHOLESKY, &p_factor),
+                    MATRIX_NOT_POSITIVE_DEFINITE);
+    CU_ASSERT_PTR_NULL(p_factor);
+    matrix_set(p_a, 0, 0, 0.5);
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_x, p_b), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_factorize(p_a, MATRIX_SOLVE_AUTO, &p_factor),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(p_factor->method, MATRIX_SOLVE_LU);
+    CU_ASSERT_EQUAL(matrix_factor_solve(p_factor, p_b, p_sol), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_sol, p_x), 0.0, 1e-8);
+    matrix_factor_destroy(p_factor);
+
+    matrix_destroy(p_m);
+    matrix_destroy(p_mt);
+    matrix_destroy(p_a);
+    matrix_destroy(p_x);
+    matrix_destroy(p_b);
+    matrix_destroy(p_sol);
+    return;
+}
+
+static void
+test_matrix_solve_lu (void)
+{
+    size_t    n     = 90;
+    matrix_t *p_a   = matrix_create(n, n);
+    matrix_t *p_x   = matrix_create(n, 2);
+    matrix_t *p_b   = matrix_create(n, 2);
+    matrix_t *p_sol = matrix_create(n, 2);
+    fill_pseudo_random(p_a, 17U);
+
+    // One factorization reused for two batches of right-hand sides
+    matrix_factor_t *p_factor = NULL;
+    CU_ASSERT_EQUAL(matrix_factorize(p_a, MATRIX_SOLVE_AUTO, &p_factor),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(p_factor->method, MATRIX_SOLVE_LU);
+
+    for (unsigned int seed = 1U; seed <= 2U; ++seed)
+    {
+        fill_pseudo_random(p_x, seed);
+        CU_ASSERT_EQUAL(matrix_multiply(p_a, p_x, p_b), MATRIX_SUCCESS);
+        CU_ASSERT_EQUAL(matrix_factor_solve(p_factor, p_b, p_sol),
+                        MATRIX_SUCCESS);
+        CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_sol, p_x), 0.0, 1e-8);
+    }
+
+    matrix_factor_destroy(p_factor);
+
+    // Singular system
+    matrix_fill(p_a, 1.0);
+    CU_ASSERT_EQUAL(matrix_solve_using(p_a, MATRIX_SOLVE_LU, p_b, p_sol),
+                    MATRIX_SINGULAR);
+
+    matrix_destroy(p_a);
+    matrix_destroy(p_x);
+    matrix_destroy(p_b);
+    matrix_destroy(p_sol);
+    return;
+}
+
+static void
+test_matrix_solve_qr (void)
+{
+    // Consistent overdetermined system spanning several QR panels
+    size_t    rows  = 120;
+    size_t    cols  = 70;
+    matrix_t *p_a   = matrix_create(rows, cols);
+    matrix_t *p_x   = matrix_create(cols, 3);
+    matrix_t *p_b   = matrix_create(rows, 3);
+    matrix_t *p_sol = matrix_create(cols, 3);
+    fill_pseudo_random(p_a, 23U);
+    fill_pseudo_random(p_x, 29U);
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_x, p_b), MATRIX_SUCCESS);
+
+    CU_ASSERT_EQUAL(matrix_solve(p_a, p_b, p_sol), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_sol, p_x), 0.0, 1e-9);
+
+    // Inconsistent system: the residual must be orthogonal to range(A)
+    fill_pseudo_random(p_b, 31U);
+    CU_ASSERT_EQUAL(matrix_solve_using(p_a, MATRIX_SOLVE_QR, p_b, p_sol),
+                    MATRIX_SUCCESS);
+
+    matrix_t *p_ax  = matrix_create(rows, 3);
+    matrix_t *p_at  = matrix_create(cols, rows);
+    matrix_t *p_atr = matrix_create(cols, 3);
+    double    val_b = 0.0;
+    double    val_r = 0.0;
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_sol, p_ax), MATRIX_SUCCESS);
+
+    for (size_t row = 0; row < rows; ++row)
+    {
+        for (size_t col = 0; col < 3; ++col)
+        {
+            matrix_get(p_b, row, col, &val_b);
+            matrix_get(p_ax, row, col, &val_r);
+            matrix_set(p_ax, row, col, val_r - val_b);
+        }
+    }
+
+    CU_ASSERT_EQUAL(matrix_transpose(p_a, p_at), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_multiply(p_at, p_ax, p_atr), MATRIX_SUCCESS);
+    matrix_t *p_zero = matrix_create(cols, 3);
+    CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_atr, p_zero), 0.0, 1e-9);
+
+    matrix_destroy(p_zero);
+    matrix_destroy(p_ax);
+    matrix_destroy(p_at);
+    matrix_destroy(p_atr);
+    matrix_destroy(p_a);
+    matrix_destroy(p_x);
+    matrix_destroy(p_b);
+    matrix_destroy(p_sol);
+    return;
+}
+
+static void
+test_matrix_solve_invalid (void)
+{
+    matrix_t        *p_wide   = matrix_create(2, 3);
+    matrix_t        *p_tall   = matrix_create(3, 2);
+    matrix_t        *p_b      = matrix_create(3, 1);
+    matrix_t        *p_x      = matrix_create(2, 1);
+    matrix_factor_t *p_factor = NULL;
+
+    // Underdetermined systems are not supported
+    CU_ASSERT_EQUAL(matrix_factorize(p_wide, MATRIX_SOLVE_AUTO, &p_factor),
+                    MATRIX_INVALID_ARGUMENT);
+
+    // Square-only methods reject rectangular input
+    CU_ASSERT_EQUAL(matrix_factorize(p_tall, MATRIX_SOLVE_LU, &p_factor),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_factorize(p_tall, MATRIX_SOLVE_CHOLESKY, &p_factor),
+                    MATRIX_INVALID_ARGUMENT);
+
+    // Rank deficient least squares (all zero columns)
+    CU_ASSERT_EQUAL(matrix_solve(p_tall, p_b, p_x), MATRIX_SINGULAR);
+
+    // Dimension mismatch and NULL inputs
+    CU_ASSERT_EQUAL(matrix_solve(p_tall, p_x, p_x), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_solve(NULL, p_b, p_x), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_factor_solve(NULL, p_b, p_x),
+                    MATRIX_INVALID_ARGUMENT);
+    matrix_factor_destroy(NULL);
+
+    matrix_destroy(p_wide);
+    matrix_destroy(p_tall);
+    matrix_destroy(p_b);
+    matrix_destroy(p_x);
+    return;
+}
+
+/*** end of file ***/
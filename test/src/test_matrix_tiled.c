@@ -0,0 +1,239 @@
+/**
+ * @file    test_matrix_tiled.c
+ * @brief   Test suite for tiled Morton-order matrices.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_matrix_tiled.h"
+#include "matrix_tiled.h"
+#include "parallel.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+static void test_matrix_tiled_layout(void);
+static void test_matrix_tiled_kernels(void);
+static void test_matrix_tiled_invalid(void);
+
+CU_pSuite
+matrix_tiled_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("matrix-tiled-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add matrix-tiled-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_tiled_layout", test_matrix_tiled_layout)))
+    {
+        ERROR_LOG("Failed to add test_matrix_tiled_layout to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_tiled_kernels", test_matrix_tiled_kernels)))
+    {
+        ERROR_LOG("Failed to add test_matrix_tiled_kernels to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_tiled_invalid", test_matrix_tiled_invalid)))
+    {
+        ERROR_LOG("Failed to add test_matrix_tiled_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+static void
+test_matrix_tiled_layout (void)
+{
+    matrix_t       *p_src   = matrix_create(150, 150);
+    matrix_t       *p_back  = matrix_create(150, 150);
+    matrix_t        view    = { 0 };
+    matrix_t        tile    = { 0 };
+    double          value   = 0.0;
+    matrix_tiled_t *p_tiled = NULL;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_src);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_back);
+    fill_pseudo_random(p_src, 3U);
+
+    p_tiled = matrix_tiled_from_matrix(p_src);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_tiled);
+    CU_ASSERT_EQUAL(p_tiled->tile_rows, 3);
+    CU_ASSERT_EQUAL(p_tiled->tile_cols, 3);
+
+    // Z order over a 3 x 3 grid: the top-left 2 x 2 block comes first,
+    // then its right neighbour column, then the bottom row
+    CU_ASSERT_EQUAL(p_tiled->p_slot[(1 * 3) + 0], 2);
+    CU_ASSERT_EQUAL(p_tiled->p_slot[(0 * 3) + 2], 4);
+    CU_ASSERT_EQUAL(p_tiled->p_slot[(1 * 3) + 2], 5);
+    CU_ASSERT_EQUAL(p_tiled->p_slot[(2 * 3) + 0], 6);
+    CU_ASSERT_EQUAL(p_tiled->p_slot[(2 * 3) + 2], 8);
+
+    for (size_t slot = 0; slot < 9; ++slot)
+    {
+        CU_ASSERT_EQUAL(p_tiled->p_slot[p_tiled->p_tile[slot]], slot);
+    }
+
+    for (size_t row = 0; row < 150; row += 7)
+    {
+        for (size_t col = 0; col < 150; col += 5)
+        {
+            CU_ASSERT_EQUAL(matrix_tiled_get(p_tiled, row, col, &value),
+                            MATRIX_SUCCESS);
+            CU_ASSERT_EQUAL(value, p_src->p_data[(row * p_src->ld) + col]);
+        }
+    }
+
+    CU_ASSERT_EQUAL(matrix_tiled_to_matrix(p_tiled, p_back), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(p_src, p_back));
+
+    // Edge tiles are views of their real elements only
+    CU_ASSERT_EQUAL(matrix_tiled_tile_view(p_tiled, 2, 1, &tile),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(tile.rows, 150 - 128);
+    CU_ASSERT_EQUAL(tile.cols, MATRIX_TILE_SIZE);
+    CU_ASSERT_EQUAL(tile.ld, MATRIX_TILE_SIZE);
+    CU_ASSERT_TRUE(tile.b_view);
+    CU_ASSERT_EQUAL(tile.p_data[(5 * tile.ld) + 3],
+                    p_src->p_data[(133 * p_src->ld) + 67]);
+
+    // Writes through a tile view and through set land in the same place
+    tile.p_data[0] = 42.0;
+    matrix_tiled_get(p_tiled, 128, 64, &value);
+    CU_ASSERT_EQUAL(value, 42.0);
+    CU_ASSERT_EQUAL(matrix_tiled_set(p_tiled, 149, 149, -1.5),
+                    MATRIX_SUCCESS);
+    matrix_tiled_tile_view(p_tiled, 2, 2, &tile);
+    CU_ASSERT_EQUAL(tile.p_data[(21 * tile.ld) + 21], -1.5);
+
+    // A strided view converts like any other matrix
+    matrix_tiled_destroy(p_tiled);
+    CU_ASSERT_EQUAL(matrix_view(p_src, 10, 20, 70, 100, &view),
+                    MATRIX_SUCCESS);
+    p_tiled = matrix_tiled_from_matrix(&view);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_tiled);
+    CU_ASSERT_EQUAL(p_tiled->tile_rows, 2);
+    CU_ASSERT_EQUAL(p_tiled->tile_cols, 2);
+    matrix_tiled_get(p_tiled, 69, 99, &value);
+    CU_ASSERT_EQUAL(value, p_src->p_data[(79 * p_src->ld) + 119]);
+
+    matrix_tiled_destroy(p_tiled);
+    matrix_destroy(p_src);
+    matrix_destroy(p_back);
+}
+
+static void
+test_matrix_tiled_kernels (void)
+{
+    matrix_t       *p_a      = matrix_create(150, 70);
+    matrix_t       *p_b      = matrix_create(70, 130);
+    matrix_t       *p_ref    = matrix_create(150, 130);
+    matrix_t       *p_out    = matrix_create(150, 130);
+    matrix_t       *p_at     = matrix_create(70, 150);
+    matrix_t       *p_at_ref = matrix_create(70, 150);
+    matrix_tiled_t *p_ta     = NULL;
+    matrix_tiled_t *p_tb     = NULL;
+    matrix_tiled_t *p_tc     = matrix_tiled_create(150, 130);
+    matrix_tiled_t *p_tt     = matrix_tiled_create(70, 150);
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_a);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_b);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_tc);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_tt);
+    fill_pseudo_random(p_a, 5U);
+    fill_pseudo_random(p_b, 7U);
+    p_ta = matrix_tiled_from_matrix(p_a);
+    p_tb = matrix_tiled_from_matrix(p_b);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_ta);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_tb);
+
+    CU_ASSERT_EQUAL(matrix_tiled_transpose(p_ta, p_tt), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_tiled_to_matrix(p_tt, p_at), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_transpose(p_a, p_at_ref), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(p_at, p_at_ref));
+
+    // Result tiles split across threads match the row-major product
+    CU_ASSERT_EQUAL(matrix_multiply(p_a, p_b, p_ref), MATRIX_SUCCESS);
+    parallel_set_threads(3);
+    CU_ASSERT_EQUAL(matrix_tiled_multiply(p_ta, p_tb, p_tc), MATRIX_SUCCESS);
+    parallel_set_threads(0);
+    CU_ASSERT_EQUAL(matrix_tiled_to_matrix(p_tc, p_out), MATRIX_SUCCESS);
+    CU_ASSERT(max_abs_diff(p_out, p_ref) < 1e-10);
+
+    // Stale contents of C are overwritten, not accumulated into
+    CU_ASSERT_EQUAL(matrix_tiled_multiply(p_ta, p_tb, p_tc), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_tiled_to_matrix(p_tc, p_out), MATRIX_SUCCESS);
+    CU_ASSERT(max_abs_diff(p_out, p_ref) < 1e-10);
+
+    matrix_tiled_destroy(p_ta);
+    matrix_tiled_destroy(p_tb);
+    matrix_tiled_destroy(p_tc);
+    matrix_tiled_destroy(p_tt);
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    matrix_destroy(p_ref);
+    matrix_destroy(p_out);
+    matrix_destroy(p_at);
+    matrix_destroy(p_at_ref);
+}
+
+static void
+test_matrix_tiled_invalid (void)
+{
+    matrix_tiled_t *p_a     = matrix_tiled_create(10, 20);
+    matrix_tiled_t *p_b     = matrix_tiled_create(10, 20);
+    matrix_t       *p_dense = matrix_create(20, 10);
+    matrix_t        view    = { 0 };
+    double          value   = 0.0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_a);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_b);
+    CU_ASSERT_PTR_NULL(matrix_tiled_create(0, 4));
+    CU_ASSERT_PTR_NULL(matrix_tiled_from_matrix(NULL));
+    matrix_tiled_destroy(NULL);
+
+    CU_ASSERT_EQUAL(matrix_tiled_get(p_a, 10, 0, &value),
+                    MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_tiled_set(p_a, 0, 20, 1.0), MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_tiled_get(p_a, 0, 0, NULL),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_tiled_tile_view(p_a, 1, 0, &view),
+                    MATRIX_OUT_OF_BOUNDS);
+    CU_ASSERT_EQUAL(matrix_tiled_to_matrix(p_a, p_dense),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_tiled_transpose(p_a, p_b),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_tiled_multiply(p_a, p_b, p_b),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_tiled_multiply(p_a, p_a, p_b),
+                    MATRIX_INVALID_ARGUMENT);
+
+    matrix_tiled_destroy(p_a);
+    matrix_tiled_destroy(p_b);
+    matrix_destroy(p_dense);
+}
+
+/*** end of file ***/
@@ -0,0 +1,362 @@
+/**
+ * @file    test_matrix_typed.c
+ * @brief   Test suite for float32 and int8 quantized matrices.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_matrix_typed.h"
+#include "matrix_typed.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void test_matrix_typed_basic(void);
+static void test_matrix_typed_f32_gemm(void);
+static void test_matrix_typed_quantize(void);
+static void test_matrix_typed_i8_gemm(void);
+static void test_matrix_typed_invalid(void);
+
+CU_pSuite
+matrix_typed_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("matrix-typed-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add matrix-typed-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_typed_basic", test_matrix_typed_basic)))
+    {
+        ERROR_LOG("Failed to add test_matrix_typed_basic to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_typed_f32_gemm", test_matrix_typed_f32_gemm)))
+    {
+        ERROR_LOG("Failed to add test_matrix_typed_f32_gemm to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_typed_quantize", test_matrix_typed_quantize)))
+    {
+        ERROR_LOG("Failed to add test_matrix_typed_quantize to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_typed_i8_gemm", test_matrix_typed_i8_gemm)))
+    {
+        ERROR_LOG("Failed to add test_matrix_typed_i8_gemm to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(
+            suite, "test_matrix_typed_invalid", test_matrix_typed_invalid)))
+    {
+        ERROR_LOG("Failed to add test_matrix_typed_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+/**
+ * @brief   Largest absolute element-wise difference of two float matrices.
+ */
+static float
+max_abs_diff_f32 (const matrix_f32_t *p_a, const matrix_f32_t *p_b)
+{
+    float max_err = 0.0f;
+
+    for (size_t row = 0; row < p_a->rows; ++row)
+    {
+        for (size_t col = 0; col < p_a->cols; ++col)
+        {
+            float err = fabsf(p_a->p_data[(row * p_a->ld) + col]
+                              - p_b->p_data[(row * p_b->ld) + col]);
+            max_err   = (err > max_err) ? err : max_err;
+        }
+    }
+
+    return max_err;
+}
+
+static void
+test_matrix_typed_basic (void)
+{
+    matrix_f32_t *p_f = matrix_f32_create(3, 5);
+    matrix_i8_t  *p_q = matrix_i8_create(3, 5);
+    matrix_t     *p_d = matrix_create(3, 5);
+    matrix_t     *p_r = matrix_create(3, 5);
+    float         val = 0.0f;
+    int8_t        raw = 0;
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_f);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_q);
+    CU_ASSERT_EQUAL(p_f->ld, 5);
+    CU_ASSERT_EQUAL(p_q->scale, 1.0f);
+
+    CU_ASSERT_EQUAL(matrix_f32_fill(p_f, 2.5f), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_f32_set(p_f, 2, 4, -1.0f), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_f32_get(p_f, 2, 4, &val), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(val, -1.0f);
+    CU_ASSERT_EQUAL(matrix_f32_get(p_f, 0, 0, &val), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(val, 2.5f);
+    CU_ASSERT_EQUAL(matrix_f32_get(p_f, 3, 0, &val), MATRIX_OUT_OF_BOUNDS);
+
+    CU_ASSERT_EQUAL(matrix_i8_fill(p_q, -7), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_i8_set(p_q, 1, 1, 100), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_i8_get(p_q, 1, 1, &raw), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(raw, 100);
+    CU_ASSERT_EQUAL(matrix_i8_get(p_q, 0, 4, &raw), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(raw, -7);
+    CU_ASSERT_EQUAL(matrix_i8_set(p_q, 0, 5, 1), MATRIX_OUT_OF_BOUNDS);
+
+    // Values representable in float survive a double round trip exactly
+    matrix_set(p_d, 0, 0, 0.25);
+    matrix_set(p_d, 1, 2, -3.5);
+    matrix_set(p_d, 2, 4, 1024.0);
+    CU_ASSERT_EQUAL(matrix_f32_from_matrix(p_d, p_f), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_f32_to_matrix(p_f, p_r), MATRIX_SUCCESS);
+    CU_ASSERT_TRUE(matrix_is_equal(p_d, p_r));
+
+    matrix_f32_destroy(p_f);
+    matrix_i8_destroy(p_q);
+    matrix_f32_destroy(NULL);
+    matrix_i8_destroy(NULL);
+    matrix_destroy(p_d);
+    matrix_destroy(p_r);
+    return;
+}
+
+static void
+test_matrix_typed_f32_gemm (void)
+{
+    // Ragged sizes exercise every edge of the 4 x 16 register block
+    const size_t m   = 37;
+    const size_t k   = 300;
+    const size_t n   = 45;
+    matrix_t    *p_a = matrix_create(m, k);
+    matrix_t    *p_b = matrix_create(k, n);
+    matrix_t    *p_c = matrix_create(m, n);
+    fill_pseudo_random(p_a, 21U);
+    fill_pseudo_random(p_b, 22U);
+    matrix_multiply(p_a, p_b, p_c);
+
+    matrix_f32_t *p_fa  = matrix_f32_create(m, k);
+    matrix_f32_t *p_fb  = matrix_f32_create(k, n);
+    matrix_f32_t *p_fc  = matrix_f32_create(m, n);
+    matrix_f32_t *p_ref = matrix_f32_create(m, n);
+    matrix_f32_from_matrix(p_a, p_fa);
+    matrix_f32_from_matrix(p_b, p_fb);
+    matrix_f32_from_matrix(p_c, p_ref);
+
+    matrix_f32_fill(p_fc, 123.0f);
+    CU_ASSERT_EQUAL(matrix_f32_multiply(p_fa, p_fb, p_fc), MATRIX_SUCCESS);
+    CU_ASSERT(max_abs_diff_f32(p_fc, p_ref) < 1e-3f);
+
+    // C = 2 * A * B - C doubles the product once more
+    CU_ASSERT_EQUAL(matrix_f32_gemm(m,
+                                    n,
+                                    k,
+                                    2.0f,
+                                    p_fa->p_data,
+                                    p_fa->ld,
+                                    p_fb->p_data,
+                                    p_fb->ld,
+                                    -1.0f,
+                                    p_fc->p_data,
+                                    p_fc->ld),
+                    MATRIX_SUCCESS);
+    CU_ASSERT(max_abs_diff_f32(p_fc, p_ref) < 2e-3f);
+
+    matrix_destroy(p_a);
+    matrix_destroy(p_b);
+    matrix_destroy(p_c);
+    matrix_f32_destroy(p_fa);
+    matrix_f32_destroy(p_fb);
+    matrix_f32_destroy(p_fc);
+    matrix_f32_destroy(p_ref);
+    return;
+}
+
+static void
+test_matrix_typed_quantize (void)
+{
+    matrix_t     *p_d = matrix_create(9, 13);
+    matrix_f32_t *p_f = matrix_f32_create(9, 13);
+    matrix_f32_t *p_r = matrix_f32_create(9, 13);
+    matrix_i8_t  *p_q = matrix_i8_create(9, 13);
+    int8_t        raw = 0;
+    fill_pseudo_random(p_d, 31U);
+    matrix_set(p_d, 4, 6, -2.54);
+    matrix_f32_from_matrix(p_d, p_f);
+
+    CU_ASSERT_EQUAL(matrix_i8_quantize(p_f, p_q), MATRIX_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(p_q->scale, 2.54 / MATRIX_I8_MAX, 1e-6);
+    matrix_i8_get(p_q, 4, 6, &raw);
+    CU_ASSERT_EQUAL(raw, -MATRIX_I8_MAX);
+
+    // Round to nearest bounds the error by half a quantization step
+    CU_ASSERT_EQUAL(matrix_i8_dequantize(p_q, p_r), MATRIX_SUCCESS);
+    CU_ASSERT(max_abs_diff_f32(p_f, p_r) <= (p_q->scale * 0.5f) + 1e-6f);
+
+    // All-zero input keeps a usable scale
+    matrix_f32_fill(p_f, 0.0f);
+    CU_ASSERT_EQUAL(matrix_i8_quantize(p_f, p_q), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(p_q->scale, 1.0f);
+    matrix_i8_get(p_q, 4, 6, &raw);
+    CU_ASSERT_EQUAL(raw, 0);
+
+    matrix_destroy(p_d);
+    matrix_f32_destroy(p_f);
+    matrix_f32_destroy(p_r);
+    matrix_i8_destroy(p_q);
+    return;
+}
+
+static void
+test_matrix_typed_i8_gemm (void)
+{
+    // Odd k leaves a half-filled int16 pair at the end of each panel
+    const size_t m     = 11;
+    const size_t k     = 301;
+    const size_t n     = 19;
+    matrix_i8_t *p_a   = matrix_i8_create(m, k);
+    matrix_i8_t *p_b   = matrix_i8_create(k, n);
+    int32_t     *p_c   = calloc(m * n, sizeof(int32_t));
+    int32_t     *p_ref = calloc(m * n, sizeof(int32_t));
+    matrix_t    *p_src = matrix_create(k, (m > n) ? m : n);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_c);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_ref);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_src);
+
+    // Scale [-1, 1) onto the full int8 range except -128
+    fill_pseudo_random(p_src, 41U);
+
+    for (size_t idx = 0; idx < m * k; ++idx)
+    {
+        double value     = p_src->p_data[((idx % k) * p_src->ld) + (idx / k)];
+        p_a->p_data[idx] = (int8_t)lrint(value * 127.0);
+    }
+
+    fill_pseudo_random(p_src, 42U);
+
+    for (size_t idx = 0; idx < k * n; ++idx)
+    {
+        double value     = p_src->p_data[((idx / n) * p_src->ld) + (idx % n)];
+        p_b->p_data[idx] = (int8_t)lrint(value * 127.0);
+    }
+
+    matrix_destroy(p_src);
+
+    for (size_t row = 0; row < m; ++row)
+    {
+        for (size_t col = 0; col < n; ++col)
+        {
+            int32_t sum = 1;
+
+            for (size_t depth = 0; depth < k; ++depth)
+            {
+                sum += (int32_t)p_a->p_data[(row * k) + depth]
+                       * (int32_t)p_b->p_data[(depth * n) + col];
+            }
+
+            p_ref[(row * n) + col] = sum;
+            p_c[(row * n) + col]   = 1;
+        }
+    }
+
+    // Integer accumulation is exact and adds onto C
+    CU_ASSERT_EQUAL(
+        matrix_i8_gemm(m, n, k, p_a->p_data, k, p_b->p_data, n, p_c, n),
+        MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(memcmp(p_c, p_ref, m * n * sizeof(int32_t)), 0);
+
+    // The float result is the int32 sum times both scales
+    matrix_f32_t *p_out = matrix_f32_create(m, n);
+    p_a->scale          = 0.5f;
+    p_b->scale          = 0.25f;
+    CU_ASSERT_EQUAL(matrix_i8_multiply(p_a, p_b, p_out), MATRIX_SUCCESS);
+
+    for (size_t idx = 0; idx < m * n; ++idx)
+    {
+        CU_ASSERT_EQUAL(p_out->p_data[idx],
+                        0.125f * (float)(p_ref[idx] - 1));
+    }
+
+    // An inner dimension that could overflow int32 is refused up front
+    CU_ASSERT_EQUAL(matrix_i8_gemm(1,
+                                   1,
+                                   MATRIX_I8_GEMM_MAX_K + 1U,
+                                   p_a->p_data,
+                                   MATRIX_I8_GEMM_MAX_K + 1U,
+                                   p_b->p_data,
+                                   1,
+                                   p_c,
+                                   1),
+                    MATRIX_INVALID_ARGUMENT);
+
+    matrix_i8_destroy(p_a);
+    matrix_i8_destroy(p_b);
+    matrix_f32_destroy(p_out);
+    free(p_c);
+    free(p_ref);
+    return;
+}
+
+static void
+test_matrix_typed_invalid (void)
+{
+    matrix_f32_t *p_a = matrix_f32_create(2, 3);
+    matrix_f32_t *p_b = matrix_f32_create(2, 3);
+    matrix_i8_t  *p_q = matrix_i8_create(3, 2);
+    matrix_t     *p_d = matrix_create(3, 3);
+
+    CU_ASSERT_PTR_NULL(matrix_f32_create(0, 3));
+    CU_ASSERT_PTR_NULL(matrix_i8_create(3, 0));
+    CU_ASSERT_EQUAL(matrix_f32_fill(NULL, 1.0f), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_f32_from_matrix(p_d, p_a),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_i8_quantize(p_a, p_q), MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_f32_multiply(p_a, p_b, p_a),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(matrix_f32_gemm(2, 3, 3, 1.0f, NULL, 3, NULL, 3, 0.0f,
+                                    p_a->p_data, 3),
+                    MATRIX_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(
+        matrix_i8_gemm(2, 3, 2, p_q->p_data, 1, p_q->p_data, 2, NULL, 3),
+        MATRIX_INVALID_ARGUMENT);
+
+    matrix_f32_destroy(p_a);
+    matrix_f32_destroy(p_b);
+    matrix_i8_destroy(p_q);
+    matrix_destroy(p_d);
+    return;
+}
+
+/*** end of file ***/
@@ -0,0 +1,355 @@
+/**
+ * @file    test_sparse_matrix.c
+ * @brief   Test suite for sparse matrices.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_sparse_matrix.h"
+#include "parallel.h"
+#include "sparse_matrix.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+
+static void test_sparse_dense_round_trip(void);
+static void test_sparse_triplets(void);
+static void test_sparse_transpose_convert(void);
+static void test_sparse_products(void);
+static void test_sparse_parallel_products(void);
+
+CU_pSuite
+sparse_matrix_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("sparse-matrix-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add sparse-matrix-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite,
+                        "test_sparse_dense_round_trip",
+                        test_sparse_dense_round_trip)))
+    {
+        ERROR_LOG("Failed to add test_sparse_dense_round_trip to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_sparse_triplets", test_sparse_triplets)))
+    {
+        ERROR_LOG("Failed to add test_sparse_triplets to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite,
+                        "test_sparse_transpose_convert",
+                        test_sparse_transpose_convert)))
+    {
+        ERROR_LOG("Failed to add test_sparse_transpose_convert to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_sparse_products", test_sparse_products)))
+    {
+        ERROR_LOG("Failed to add test_sparse_products to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite,
+                        "test_sparse_parallel_products",
+                        test_sparse_parallel_products)))
+    {
+        ERROR_LOG("Failed to add test_sparse_parallel_products to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+/**
+ * @brief   Fill roughly one in `stride` elements with pseudo-random values
+ *          and leave the rest zero.
+ */
+static void
+fill_sparse_pattern (matrix_t *p_matrix, unsigned int seed, unsigned int stride)
+{
+    double val = 0.0;
+    fill_pseudo_random(p_matrix, seed);
+
+    // The values are multiples of 0.001, so their bucket picks the pattern
+    for (size_t row = 0; row < p_matrix->rows; ++row)
+    {
+        for (size_t col = 0; col < p_matrix->cols; ++col)
+        {
+            matrix_get(p_matrix, row, col, &val);
+
+            if (0U != ((unsigned int)lround((val + 1.0) * 1000.0) % stride))
+            {
+                matrix_set(p_matrix, row, col, 0.0);
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Check a sparse matrix against a dense reference in both formats.
+ */
+static bool
+is_sparse_equal_dense (const sparse_matrix_t *p_sparse, const matrix_t *p_dense)
+{
+    matrix_t *p_out = matrix_create(p_dense->rows, p_dense->cols);
+    bool b_equal    = (SPARSE_SUCCESS == sparse_to_dense(p_sparse, p_out))
+                   && matrix_is_equal(p_out, p_dense);
+    matrix_destroy(p_out);
+    return b_equal;
+}
+
+static void
+test_sparse_dense_round_trip (void)
+{
+    matrix_t *p_dense = matrix_create(37, 23);
+    double    val     = 0.0;
+    double    ref     = 0.0;
+    fill_sparse_pattern(p_dense, 7U, 5U);
+
+    for (int format = SPARSE_CSR; format <= SPARSE_CSC; ++format)
+    {
+        sparse_matrix_t *p_sparse
+            = sparse_from_dense(p_dense, (sparse_format_t)format);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(p_sparse);
+        CU_ASSERT_TRUE(p_sparse->nnz < (37 * 23) / 2);
+        CU_ASSERT_TRUE(is_sparse_equal_dense(p_sparse, p_dense));
+
+        for (size_t row = 0; row < 37; ++row)
+        {
+            for (size_t col = 0; col < 23; ++col)
+            {
+                matrix_get(p_dense, row, col, &ref);
+                CU_ASSERT_EQUAL(sparse_get(p_sparse, row, col, &val),
+                                SPARSE_SUCCESS);
+                CU_ASSERT_EQUAL(val, ref);
+            }
+        }
+
+        CU_ASSERT_EQUAL(sparse_get(p_sparse, 37, 0, &val),
+                        SPARSE_OUT_OF_BOUNDS);
+        CU_ASSERT_EQUAL(sparse_get(p_sparse, 0, 0, NULL),
+                        SPARSE_INVALID_ARGUMENT);
+        sparse_destroy(p_sparse);
+    }
+
+    // All-zero matrix has no stored entries
+    matrix_fill(p_dense, 0.0);
+    sparse_matrix_t *p_empty = sparse_from_dense(p_dense, SPARSE_CSR);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_empty);
+    CU_ASSERT_EQUAL(p_empty->nnz, 0);
+    CU_ASSERT_TRUE(is_sparse_equal_dense(p_empty, p_dense));
+    sparse_destroy(p_empty);
+
+    CU_ASSERT_PTR_NULL(sparse_from_dense(NULL, SPARSE_CSR));
+    sparse_destroy(NULL);
+    matrix_destroy(p_dense);
+    return;
+}
+
+static void
+test_sparse_triplets (void)
+{
+    // Unordered triplets with a duplicate at (1, 2)
+    size_t rows[] = { 2, 1, 0, 1, 2 };
+    size_t cols[] = { 0, 2, 1, 2, 3 };
+    double vals[] = { 5.0, 1.5, -2.0, 2.5, 7.0 };
+    double val    = 0.0;
+
+    for (int format = SPARSE_CSR; format <= SPARSE_CSC; ++format)
+    {
+        sparse_matrix_t *p_sparse = sparse_from_triplets(
+            3, 4, 5, rows, cols, vals, (sparse_format_t)format);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(p_sparse);
+        CU_ASSERT_EQUAL(p_sparse->nnz, 4);
+        sparse_get(p_sparse, 1, 2, &val);
+        CU_ASSERT_EQUAL(val, 4.0);
+        sparse_get(p_sparse, 2, 0, &val);
+        CU_ASSERT_EQUAL(val, 5.0);
+        sparse_get(p_sparse, 0, 1, &val);
+        CU_ASSERT_EQUAL(val, -2.0);
+        sparse_get(p_sparse, 2, 3, &val);
+        CU_ASSERT_EQUAL(val, 7.0);
+        sparse_get(p_sparse, 0, 0, &val);
+        CU_ASSERT_EQUAL(val, 0.0);
+
+        // Minor indices are sorted within every slice
+        size_t major = (SPARSE_CSR == format) ? 3 : 4;
+
+        for (size_t outer = 0; outer < major; ++outer)
+        {
+            for (size_t pos = p_sparse->p_ptr[outer] + 1;
+                 pos < p_sparse->p_ptr[outer + 1];
+                 ++pos)
+            {
+                CU_ASSERT_TRUE(p_sparse->p_idx[pos - 1] < p_sparse->p_idx[pos]);
+            }
+        }
+
+        sparse_destroy(p_sparse);
+    }
+
+    // Out of range indices are rejected
+    rows[0] = 3;
+    CU_ASSERT_PTR_NULL(
+        sparse_from_triplets(3, 4, 5, rows, cols, vals, SPARSE_CSR));
+    return;
+}
+
+static void
+test_sparse_transpose_convert (void)
+{
+    matrix_t *p_dense = matrix_create(41, 29);
+    matrix_t *p_trans = matrix_create(29, 41);
+    fill_sparse_pattern(p_dense, 11U, 4U);
+    matrix_transpose(p_dense, p_trans);
+
+    sparse_matrix_t *p_csr = sparse_from_dense(p_dense, SPARSE_CSR);
+    sparse_matrix_t *p_csc = sparse_convert(p_csr, SPARSE_CSC);
+    sparse_matrix_t *p_rt  = sparse_convert(p_csc, SPARSE_CSR);
+    sparse_matrix_t *p_t   = sparse_transpose(p_csr);
+    sparse_matrix_t *p_tc  = sparse_transpose(p_csc);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_t);
+    CU_ASSERT_EQUAL(p_csc->format, SPARSE_CSC);
+    CU_ASSERT_EQUAL(p_t->format, SPARSE_CSR);
+    CU_ASSERT_EQUAL(p_t->rows, 29);
+    CU_ASSERT_EQUAL(p_t->cols, 41);
+    CU_ASSERT_TRUE(is_sparse_equal_dense(p_csc, p_dense));
+    CU_ASSERT_TRUE(is_sparse_equal_dense(p_rt, p_dense));
+    CU_ASSERT_TRUE(is_sparse_equal_dense(p_t, p_trans));
+    CU_ASSERT_TRUE(is_sparse_equal_dense(p_tc, p_trans));
+
+    // Converting to the same format copies
+    sparse_matrix_t *p_copy = sparse_convert(p_csr, SPARSE_CSR);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_copy);
+    CU_ASSERT_PTR_NOT_EQUAL(p_copy->p_values, p_csr->p_values);
+    CU_ASSERT_TRUE(is_sparse_equal_dense(p_copy, p_dense));
+
+    sparse_destroy(p_copy);
+    sparse_destroy(p_csr);
+    sparse_destroy(p_csc);
+    sparse_destroy(p_rt);
+    sparse_destroy(p_t);
+    sparse_destroy(p_tc);
+    matrix_destroy(p_dense);
+    matrix_destroy(p_trans);
+    return;
+}
+
+/**
+ * @brief   Compare sparse SpMV and SpMM in both formats against dense GEMM.
+ */
+static void
+check_products (const matrix_t *p_dense, size_t width, double tolerance)
+{
+    size_t    rows  = p_dense->rows;
+    size_t    cols  = p_dense->cols;
+    matrix_t *p_b   = matrix_create(cols, width);
+    matrix_t *p_ref = matrix_create(rows, width);
+    matrix_t *p_out = matrix_create(rows, width);
+    matrix_t *p_x   = matrix_create(cols, 1);
+    matrix_t *p_y   = matrix_create(rows, 1);
+    matrix_t *p_yr  = matrix_create(rows, 1);
+    fill_sparse_pattern(p_b, 3U, 1U);
+    fill_sparse_pattern(p_x, 5U, 1U);
+    CU_ASSERT_EQUAL(matrix_multiply(p_dense, p_b, p_ref), MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_multiply(p_dense, p_x, p_yr), MATRIX_SUCCESS);
+
+    for (int format = SPARSE_CSR; format <= SPARSE_CSC; ++format)
+    {
+        sparse_matrix_t *p_sparse
+            = sparse_from_dense(p_dense, (sparse_format_t)format);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(p_sparse);
+        matrix_fill(p_out, 99.0);
+        matrix_fill(p_y, 99.0);
+        CU_ASSERT_EQUAL(sparse_spmm(p_sparse, p_b, p_out), SPARSE_SUCCESS);
+        CU_ASSERT_EQUAL(sparse_spmv(p_sparse, p_x->p_data, p_y->p_data),
+                        SPARSE_SUCCESS);
+        CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_out, p_ref), 0.0, tolerance);
+        CU_ASSERT_DOUBLE_EQUAL(max_abs_diff(p_y, p_yr), 0.0, tolerance);
+        sparse_destroy(p_sparse);
+    }
+
+    matrix_destroy(p_b);
+    matrix_destroy(p_ref);
+    matrix_destroy(p_out);
+    matrix_destroy(p_x);
+    matrix_destroy(p_y);
+    matrix_destroy(p_yr);
+}
+
+static void
+test_sparse_products (void)
+{
+    matrix_t *p_dense = matrix_create(53, 47);
+    fill_sparse_pattern(p_dense, 13U, 6U);
+    check_products(p_dense, 9, 1e-12);
+
+    // Invalid shapes and NULL inputs
+    sparse_matrix_t *p_sparse = sparse_from_dense(p_dense, SPARSE_CSR);
+    matrix_t        *p_bad    = matrix_create(46, 3);
+    matrix_t        *p_c      = matrix_create(53, 3);
+    CU_ASSERT_EQUAL(sparse_spmm(p_sparse, p_bad, p_c),
+                    SPARSE_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(sparse_spmv(p_sparse, NULL, p_c->p_data),
+                    SPARSE_INVALID_ARGUMENT);
+
+    // C would overwrite rows of B that are still to be read
+    matrix_t *p_grid = matrix_create(54, 3);
+    matrix_t  b_view = { 0 };
+    matrix_t  c_view = { 0 };
+    CU_ASSERT_EQUAL(matrix_view(p_grid, 0, 0, 47, 3, &b_view),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(matrix_view(p_grid, 1, 0, 53, 3, &c_view),
+                    MATRIX_SUCCESS);
+    CU_ASSERT_EQUAL(sparse_spmm(p_sparse, &b_view, &c_view),
+                    SPARSE_INVALID_ARGUMENT);
+    sparse_destroy(p_sparse);
+    matrix_destroy(p_bad);
+    matrix_destroy(p_c);
+    matrix_destroy(p_grid);
+    matrix_destroy(p_dense);
+    return;
+}
+
+static void
+test_sparse_parallel_products (void)
+{
+    // Enough non-zeros to split the CSR products across four threads
+    matrix_t *p_dense = matrix_create(700, 600);
+    fill_sparse_pattern(p_dense, 19U, 2U);
+    parallel_set_threads(4);
+    CU_ASSERT_EQUAL(parallel_get_threads(), 4);
+    check_products(p_dense, 3, 1e-10);
+    parallel_set_threads(0);
+    CU_ASSERT_TRUE(parallel_get_threads() >= 1);
+    matrix_destroy(p_dense);
+    return;
+}
+
+/*** end of file ***/
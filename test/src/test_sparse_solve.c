@@ -0,0 +1,553 @@
+/**
+ * @file    test_sparse_solve.c
+ * @brief   Test suite for the iterative sparse solvers.
+ *
+ * @author  heapbadger
+ */
+
+#include "test_sparse_solve.h"
+#include "parallel.h"
+#include "sparse_solve.h"
+#include "test_auxiliary.h"
+#include <CUnit/Basic.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void test_sparse_solve_spd(void);
+static void test_sparse_solve_general(void);
+static void test_sparse_solve_operator(void);
+static void test_sparse_solve_invalid(void);
+static void test_sparse_solve_parallel(void);
+
+CU_pSuite
+sparse_solve_suite (void)
+{
+    CU_pSuite suite = NULL;
+    suite           = CU_add_suite("sparse-solve-suite", 0, 0);
+
+    if (NULL == suite)
+    {
+        ERROR_LOG("Failed to add sparse-solve-suite\n");
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite, "test_sparse_solve_spd", test_sparse_solve_spd)))
+    {
+        ERROR_LOG("Failed to add test_sparse_solve_spd to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite,
+                        "test_sparse_solve_general",
+                        test_sparse_solve_general)))
+    {
+        ERROR_LOG("Failed to add test_sparse_solve_general to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite,
+                        "test_sparse_solve_operator",
+                        test_sparse_solve_operator)))
+    {
+        ERROR_LOG("Failed to add test_sparse_solve_operator to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite,
+                        "test_sparse_solve_invalid",
+                        test_sparse_solve_invalid)))
+    {
+        ERROR_LOG("Failed to add test_sparse_solve_invalid to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+    if (NULL
+        == (CU_add_test(suite,
+                        "test_sparse_solve_parallel",
+                        test_sparse_solve_parallel)))
+    {
+        ERROR_LOG("Failed to add test_sparse_solve_parallel to suite\n");
+        suite = NULL;
+        goto CLEANUP;
+    }
+
+CLEANUP:
+    if (NULL == suite)
+    {
+        CU_cleanup_registry();
+    }
+
+    return suite;
+}
+
+/**
+ * @brief   Five-point finite difference operator on a grid x grid mesh:
+ *          4 on the diagonal, -1 - wind and -1 + wind for the west and east
+ *          neighbours, -1 for north and south. wind == 0 gives the SPD
+ *          Laplacian, anything else a non-symmetric convection-diffusion
+ *          operator.
+ */
+static sparse_matrix_t *
+grid_operator (size_t grid, double wind, sparse_format_t format)
+{
+    size_t  size      = grid * grid;
+    size_t *p_row_idx = malloc(5U * size * sizeof(size_t));
+    size_t *p_col_idx = malloc(5U * size * sizeof(size_t));
+    double *p_values  = malloc(5U * size * sizeof(double));
+    size_t  count     = 0U;
+
+    for (size_t row = 0U; row < size; ++row)
+    {
+        size_t y = row / grid;
+        size_t x = row % grid;
+
+        p_row_idx[count]  = row;
+        p_col_idx[count]  = row;
+        p_values[count++] = 4.0;
+
+        if (0U < x)
+        {
+            p_row_idx[count]  = row;
+            p_col_idx[count]  = row - 1U;
+            p_values[count++] = -1.0 - wind;
+        }
+
+        if (x + 1U < grid)
+        {
+            p_row_idx[count]  = row;
+            p_col_idx[count]  = row + 1U;
+            p_values[count++] = -1.0 + wind;
+        }
+
+        if (0U < y)
+        {
+            p_row_idx[count]  = row;
+            p_col_idx[count]  = row - grid;
+            p_values[count++] = -1.0;
+        }
+
+        if (y + 1U < grid)
+        {
+            p_row_idx[count]  = row;
+            p_col_idx[count]  = row + grid;
+            p_values[count++] = -1.0;
+        }
+    }
+
+    sparse_matrix_t *p_sparse = sparse_from_triplets(
+        size, size, count, p_row_idx, p_col_idx, p_values, format);
+    free(p_row_idx);
+    free(p_col_idx);
+    free(p_values);
+    return p_sparse;
+}
+
+/**
+ * @brief   Pseudo-random vector with entries in [-1, 1).
+ */
+static void
+fill_vector (double *p_vec, size_t size, unsigned int seed)
+{
+    matrix_t row = {
+        .rows = 1U, .cols = size, .ld = size, .b_view = true, .p_data = p_vec
+    };
+    fill_pseudo_random(&row, seed);
+}
+
+/**
+ * @brief   ||b - A * x|| / ||b||, computed independently of the solvers.
+ */
+static double
+relative_residual (const sparse_matrix_t *p_sparse,
+                   const double          *p_b,
+                   const double          *p_x)
+{
+    double *p_ax   = malloc(p_sparse->rows * sizeof(double));
+    double  r_norm = 0.0;
+    double  b_norm = 0.0;
+
+    sparse_spmv(p_sparse, p_x, p_ax);
+
+    for (size_t idx = 0U; idx < p_sparse->rows; ++idx)
+    {
+        r_norm += (p_b[idx] - p_ax[idx]) * (p_b[idx] - p_ax[idx]);
+        b_norm += p_b[idx] * p_b[idx];
+    }
+
+    free(p_ax);
+    return sqrt(r_norm / b_norm);
+}
+
+/**
+ * @brief   Solve A * x = b from x = 0 and check the result and statistics.
+ *
+ * @return  Iterations taken.
+ */
+static size_t
+check_solve (const sparse_matrix_t *p_sparse,
+             sparse_solve_method_t  method,
+             sparse_precond_t       precond)
+{
+    size_t                size   = p_sparse->rows;
+    double               *p_b    = malloc(size * sizeof(double));
+    double               *p_x    = calloc(size, sizeof(double));
+    sparse_solve_stats_t  stats  = { 0 };
+    sparse_solve_params_t params = { 0 };
+
+    params.method    = method;
+    params.precond   = precond;
+    params.tolerance = 1e-10;
+    fill_vector(p_b, size, 7U);
+
+    CU_ASSERT_EQUAL(sparse_solve(p_sparse, p_b, p_x, &params, &stats),
+                    SPARSE_SUCCESS);
+    CU_ASSERT_TRUE(stats.b_converged);
+    CU_ASSERT_TRUE(stats.residual <= 1e-10);
+    CU_ASSERT_TRUE(0U < stats.iterations);
+    CU_ASSERT_TRUE(stats.iterations <= stats.matvecs);
+
+    // The tracked residual drifts slightly from the true one
+    CU_ASSERT_TRUE(relative_residual(p_sparse, p_b, p_x) < 1e-8);
+    free(p_b);
+    free(p_x);
+    return stats.iterations;
+}
+
+/**
+ * @brief   Tridiagonal operator [-1, 3, -1] as a callback.
+ */
+static sparse_error_code_t
+tridiagonal_apply (const double *p_x, double *p_y, void *p_ctx)
+{
+    size_t size = *(const size_t *)p_ctx;
+
+    for (size_t idx = 0U; idx < size; ++idx)
+    {
+        p_y[idx] = 3.0 * p_x[idx];
+        p_y[idx] -= (0U < idx) ? p_x[idx - 1U] : 0.0;
+        p_y[idx] -= (idx + 1U < size) ? p_x[idx + 1U] : 0.0;
+    }
+
+    return SPARSE_SUCCESS;
+}
+
+/**
+ * @brief   Jacobi preconditioner of tridiagonal_apply as a callback.
+ */
+static sparse_error_code_t
+tridiagonal_jacobi (const double *p_x, double *p_y, void *p_ctx)
+{
+    size_t size = *(const size_t *)p_ctx;
+
+    for (size_t idx = 0U; idx < size; ++idx)
+    {
+        p_y[idx] = p_x[idx] / 3.0;
+    }
+
+    return SPARSE_SUCCESS;
+}
+
+/**
+ * @brief   Operator callback that always fails.
+ */
+static sparse_error_code_t
+failing_apply (const double *p_x, double *p_y, void *p_ctx)
+{
+    (void)p_x;
+    (void)p_y;
+    (void)p_ctx;
+    return SPARSE_FAILURE;
+}
+
+static void
+test_sparse_solve_spd (void)
+{
+    sparse_matrix_t *p_csr = grid_operator(30U, 0.0, SPARSE_CSR);
+    sparse_matrix_t *p_csc = grid_operator(30U, 0.0, SPARSE_CSC);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_csr);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_csc);
+
+    // Every method handles an SPD system
+    size_t plain = check_solve(p_csr, SPARSE_SOLVE_CG, SPARSE_PRECOND_NONE);
+    check_solve(p_csr, SPARSE_SOLVE_CG, SPARSE_PRECOND_JACOBI);
+    size_t ilu = check_solve(p_csr, SPARSE_SOLVE_CG, SPARSE_PRECOND_ILU0);
+    check_solve(p_csc, SPARSE_SOLVE_CG, SPARSE_PRECOND_ILU0);
+    check_solve(p_csr, SPARSE_SOLVE_BICGSTAB, SPARSE_PRECOND_NONE);
+    check_solve(p_csr, SPARSE_SOLVE_GMRES, SPARSE_PRECOND_NONE);
+
+    // ILU(0) roughly halves the CG iterations on the Laplacian
+    CU_ASSERT_TRUE(ilu < plain);
+
+    // A zero right-hand side returns x = 0 without iterating
+    size_t               size  = p_csr->rows;
+    double              *p_b   = calloc(size, sizeof(double));
+    double              *p_x   = malloc(size * sizeof(double));
+    sparse_solve_stats_t stats = { 0 };
+    fill_vector(p_x, size, 3U);
+    CU_ASSERT_EQUAL(sparse_solve(p_csr, p_b, p_x, NULL, &stats),
+                    SPARSE_SUCCESS);
+    CU_ASSERT_TRUE(stats.b_converged);
+    CU_ASSERT_EQUAL(stats.iterations, 0U);
+    CU_ASSERT_EQUAL(stats.matvecs, 0U);
+
+    for (size_t idx = 0U; idx < size; ++idx)
+    {
+        CU_ASSERT_EQUAL(p_x[idx], 0.0);
+    }
+
+    // An exact initial guess converges without iterating
+    double *p_exact = malloc(size * sizeof(double));
+    fill_vector(p_exact, size, 11U);
+    sparse_spmv(p_csr, p_exact, p_b);
+    memcpy(p_x, p_exact, size * sizeof(double));
+    CU_ASSERT_EQUAL(sparse_solve(p_csr, p_b, p_x, NULL, &stats),
+                    SPARSE_SUCCESS);
+    CU_ASSERT_EQUAL(stats.iterations, 0U);
+    CU_ASSERT_EQUAL(stats.matvecs, 1U);
+
+    free(p_exact);
+    free(p_b);
+    free(p_x);
+    sparse_destroy(p_csr);
+    sparse_destroy(p_csc);
+    return;
+}
+
+static void
+test_sparse_solve_general (void)
+{
+    sparse_matrix_t *p_sparse = grid_operator(30U, 0.5, SPARSE_CSR);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_sparse);
+
+    sparse_solve_method_t methods[] = { SPARSE_SOLVE_BICGSTAB,
+                                        SPARSE_SOLVE_GMRES };
+
+    for (size_t idx = 0U; idx < 2U; ++idx)
+    {
+        size_t plain = check_solve(p_sparse, methods[idx], SPARSE_PRECOND_NONE);
+        check_solve(p_sparse, methods[idx], SPARSE_PRECOND_JACOBI);
+        size_t ilu = check_solve(p_sparse, methods[idx], SPARSE_PRECOND_ILU0);
+        CU_ASSERT_TRUE(ilu < plain);
+    }
+
+    // Iteration limit in the middle of a restart cycle
+    size_t                size   = p_sparse->rows;
+    double               *p_b    = malloc(size * sizeof(double));
+    double               *p_x    = calloc(size, sizeof(double));
+    sparse_solve_stats_t  stats  = { 0 };
+    sparse_solve_params_t params = { 0 };
+    params.method                = SPARSE_SOLVE_GMRES;
+    params.restart               = 5U;
+    params.max_iterations        = 12U;
+    fill_vector(p_b, size, 5U);
+
+    // Two full cycles and two steps of a third, each cycle starting with
+    // one product for its residual
+    CU_ASSERT_EQUAL(sparse_solve(p_sparse, p_b, p_x, &params, &stats),
+                    SPARSE_NOT_CONVERGED);
+    CU_ASSERT_FALSE(stats.b_converged);
+    CU_ASSERT_EQUAL(stats.iterations, 12U);
+    CU_ASSERT_EQUAL(stats.matvecs, 15U);
+    CU_ASSERT_TRUE(stats.residual < 1.0);
+    CU_ASSERT_TRUE(relative_residual(p_sparse, p_b, p_x) < 1.0);
+
+    free(p_b);
+    free(p_x);
+    sparse_destroy(p_sparse);
+    return;
+}
+
+static void
+test_sparse_solve_operator (void)
+{
+    size_t                size      = 500U;
+    double               *p_b       = malloc(size * sizeof(double));
+    double               *p_x       = calloc(size, sizeof(double));
+    double               *p_ax      = malloc(size * sizeof(double));
+    sparse_solve_stats_t  stats     = { 0 };
+    sparse_solve_params_t params    = { 0 };
+    sparse_operator_t     op        = { size, tridiagonal_apply, &size };
+    sparse_operator_t     jacobi    = { size, tridiagonal_jacobi, &size };
+    sparse_solve_method_t methods[] = { SPARSE_SOLVE_CG,
+                                        SPARSE_SOLVE_BICGSTAB,
+                                        SPARSE_SOLVE_GMRES };
+    fill_vector(p_b, size, 9U);
+    params.tolerance = 1e-12;
+
+    for (size_t idx = 0U; idx < 6U; ++idx)
+    {
+        params.method = methods[idx % 3U];
+        memset(p_x, 0, size * sizeof(double));
+        CU_ASSERT_EQUAL(sparse_solve_operator(&op,
+                                              (3U <= idx) ? &jacobi : NULL,
+                                              p_b,
+                                              p_x,
+                                              &params,
+                                              &stats),
+                        SPARSE_SUCCESS);
+        CU_ASSERT_TRUE(stats.b_converged);
+        tridiagonal_apply(p_x, p_ax, &size);
+
+        double error = 0.0;
+
+        for (size_t row = 0U; row < size; ++row)
+        {
+            error = fmax(error, fabs(p_ax[row] - p_b[row]));
+        }
+
+        CU_ASSERT_TRUE(error < 1e-10);
+    }
+
+    // Errors from the callbacks abort the solve
+    sparse_operator_t failing = { size, failing_apply, NULL };
+    CU_ASSERT_EQUAL(
+        sparse_solve_operator(&failing, NULL, p_b, p_x, &params, &stats),
+        SPARSE_FAILURE);
+    CU_ASSERT_EQUAL(stats.matvecs, 1U);
+    params.method = SPARSE_SOLVE_GMRES;
+    memset(p_x, 0, size * sizeof(double));
+    CU_ASSERT_EQUAL(
+        sparse_solve_operator(&op, &failing, p_b, p_x, &params, &stats),
+        SPARSE_FAILURE);
+
+    // Stopping early reports the limit and keeps the last iterate
+    params.method         = SPARSE_SOLVE_CG;
+    params.max_iterations = 3U;
+    memset(p_x, 0, size * sizeof(double));
+    CU_ASSERT_EQUAL(sparse_solve_operator(&op, NULL, p_b, p_x, NULL, NULL),
+                    SPARSE_SUCCESS);
+    memset(p_x, 0, size * sizeof(double));
+    CU_ASSERT_EQUAL(
+        sparse_solve_operator(&op, NULL, p_b, p_x, &params, &stats),
+        SPARSE_NOT_CONVERGED);
+    CU_ASSERT_EQUAL(stats.iterations, 3U);
+    CU_ASSERT_EQUAL(stats.matvecs, 4U);
+    CU_ASSERT_TRUE(stats.residual < 1.0);
+
+    free(p_b);
+    free(p_x);
+    free(p_ax);
+    return;
+}
+
+static void
+test_sparse_solve_invalid (void)
+{
+    size_t                size   = 4U;
+    double                p_b[4] = { 1.0, 2.0, 3.0, 4.0 };
+    double                p_x[4] = { 0.0 };
+    sparse_solve_params_t params = { 0 };
+    sparse_operator_t     op     = { size, tridiagonal_apply, &size };
+    sparse_operator_t     small  = { size - 1U, tridiagonal_jacobi, &size };
+
+    CU_ASSERT_EQUAL(sparse_solve(NULL, p_b, p_x, NULL, NULL),
+                    SPARSE_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(sparse_solve_operator(NULL, NULL, p_b, p_x, NULL, NULL),
+                    SPARSE_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(sparse_solve_operator(&op, NULL, NULL, p_x, NULL, NULL),
+                    SPARSE_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(sparse_solve_operator(&op, NULL, p_b, p_b, NULL, NULL),
+                    SPARSE_INVALID_ARGUMENT);
+    CU_ASSERT_EQUAL(sparse_solve_operator(&op, &small, p_b, p_x, NULL, NULL),
+                    SPARSE_INVALID_ARGUMENT);
+    params.method = (sparse_solve_method_t)7;
+    CU_ASSERT_EQUAL(sparse_solve_operator(&op, NULL, p_b, p_x, &params, NULL),
+                    SPARSE_INVALID_ARGUMENT);
+
+    // Non-square matrices and unknown preconditioners
+    size_t           rows[]   = { 0U, 1U, 2U };
+    size_t           cols[]   = { 0U, 2U, 3U };
+    double           values[] = { 1.0, 2.0, 0.0 };
+    sparse_matrix_t *p_wide
+        = sparse_from_triplets(3U, 4U, 3U, rows, cols, values, SPARSE_CSR);
+    CU_ASSERT_EQUAL(sparse_solve(p_wide, p_b, p_x, NULL, NULL),
+                    SPARSE_INVALID_ARGUMENT);
+    sparse_destroy(p_wide);
+
+    // Preconditioners need every diagonal entry: row 2 has none
+    size_t           diag_rows[] = { 0U, 1U, 2U, 3U };
+    size_t           diag_cols[] = { 0U, 1U, 3U, 3U };
+    double           diag_vals[] = { 2.0, 2.0, 1.0, 2.0 };
+    sparse_matrix_t *p_sparse    = sparse_from_triplets(
+        4U, 4U, 4U, diag_rows, diag_cols, diag_vals, SPARSE_CSR);
+    params.method  = SPARSE_SOLVE_GMRES;
+    params.precond = SPARSE_PRECOND_JACOBI;
+    CU_ASSERT_EQUAL(sparse_solve(p_sparse, p_b, p_x, &params, NULL),
+                    SPARSE_FAILURE);
+    params.precond = SPARSE_PRECOND_ILU0;
+    CU_ASSERT_EQUAL(sparse_solve(p_sparse, p_b, p_x, &params, NULL),
+                    SPARSE_FAILURE);
+    params.precond = (sparse_precond_t)9;
+    CU_ASSERT_EQUAL(sparse_solve(p_sparse, p_b, p_x, &params, NULL),
+                    SPARSE_INVALID_ARGUMENT);
+
+    // CG stops at the first non-positive curvature of an indefinite matrix
+    diag_cols[2]  = 2U;
+    diag_vals[2]  = -1.0;
+    sparse_destroy(p_sparse);
+    p_sparse = sparse_from_triplets(
+        4U, 4U, 4U, diag_rows, diag_cols, diag_vals, SPARSE_CSR);
+    params.method  = SPARSE_SOLVE_CG;
+    params.precond = SPARSE_PRECOND_NONE;
+    double p_neg[4] = { 0.0, 0.0, 1.0, 0.0 };
+    CU_ASSERT_EQUAL(sparse_solve(p_sparse, p_neg, p_x, &params, NULL),
+                    SPARSE_NOT_CONVERGED);
+    params.method = SPARSE_SOLVE_GMRES;
+    memset(p_x, 0, sizeof(p_x));
+    CU_ASSERT_EQUAL(sparse_solve(p_sparse, p_neg, p_x, &params, NULL),
+                    SPARSE_SUCCESS);
+    CU_ASSERT_DOUBLE_EQUAL(p_x[2], -1.0, 1e-12);
+    sparse_destroy(p_sparse);
+    return;
+}
+
+static void
+test_sparse_solve_parallel (void)
+{
+    // Several SPARSE_SOLVE_BLOCK blocks, so the vector operations and
+    // SpMV split across threads
+    sparse_matrix_t *p_sparse = grid_operator(300U, 0.25, SPARSE_CSR);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_sparse);
+
+    size_t                size     = p_sparse->rows;
+    double               *p_b      = malloc(size * sizeof(double));
+    double               *p_x_one  = calloc(size, sizeof(double));
+    double               *p_x_four = calloc(size, sizeof(double));
+    sparse_solve_stats_t  one      = { 0 };
+    sparse_solve_stats_t  four     = { 0 };
+    sparse_solve_params_t params   = { 0 };
+    params.method                  = SPARSE_SOLVE_BICGSTAB;
+    params.precond                 = SPARSE_PRECOND_ILU0;
+    fill_vector(p_b, size, 13U);
+
+    parallel_set_threads(1);
+    CU_ASSERT_EQUAL(sparse_solve(p_sparse, p_b, p_x_one, &params, &one),
+                    SPARSE_SUCCESS);
+    parallel_set_threads(4);
+    CU_ASSERT_EQUAL(sparse_solve(p_sparse, p_b, p_x_four, &params, &four),
+                    SPARSE_SUCCESS);
+    parallel_set_threads(0);
+
+    // Dot products reduce in block order, so threads change nothing
+    CU_ASSERT_EQUAL(one.iterations, four.iterations);
+    CU_ASSERT_EQUAL(one.residual, four.residual);
+    CU_ASSERT_EQUAL(memcmp(p_x_one, p_x_four, size * sizeof(double)), 0);
+    CU_ASSERT_TRUE(relative_residual(p_sparse, p_b, p_x_four) < 1e-7);
+
+    free(p_b);
+    free(p_x_one);
+    free(p_x_four);
+    sparse_destroy(p_sparse);
+    return;
+}
+
+/*** end of file ***/
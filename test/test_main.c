@@ -12,6 +12,18 @@
 #include "test_auxiliary.h"
 #include "test_linked_list.h"
 #include "test_matrix.h"
+#include "test_matrix_conv.h"
+#include "test_matrix_expr.h"
+#include "test_matrix_fixed.h"
+#include "test_matrix_io.h"
+#include "test_matrix_map.h"
+#include "test_matrix_packed.h"
+#include "test_matrix_reduce.h"
+#include "test_matrix_solve.h"
+#include "test_matrix_tiled.h"
+#include "test_matrix_typed.h"
+#include "test_sparse_matrix.h"
+#include "test_sparse_solve.h"
 #include "test_stack.h"
 #include "test_queue.h"
 
@@ -179,6 +191,102 @@ create_suites (void)
         goto EXIT;
     }
 
+    // Matrix Expression
+    if (NULL == matrix_expr_suite())
+    {
+        ERROR_LOG("Failed to create the Matrix Expression Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
+    // Matrix Fixed
+    if (NULL == matrix_fixed_suite())
+    {
+        ERROR_LOG("Failed to create the Matrix Fixed Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
+    // Matrix Packed
+    if (NULL == matrix_packed_suite())
+    {
+        ERROR_LOG("Failed to create the Matrix Packed Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
+    // Matrix Map
+    if (NULL == matrix_map_suite())
+    {
+        ERROR_LOG("Failed to create the Matrix Map Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
+    // Matrix Tiled
+    if (NULL == matrix_tiled_suite())
+    {
+        ERROR_LOG("Failed to create the Matrix Tiled Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
+    // Matrix Convolution
+    if (NULL == matrix_conv_suite())
+    {
+        ERROR_LOG("Failed to create the Matrix Convolution Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
+    // Matrix IO
+    if (NULL == matrix_io_suite())
+    {
+        ERROR_LOG("Failed to create the Matrix IO Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
+    // Matrix Reduce
+    if (NULL == matrix_reduce_suite())
+    {
+        ERROR_LOG("Failed to create the Matrix Reduce Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
+    // Matrix Solve
+    if (NULL == matrix_solve_suite())
+    {
+        ERROR_LOG("Failed to create the Matrix Solve Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
+    // Matrix Typed
+    if (NULL == matrix_typed_suite())
+    {
+        ERROR_LOG("Failed to create the Matrix Typed Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
+    // Sparse Matrix
+    if (NULL == sparse_matrix_suite())
+    {
+        ERROR_LOG("Failed to create the Sparse Matrix Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
+    // Sparse Solve
+    if (NULL == sparse_solve_suite())
+    {
+        ERROR_LOG("Failed to create the Sparse Solve Suite\n");
+        retval = CU_get_error();
+        goto EXIT;
+    }
+
     // Stack
     if (NULL == stack_suite())
     {